@@ -20,7 +20,9 @@
 
 #include "network/EventServer.h"
 #include "network/Network.h"
+#include "threads/ReadWriteSection.h"
 #include "threads/SystemClock.h"
+#include "threads/TimerWheel.h"
 #include "Application.h"
 #include "AppInboundProtocol.h"
 #include "dialogs/GUIDialogBusy.h"
@@ -50,6 +52,7 @@
 #include "GUIInfoManager.h"
 #include "playlists/PlayListFactory.h"
 #include "guilib/GUIFontManager.h"
+#include "guilib/GUISkinCache.h"
 #include "guilib/GUIColorManager.h"
 #include "guilib/StereoscopicsManager.h"
 #include "addons/BinaryAddonCache.h"
@@ -74,6 +77,7 @@
 #include "GUIUserMessages.h"
 #include "filesystem/Directory.h"
 #include "filesystem/DirectoryCache.h"
+#include "listproviders/DirectoryProviderCache.h"
 #include "filesystem/StackDirectory.h"
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/DllLibCurl.h"
@@ -1600,6 +1604,7 @@ bool CApplication::LoadSkin(const std::string& skinID)
 
   int64_t start;
   start = CurrentHostCounter();
+  const CGUISkinCache::Statistics skinCacheStart = CGUISkinCache::GetInstance().GetStatistics();
 
   CLog::Log(LOGINFO, "  load new skin...");
 
@@ -1627,6 +1632,11 @@ bool CApplication::LoadSkin(const std::string& skinID)
 
   CLog::Log(LOGINFO, "  skin loaded...");
 
+  const CGUISkinCache::Statistics skinCacheEnd = CGUISkinCache::GetInstance().GetStatistics();
+  CLog::Log(LOGDEBUG, "Skin windows: %u loaded from cache in %.2fms, %u parsed and resolved in %.2fms",
+            skinCacheEnd.hits - skinCacheStart.hits, skinCacheEnd.hitTime - skinCacheStart.hitTime,
+            skinCacheEnd.misses - skinCacheStart.misses, skinCacheEnd.missTime - skinCacheStart.missTime);
+
   // leave the graphics lock
   lock.Leave();
 
@@ -1859,7 +1869,7 @@ void CApplication::Render()
   // fresh for the next process(), or after a windowclose animation (where process()
   // isn't called)
   CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
-  infoMgr.ResetCache();
+  infoMgr.NewFrame();
   infoMgr.GetInfoProviders().GetGUIControlsInfoProvider().ResetContainerMovingCache();
 
   if (hasRendered)
@@ -2754,6 +2764,7 @@ bool CApplication::Cleanup()
     g_LangCodeExpander.Clear();
     g_charsetConverter.clear();
     g_directoryCache.Clear();
+    CDirectoryProviderCache::GetInstance().Clear();
     //CServiceBroker::GetInputManager().ClearKeymaps(); //! @todo
     CEventServer::RemoveInstance();
     DllLoaderContainer::Clear();
@@ -2801,6 +2812,11 @@ bool CApplication::Cleanup()
 
 void CApplication::Stop(int exitCode)
 {
+  // dump reader/writer lock contention, timer latencies and widget listing reuse gathered during this session
+  CReadWriteSection::LogStatistics();
+  CTimerWheel::GetInstance().LogStatistics();
+  CDirectoryProviderCache::GetInstance().LogStatistics();
+
   CLog::Log(LOGNOTICE, "stop player");
   m_appPlayer.ClosePlayer();
 
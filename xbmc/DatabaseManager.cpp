@@ -79,7 +79,10 @@ void CDatabaseManager::UpdateDatabase(CDatabase &db, DatabaseSettings *settings)
   std::string name = db.GetBaseDBName();
   UpdateStatus(name, DB_UPDATING);
   if (Update(db, settings ? *settings : DatabaseSettings()))
+  {
+    db.UpdateFullTextIndexes();
     UpdateStatus(name, DB_READY);
+  }
   else
     UpdateStatus(name, DB_FAILED);
 }
@@ -21,6 +21,7 @@
 #include <cstdlib>
 
 #include "FileItem.h"
+#include "FileItemListCache.h"
 #include "ServiceBroker.h"
 #include "guilib/LocalizeStrings.h"
 #include "utils/StringUtils.h"
@@ -68,6 +69,8 @@
 #include "events/IEvent.h"
 
 #include <algorithm>
+#include <map>
+#include <memory>
 
 using namespace KODI;
 using namespace XFILE;
@@ -291,7 +294,10 @@ CFileItem::CFileItem(const CURL& path, bool bIsFolder)
   m_strPath = path.Get();
   m_bIsFolder = bIsFolder;
   if (m_bIsFolder && !m_strPath.empty() && !IsFileFolder())
+  {
     URIUtils::AddSlashAtEnd(m_strPath);
+    m_pathClassification.Reset();
+  }
   FillInMimeType(false);
 }
 
@@ -301,7 +307,10 @@ CFileItem::CFileItem(const std::string& strPath, bool bIsFolder)
   m_strPath = strPath;
   m_bIsFolder = bIsFolder;
   if (m_bIsFolder && !m_strPath.empty() && !IsFileFolder())
+  {
     URIUtils::AddSlashAtEnd(m_strPath);
+    m_pathClassification.Reset();
+  }
   FillInMimeType(false);
 }
 
@@ -313,6 +322,7 @@ CFileItem::CFileItem(const CMediaSource& share)
   m_strPath = share.strPath;
   if (!IsRSS()) // no slash at end for rss feeds
     URIUtils::AddSlashAtEnd(m_strPath);
+  m_pathClassification.Reset();
   std::string label = share.strName;
   if (!share.strStatus.empty())
     label = StringUtils::Format("%s (%s)", share.strName.c_str(), share.strStatus.c_str());
@@ -367,6 +377,7 @@ CFileItem& CFileItem::operator=(const CFileItem& item)
   m_bLabelPreformatted=item.m_bLabelPreformatted;
   FreeMemory();
   m_strPath = item.m_strPath;
+  m_pathClassification = item.m_pathClassification;
   m_strDynPath = item.m_strDynPath;
   m_bIsParentFolder = item.m_bIsParentFolder;
   m_iDriveType = item.m_iDriveType;
@@ -492,6 +503,7 @@ void CFileItem::Reset()
   m_strDVDLabel.clear();
   m_strTitle.clear();
   m_strPath.clear();
+  m_pathClassification.Reset();
   m_strDynPath.clear();
   m_dateTime.Reset();
   m_strLockCode.clear();
@@ -589,6 +601,7 @@ void CFileItem::Archive(CArchive& ar)
     ar >> m_bIsParentFolder;
     ar >> m_bLabelPreformatted;
     ar >> m_strPath;
+    m_pathClassification.Reset();
     ar >> m_bIsShareOrDrive;
     ar >> m_iDriveType;
     ar >> m_dateTime;
@@ -996,7 +1009,7 @@ bool CFileItem::IsInternetStream(const bool bStrictCheck /* = false */) const
   if (!m_strDynPath.empty())
     return URIUtils::IsInternetStream(m_strDynPath, bStrictCheck);
 
-  return URIUtils::IsInternetStream(m_strPath, bStrictCheck);
+  return m_pathClassification.Is(bStrictCheck ? CPathClassification::INTERNET_STREAM_STRICT : CPathClassification::INTERNET_STREAM, m_strPath);
 }
 
 bool CFileItem::IsFileFolder(EFileFolderType types) const
@@ -1051,7 +1064,7 @@ bool CFileItem::IsLibraryFolder() const
   if (HasProperty("library.filter") && GetProperty("library.filter").asBoolean())
     return true;
 
-  return URIUtils::IsLibraryFolder(m_strPath);
+  return m_pathClassification.Is(CPathClassification::LIBRARY_FOLDER, m_strPath);
 }
 
 bool CFileItem::IsPlayList() const
@@ -1116,17 +1129,17 @@ bool CFileItem::IsBDFile() const
 
 bool CFileItem::IsRAR() const
 {
-  return URIUtils::IsRAR(m_strPath);
+  return m_pathClassification.Is(CPathClassification::RAR, m_strPath);
 }
 
 bool CFileItem::IsAPK() const
 {
-  return URIUtils::IsAPK(m_strPath);
+  return m_pathClassification.Is(CPathClassification::APK, m_strPath);
 }
 
 bool CFileItem::IsZIP() const
 {
-  return URIUtils::IsZIP(m_strPath);
+  return m_pathClassification.Is(CPathClassification::ZIP, m_strPath);
 }
 
 bool CFileItem::IsCBZ() const
@@ -1148,42 +1161,42 @@ bool CFileItem::IsRSS() const
 
 bool CFileItem::IsAndroidApp() const
 {
-  return URIUtils::IsAndroidApp(m_strPath);
+  return m_pathClassification.Is(CPathClassification::ANDROID_APP, m_strPath);
 }
 
 bool CFileItem::IsStack() const
 {
-  return URIUtils::IsStack(m_strPath);
+  return m_pathClassification.Is(CPathClassification::STACK, m_strPath);
 }
 
 bool CFileItem::IsPlugin() const
 {
-  return URIUtils::IsPlugin(m_strPath);
+  return m_pathClassification.Is(CPathClassification::PLUGIN, m_strPath);
 }
 
 bool CFileItem::IsScript() const
 {
-  return URIUtils::IsScript(m_strPath);
+  return m_pathClassification.Is(CPathClassification::SCRIPT, m_strPath);
 }
 
 bool CFileItem::IsAddonsPath() const
 {
-  return URIUtils::IsAddonsPath(m_strPath);
+  return m_pathClassification.Is(CPathClassification::ADDONS_PATH, m_strPath);
 }
 
 bool CFileItem::IsSourcesPath() const
 {
-  return URIUtils::IsSourcesPath(m_strPath);
+  return m_pathClassification.Is(CPathClassification::SOURCES_PATH, m_strPath);
 }
 
 bool CFileItem::IsMultiPath() const
 {
-  return URIUtils::IsMultiPath(m_strPath);
+  return m_pathClassification.Is(CPathClassification::MULTI_PATH, m_strPath);
 }
 
 bool CFileItem::IsCDDA() const
 {
-  return URIUtils::IsCDDA(m_strPath);
+  return m_pathClassification.Is(CPathClassification::CDDA, m_strPath);
 }
 
 bool CFileItem::IsDVD() const
@@ -1198,7 +1211,7 @@ bool CFileItem::IsOnDVD() const
 
 bool CFileItem::IsNfs() const
 {
-  return URIUtils::IsNfs(m_strPath);
+  return m_pathClassification.Is(CPathClassification::NFS, m_strPath);
 }
 
 bool CFileItem::IsOnLAN() const
@@ -1208,22 +1221,22 @@ bool CFileItem::IsOnLAN() const
 
 bool CFileItem::IsISO9660() const
 {
-  return URIUtils::IsISO9660(m_strPath);
+  return m_pathClassification.Is(CPathClassification::ISO9660, m_strPath);
 }
 
 bool CFileItem::IsRemote() const
 {
-  return URIUtils::IsRemote(m_strPath);
+  return m_pathClassification.Is(CPathClassification::REMOTE, m_strPath);
 }
 
 bool CFileItem::IsSmb() const
 {
-  return URIUtils::IsSmb(m_strPath);
+  return m_pathClassification.Is(CPathClassification::SMB, m_strPath);
 }
 
 bool CFileItem::IsURL() const
 {
-  return URIUtils::IsURL(m_strPath);
+  return m_pathClassification.Is(CPathClassification::URL, m_strPath);
 }
 
 bool CFileItem::IsPVR() const
@@ -1233,22 +1246,22 @@ bool CFileItem::IsPVR() const
 
 bool CFileItem::IsLiveTV() const
 {
-  return URIUtils::IsLiveTV(m_strPath);
+  return m_pathClassification.Is(CPathClassification::LIVE_TV, m_strPath);
 }
 
 bool CFileItem::IsHD() const
 {
-  return URIUtils::IsHD(m_strPath);
+  return m_pathClassification.Is(CPathClassification::HD, m_strPath);
 }
 
 bool CFileItem::IsMusicDb() const
 {
-  return URIUtils::IsMusicDb(m_strPath);
+  return m_pathClassification.Is(CPathClassification::MUSIC_DB, m_strPath);
 }
 
 bool CFileItem::IsVideoDb() const
 {
-  return URIUtils::IsVideoDb(m_strPath);
+  return m_pathClassification.Is(CPathClassification::VIDEO_DB, m_strPath);
 }
 
 bool CFileItem::IsVirtualDirectoryRoot() const
@@ -1274,7 +1287,7 @@ bool CFileItem::IsReadOnly() const
 
 void CFileItem::FillInDefaultIcon()
 {
-  if (URIUtils::IsPVRGuideItem(m_strPath))
+  if (m_pathClassification.Is(CPathClassification::PVR_GUIDE_ITEM, m_strPath))
   {
     // epg items never have a default icon. no need to execute this expensive method.
     // when filling epg grid window, easily tens of thousands of epg items are processed.
@@ -1315,7 +1328,7 @@ void CFileItem::FillInDefaultIcon()
         // Live TV Channel
         SetIconImage("DefaultTVShows.png");
       }
-      else if ( URIUtils::IsArchive(m_strPath) )
+      else if (m_pathClassification.Is(CPathClassification::ARCHIVE, m_strPath))
       { // archive
         SetIconImage("DefaultFile.png");
       }
@@ -1381,9 +1394,9 @@ void CFileItem::FillInDefaultIcon()
   // Set the icon overlays (if applicable)
   if (!HasOverlay())
   {
-    if (URIUtils::IsInRAR(m_strPath))
+    if (m_pathClassification.Is(CPathClassification::IN_RAR, m_strPath))
       SetOverlayImage(CGUIListItem::ICON_OVERLAY_RAR);
-    else if (URIUtils::IsInZIP(m_strPath))
+    else if (m_pathClassification.Is(CPathClassification::IN_ZIP, m_strPath))
       SetOverlayImage(CGUIListItem::ICON_OVERLAY_ZIP);
   }
 }
@@ -1486,7 +1499,10 @@ void CFileItem::FillInMimeType(bool lookup /*= true*/)
 
   // change protocol to mms for the following mime-type.  Allows us to create proper FileMMS.
   if( StringUtils::StartsWithNoCase(m_mimetype, "application/vnd.ms.wms-hdr.asfv1") || StringUtils::StartsWithNoCase(m_mimetype, "application/x-mms-framed") )
+  {
     StringUtils::Replace(m_strPath, "http:", "mms:");
+    m_pathClassification.Reset();
+  }
 }
 
 void CFileItem::SetMimeTypeForInternetFile()
@@ -1631,6 +1647,7 @@ void CFileItem::SetFromVideoInfoTag(const CVideoInfoTag &video)
     m_strPath = video.m_strFileNameAndPath;
     m_bIsFolder = false;
   }
+  m_pathClassification.Reset();
 
   if (m_videoInfoTag)
     *m_videoInfoTag = video;
@@ -1648,7 +1665,7 @@ void CFileItem::SetFromMusicInfoTag(const MUSIC_INFO::CMusicInfoTag &music)
   if (!music.GetTitle().empty())
     SetLabel(music.GetTitle());
   if (!music.GetURL().empty())
-    m_strPath = music.GetURL();
+    SetPath(music.GetURL());
   m_bIsFolder = URIUtils::HasSlashAtEnd(m_strPath);
 
   *GetMusicInfoTag() = music;
@@ -1676,10 +1693,10 @@ void CFileItem::SetFromSong(const CSong &song)
   if (song.idSong > 0)
   {
     std::string strExt = URIUtils::GetExtension(song.strFileName);
-    m_strPath = StringUtils::Format("musicdb://songs/%li%s", song.idSong, strExt.c_str());
+    SetPath(StringUtils::Format("musicdb://songs/%li%s", song.idSong, strExt.c_str()));
   }
   else if (!song.strFileName.empty())
-    m_strPath = song.strFileName;
+    SetPath(song.strFileName);
   GetMusicInfoTag()->SetSong(song);
   m_lStartOffset = song.iStartOffset;
   m_lStartPartNumber = 1;
@@ -1722,7 +1739,7 @@ std::string CFileItem::GetOpticalMediaPath() const
 */
 void CFileItem::SetURL(const CURL& url)
 {
-  m_strPath = url.Get();
+  SetPath(url.Get());
 }
 
 const CURL CFileItem::GetURL() const
@@ -2298,27 +2315,7 @@ void CFileItemList::Archive(CArchive& ar)
 
     ar << m_fastLookup;
 
-    ar << (int)m_sortDescription.sortBy;
-    ar << (int)m_sortDescription.sortOrder;
-    ar << (int)m_sortDescription.sortAttributes;
-    ar << m_sortIgnoreFolders;
-    ar << (int)m_cacheToDisc;
-
-    ar << (int)m_sortDetails.size();
-    for (unsigned int j = 0; j < m_sortDetails.size(); ++j)
-    {
-      const GUIViewSortDetails &details = m_sortDetails[j];
-      ar << (int)details.m_sortDescription.sortBy;
-      ar << (int)details.m_sortDescription.sortOrder;
-      ar << (int)details.m_sortDescription.sortAttributes;
-      ar << details.m_buttonLabel;
-      ar << details.m_labelMasks.m_strLabelFile;
-      ar << details.m_labelMasks.m_strLabelFolder;
-      ar << details.m_labelMasks.m_strLabel2File;
-      ar << details.m_labelMasks.m_strLabel2Folder;
-    }
-
-    ar << m_content;
+    ArchiveSortState(ar);
 
     for (; i < (int)m_items.size(); ++i)
     {
@@ -2361,6 +2358,48 @@ void CFileItemList::Archive(CArchive& ar)
     bool fastLookup = false;
     ar >> fastLookup;
 
+    ArchiveSortState(ar);
+
+    for (int i = 0; i < iSize; ++i)
+    {
+      CFileItemPtr pItem(new CFileItem);
+      ar >> *pItem;
+      Add(pItem);
+    }
+
+    SetIgnoreURLOptions(ignoreURLOptions);
+    SetFastLookup(fastLookup);
+  }
+}
+
+void CFileItemList::ArchiveSortState(CArchive& ar)
+{
+  if (ar.IsStoring())
+  {
+    ar << (int)m_sortDescription.sortBy;
+    ar << (int)m_sortDescription.sortOrder;
+    ar << (int)m_sortDescription.sortAttributes;
+    ar << m_sortIgnoreFolders;
+    ar << (int)m_cacheToDisc;
+
+    ar << (int)m_sortDetails.size();
+    for (unsigned int j = 0; j < m_sortDetails.size(); ++j)
+    {
+      const GUIViewSortDetails &details = m_sortDetails[j];
+      ar << (int)details.m_sortDescription.sortBy;
+      ar << (int)details.m_sortDescription.sortOrder;
+      ar << (int)details.m_sortDescription.sortAttributes;
+      ar << details.m_buttonLabel;
+      ar << details.m_labelMasks.m_strLabelFile;
+      ar << details.m_labelMasks.m_strLabelFolder;
+      ar << details.m_labelMasks.m_strLabel2File;
+      ar << details.m_labelMasks.m_strLabel2Folder;
+    }
+
+    ar << m_content;
+  }
+  else
+  {
     int tempint;
     ar >> (int&)tempint;
     m_sortDescription.sortBy = (SortBy)tempint;
@@ -2392,16 +2431,6 @@ void CFileItemList::Archive(CArchive& ar)
     }
 
     ar >> m_content;
-
-    for (int i = 0; i < iSize; ++i)
-    {
-      CFileItemPtr pItem(new CFileItem);
-      ar >> *pItem;
-      Add(pItem);
-    }
-
-    SetIgnoreURLOptions(ignoreURLOptions);
-    SetFastLookup(fastLookup);
   }
 }
 
@@ -2687,111 +2716,192 @@ void CFileItemList::StackFolders()
   }
 }
 
-void CFileItemList::StackFiles()
+namespace
 {
-  // Precompile our REs
-  VECCREGEXP stackRegExps;
-  CRegExp tmpRegExp(true, CRegExp::autoUtf8);
-  const std::vector<std::string>& strStackRegExps = g_advancedSettings.m_videoStackRegExps;
-  std::vector<std::string>::const_iterator strRegExp = strStackRegExps.begin();
-  while (strRegExp != strStackRegExps.end())
+/*!
+ \brief Pool of compiled video stacking expressions.
+
+ CRegExp keeps the state of its last match, so every listing being stacked
+ takes a set of expressions of its own out of the pool and puts it back when
+ done. The pool is dropped when the expressions in the advanced settings change.
+ */
+class CStackRegExpPool
+{
+public:
+  std::unique_ptr<VECCREGEXP> Acquire(const std::vector<std::string> &patterns)
   {
-    if (tmpRegExp.RegComp(*strRegExp))
     {
-      if (tmpRegExp.GetCaptureTotal() == 4)
-        stackRegExps.push_back(tmpRegExp);
-      else
-        CLog::Log(LOGERROR, "Invalid video stack RE (%s). Must have 4 captures.", strRegExp->c_str());
+      CSingleLock lock(m_section);
+      if (patterns != m_patterns)
+      {
+        m_patterns = patterns;
+        m_free.clear();
+      }
+      if (!m_free.empty())
+      {
+        std::unique_ptr<VECCREGEXP> regExps = std::move(m_free.back());
+        m_free.pop_back();
+        return regExps;
+      }
     }
-    strRegExp++;
+
+    std::unique_ptr<VECCREGEXP> regExps(new VECCREGEXP);
+    // copying a CRegExp drops its study data, so compile them in place
+    regExps->reserve(patterns.size());
+    for (const auto &pattern : patterns)
+    {
+      regExps->emplace_back(true, CRegExp::autoUtf8);
+      if (!regExps->back().RegComp(pattern, CRegExp::StudyRegExp))
+        regExps->pop_back();
+      else if (regExps->back().GetCaptureTotal() != 4)
+      {
+        CLog::Log(LOGERROR, "Invalid video stack RE (%s). Must have 4 captures.", pattern.c_str());
+        regExps->pop_back();
+      }
+    }
+    return regExps;
+  }
+
+  void Release(std::unique_ptr<VECCREGEXP> regExps, const std::vector<std::string> &patterns)
+  {
+    CSingleLock lock(m_section);
+    if (patterns == m_patterns)
+      m_free.push_back(std::move(regExps));
   }
 
-  // now stack the files, some of which may be from the previous stack iteration
-  int i = 0;
-  while (i < Size())
+private:
+  CCriticalSection m_section;
+  std::vector<std::string> m_patterns;
+  std::vector<std::unique_ptr<VECCREGEXP>> m_free;
+};
+
+CStackRegExpPool stackRegExpPool;
+
+struct StackMatch
+{
+  bool matched = false;
+  std::string title;
+  std::string volume;
+  std::string ignore;
+  std::string extension;
+  int ignoreStart = 0;
+};
+
+void MatchStackRegExp(CRegExp &expr, const std::string &file, unsigned int offset, StackMatch &match)
+{
+  match.matched = expr.RegFind(file, offset) != -1;
+  if (!match.matched)
+    return;
+
+  match.title = offset ? file.substr(0, expr.GetSubStart(2)) : expr.GetMatch(1);
+  match.volume = expr.GetMatch(2);
+  match.ignore = expr.GetMatch(3);
+  match.extension = expr.GetMatch(4);
+  match.ignoreStart = expr.GetSubStart(3);
+}
+}
+
+void CFileItemList::StackFiles()
+{
+  const std::vector<std::string> patterns = g_advancedSettings.m_videoStackRegExps;
+  std::unique_ptr<VECCREGEXP> stackRegExps = stackRegExpPool.Acquire(patterns);
+  const size_t numRegExps = stackRegExps->size();
+  const int count = Size();
+
+  // split and decode the file names once, every file is compared with its
+  // predecessor and its successor for every expression
+  std::vector<std::string> files(count);
+  std::vector<bool> candidates(count, false);
+  for (int i = 0; i < count; i++)
   {
-    CFileItemPtr item1 = Get(i);
+    const CFileItemPtr &item = m_items[i];
 
     // skip folders, nfo files, playlists
-    if (item1->m_bIsFolder
-      || item1->IsParentFolder()
-      || item1->IsNFO()
-      || item1->IsPlayList()
+    if (item->m_bIsFolder
+      || item->IsParentFolder()
+      || item->IsNFO()
+      || item->IsPlayList()
       )
-    {
-      // increment index
-      i++;
       continue;
+
+    std::string filePath;
+    URIUtils::Split(item->GetPath(), filePath, files[i]);
+    if (URIUtils::HasEncodedFilename(CURL(filePath)))
+      files[i] = CURL::Decode(files[i]);
+    candidates[i] = true;
+  }
+
+  // matches of the files from the current one up to the end of its stack,
+  // so that no file is matched against the same expression twice
+  std::map<std::pair<int, size_t>, StackMatch> matches;
+  auto getMatch = [&](int index, size_t expr, unsigned int offset, StackMatch &offsetMatch) -> const StackMatch&
+  {
+    if (offset)
+    {
+      MatchStackRegExp((*stackRegExps)[expr], files[index], offset, offsetMatch);
+      return offsetMatch;
+    }
+    auto it = matches.find(std::make_pair(index, expr));
+    if (it == matches.end())
+    {
+      it = matches.insert(std::make_pair(std::make_pair(index, expr), StackMatch())).first;
+      MatchStackRegExp((*stackRegExps)[expr], files[index], 0, it->second);
     }
+    return it->second;
+  };
 
+  // now stack the files, stacked files are only removed from the list at
+  // the end, in one go
+  std::vector<bool> removed(count, false);
+  bool stacked = false;
+  for (int i = 0; i < count; i++)
+  {
+    if (!candidates[i] || removed[i])
+      continue;
+    matches.erase(matches.begin(), matches.lower_bound(std::make_pair(i, static_cast<size_t>(0))));
+
+    CFileItemPtr item1 = m_items[i];
     int64_t               size        = 0;
-    size_t                offset      = 0;
+    unsigned int          offset      = 0;
     std::string           stackName;
-    std::string           file1;
-    std::string           filePath;
     std::vector<int>      stack;
-    VECCREGEXP::iterator  expr        = stackRegExps.begin();
-
-    URIUtils::Split(item1->GetPath(), filePath, file1);
-    if (URIUtils::HasEncodedFilename(CURL(filePath)))
-      file1 = CURL::Decode(file1);
+    size_t                expr        = 0;
+    StackMatch            offsetMatch1;
+    StackMatch            offsetMatch2;
 
-    int j;
-    while (expr != stackRegExps.end())
+    while (expr < numRegExps)
     {
-      if (expr->RegFind(file1, offset) != -1)
+      const StackMatch &match1 = getMatch(i, expr, offset, offsetMatch1);
+      if (match1.matched)
       {
-        std::string Title1      = expr->GetMatch(1),
-                    Volume1     = expr->GetMatch(2),
-                    Ignore1     = expr->GetMatch(3),
-                    Extension1  = expr->GetMatch(4);
-        if (offset)
-          Title1 = file1.substr(0, expr->GetSubStart(2));
-        j = i + 1;
-        while (j < Size())
+        int j = i + 1;
+        while (j < count)
         {
-          CFileItemPtr item2 = Get(j);
-
-          // skip folders, nfo files, playlists
-          if (item2->m_bIsFolder
-            || item2->IsParentFolder()
-            || item2->IsNFO()
-            || item2->IsPlayList()
-            )
+          if (!candidates[j])
           {
             // increment index
             j++;
             continue;
           }
 
-          std::string file2, filePath2;
-          URIUtils::Split(item2->GetPath(), filePath2, file2);
-          if (URIUtils::HasEncodedFilename(CURL(filePath2)) )
-            file2 = CURL::Decode(file2);
-
-          if (expr->RegFind(file2, offset) != -1)
+          const StackMatch &match2 = getMatch(j, expr, offset, offsetMatch2);
+          if (match2.matched)
           {
-            std::string  Title2      = expr->GetMatch(1),
-                        Volume2     = expr->GetMatch(2),
-                        Ignore2     = expr->GetMatch(3),
-                        Extension2  = expr->GetMatch(4);
-            if (offset)
-              Title2 = file2.substr(0, expr->GetSubStart(2));
-            if (StringUtils::EqualsNoCase(Title1, Title2))
+            if (StringUtils::EqualsNoCase(match1.title, match2.title))
             {
-              if (!StringUtils::EqualsNoCase(Volume1, Volume2))
+              if (!StringUtils::EqualsNoCase(match1.volume, match2.volume))
               {
-                if (StringUtils::EqualsNoCase(Ignore1, Ignore2) &&
-                    StringUtils::EqualsNoCase(Extension1, Extension2))
+                if (StringUtils::EqualsNoCase(match1.ignore, match2.ignore) &&
+                    StringUtils::EqualsNoCase(match1.extension, match2.extension))
                 {
                   if (stack.empty())
                   {
-                    stackName = Title1 + Ignore1 + Extension1;
+                    stackName = match1.title + match1.ignore + match1.extension;
                     stack.push_back(i);
                     size += item1->m_dwSize;
                   }
                   stack.push_back(j);
-                  size += item2->m_dwSize;
+                  size += m_items[j]->m_dwSize;
                 }
                 else // Sequel
                 {
@@ -2800,9 +2910,9 @@ void CFileItemList::StackFiles()
                   break;
                 }
               }
-              else if (!StringUtils::EqualsNoCase(Ignore1, Ignore2)) // False positive, try again with offset
+              else if (!StringUtils::EqualsNoCase(match1.ignore, match2.ignore)) // False positive, try again with offset
               {
-                offset = expr->GetSubStart(3);
+                offset = match2.ignoreStart;
                 break;
               }
               else // Extension mismatch
@@ -2827,8 +2937,8 @@ void CFileItemList::StackFiles()
           }
           j++;
         }
-        if (j == Size())
-          expr = stackRegExps.end();
+        if (j == count)
+          expr = numRegExps;
       }
       else // No match 1
       {
@@ -2837,20 +2947,21 @@ void CFileItemList::StackFiles()
       }
       if (stack.size() > 1)
       {
-        // have a stack, remove the items and add the stacked item
+        // have a stack, mark the items for removal and replace the first one
+        // by the stacked item
         // dont actually stack a multipart rar set, just remove all items but the first
         std::string stackPath;
-        if (Get(stack[0])->IsRAR())
-          stackPath = Get(stack[0])->GetPath();
+        if (m_items[stack[0]]->IsRAR())
+          stackPath = m_items[stack[0]]->GetPath();
         else
         {
           CStackDirectory dir;
           stackPath = dir.ConstructStackPath(*this, stack);
         }
         item1->SetPath(stackPath);
-        // clean up list
         for (unsigned k = 1; k < stack.size(); k++)
-          Remove(i+1);
+          removed[stack[k]] = true;
+        stacked = true;
         // item->m_bIsFolder = true;  // don't treat stacked files as folders
         // the label may be in a different char set from the filename (eg over smb
         // the label is converted from utf8, but the filename is not)
@@ -2862,33 +2973,35 @@ void CFileItemList::StackFiles()
         break;
       }
     }
-    i++;
   }
+
+  stackRegExpPool.Release(std::move(stackRegExps), patterns);
+
+  if (!stacked)
+    return;
+
+  VECFILEITEMS items;
+  items.reserve(count);
+  for (int i = 0; i < count; i++)
+  {
+    if (!removed[i])
+      items.push_back(m_items[i]);
+    else if (m_fastLookup)
+      m_map.erase(m_ignoreURLOptions ? CURL(m_items[i]->GetPath()).GetWithoutOptions() : m_items[i]->GetPath());
+  }
+  m_items.swap(items);
 }
 
 bool CFileItemList::Load(int windowID)
 {
-  CFile file;
   auto path = GetDiscFileCache(windowID);
-  try
-  {
-    if (file.Open(path))
-    {
-      CArchive ar(&file, CArchive::load);
-      ar >> *this;
-      CLog::Log(LOGDEBUG,"Loading items: %i, directory: %s sort method: %i, ascending: %s", Size(), CURL::GetRedacted(GetPath()).c_str(), m_sortDescription.sortBy,
-        m_sortDescription.sortOrder == SortOrderAscending ? "true" : "false");
-      ar.Close();
-      file.Close();
-      return true;
-    }
-  }
-  catch(std::out_of_range ex)
-  {
-    CLog::Log(LOGERROR, "Corrupt archive: %s", CURL::GetRedacted(path).c_str());
-  }
+  CFileItemListCache cache;
+  if (!cache.Open(path) || !cache.Load(*this))
+    return false;
 
-  return false;
+  CLog::Log(LOGDEBUG,"Loading items: %i, directory: %s sort method: %i, ascending: %s", Size(), CURL::GetRedacted(GetPath()).c_str(), m_sortDescription.sortBy,
+    m_sortDescription.sortOrder == SortOrderAscending ? "true" : "false");
+  return true;
 }
 
 bool CFileItemList::Save(int windowID)
@@ -2899,14 +3012,9 @@ bool CFileItemList::Save(int windowID)
 
   CLog::Log(LOGDEBUG,"Saving fileitems [%s]", CURL::GetRedacted(GetPath()).c_str());
 
-  CFile file;
-  if (file.OpenForWrite(GetDiscFileCache(windowID), true)) // overwrite always
+  if (CFileItemListCache::Save(*this, GetDiscFileCache(windowID)))
   {
-    CArchive ar(&file, CArchive::store);
-    ar << *this;
     CLog::Log(LOGDEBUG,"  -- items: %i, sort method: %i, ascending: %s", iSize, m_sortDescription.sortBy, m_sortDescription.sortOrder == SortOrderAscending ? "true" : "false");
-    ar.Close();
-    file.Close();
     return true;
   }
 
@@ -2968,8 +3076,8 @@ std::string CFileItem::GetUserMusicThumb(bool alwaysCheckRemote /* = false */, b
    || StringUtils::StartsWithNoCase(m_strPath, "newplaylist://")
    || m_bIsShareOrDrive
    || IsInternetStream()
-   || URIUtils::IsUPnP(m_strPath)
-   || (URIUtils::IsFTP(m_strPath) && !g_advancedSettings.m_bFTPThumbs)
+   || m_pathClassification.Is(CPathClassification::UPNP, m_strPath)
+   || (m_pathClassification.Is(CPathClassification::FTP, m_strPath) && !g_advancedSettings.m_bFTPThumbs)
    || IsPlugin()
    || IsAddonsPath()
    || IsLibraryFolder()
@@ -3060,8 +3168,8 @@ bool CFileItem::SkipLocalArt() const
        || StringUtils::StartsWithNoCase(m_strPath, "newplaylist://")
        || m_bIsShareOrDrive
        || IsInternetStream()
-       || URIUtils::IsUPnP(m_strPath)
-       || (URIUtils::IsFTP(m_strPath) && !g_advancedSettings.m_bFTPThumbs)
+       || m_pathClassification.Is(CPathClassification::UPNP, m_strPath)
+       || (m_pathClassification.Is(CPathClassification::FTP, m_strPath) && !g_advancedSettings.m_bFTPThumbs)
        || IsPlugin()
        || IsAddonsPath()
        || IsLibraryFolder()
@@ -3205,12 +3313,12 @@ std::string CFileItem::GetBaseMoviePath(bool bUseFolderNames) const
     return GetLocalMetadataPath();
 
   if (bUseFolderNames &&
-     (!m_bIsFolder || URIUtils::IsInArchive(m_strPath) ||
+     (!m_bIsFolder || m_pathClassification.Is(CPathClassification::IN_ARCHIVE, m_strPath) ||
      (HasVideoInfoTag() && GetVideoInfoTag()->m_iDbId > 0 && !CMediaTypes::IsContainer(GetVideoInfoTag()->m_type))))
   {
     std::string name2(strMovieName);
     URIUtils::GetParentPath(name2,strMovieName);
-    if (URIUtils::IsInArchive(m_strPath))
+    if (m_pathClassification.Is(CPathClassification::IN_ARCHIVE, m_strPath))
     {
       std::string strArchivePath;
       URIUtils::GetParentPath(strMovieName, strArchivePath);
@@ -38,6 +38,7 @@
 #include "utils/IArchivable.h"
 #include "utils/ISerializable.h"
 #include "utils/ISortable.h"
+#include "utils/PathClassification.h"
 #include "utils/SortUtils.h"
 #include "XBDateTime.h"
 
@@ -129,7 +130,7 @@ public:
   void SetURL(const CURL& url);
   bool IsURL(const CURL& url) const;
   const std::string &GetPath() const { return m_strPath; };
-  void SetPath(const std::string &path) { m_strPath = path; };
+  void SetPath(const std::string &path) { m_strPath = path; m_pathClassification.Reset(); };
   bool IsPath(const std::string& path, bool ignoreURLOptions = false) const;
 
   const CURL GetDynURL() const;
@@ -578,6 +579,7 @@ private:
   void FillMusicInfoTag(const PVR::CPVRChannelPtr& channel, const PVR::CPVREpgInfoTagPtr& tag);
 
   std::string m_strPath;            ///< complete path to item
+  CPathClassification m_pathClassification; ///< memoized URIUtils checks of m_strPath, reset whenever it changes
   std::string m_strDynPath;
 
   SortSpecial m_specialSort;
@@ -781,10 +783,17 @@ public:
   VECFILEITEMS::const_iterator cbegin() const { return m_items.begin(); }
   VECFILEITEMS::const_iterator cend() const { return m_items.end(); }
 private:
+  friend class CFileItemListCache;
+
   void Sort(FILEITEMLISTCOMPARISONFUNC func);
   void FillSortFields(FILEITEMFILLFUNC func);
   std::string GetDiscFileCache(int windowID) const;
 
+  /*!
+   \brief (de)serialize the sort methods and the content of the list
+   */
+  void ArchiveSortState(CArchive& ar);
+
   /*!
    \brief stack files in a CFileItemList
    \sa Stack
@@ -0,0 +1,404 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItemListCache.h"
+
+#include <limits>
+#include <stdexcept>
+#include <string.h>
+
+#include "CompileInfo.h"
+#include "URL.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+
+using namespace XFILE;
+
+static const char CACHE_MAGIC[4] = { 'K', 'F', 'I', 'L' };
+
+// flags of a record
+#define RECORD_FOLDER 0x1
+
+struct CFileItemListCache::Header
+{
+  char magic[4];
+  uint32_t version;
+  uint32_t stamp;             //!< build that wrote the cache
+  uint32_t count;             //!< number of records
+  uint32_t propertiesOffset;  //!< archived properties of the list
+  uint32_t propertiesSize;
+  uint32_t recordsOffset;
+  uint32_t stringsOffset;     //!< paths and labels, not terminated
+  uint32_t stringsSize;
+  uint32_t itemsOffset;       //!< archived items
+  uint32_t itemsSize;
+};
+
+struct CFileItemListCache::Record
+{
+  uint32_t offset;            //!< archived item, relative to itemsOffset
+  uint32_t size;
+  uint32_t path;              //!< relative to stringsOffset
+  uint32_t pathLength;
+  uint32_t label;
+  uint32_t labelLength;
+  uint32_t pathHash;
+  uint32_t flags;
+};
+
+bool CFileItemListCache::Write(CFileItemList& items, std::vector<uint8_t>& data)
+{
+  CSingleLock lock(items.m_lock);
+
+  std::vector<uint8_t> properties;
+  {
+    CArchive ar(properties);
+    items.CFileItem::Archive(ar);
+    ar << items.m_ignoreURLOptions;
+    ar << items.m_fastLookup;
+    items.ArchiveSortState(ar);
+  }
+
+  size_t first = 0;
+  if (!items.m_items.empty() && items.m_items[0]->IsParentFolder())
+    first = 1;
+
+  std::vector<Record> records;
+  records.reserve(items.m_items.size() - first);
+  std::string strings;
+  std::vector<uint8_t> archived;
+  {
+    CArchive ar(archived);
+    for (size_t i = first; i < items.m_items.size(); ++i)
+    {
+      const CFileItemPtr& item = items.m_items[i];
+      const std::string& path = item->GetPath();
+      const std::string& label = item->GetLabel();
+
+      Record record;
+      record.offset = static_cast<uint32_t>(archived.size());
+      ar << *item;
+      ar.Close();
+      record.size = static_cast<uint32_t>(archived.size() - record.offset);
+      record.path = static_cast<uint32_t>(strings.size());
+      record.pathLength = static_cast<uint32_t>(path.size());
+      strings += path;
+      record.label = static_cast<uint32_t>(strings.size());
+      record.labelLength = static_cast<uint32_t>(label.size());
+      strings += label;
+      record.pathHash = Crc32::Compute(path);
+      record.flags = item->m_bIsFolder ? RECORD_FOLDER : 0;
+      records.push_back(record);
+    }
+  }
+
+  const uint64_t total = sizeof(Header) + properties.size() + records.size() * sizeof(Record) +
+                         strings.size() + archived.size();
+  if (total > std::numeric_limits<uint32_t>::max())
+    return false;
+
+  Header header;
+  memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+  header.version = VERSION;
+  header.stamp = GetStamp();
+  header.count = static_cast<uint32_t>(records.size());
+  header.propertiesOffset = sizeof(Header);
+  header.propertiesSize = static_cast<uint32_t>(properties.size());
+  header.recordsOffset = header.propertiesOffset + header.propertiesSize;
+  header.stringsOffset = header.recordsOffset + header.count * sizeof(Record);
+  header.stringsSize = static_cast<uint32_t>(strings.size());
+  header.itemsOffset = header.stringsOffset + header.stringsSize;
+  header.itemsSize = static_cast<uint32_t>(archived.size());
+
+  data.resize(static_cast<size_t>(total));
+  uint8_t* out = data.data();
+  memcpy(out, &header, sizeof(header));
+  memcpy(out + header.propertiesOffset, properties.data(), properties.size());
+  if (!records.empty())
+    memcpy(out + header.recordsOffset, records.data(), records.size() * sizeof(Record));
+  memcpy(out + header.stringsOffset, strings.data(), strings.size());
+  if (!archived.empty())
+    memcpy(out + header.itemsOffset, archived.data(), archived.size());
+  return true;
+}
+
+bool CFileItemListCache::Save(CFileItemList& items, const std::string& path)
+{
+  std::vector<uint8_t> data;
+  if (!Write(items, data))
+  {
+    CLog::Log(LOGERROR, "%s: list too large to cache: %s", __FUNCTION__, CURL::GetRedacted(path).c_str());
+    return false;
+  }
+
+  CFile file;
+  if (!file.OpenForWrite(path, true)) // overwrite always
+    return false;
+
+  const bool written = file.Write(data.data(), data.size()) == static_cast<ssize_t>(data.size());
+  file.Close();
+  return written;
+}
+
+bool CFileItemListCache::Open(const std::string& path)
+{
+  Close();
+
+  CFile file;
+  if (file.LoadFile(path, m_file) <= 0)
+    return false;
+
+  m_data = reinterpret_cast<const uint8_t*>(m_file.get());
+  m_size = m_file.size();
+  if (!Validate())
+  {
+    CLog::Log(LOGDEBUG, "%s: not using outdated or corrupt cache %s", __FUNCTION__, CURL::GetRedacted(path).c_str());
+    Close();
+    return false;
+  }
+  return true;
+}
+
+bool CFileItemListCache::Open(const CFileItemList& items, int windowID /* = 0 */)
+{
+  return Open(items.GetDiscFileCache(windowID));
+}
+
+bool CFileItemListCache::Open(std::vector<uint8_t> data)
+{
+  Close();
+
+  m_memory = std::move(data);
+  m_data = m_memory.data();
+  m_size = m_memory.size();
+  if (!Validate())
+  {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void CFileItemListCache::Close()
+{
+  m_file.clear();
+  m_memory.clear();
+  m_data = nullptr;
+  m_size = 0;
+  m_count = 0;
+  m_items.clear();
+  m_pathIndex.clear();
+}
+
+bool CFileItemListCache::Validate()
+{
+  static_assert(sizeof(Header) == 44, "cache header must not be padded");
+  static_assert(sizeof(Record) == 32, "cache record must not be padded");
+
+  if (m_size < sizeof(Header))
+    return false;
+
+  Header header;
+  memcpy(&header, m_data, sizeof(header));
+  if (memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != VERSION ||
+      header.stamp != GetStamp())
+    return false;
+
+  // the sections must lie within the data
+  const uint64_t size = m_size;
+  if (static_cast<uint64_t>(header.propertiesOffset) + header.propertiesSize > size ||
+      static_cast<uint64_t>(header.recordsOffset) + static_cast<uint64_t>(header.count) * sizeof(Record) > size ||
+      static_cast<uint64_t>(header.stringsOffset) + header.stringsSize > size ||
+      static_cast<uint64_t>(header.itemsOffset) + header.itemsSize > size)
+    return false;
+
+  m_count = header.count;
+  m_propertiesOffset = header.propertiesOffset;
+  m_propertiesSize = header.propertiesSize;
+  m_recordsOffset = header.recordsOffset;
+  m_stringsOffset = header.stringsOffset;
+  m_stringsSize = header.stringsSize;
+  m_itemsOffset = header.itemsOffset;
+  m_itemsSize = header.itemsSize;
+  m_items.assign(m_count, CFileItemPtr());
+  return true;
+}
+
+bool CFileItemListCache::GetRecord(int index, Record& record) const
+{
+  if (index < 0 || static_cast<uint32_t>(index) >= m_count)
+    return false;
+
+  memcpy(&record, m_data + m_recordsOffset + static_cast<size_t>(index) * sizeof(Record), sizeof(record));
+
+  // records are checked when used, not all of them when opening the cache
+  return static_cast<uint64_t>(record.offset) + record.size <= m_itemsSize &&
+         static_cast<uint64_t>(record.path) + record.pathLength <= m_stringsSize &&
+         static_cast<uint64_t>(record.label) + record.labelLength <= m_stringsSize;
+}
+
+std::string CFileItemListCache::GetString(uint32_t offset, uint32_t length) const
+{
+  return std::string(reinterpret_cast<const char*>(m_data + m_stringsOffset + offset), length);
+}
+
+std::string CFileItemListCache::GetPath(int index) const
+{
+  Record record;
+  if (!GetRecord(index, record))
+    return "";
+  return GetString(record.path, record.pathLength);
+}
+
+std::string CFileItemListCache::GetLabel(int index) const
+{
+  Record record;
+  if (!GetRecord(index, record))
+    return "";
+  return GetString(record.label, record.labelLength);
+}
+
+bool CFileItemListCache::IsFolder(int index) const
+{
+  Record record;
+  if (!GetRecord(index, record))
+    return false;
+  return (record.flags & RECORD_FOLDER) != 0;
+}
+
+CFileItemPtr CFileItemListCache::Deserialize(int index) const
+{
+  Record record;
+  if (!GetRecord(index, record))
+    return CFileItemPtr();
+
+  CFileItemPtr item(new CFileItem);
+  try
+  {
+    CArchive ar(m_data + m_itemsOffset + record.offset, record.size);
+    ar >> *item;
+  }
+  catch (const std::out_of_range&)
+  {
+    CLog::Log(LOGERROR, "%s: corrupt item %i", __FUNCTION__, index);
+    return CFileItemPtr();
+  }
+  return item;
+}
+
+CFileItemPtr CFileItemListCache::Get(int index)
+{
+  if (index < 0 || static_cast<uint32_t>(index) >= m_count)
+    return CFileItemPtr();
+
+  if (!m_items[index])
+    m_items[index] = Deserialize(index);
+  return m_items[index];
+}
+
+CFileItemPtr CFileItemListCache::Get(const std::string& path)
+{
+  Record record;
+  if (m_pathIndex.empty())
+  {
+    m_pathIndex.reserve(m_count);
+    for (uint32_t i = 0; i < m_count; ++i)
+    {
+      if (GetRecord(i, record))
+        m_pathIndex.emplace(record.pathHash, i);
+    }
+  }
+
+  // the first of several items with the same path wins, like in a list
+  uint32_t found = m_count;
+  const auto range = m_pathIndex.equal_range(Crc32::Compute(path));
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    if (it->second < found && GetRecord(it->second, record) &&
+        record.pathLength == path.size() &&
+        memcmp(m_data + m_stringsOffset + record.path, path.data(), path.size()) == 0)
+      found = it->second;
+  }
+  return Get(static_cast<int>(found));
+}
+
+bool CFileItemListCache::Load(CFileItemList& items)
+{
+  if (!m_data)
+    return false;
+
+  CSingleLock lock(items.m_lock);
+
+  CFileItemPtr parent;
+  if (!items.IsEmpty() && items.m_items[0]->IsParentFolder())
+    parent.reset(new CFileItem(*items.m_items[0]));
+
+  items.SetIgnoreURLOptions(false);
+  items.SetFastLookup(false);
+  items.Clear();
+
+  bool ignoreURLOptions = false;
+  bool fastLookup = false;
+  try
+  {
+    CArchive ar(m_data + m_propertiesOffset, m_propertiesSize);
+    items.CFileItem::Archive(ar);
+    ar >> ignoreURLOptions;
+    ar >> fastLookup;
+    items.ArchiveSortState(ar);
+  }
+  catch (const std::out_of_range&)
+  {
+    CLog::Log(LOGERROR, "%s: corrupt list properties", __FUNCTION__);
+    items.Clear();
+    return false;
+  }
+
+  items.m_items.reserve(m_count + (parent ? 1 : 0));
+  if (parent)
+    items.m_items.push_back(parent);
+
+  for (uint32_t i = 0; i < m_count; ++i)
+  {
+    // items already handed out are not shared with the list
+    CFileItemPtr item = Deserialize(i);
+    if (!item)
+    {
+      items.Clear();
+      return false;
+    }
+    items.Add(item);
+  }
+
+  items.SetIgnoreURLOptions(ignoreURLOptions);
+  items.SetFastLookup(fastLookup);
+  return true;
+}
+
+uint32_t CFileItemListCache::GetStamp()
+{
+  // the archived items are only compatible with the build that wrote them
+  static const uint32_t stamp = Crc32::Compute(std::string(CCompileInfo::GetSCMID()));
+  return stamp;
+}
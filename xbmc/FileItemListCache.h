@@ -0,0 +1,147 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "FileItem.h"
+#include "utils/auto_buffer.h"
+
+/*!
+ \brief Disk cache of a CFileItemList with access to single items.
+
+ The cache consists of a header, the archived properties of the list, a
+ record of fixed size per item and a string table with the paths and labels
+ of the items, followed by the archived items. Everything is located by
+ offsets, so the cache is read at once and an item is only deserialized when
+ it is asked for.
+
+ The header carries the version of the format and a stamp of the build that
+ wrote it. Caches that don't match are rejected, so they get rebuilt.
+ */
+class CFileItemListCache
+{
+public:
+  static const uint32_t VERSION = 1;
+
+  CFileItemListCache() = default;
+  CFileItemListCache(const CFileItemListCache&) = delete;
+  CFileItemListCache& operator=(const CFileItemListCache&) = delete;
+
+  /*!
+   \brief Serialize a list, leaving out its parent folder item
+   \param items the list to serialize
+   \param data [out] the serialized list
+   \return true on success, false if the list is too large
+   */
+  static bool Write(CFileItemList& items, std::vector<uint8_t>& data);
+
+  /*!
+   \brief Serialize a list to a file
+   \sa Write
+   */
+  static bool Save(CFileItemList& items, const std::string& path);
+
+  /*!
+   \brief Read a cache file and check that it is valid
+   \return true if the cache can be used, false otherwise
+   */
+  bool Open(const std::string& path);
+
+  /*!
+   \brief Read the disk cache of a list as written by CFileItemList::Save()
+   \sa Open
+   */
+  bool Open(const CFileItemList& items, int windowID = 0);
+
+  /*!
+   \brief Use a serialized list and check that it is valid
+   \return true if the cache can be used, false otherwise
+   */
+  bool Open(std::vector<uint8_t> data);
+
+  void Close();
+
+  int Size() const { return static_cast<int>(m_count); }
+
+  /*!
+   \brief Get the path of an item without deserializing it
+   */
+  std::string GetPath(int index) const;
+
+  /*!
+   \brief Get the label of an item without deserializing it
+   */
+  std::string GetLabel(int index) const;
+
+  bool IsFolder(int index) const;
+
+  /*!
+   \brief Get an item, it is deserialized on first access
+   \return the item, nullptr if the index is out of range or the item is corrupt
+   */
+  CFileItemPtr Get(int index);
+
+  /*!
+   \brief Get the first item with the given path. The paths are indexed on
+   first use, only the item found is deserialized.
+   \return the item, nullptr if there is none
+   */
+  CFileItemPtr Get(const std::string& path);
+
+  /*!
+   \brief Restore the properties and all items of a list
+
+   A parent folder item in the list is kept, like when loading the list from
+   a CArchive.
+   \return true on success, false if the cache is corrupt
+   */
+  bool Load(CFileItemList& items);
+
+private:
+  struct Header;
+  struct Record;
+
+  bool Validate();
+  bool GetRecord(int index, Record& record) const;
+  std::string GetString(uint32_t offset, uint32_t length) const;
+  CFileItemPtr Deserialize(int index) const;
+  static uint32_t GetStamp();
+
+  XUTILS::auto_buffer m_file;
+  std::vector<uint8_t> m_memory;
+  const uint8_t* m_data = nullptr;
+  size_t m_size = 0;
+
+  uint32_t m_count = 0;
+  uint32_t m_propertiesOffset = 0;
+  uint32_t m_propertiesSize = 0;
+  uint32_t m_recordsOffset = 0;
+  uint32_t m_stringsOffset = 0;
+  uint32_t m_stringsSize = 0;
+  uint32_t m_itemsOffset = 0;
+  uint32_t m_itemsSize = 0;
+
+  std::vector<CFileItemPtr> m_items; //!< deserialized items, nullptr if not yet
+  std::unordered_multimap<uint32_t, uint32_t> m_pathIndex; //!< path hash to index, empty until looked up by path
+};
@@ -41,11 +41,15 @@
 #include "interfaces/info/InfoExpression.h"
 #include "messaging/ApplicationMessenger.h"
 #include "settings/SkinSettings.h"
+#include "threads/SystemClock.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
+// keep updating the playback state for this long (ms) after the player went away
+#define PLAYER_SETTLE_TIME 5000
+
 using namespace KODI::GUILIB;
 using namespace KODI::GUILIB::GUIINFO;
 using namespace INFO;
@@ -58,7 +62,9 @@ bool InfoBoolComparator(const InfoPtr &right, const InfoPtr &left)
 CGUIInfoManager::CGUIInfoManager(void)
 : m_currentFile(new CFileItem),
   m_bools(&InfoBoolComparator),
-  m_refreshCounter(0)
+  m_lastFrameTime(0),
+  m_lastPlayerTime(0),
+  m_lastFrameSeconds(0)
 {
 }
 
@@ -6393,9 +6399,9 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
   std::pair<INFOBOOLTYPE::iterator, bool> res;
 
   if (condition.find_first_of("|+[]!") != condition.npos)
-    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_infoSources));
   else
-    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_infoSources));
 
   if (res.second)
     res.first->get()->Initialize();
@@ -6911,8 +6917,92 @@ bool CGUIInfoManager::GetItemBool(const CGUIListItem *item, int contextWindow, i
 void CGUIInfoManager::ResetCache()
 {
   // mark our infobools as dirty
-  CSingleLock lock(m_critInfo);
-  ++m_refreshCounter;
+  m_infoSources.Invalidate(INFO::SOURCE_ALL);
+}
+
+void CGUIInfoManager::InvalidateInfo(unsigned int sources)
+{
+  m_infoSources.Invalidate(sources);
+}
+
+void CGUIInfoManager::NewFrame()
+{
+  unsigned int sources = INFO::SOURCE_FRAME;
+
+  // the playback state doesn't change without a player, keep updating it for
+  // a while after the player went away for infos taking a moment to settle
+  const unsigned int now = XbmcThreads::SystemClockMillis();
+  if (g_application.GetAppPlayer().HasPlayer())
+    m_lastPlayerTime = now;
+  if (now - m_lastPlayerTime < PLAYER_SETTLE_TIME)
+    sources |= INFO::SOURCE_PLAYER;
+
+  const time_t seconds = time(nullptr);
+  if (seconds != m_lastFrameSeconds)
+  {
+    m_lastFrameSeconds = seconds;
+    sources |= INFO::SOURCE_TIME;
+  }
+
+  m_infoSources.Invalidate(sources);
+
+  m_statistics.lookups = m_infoSources.m_lookups;
+  m_statistics.evaluations = m_infoSources.m_evaluations;
+  m_statistics.frameTime = now - m_lastFrameTime;
+  m_infoSources.m_lookups = 0;
+  m_infoSources.m_evaluations = 0;
+  m_lastFrameTime = now;
+}
+
+unsigned int CGUIInfoManager::GetInfoSources(int condition) const
+{
+  int info = std::abs(condition);
+  if (info >= MULTI_INFO_START && info <= MULTI_INFO_END)
+    info = std::abs(m_multiInfo[info - MULTI_INFO_START].m_info);
+
+  switch (info)
+  {
+    case SYSTEM_ALWAYS_TRUE:
+    case SYSTEM_ALWAYS_FALSE:
+      return INFO::SOURCE_NONE;
+    case SYSTEM_TIME:
+    case SYSTEM_DATE:
+      return INFO::SOURCE_TIME;
+    case LIBRARY_HAS_MUSIC:
+    case LIBRARY_HAS_VIDEO:
+    case LIBRARY_HAS_MOVIES:
+    case LIBRARY_HAS_MOVIE_SETS:
+    case LIBRARY_HAS_TVSHOWS:
+    case LIBRARY_HAS_MUSICVIDEOS:
+    case LIBRARY_HAS_SINGLES:
+    case LIBRARY_HAS_COMPILATIONS:
+    case LIBRARY_HAS_ROLE:
+      return INFO::SOURCE_LIBRARY;
+    case SKIN_BOOL:
+    case SKIN_STRING:
+    case SKIN_THEME:
+    case SKIN_COLOUR_THEME:
+    case SKIN_HAS_THEME:
+    case SKIN_ASPECT_RATIO:
+    case SKIN_FONT:
+      return INFO::SOURCE_SKIN;
+    // player infos that also change without playback
+    case PLAYER_VOLUME:
+    case PLAYER_MUTED:
+    case PLAYER_SHOWCODEC:
+    case PLAYER_SHOWINFO:
+    case PLAYER_SHOWTIME:
+    case PLAYER_SEEKBAR:
+      return INFO::SOURCE_FRAME;
+    default:
+      break;
+  }
+
+  if ((info >= PLAYER_HAS_MEDIA && info <= PLAYER_HAS_PROGRAMS) ||
+      (info >= PLAYER_PROCESS_VIDEODECODER && info <= PLAYER_PROCESS_AUDIOBITSPERSAMPLE))
+    return INFO::SOURCE_PLAYER;
+
+  return INFO::SOURCE_FRAME;
 }
 
 void CGUIInfoManager::SetCurrentVideoTag(const CVideoInfoTag &tag)
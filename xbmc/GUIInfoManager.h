@@ -23,6 +23,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <time.h>
 #include <vector>
 
 #include "guilib/guiinfo/GUIInfoProviders.h"
@@ -71,8 +72,36 @@ public:
   void Initialize();
 
   void Clear();
+
+  /*! \brief Mark all infos as dirty
+   */
   void ResetCache();
 
+  /*! \brief Mark the infos depending on the given sources as dirty
+   \param sources a combination of INFO::InfoSource
+   */
+  void InvalidateInfo(unsigned int sources);
+
+  /*! \brief Called once per frame after rendering, marks the infos that may
+   have changed since the last frame as dirty and updates the statistics
+   */
+  void NewFrame();
+
+  /*! \brief Get the data an info depends on
+   \param condition the translated condition
+   \return a combination of INFO::InfoSource
+   */
+  unsigned int GetInfoSources(int condition) const;
+
+  struct InfoStatistics
+  {
+    unsigned int lookups = 0;     ///< conditions looked up in the last frame
+    unsigned int evaluations = 0; ///< conditions (re)evaluated in the last frame
+    unsigned int frameTime = 0;   ///< duration of the last frame in ms
+  };
+
+  InfoStatistics GetStatistics() const { return m_statistics; }
+
   // KODI::MESSAGING::IMessageTarget implementation
   int GetMessageMask() override;
   void OnApplicationMessage(KODI::MESSAGING::ThreadMessage* pMsg) override;
@@ -209,7 +238,11 @@ private:
 
   typedef std::set<INFO::InfoPtr, bool(*)(const INFO::InfoPtr&, const INFO::InfoPtr&)> INFOBOOLTYPE;
   INFOBOOLTYPE m_bools;
-  unsigned int m_refreshCounter;
+  INFO::CInfoSources m_infoSources;
+  InfoStatistics m_statistics;
+  unsigned int m_lastFrameTime;
+  unsigned int m_lastPlayerTime; ///< last frame with a player
+  time_t m_lastFrameSeconds;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
   CCriticalSection m_critInfo;
@@ -348,22 +348,20 @@ bool CPartyModeManager::AddRandomSongs(int iSongs /* = 0 */)
     if (database.Open())
     {
       // Method:
-      // 1. Grab a random entry from the database using a where clause
+      // 1. Grab a random entry from the database that wasn't picked before in this session
       // 2. Iterate on iSongs.
 
-      // Note: At present, this method is faster than the alternative, which is to grab
-      // all valid songids, then select a random number of them (as done in AddInitialSongs()).
-      // The reason for this is simply the number of songs we are requesting - we generally
-      // only want one here.  Any more than about 3 songs and it is more efficient
-      // to use the technique in AddInitialSongs.  As it's unlikely that we'll require
-      // more than 1 song at a time here, this method is faster.
+      // The database picks the entry by probing random ids, so this doesn't depend on the
+      // size of the library. Once every matching song was picked we start over, keeping
+      // only the most recent ones out.
       bool error(false);
       for (int i = 0; i < iSongsToAdd; i++)
       {
-        std::pair<std::string,std::string> whereClause = GetWhereClauseWithHistory();
         CFileItemPtr item(new CFileItem);
         int songID;
-        if (database.GetRandomSong(item.get(), songID, CDatabase::Filter(whereClause.first)))
+        CDatabase::Filter filter(m_strCurrentFilterMusic);
+        if (database.GetRandomSong(item.get(), songID, filter, m_pickedSongs) ||
+            (ResetPicked(1) && database.GetRandomSong(item.get(), songID, filter, m_pickedSongs)))
         { // success
           Add(item);
           AddToHistory(1,songID);
@@ -396,22 +394,15 @@ bool CPartyModeManager::AddRandomSongs(int iSongs /* = 0 */)
     if (database.Open())
     {
       // Method:
-      // 1. Grab a random entry from the database using a where clause
+      // 1. Grab a random entry from the database that wasn't picked before in this session
       // 2. Iterate on iSongs.
-
-      // Note: At present, this method is faster than the alternative, which is to grab
-      // all valid songids, then select a random number of them (as done in AddInitialSongs()).
-      // The reason for this is simply the number of songs we are requesting - we generally
-      // only want one here.  Any more than about 3 songs and it is more efficient
-      // to use the technique in AddInitialSongs.  As it's unlikely that we'll require
-      // more than 1 song at a time here, this method is faster.
       bool error(false);
       for (int i = 0; i < iVidsToAdd; i++)
       {
-        std::pair<std::string,std::string> whereClause = GetWhereClauseWithHistory();
         CFileItemPtr item(new CFileItem);
         int songID;
-        if (database.GetRandomMusicVideo(item.get(), songID, whereClause.second))
+        if (database.GetRandomMusicVideo(item.get(), songID, m_strCurrentFilterVideo, m_pickedVideos) ||
+            (ResetPicked(2) && database.GetRandomMusicVideo(item.get(), songID, m_strCurrentFilterVideo, m_pickedVideos)))
         { // success
           Add(item);
           AddToHistory(2,songID);
@@ -591,6 +582,8 @@ void CPartyModeManager::ClearState()
 
   m_songsInHistory = 0;
   m_history.clear();
+  m_pickedSongs.clear();
+  m_pickedVideos.clear();
 }
 
 void CPartyModeManager::UpdateStats()
@@ -645,7 +638,8 @@ bool CPartyModeManager::AddInitialSongs(std::vector< std::pair<int,int > > &song
                                      CDatabase::Filter(sqlWhereVideo), items);
     }
 
-    m_history = chosenSongIDs;
+    for (const auto &it : chosenSongIDs)
+      AddToHistory(it.first, it.second);
     items.Randomize(); //randomizing the initial list or they will be in database order
     for (int i = 0; i < items.Size(); i++)
     {
@@ -657,44 +651,34 @@ bool CPartyModeManager::AddInitialSongs(std::vector< std::pair<int,int > > &song
   return true;
 }
 
-std::pair<std::string,std::string> CPartyModeManager::GetWhereClauseWithHistory() const
+bool CPartyModeManager::ResetPicked(int type)
 {
-  // now add this on to the normal where clause
-  std::vector<std::string> historyItemsMusic;
-  std::vector<std::string> historyItemsVideo;
-  for (unsigned int i = 0; i < m_history.size(); i++)
-  {
-    std::string number = StringUtils::Format("%i", m_history[i].second);
-    if (m_history[i].first == 1)
-      historyItemsMusic.push_back(number);
-    if (m_history[i].first == 2)
-      historyItemsVideo.push_back(number);
-  }
+  std::set<int> &picked = type == 1 ? m_pickedSongs : m_pickedVideos;
+  if (picked.empty())
+    return false; // nothing to start over with, the filter doesn't match anything
 
-  std::string historyWhereMusic;
-  if (!historyItemsMusic.empty())
+  // keep the most recently picked ones out
+  picked.clear();
+  for (const auto &it : m_history)
   {
-    if (!m_strCurrentFilterMusic.empty())
-      historyWhereMusic = m_strCurrentFilterMusic + " and ";
-    historyWhereMusic += "songview.idSong not in (" + StringUtils::Join(historyItemsMusic, ", ") + ")";
+    if (it.first == type)
+      picked.insert(it.second);
   }
-
-  std::string historyWhereVideo;
-  if (!historyItemsVideo.empty())
-  {
-    if (!m_strCurrentFilterVideo.empty())
-      historyWhereVideo = m_strCurrentFilterVideo + " and ";
-    historyWhereVideo += "idMVideo not in (" + StringUtils::Join(historyItemsVideo, ", ") + ")";
-  }
-
-  return std::make_pair(historyWhereMusic, historyWhereVideo);
+  CLog::Log(LOGDEBUG, "PARTY MODE MANAGER: All matching %s were picked, starting over", type == 1 ? "songs" : "music videos");
+  return true;
 }
 
 void CPartyModeManager::AddToHistory(int type, int songID)
 {
-  while (m_history.size() >= m_songsInHistory && m_songsInHistory)
+  while (m_history.size() >= m_songsInHistory && !m_history.empty())
     m_history.erase(m_history.begin());
-  m_history.push_back(std::make_pair(type,songID));
+  if (m_songsInHistory > 0)
+    m_history.push_back(std::make_pair(type,songID));
+
+  if (type == 1)
+    m_pickedSongs.insert(songID);
+  else if (type == 2)
+    m_pickedVideos.insert(songID);
 }
 
 void CPartyModeManager::GetRandomSelection(std::vector< std::pair<int,int> >& in, unsigned int number, std::vector< std::pair<int,int> >& out)
@@ -20,6 +20,7 @@
  */
 
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -70,7 +71,7 @@ private:
   void OnError(int iError, const std::string& strLogMessage);
   void ClearState();
   void UpdateStats();
-  std::pair<std::string,std::string> GetWhereClauseWithHistory() const;
+  bool ResetPicked(int type);
   void AddToHistory(int type, int songID);
   void GetRandomSelection(std::vector< std::pair<int,int> > &in, unsigned int number, std::vector< std::pair<int, int> > &out);
   void Announce();
@@ -94,6 +95,8 @@ private:
   // history
   unsigned int m_songsInHistory;
   std::vector< std::pair<int,int> > m_history;
+  std::set<int> m_pickedSongs;  ///< songs picked in this session, not picked again until all matching ones were
+  std::set<int> m_pickedVideos; ///< same for music videos
 };
 
 extern CPartyModeManager g_partyModeManager;
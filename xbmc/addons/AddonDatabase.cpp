@@ -143,7 +143,7 @@ int CAddonDatabase::GetMinSchemaVersion() const
 
 int CAddonDatabase::GetSchemaVersion() const
 {
-  return 27;
+  return 28;
 }
 
 void CAddonDatabase::CreateTables()
@@ -157,7 +157,8 @@ void CAddonDatabase::CreateTables()
       "name TEXT NOT NULL,"
       "summary TEXT NOT NULL,"
       "news TEXT NOT NULL,"
-      "description TEXT NOT NULL)");
+      "description TEXT NOT NULL,"
+      "checksum TEXT NOT NULL DEFAULT '')");
 
   CLog::Log(LOGINFO, "create repo table");
   m_pDS->exec("CREATE TABLE repo (id integer primary key, addonID text,"
@@ -314,6 +315,10 @@ void CAddonDatabase::UpdateTables(int version)
   {
     m_pDS->exec("ALTER TABLE addons ADD news TEXT NOT NULL DEFAULT ''");
   }
+  if (version < 28)
+  {
+    m_pDS->exec("ALTER TABLE addons ADD checksum TEXT NOT NULL DEFAULT ''");
+  }
 }
 
 void CAddonDatabase::SyncInstalled(const std::set<std::string>& ids,
@@ -803,29 +808,71 @@ bool CAddonDatabase::UpdateRepositoryContent(const std::string& repository, cons
     m_pDS->exec(PrepareSQL("UPDATE repo SET checksum='%s' WHERE id='%d'", checksum.c_str(), idRepo));
     for (const auto& addon : addons)
     {
-      m_pDS->exec(PrepareSQL(
-          "INSERT INTO addons (id, metadata, addonID, version, name, summary, description, news) "
-          "VALUES (NULL, '%s', '%s', '%s', '%s','%s', '%s','%s')",
-          SerializeMetadata(*addon).c_str(),
-          addon->ID().c_str(),
-          addon->Version().asString().c_str(),
-          addon->Name().c_str(),
-          addon->Summary().c_str(),
-          addon->Description().c_str(),
-          addon->ChangeLog().c_str()));
-
-      int idAddon = static_cast<int>(m_pDS->lastinsertid());
-      if (idAddon <= 0)
+      if (!AddRepositoryAddon(idRepo, *addon, ""))
       {
-        CLog::Log(LOGERROR, "%s insert failed on addon '%s'", __FUNCTION__, addon->ID().c_str());
         RollbackTransaction();
         return false;
       }
+    }
+
+    m_pDB->commit_transaction();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed on repo '%s'", __FUNCTION__, repository.c_str());
+    RollbackTransaction();
+  }
+  return false;
+}
+
+bool CAddonDatabase::UpdateRepositoryContent(const std::string& repository, const AddonVersion& version,
+    const std::string& checksum, const std::map<std::string, AddonPtr>& addons,
+    const std::set<std::string>& unchanged)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    int idRepo = SetLastChecked(repository, version, CDateTime::GetCurrentDateTime().GetAsDBDateTime());
+    if (idRepo < 0)
+      return false;
+    assert(idRepo > 0);
+
+    m_pDB->start_transaction();
+    m_pDS->exec(PrepareSQL("UPDATE repo SET checksum='%s' WHERE id='%d'", checksum.c_str(), idRepo));
+
+    // remove the addons of descriptors no longer in the repository or changed
+    std::vector<int> removed;
+    m_pDS->query(PrepareSQL("SELECT addons.id, addons.checksum FROM addons "
+        "JOIN addonlinkrepo ON addons.id=addonlinkrepo.idAddon WHERE addonlinkrepo.idRepo=%i", idRepo));
+    while (!m_pDS->eof())
+    {
+      if (unchanged.find(m_pDS->fv(1).get_asString()) == unchanged.end())
+        removed.push_back(m_pDS->fv(0).get_asInt());
+      m_pDS->next();
+    }
+    m_pDS->close();
 
-      m_pDS->exec(PrepareSQL("INSERT INTO addonlinkrepo (idRepo, idAddon) VALUES (%i, %i)", idRepo, idAddon));
+    for (int idAddon : removed)
+    {
+      m_pDS->exec(PrepareSQL("DELETE FROM addons WHERE id=%i", idAddon));
+      m_pDS->exec(PrepareSQL("DELETE FROM addonlinkrepo WHERE idAddon=%i", idAddon));
+    }
+
+    for (const auto& addon : addons)
+    {
+      if (!AddRepositoryAddon(idRepo, *addon.second, addon.first))
+      {
+        RollbackTransaction();
+        return false;
+      }
     }
 
     m_pDB->commit_transaction();
+    CLog::Log(LOGDEBUG, "%s repo '%s': %zu addons added, %zu removed", __FUNCTION__,
+        repository.c_str(), addons.size(), removed.size());
     return true;
   }
   catch (...)
@@ -836,6 +883,58 @@ bool CAddonDatabase::UpdateRepositoryContent(const std::string& repository, cons
   return false;
 }
 
+bool CAddonDatabase::AddRepositoryAddon(int idRepo, const IAddon& addon, const std::string& checksum)
+{
+  m_pDS->exec(PrepareSQL(
+      "INSERT INTO addons (id, metadata, addonID, version, name, summary, description, news, checksum) "
+      "VALUES (NULL, '%s', '%s', '%s', '%s','%s', '%s','%s', '%s')",
+      SerializeMetadata(addon).c_str(),
+      addon.ID().c_str(),
+      addon.Version().asString().c_str(),
+      addon.Name().c_str(),
+      addon.Summary().c_str(),
+      addon.Description().c_str(),
+      addon.ChangeLog().c_str(),
+      checksum.c_str()));
+
+  int idAddon = static_cast<int>(m_pDS->lastinsertid());
+  if (idAddon <= 0)
+  {
+    CLog::Log(LOGERROR, "%s insert failed on addon '%s'", __FUNCTION__, addon.ID().c_str());
+    return false;
+  }
+
+  m_pDS->exec(PrepareSQL("INSERT INTO addonlinkrepo (idRepo, idAddon) VALUES (%i, %i)", idRepo, idAddon));
+  return true;
+}
+
+bool CAddonDatabase::GetRepositoryEntries(const std::string& id, std::set<std::string>& checksums)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    m_pDS->query(PrepareSQL("SELECT addons.checksum FROM addons "
+        "JOIN addonlinkrepo ON addons.id=addonlinkrepo.idAddon "
+        "JOIN repo ON addonlinkrepo.idRepo=repo.id WHERE repo.addonID='%s'", id.c_str()));
+    while (!m_pDS->eof())
+    {
+      std::string checksum = m_pDS->fv(0).get_asString();
+      if (!checksum.empty())
+        checksums.insert(std::move(checksum));
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed on repo '%s'", __FUNCTION__, id.c_str());
+  }
+  return false;
+}
+
 int CAddonDatabase::GetRepoChecksum(const std::string& id, std::string& checksum)
 {
   try
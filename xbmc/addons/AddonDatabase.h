@@ -19,6 +19,8 @@
  *
  */
 
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -56,6 +58,18 @@ public:
   bool UpdateRepositoryContent(const std::string& repositoryId, const ADDON::AddonVersion& version,
       const std::string& checksum, const std::vector<ADDON::AddonPtr>& addons);
 
+  /*!
+   \brief Update the addons of a repository with the descriptors of its index that changed
+   \param addons addons of the new and changed descriptors, by checksum of their descriptor
+   \param unchanged checksums of the descriptors to keep, addons of all others are removed
+   */
+  bool UpdateRepositoryContent(const std::string& repositoryId, const ADDON::AddonVersion& version,
+      const std::string& checksum, const std::map<std::string, ADDON::AddonPtr>& addons,
+      const std::set<std::string>& unchanged);
+
+  /*! Get the checksums of the descriptors the addons of repository `id` were read from */
+  bool GetRepositoryEntries(const std::string& id, std::set<std::string>& checksums);
+
   int GetRepoChecksum(const std::string& id, std::string& checksum);
 
   /*!
@@ -160,5 +174,6 @@ protected:
 
   bool GetAddon(int id, ADDON::AddonPtr& addon);
   void DeleteRepository(const std::string& id);
+  bool AddRepositoryAddon(int idRepo, const ADDON::IAddon& addon, const std::string& checksum);
 };
 
@@ -20,6 +20,8 @@
 
 #include "AddonManager.h"
 
+#include "CompileInfo.h"
+#include "RepoIndexReader.h"
 #include "ServiceBroker.h"
 #include "events/AddonManagementEvent.h"
 #include "events/EventLog.h"
@@ -27,6 +29,7 @@
 #include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
 #include "settings/AdvancedSettings.h"
+#include "utils/Digest.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -1160,38 +1163,61 @@ bool CAddonMgr::LoadAddonDescription(const std::string &directory, AddonPtr &add
   return addon != nullptr;
 }
 
-bool CAddonMgr::AddonsFromRepoXML(const CRepository::DirInfo& repo, const std::string& xml, VECADDONS& addons)
+bool CAddonMgr::AddonsFromRepoXML(const CRepository::DirInfo& repo, const std::string& xml,
+                                  const std::set<std::string>& known,
+                                  std::map<std::string, AddonPtr>& addons,
+                                  std::set<std::string>& unchanged)
 {
-  CXBMCTinyXML doc;
-  if (!doc.Parse(xml))
-  {
-    CLog::Log(LOGERROR, "CAddonMgr: Failed to parse addons.xml.");
-    return false;
-  }
-
-  if (doc.RootElement() == nullptr || doc.RootElement()->ValueStr() != "addons")
+  CRepoIndexReader reader(xml.c_str(), xml.size());
+  if (!reader.Open())
   {
     CLog::Log(LOGERROR, "CAddonMgr: Failed to parse addons.xml. Malformed.");
     return false;
   }
 
+  // the descriptors are handed to cpluff as they are, which reads UTF-8
+  // unless told otherwise by a declaration
+  std::string declaration = reader.GetDeclaration();
+  std::string encoding = declaration;
+  StringUtils::ToLower(encoding);
+  if (encoding.find("encoding") == std::string::npos || encoding.find("utf-8") != std::string::npos)
+    declaration.clear();
+
   // create a context for these addons
   cp_status_t status;
   cp_context_t *context = cp_create_context(&status);
   if (!context)
     return false;
 
-  // each addon XML should have a UTF-8 declaration
-  TiXmlDeclaration decl("1.0", "UTF-8", "");
-  auto element = doc.RootElement()->FirstChildElement("addon");
-  while (element)
+  std::string descriptor;
+  while (reader.Next())
   {
-    // dump the XML back to text
-    std::string xml;
-    xml << decl;
-    xml << *element;
-    cp_status_t status;
-    cp_plugin_info_t *info = cp_load_plugin_descriptor_from_memory(context, xml.c_str(), xml.size(), &status);
+    // the path of an addon depends on the repository directory it is read from
+    KODI::UTILITY::CDigest digest{KODI::UTILITY::CDigest::Type::MD5};
+    digest.Update(CCompileInfo::GetSCMID());
+    digest.Update(repo.datadir + "\n" + repo.artdir + "\n");
+    digest.Update(reader.GetElement(), reader.GetElementSize());
+    std::string checksum = digest.Finalize();
+
+    if (known.find(checksum) != known.end())
+    {
+      unchanged.insert(std::move(checksum));
+      continue;
+    }
+    if (addons.find(checksum) != addons.end())
+      continue;
+
+    const char* data = reader.GetElement();
+    size_t size = reader.GetElementSize();
+    if (!declaration.empty())
+    {
+      descriptor = declaration;
+      descriptor.append(data, size);
+      data = descriptor.c_str();
+      size = descriptor.size();
+    }
+
+    cp_plugin_info_t *info = cp_load_plugin_descriptor_from_memory(context, data, size, &status);
     if (info)
     {
       CAddonBuilder builder;
@@ -1206,15 +1232,20 @@ bool CAddonMgr::AddonsFromRepoXML(const CRepository::DirInfo& repo, const std::s
           StringUtils::Format("{}-{}.zip", info->identifier, builder.GetVersion().asString())));
         auto addon = builder.Build();
         if (addon)
-          addons.push_back(std::move(addon));
+          addons.emplace(std::move(checksum), std::move(addon));
       }
       free(info->plugin_path);
       info->plugin_path = nullptr;
       cp_release_info(context, info);
     }
-    element = element->NextSiblingElement("addon");
   }
   cp_destroy_context(context);
+
+  if (reader.HasError())
+  {
+    CLog::Log(LOGERROR, "CAddonMgr: Failed to parse addons.xml. Malformed.");
+    return false;
+  }
   return true;
 }
 
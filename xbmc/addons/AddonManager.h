@@ -271,12 +271,19 @@ namespace ADDON
 
     /*! \brief Parse a repository XML file for addons and load their descriptors
      A repository XML is essentially a concatenated list of addon descriptors.
+     Every descriptor is identified by a checksum of its text, descriptors
+     already known aren't loaded again.
      \param repo The repository info.
      \param xml The XML document from repository.
-     \param addons [out] returned list of addons.
+     \param known checksums of the descriptors loaded before.
+     \param addons [out] returned addons of the descriptors not known, by checksum.
+     \param unchanged [out] checksums of the known descriptors in the XML document.
      \return true if the repository XML file is parsed, false otherwise.
      */
-    bool AddonsFromRepoXML(const CRepository::DirInfo& repo, const std::string& xml, VECADDONS& addons);
+    bool AddonsFromRepoXML(const CRepository::DirInfo& repo, const std::string& xml,
+                           const std::set<std::string>& known,
+                           std::map<std::string, AddonPtr>& addons,
+                           std::set<std::string>& unchanged);
 
     bool ServicesHasStarted() const;
 
@@ -0,0 +1,246 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RepoIndexReader.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace ADDON
+{
+
+static inline bool IsSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+CRepoIndexReader::CRepoIndexReader(const char* data, size_t size)
+  : m_pos(data), m_end(data + size)
+{
+}
+
+bool CRepoIndexReader::Open()
+{
+  if (m_open || m_error)
+    return m_open;
+
+  // byte order mark
+  if (StartsWith("\xEF\xBB\xBF"))
+    m_pos += 3;
+
+  while (true)
+  {
+    while (m_pos < m_end && IsSpace(*m_pos))
+      ++m_pos;
+    if (m_pos >= m_end || *m_pos != '<')
+      break;
+
+    if (IsTag("?xml"))
+    {
+      const char* start = m_pos;
+      if (!SkipPast("?>"))
+        break;
+      m_declaration.assign(start, m_pos - start);
+    }
+    else if (StartsWith("<!") || StartsWith("<?"))
+    {
+      if (!SkipMarkup())
+        break;
+    }
+    else
+    {
+      bool empty;
+      if (!IsTag("addons") || !SkipTag(empty))
+        break;
+      m_open = true;
+      m_done = empty;
+      return true;
+    }
+  }
+
+  m_error = true;
+  return false;
+}
+
+bool CRepoIndexReader::Next()
+{
+  m_element = nullptr;
+  m_elementSize = 0;
+  if (!m_open || m_done)
+    return false;
+
+  while (true)
+  {
+    const char* tag = static_cast<const char*>(memchr(m_pos, '<', m_end - m_pos));
+    if (!tag)
+      break;
+    m_pos = tag;
+
+    if (StartsWith("</"))
+    {
+      // end of the root
+      m_done = true;
+      return false;
+    }
+    if (StartsWith("<!") || StartsWith("<?"))
+    {
+      if (!SkipMarkup())
+        break;
+      continue;
+    }
+
+    const char* start = m_pos;
+    const bool addon = IsTag("addon");
+    if (!SkipElement())
+      break;
+    if (addon)
+    {
+      m_element = start;
+      m_elementSize = m_pos - start;
+      return true;
+    }
+  }
+
+  m_error = true;
+  m_done = true;
+  return false;
+}
+
+bool CRepoIndexReader::StartsWith(const char* text) const
+{
+  const size_t length = strlen(text);
+  return static_cast<size_t>(m_end - m_pos) >= length && memcmp(m_pos, text, length) == 0;
+}
+
+bool CRepoIndexReader::IsTag(const char* name) const
+{
+  const size_t length = strlen(name);
+  if (static_cast<size_t>(m_end - m_pos) <= length + 1 || memcmp(m_pos + 1, name, length) != 0)
+    return false;
+  const char next = m_pos[length + 1];
+  return IsSpace(next) || next == '>' || next == '/';
+}
+
+bool CRepoIndexReader::SkipPast(const char* text)
+{
+  const size_t length = strlen(text);
+  const char* found = std::search(m_pos, m_end, text, text + length);
+  if (found == m_end)
+    return false;
+  m_pos = found + length;
+  return true;
+}
+
+bool CRepoIndexReader::SkipMarkup()
+{
+  if (StartsWith("<!--"))
+    return SkipPast("-->");
+  if (StartsWith("<![CDATA["))
+    return SkipPast("]]>");
+  if (StartsWith("<?"))
+    return SkipPast("?>");
+
+  // <!DOCTYPE ...>, possibly with an internal subset in brackets
+  int brackets = 0;
+  char quote = 0;
+  for (++m_pos; m_pos < m_end; ++m_pos)
+  {
+    const char c = *m_pos;
+    if (quote)
+    {
+      if (c == quote)
+        quote = 0;
+    }
+    else if (c == '"' || c == '\'')
+      quote = c;
+    else if (c == '[')
+      brackets++;
+    else if (c == ']')
+      brackets--;
+    else if (c == '>' && brackets <= 0)
+    {
+      ++m_pos;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CRepoIndexReader::SkipTag(bool& empty)
+{
+  // attribute values may hold '>'
+  char quote = 0;
+  for (++m_pos; m_pos < m_end; ++m_pos)
+  {
+    const char c = *m_pos;
+    if (quote)
+    {
+      if (c == quote)
+        quote = 0;
+    }
+    else if (c == '"' || c == '\'')
+      quote = c;
+    else if (c == '>')
+    {
+      empty = m_pos[-1] == '/';
+      ++m_pos;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CRepoIndexReader::SkipElement()
+{
+  bool empty;
+  if (!SkipTag(empty))
+    return false;
+
+  int depth = empty ? 0 : 1;
+  while (depth > 0)
+  {
+    const char* tag = static_cast<const char*>(memchr(m_pos, '<', m_end - m_pos));
+    if (!tag)
+      return false;
+    m_pos = tag;
+
+    if (StartsWith("</"))
+    {
+      if (!SkipPast(">"))
+        return false;
+      depth--;
+    }
+    else if (StartsWith("<!") || StartsWith("<?"))
+    {
+      if (!SkipMarkup())
+        return false;
+    }
+    else
+    {
+      if (!SkipTag(empty))
+        return false;
+      if (!empty)
+        depth++;
+    }
+  }
+  return true;
+}
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stddef.h>
+#include <string>
+
+namespace ADDON
+{
+
+/*!
+ \brief Reads the <addon> elements of a repository index (addons.xml) in a
+ single pass over the text, without building a document.
+
+ Each element is handed out as the slice of the index holding it, so it can be
+ checksummed and given to the addon descriptor parser as is. The reader only
+ follows the structure of the index; the elements themselves are checked when
+ they are parsed.
+ */
+class CRepoIndexReader
+{
+public:
+  CRepoIndexReader(const char* data, size_t size);
+
+  /*!
+   \brief Read up to the <addons> root element
+   \return false if the index has no <addons> root element
+   */
+  bool Open();
+
+  /*!
+   \brief Move to the next <addon> element of the root
+   \return false at the end of the root, check HasError() for malformed indexes
+   */
+  bool Next();
+
+  bool HasError() const { return m_error; }
+
+  //! the current <addon> element, from its start tag to the end of its end tag
+  const char* GetElement() const { return m_element; }
+  size_t GetElementSize() const { return m_elementSize; }
+
+  //! the XML declaration of the index, empty if it has none
+  const std::string& GetDeclaration() const { return m_declaration; }
+
+private:
+  bool StartsWith(const char* text) const;
+  bool SkipPast(const char* text);
+  bool SkipMarkup();
+  bool SkipTag(bool& empty);
+  bool SkipElement();
+  bool IsTag(const char* name) const;
+
+  const char* m_pos;
+  const char* m_end;
+  const char* m_element = nullptr;
+  size_t m_elementSize = 0;
+  std::string m_declaration;
+  bool m_open = false;
+  bool m_done = false;
+  bool m_error = false;
+};
+
+}
@@ -218,7 +218,8 @@ bool CRepository::FetchChecksum(const std::string& url, std::string& checksum) n
   return true;
 }
 
-bool CRepository::FetchIndex(const DirInfo& repo, std::string const& digest, VECADDONS& addons) noexcept
+bool CRepository::FetchIndex(const DirInfo& repo, std::string const& digest, const std::set<std::string>& known,
+    std::map<std::string, AddonPtr>& addons, std::set<std::string>& unchanged) noexcept
 {
   XFILE::CCurlFile http;
   http.SetAcceptEncoding("gzip");
@@ -253,11 +254,12 @@ bool CRepository::FetchIndex(const DirInfo& repo, std::string const& digest, VEC
     response = std::move(buffer);
   }
 
-  return CServiceBroker::GetAddonMgr().AddonsFromRepoXML(repo, response, addons);
+  return CServiceBroker::GetAddonMgr().AddonsFromRepoXML(repo, response, known, addons, unchanged);
 }
 
 CRepository::FetchStatus CRepository::FetchIfChanged(const std::string& oldChecksum,
-    std::string& checksum, VECADDONS& addons) const
+    const std::set<std::string>& known, std::string& checksum,
+    std::map<std::string, AddonPtr>& addons, std::set<std::string>& unchanged) const
 {
   checksum = "";
   std::vector<std::tuple<DirInfo const&, std::string>> dirChecksums;
@@ -281,10 +283,8 @@ CRepository::FetchStatus CRepository::FetchIfChanged(const std::string& oldCheck
 
   for (const auto& dirTuple : dirChecksums)
   {
-    VECADDONS tmp;
-    if (!FetchIndex(std::get<0>(dirTuple), std::get<1>(dirTuple), tmp))
+    if (!FetchIndex(std::get<0>(dirTuple), std::get<1>(dirTuple), known, addons, unchanged))
       return STATUS_ERROR;
-    addons.insert(addons.end(), tmp.begin(), tmp.end());
   }
   return STATUS_OK;
 }
@@ -301,9 +301,13 @@ bool CRepositoryUpdateJob::DoWork()
   if (database.GetRepoChecksum(m_repo->ID(), oldChecksum) == -1)
     oldChecksum = "";
 
+  std::set<std::string> known;
+  database.GetRepositoryEntries(m_repo->ID(), known);
+
   std::string newChecksum;
-  VECADDONS addons;
-  auto status = m_repo->FetchIfChanged(oldChecksum, newChecksum, addons);
+  std::map<std::string, AddonPtr> addons;
+  std::set<std::string> unchanged;
+  auto status = m_repo->FetchIfChanged(oldChecksum, known, newChecksum, addons, unchanged);
 
   database.SetLastChecked(m_repo->ID(), m_repo->Version(),
       CDateTime::GetCurrentDateTime().GetAsDBDateTime());
@@ -325,8 +329,9 @@ bool CRepositoryUpdateJob::DoWork()
     textureDB.Open();
     textureDB.BeginMultipleExecute();
 
-    for (const auto& addon : addons)
+    for (const auto& entry : addons)
     {
+      const AddonPtr& addon = entry.second;
       AddonPtr oldAddon;
       if (database.GetAddon(addon->ID(), oldAddon) && addon->Version() > oldAddon->Version())
       {
@@ -346,6 +351,8 @@ bool CRepositoryUpdateJob::DoWork()
     textureDB.CommitMultipleExecute();
   }
 
-  database.UpdateRepositoryContent(m_repo->ID(), m_repo->Version(), newChecksum, addons);
+  CLog::Log(LOGDEBUG, "CRepositoryUpdateJob[%s] %zu addons new or changed, %zu unchanged.",
+      m_repo->ID().c_str(), addons.size(), unchanged.size());
+  database.UpdateRepositoryContent(m_repo->ID(), m_repo->Version(), newChecksum, addons, unchanged);
   return true;
 }
@@ -19,7 +19,9 @@
  *
  */
 
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -65,7 +67,15 @@ namespace ADDON
       STATUS_ERROR
     };
 
-    FetchStatus FetchIfChanged(const std::string& oldChecksum, std::string& checksum, VECADDONS& addons) const;
+    /*! \brief Fetch the addons of the repository if its content changed
+     \param oldChecksum checksum of the content fetched before
+     \param known checksums of the addon descriptors fetched before
+     \param checksum [out] checksum of the content
+     \param addons [out] addons of the descriptors not fetched before, by checksum
+     \param unchanged [out] checksums of the known descriptors still in the repository
+     */
+    FetchStatus FetchIfChanged(const std::string& oldChecksum, const std::set<std::string>& known,
+        std::string& checksum, std::map<std::string, AddonPtr>& addons, std::set<std::string>& unchanged) const;
 
     struct ResolveResult
     {
@@ -76,7 +86,8 @@ namespace ADDON
 
   private:
     static bool FetchChecksum(const std::string& url, std::string& checksum) noexcept;
-    static bool FetchIndex(const DirInfo& repo, std::string const& digest, VECADDONS& addons) noexcept;
+    static bool FetchIndex(const DirInfo& repo, std::string const& digest, const std::set<std::string>& known,
+        std::map<std::string, AddonPtr>& addons, std::set<std::string>& unchanged) noexcept;
 
     static DirInfo ParseDirConfiguration(cp_cfg_element_t* configuration);
 
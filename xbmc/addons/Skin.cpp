@@ -20,6 +20,7 @@
 
 #include "Skin.h"
 #include "AddonManager.h"
+#include "GUIInfoManager.h"
 #include "ServiceBroker.h"
 #include "Util.h"
 #include "dialogs/GUIDialogKaiToast.h"
@@ -313,6 +314,11 @@ void CSkinInfo::LoadIncludes()
   m_includes.Load(includesPath);
 }
 
+void CSkinInfo::LoadIncludeFile(const std::string &file)
+{
+  m_includes.Load(file);
+}
+
 void CSkinInfo::ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions /* = NULL */)
 {
   if(xmlIncludeConditions)
@@ -619,6 +625,7 @@ void CSkinInfo::SetString(int setting, const std::string &label)
   {
     it->second->value = label;
     m_settingsUpdateHandler->TriggerSave();
+    InvalidateSettingInfos();
     return;
   }
 
@@ -663,6 +670,7 @@ void CSkinInfo::SetBool(int setting, bool set)
   {
     it->second->value = set;
     m_settingsUpdateHandler->TriggerSave();
+    InvalidateSettingInfos();
     return;
   }
 
@@ -679,6 +687,7 @@ void CSkinInfo::Reset(const std::string &setting)
     {
       it.second->value.clear();
       m_settingsUpdateHandler->TriggerSave();
+      InvalidateSettingInfos();
       return;
     }
   }
@@ -690,6 +699,7 @@ void CSkinInfo::Reset(const std::string &setting)
     {
       it.second->value = false;
       m_settingsUpdateHandler->TriggerSave();
+      InvalidateSettingInfos();
       return;
     }
   }
@@ -705,6 +715,15 @@ void CSkinInfo::Reset()
     it.second->value.clear();
 
   m_settingsUpdateHandler->TriggerSave();
+  InvalidateSettingInfos();
+}
+
+void CSkinInfo::InvalidateSettingInfos()
+{
+  // the conditions on skin settings are only updated after they changed
+  CGUIComponent* gui = CServiceBroker::GetGUI();
+  if (gui)
+    gui->GetInfoManager().InvalidateInfo(INFO::SOURCE_SKIN);
 }
 
 std::set<CSkinSettingPtr> CSkinInfo::ParseSettings(const TiXmlElement* rootElement)
@@ -783,6 +802,7 @@ bool CSkinInfo::SettingsFromXML(const CXBMCTinyXML &doc, bool loadDefaults /* =
       CLog::Log(LOGWARNING, "CSkinInfo: ignoring setting of unknown type \"%s\"", setting->GetType().c_str());
   }
 
+  InvalidateSettingInfos();
   return true;
 }
 
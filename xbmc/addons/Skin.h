@@ -180,6 +180,16 @@ public:
   const std::string& GetCurrentAspect() const { return m_currentAspect; }
 
   void LoadIncludes();
+
+  /*! \brief Load an additional include file, e.g. one loaded by a window taken from the skin cache
+   \param file the include file to load
+   */
+  void LoadIncludeFile(const std::string &file);
+
+  /*! \brief Get the include files loaded so far
+   */
+  const std::vector<std::string>& GetIncludeFiles() const { return m_includes.GetFiles(); }
+
   void ToggleDebug();
   const INFO::CSkinVariableString* CreateSkinVariable(const std::string& name, int context);
 
@@ -243,6 +253,8 @@ protected:
   bool m_debugging;
 
 private:
+  static void InvalidateSettingInfos();
+
   std::map<int, CSkinSettingStringPtr> m_strings;
   std::map<int, CSkinSettingBoolPtr> m_bools;
   std::unique_ptr<CSkinSettingUpdateHandler> m_settingsUpdateHandler;
@@ -85,3 +85,48 @@ TEST_F(AddonDatabaseTest, TestFindByNonExistingId)
   EXPECT_TRUE(database.FindByAddonId("does.not.exist", addons));
   EXPECT_EQ(0U, addons.size());
 }
+
+TEST_F(AddonDatabaseTest, TestUpdateChanged)
+{
+  // addons stored by a full update have no checksum
+  std::set<std::string> entries;
+  EXPECT_TRUE(database.GetRepositoryEntries("repository.a", entries));
+  EXPECT_TRUE(entries.empty());
+
+  VECADDONS created;
+  CreateAddon(created, "foo.bar", "1.0.0");
+  CreateAddon(created, "foo.qux", "2.0.0");
+  std::map<std::string, AddonPtr> addons{{"a", created[0]}, {"b", created[1]}};
+  EXPECT_TRUE(database.UpdateRepositoryContent("repository.a", AddonVersion("1.0.0"), "test2",
+                                               addons, std::set<std::string>()));
+  EXPECT_TRUE(database.GetRepositoryEntries("repository.a", entries));
+  EXPECT_EQ(std::set<std::string>({"a", "b"}), entries);
+
+  // "a" changed, "b" is kept
+  created.clear();
+  CreateAddon(created, "foo.bar", "1.1.0");
+  addons = {{"c", created[0]}};
+  EXPECT_TRUE(database.UpdateRepositoryContent("repository.a", AddonVersion("1.0.0"), "test3",
+                                               addons, std::set<std::string>{"b"}));
+  entries.clear();
+  EXPECT_TRUE(database.GetRepositoryEntries("repository.a", entries));
+  EXPECT_EQ(std::set<std::string>({"b", "c"}), entries);
+
+  VECADDONS found;
+  EXPECT_TRUE(database.FindByAddonId("foo.bar", found));
+  ASSERT_EQ(1U, found.size());
+  EXPECT_EQ("1.1.0", found.at(0)->Version().asString());
+
+  found.clear();
+  EXPECT_TRUE(database.FindByAddonId("foo.qux", found));
+  EXPECT_EQ(1U, found.size());
+
+  // other repositories are left alone
+  found.clear();
+  EXPECT_TRUE(database.FindByAddonId("foo.baz", found));
+  EXPECT_EQ(1U, found.size());
+
+  std::string checksum;
+  EXPECT_GT(database.GetRepoChecksum("repository.a", checksum), 0);
+  EXPECT_EQ("test3", checksum);
+}
@@ -0,0 +1,231 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "addons/RepoIndexReader.h"
+#include "utils/Digest.h"
+#include "utils/StringUtils.h"
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include "lib/cpluff/libcpluff/cpluff.h"
+}
+
+#include "gtest/gtest.h"
+
+using namespace ADDON;
+using KODI::UTILITY::CDigest;
+
+static std::vector<std::string> ReadAll(const std::string& xml, bool& error)
+{
+  std::vector<std::string> elements;
+  CRepoIndexReader reader(xml.c_str(), xml.size());
+  if (reader.Open())
+  {
+    while (reader.Next())
+      elements.emplace_back(reader.GetElement(), reader.GetElementSize());
+  }
+  error = reader.HasError();
+  return elements;
+}
+
+static std::string CreateAddon(int i, const std::string& version)
+{
+  return StringUtils::Format(
+    "<addon id=\"plugin.video.test%i\" name=\"Test &amp; Video %i\" version=\"%s\" provider-name=\"Team Kodi\">\n"
+    "  <requires>\n"
+    "    <import addon=\"xbmc.python\" version=\"2.25.0\"/>\n"
+    "    <import addon=\"script.module.requests\" version=\"2.12.4\"/>\n"
+    "    <import addon=\"script.module.routing\" version=\"0.2.0\" optional=\"true\"/>\n"
+    "  </requires>\n"
+    "  <extension point=\"xbmc.python.pluginsource\" library=\"addon.py\">\n"
+    "    <provides>video</provides>\n"
+    "  </extension>\n"
+    "  <extension point=\"xbmc.addon.metadata\">\n"
+    "    <summary lang=\"en_GB\">Watch the videos of channel %i</summary>\n"
+    "    <summary lang=\"de_DE\">Videos von Kanal %i ansehen</summary>\n"
+    "    <description lang=\"en_GB\">Browse the programmes of channel %i by category, date or search "
+    "and watch them in full length. Requires a free account &gt; see the website.</description>\n"
+    "    <description lang=\"de_DE\">Sendungen von Kanal %i nach Kategorie, Datum oder Suche.</description>\n"
+    "    <disclaimer lang=\"en_GB\">This addon is not endorsed by the channel</disclaimer>\n"
+    "    <platform>all</platform>\n"
+    "    <license>GPL-2.0-or-later</license>\n"
+    "    <forum>https://forum.kodi.tv/showthread.php?tid=%i</forum>\n"
+    "    <website>https://www.example.com/channel%i</website>\n"
+    "    <source>https://github.com/example/plugin.video.test%i</source>\n"
+    "    <news>v%s\n- fixed playback\n- <![CDATA[new menu <layout>]]></news>\n"
+    "    <assets>\n"
+    "      <icon>resources/icon.png</icon>\n"
+    "      <fanart>resources/fanart.jpg</fanart>\n"
+    "      <screenshot>resources/screenshot-01.jpg</screenshot>\n"
+    "    </assets>\n"
+    "  </extension>\n"
+    "</addon>\n",
+    i, i, version.c_str(), i, i, i, i, i, i, i, version.c_str());
+}
+
+TEST(TestRepoIndexReader, Elements)
+{
+  const std::string first = "<addon id=\"a\" name=\"a > b\" version=\"1.0.0\"><extension point=\"x\"/></addon>";
+  const std::string second = "<addon id='b' version='1.0.0'>\n  <!-- </addon> -->\n  <news><![CDATA[</addon>]]></news>\n</addon>";
+  const std::string empty = "<addon id=\"c\" version=\"1.0.0\"/>";
+  const std::string xml =
+      "\xEF\xBB\xBF<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+      "<!-- generated -->\n"
+      "<!DOCTYPE addons [ <!ENTITY name \"value>\"> ]>\n"
+      "<addons>\n"
+      "  " + first + "\n"
+      "  <other><addon id=\"nested\"/></other>\n"
+      "  <?processing instruction?>\n"
+      "  " + second + "\n"
+      "  " + empty + "\n"
+      "</addons>\n";
+
+  CRepoIndexReader reader(xml.c_str(), xml.size());
+  ASSERT_TRUE(reader.Open());
+  EXPECT_EQ("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>", reader.GetDeclaration());
+
+  ASSERT_TRUE(reader.Next());
+  EXPECT_EQ(first, std::string(reader.GetElement(), reader.GetElementSize()));
+  ASSERT_TRUE(reader.Next());
+  EXPECT_EQ(second, std::string(reader.GetElement(), reader.GetElementSize()));
+  ASSERT_TRUE(reader.Next());
+  EXPECT_EQ(empty, std::string(reader.GetElement(), reader.GetElementSize()));
+  EXPECT_FALSE(reader.Next());
+  EXPECT_FALSE(reader.HasError());
+  EXPECT_FALSE(reader.Next());
+}
+
+TEST(TestRepoIndexReader, Empty)
+{
+  bool error;
+  EXPECT_TRUE(ReadAll("<addons/>", error).empty());
+  EXPECT_FALSE(error);
+  EXPECT_TRUE(ReadAll("<addons></addons>", error).empty());
+  EXPECT_FALSE(error);
+}
+
+TEST(TestRepoIndexReader, Malformed)
+{
+  bool error;
+  EXPECT_TRUE(ReadAll("", error).empty());
+  EXPECT_TRUE(error);
+  EXPECT_TRUE(ReadAll("<repository><addon id=\"a\"/></repository>", error).empty());
+  EXPECT_TRUE(error);
+  EXPECT_TRUE(ReadAll("not xml", error).empty());
+  EXPECT_TRUE(error);
+
+  // addons before the error are read
+  EXPECT_EQ(1u, ReadAll("<addons><addon id=\"a\"/><addon id=\"b\"><extension></addon>", error).size());
+  EXPECT_TRUE(error);
+  EXPECT_EQ(0u, ReadAll("<addons><addon id=\"a", error).size());
+  EXPECT_TRUE(error);
+  EXPECT_EQ(0u, ReadAll("<addons><addon><!-- </addon>", error).size());
+  EXPECT_TRUE(error);
+}
+
+// Compares loading every addon descriptor of a large repository index with
+// reading it in one pass and loading only the descriptors that changed since
+// the last refresh
+TEST(TestRepoIndexReader, DISABLED_Benchmark)
+{
+  static const int COUNT = 5000;
+  static const int CHANGED = 50;
+
+  std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n<addons>\n";
+  for (int i = 0; i < COUNT; i++)
+    xml += CreateAddon(i, "1.0.0");
+  xml += "</addons>\n";
+
+  std::string updated = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n<addons>\n";
+  for (int i = 0; i < COUNT; i++)
+    updated += CreateAddon(i, i % (COUNT / CHANGED) == 0 ? "1.0.1" : "1.0.0");
+  updated += "</addons>\n";
+
+  ASSERT_EQ(CP_OK, cp_init());
+  cp_status_t status;
+  cp_context_t* context = cp_create_context(&status);
+  ASSERT_TRUE(context != nullptr);
+
+  // the first refresh loads every descriptor
+  auto start = std::chrono::steady_clock::now();
+  std::set<std::string> known;
+  int loaded = 0;
+  {
+    CRepoIndexReader reader(xml.c_str(), xml.size());
+    ASSERT_TRUE(reader.Open());
+    while (reader.Next())
+    {
+      known.insert(CDigest::Calculate(CDigest::Type::MD5, reader.GetElement(), reader.GetElementSize()));
+      cp_plugin_info_t* info = cp_load_plugin_descriptor_from_memory(context, reader.GetElement(), reader.GetElementSize(), &status);
+      ASSERT_TRUE(info != nullptr);
+      cp_release_info(context, info);
+      loaded++;
+    }
+    EXPECT_FALSE(reader.HasError());
+  }
+  const auto fullUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(COUNT, loaded);
+  EXPECT_EQ(static_cast<size_t>(COUNT), known.size());
+
+  // the next refresh only loads the descriptors that changed
+  start = std::chrono::steady_clock::now();
+  int unchanged = 0;
+  loaded = 0;
+  {
+    CRepoIndexReader reader(updated.c_str(), updated.size());
+    ASSERT_TRUE(reader.Open());
+    while (reader.Next())
+    {
+      if (known.find(CDigest::Calculate(CDigest::Type::MD5, reader.GetElement(), reader.GetElementSize())) != known.end())
+      {
+        unchanged++;
+        continue;
+      }
+      cp_plugin_info_t* info = cp_load_plugin_descriptor_from_memory(context, reader.GetElement(), reader.GetElementSize(), &status);
+      ASSERT_TRUE(info != nullptr);
+      EXPECT_STREQ("1.0.1", info->version);
+      cp_release_info(context, info);
+      loaded++;
+    }
+    EXPECT_FALSE(reader.HasError());
+  }
+  const auto updateUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(CHANGED, loaded);
+  EXPECT_EQ(COUNT - CHANGED, unchanged);
+
+  // reading the index alone
+  start = std::chrono::steady_clock::now();
+  bool error;
+  EXPECT_EQ(static_cast<size_t>(COUNT), ReadAll(updated, error).size());
+  const auto readUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  cp_destroy_context(context);
+  cp_destroy();
+
+  RecordProperty("IndexBytes", static_cast<int>(xml.size()));
+  RecordProperty("LoadAllUs", static_cast<int>(fullUs));
+  RecordProperty("LoadChangedUs", static_cast<int>(updateUs));
+  RecordProperty("ReadIndexUs", static_cast<int>(readUs));
+}
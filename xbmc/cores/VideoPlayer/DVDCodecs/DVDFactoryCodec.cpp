@@ -59,11 +59,16 @@ std::map<std::string, CreateHWAccel> CDVDFactoryCodec::m_hwAccels;
 CCriticalSection videoCodecSection, audioCodecSection;
 
 CDVDVideoCodec* CDVDFactoryCodec::CreateVideoCodec(CDVDStreamInfo &hint, CProcessInfo &processInfo)
+{
+  CDVDCodecOptions options;
+  return CreateVideoCodec(hint, processInfo, options);
+}
+
+CDVDVideoCodec* CDVDFactoryCodec::CreateVideoCodec(CDVDStreamInfo &hint, CProcessInfo &processInfo, CDVDCodecOptions &options)
 {
   CSingleLock lock(videoCodecSection);
 
   std::unique_ptr<CDVDVideoCodec> pCodec;
-  CDVDCodecOptions options;
 
   // addon handler for this stream ?
 
@@ -51,6 +51,10 @@ public:
   static CDVDVideoCodec* CreateVideoCodec(CDVDStreamInfo &hint,
                                           CProcessInfo &processInfo);
 
+  static CDVDVideoCodec* CreateVideoCodec(CDVDStreamInfo &hint,
+                                          CProcessInfo &processInfo,
+                                          CDVDCodecOptions &options);
+
   static IHardwareDecoder* CreateVideoCodecHWAccel(std::string id, CDVDStreamInfo &hint,
                                           CProcessInfo &processInfo, AVPixelFormat fmt);
 
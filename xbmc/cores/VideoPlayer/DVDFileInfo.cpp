@@ -55,6 +55,8 @@
 
 #include <cstdlib>
 #include <memory>
+#include <string>
+#include <vector>
 
 extern "C" {
 #include "libavformat/avformat.h"
@@ -83,6 +85,91 @@ bool CDVDFileInfo::GetFileDuration(const std::string &path, int& duration)
     return false;
 }
 
+namespace
+{
+
+/*!
+ \brief Decoder and scaler kept by each thread extracting thumbnails.
+
+ Thumbnails are extracted by the jobs of the thumb loaders, which run on the
+ shared, size limited low priority workers of the job manager, mostly for all
+ files of a listing in a row. The decoder is flushed and reused as long as the
+ next stream is in the same format as the one it was opened for.
+ */
+class CThumbDecoder
+{
+public:
+  ~CThumbDecoder()
+  {
+    Close();
+    sws_freeContext(m_scaler);
+  }
+
+  CDVDVideoCodec* Open(CDVDStreamInfo &hint, bool &reused)
+  {
+    reused = false;
+    if (m_codec && !hint.externalInterfaces && m_hint.Equal(hint, true))
+    {
+      m_codec->Reset();
+      reused = true;
+      return m_codec.get();
+    }
+
+    Close();
+    m_processInfo.reset(CProcessInfo::CreateInstance());
+    std::vector<AVPixelFormat> pixFmts;
+    pixFmts.push_back(AV_PIX_FMT_YUV420P);
+    m_processInfo->SetPixFormats(pixFmts);
+
+    // only key frames leave the decoder, and codecs able to decode at a
+    // fraction of the resolution do so as long as the picture stays larger
+    // than the thumb
+    CDVDCodecOptions options;
+    options.m_keys.push_back(CDVDCodecOption("skip_frame", "nokey"));
+    const AVCodec *codec = avcodec_find_decoder(hint.codec);
+    m_lowres = 0;
+    if (codec && hint.width > 0)
+    {
+      while (m_lowres < codec->max_lowres &&
+             static_cast<unsigned int>(hint.width >> (m_lowres + 1)) >= g_advancedSettings.m_imageRes)
+        m_lowres++;
+    }
+    if (m_lowres > 0)
+      options.m_keys.push_back(CDVDCodecOption("lowres", std::to_string(m_lowres)));
+
+    m_codec.reset(CDVDFactoryCodec::CreateVideoCodec(hint, *m_processInfo, options));
+    if (m_codec)
+      m_hint = hint;
+    return m_codec.get();
+  }
+
+  void Close()
+  {
+    m_codec.reset();
+    m_processInfo.reset();
+  }
+
+  int GetLowres() const { return m_lowres; }
+
+  SwsContext* GetScaler(int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+  {
+    m_scaler = sws_getCachedContext(m_scaler, srcWidth, srcHeight, AV_PIX_FMT_YUV420P,
+                                    dstWidth, dstHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
+    return m_scaler;
+  }
+
+private:
+  std::unique_ptr<CProcessInfo> m_processInfo;
+  std::unique_ptr<CDVDVideoCodec> m_codec;
+  CDVDStreamInfo m_hint;
+  SwsContext *m_scaler = nullptr;
+  int m_lowres = 0;
+};
+
+thread_local CThumbDecoder thumbDecoder;
+
+}
+
 int DegreeToOrientation(int degrees)
 {
   switch(degrees)
@@ -193,22 +280,21 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
 
   bool bOk = false;
   int packetsTried = 0;
+  bool reused = false;
+  int lowres = 0;
+  unsigned int nScaleTime = 0;
 
   if (nVideoStream != -1)
   {
-    CDVDVideoCodec *pVideoCodec;
-    std::unique_ptr<CProcessInfo> pProcessInfo(CProcessInfo::CreateInstance());
-    std::vector<AVPixelFormat> pixFmts;
-    pixFmts.push_back(AV_PIX_FMT_YUV420P);
-    pProcessInfo->SetPixFormats(pixFmts);
-
     CDVDStreamInfo hint(*pDemuxer->GetStream(demuxerId, nVideoStream), true);
     hint.codecOptions = CODEC_FORCE_SOFTWARE;
 
-    pVideoCodec = CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
+    CDVDVideoCodec *pVideoCodec = thumbDecoder.Open(hint, reused);
+    lowres = thumbDecoder.GetLowres();
 
     if (pVideoCodec)
     {
+      bool keyframesOnly = true;
       int nTotalLen = pDemuxer->GetStreamLength();
       int nSeekTo = (pos==-1) ? nTotalLen / 3 : pos;
 
@@ -220,8 +306,17 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
 
         // num streams * 160 frames, should get a valid frame, if not abort.
         int abort_index = pDemuxer->GetNrOfStreams() * 160;
+        // streams that don't flag their key frames only decode with all frames let through
+        int keyframes_index = abort_index / 2;
         do
         {
+          if (keyframesOnly && abort_index < keyframes_index)
+          {
+            CLog::Log(LOGDEBUG, "%s - no key frame in %s after %d packets, decoding all frames", __FUNCTION__, redactPath.c_str(), packetsTried);
+            pVideoCodec->SetCodecControl(0);
+            keyframesOnly = false;
+          }
+
           DemuxPacket* pPacket = pDemuxer->Read();
           packetsTried++;
 
@@ -253,45 +348,46 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
 
         if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
         {
+          unsigned int nScaleStart = XbmcThreads::SystemClockMillis();
+          unsigned int nWidth = std::min(picture.iDisplayWidth, g_advancedSettings.m_imageRes);
+          double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+          if(hint.forced_aspect && hint.aspect != 0)
+            aspect = hint.aspect;
+          unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
+
+          uint8_t *pOutBuf = (uint8_t*)av_malloc(nWidth * nHeight * 4);
+          struct SwsContext *context = thumbDecoder.GetScaler(picture.iWidth, picture.iHeight, nWidth, nHeight);
+
+          if (context)
           {
-            unsigned int nWidth = std::min(picture.iDisplayWidth, g_advancedSettings.m_imageRes);
-            double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
-            if(hint.forced_aspect && hint.aspect != 0)
-              aspect = hint.aspect;
-            unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
-
-            uint8_t *pOutBuf = (uint8_t*)av_malloc(nWidth * nHeight * 4);
-            struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
-                  AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
-
-            if (context)
-            {
-              uint8_t *planes[YuvImage::MAX_PLANES];
-              int stride[YuvImage::MAX_PLANES];
-              picture.videoBuffer->GetPlanes(planes);
-              picture.videoBuffer->GetStrides(stride);
-              uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
-              int srcStride[] = { stride[0], stride[1], stride[2], 0 };
-              uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
-              int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
-              int orientation = DegreeToOrientation(hint.orientation);
-              sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              sws_freeContext(context);
-
-              details.width = nWidth;
-              details.height = nHeight;
-              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
-              bOk = true;
-            }
-            av_free(pOutBuf);
+            uint8_t *planes[YuvImage::MAX_PLANES];
+            int stride[YuvImage::MAX_PLANES];
+            picture.videoBuffer->GetPlanes(planes);
+            picture.videoBuffer->GetStrides(stride);
+            uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
+            int srcStride[] = { stride[0], stride[1], stride[2], 0 };
+            uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
+            int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
+            int orientation = DegreeToOrientation(hint.orientation);
+            sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
+
+            details.width = nWidth;
+            details.height = nHeight;
+            CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
+            bOk = true;
           }
+          av_free(pOutBuf);
+          nScaleTime = XbmcThreads::SystemClockMillis() - nScaleStart;
         }
         else
         {
           CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets.", __FUNCTION__, redactPath.c_str(), packetsTried);
         }
       }
-      delete pVideoCodec;
+
+      // the decoder no longer skips frames, the next file gets a fresh one
+      if (!keyframesOnly)
+        thumbDecoder.Close();
     }
   }
 
@@ -306,7 +402,8 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
   }
 
   unsigned int nTotalTime = XbmcThreads::SystemClockMillis() - nTime;
-  CLog::Log(LOGDEBUG,"%s - measured %u ms to extract thumb from file <%s> in %d packets. ", __FUNCTION__, nTotalTime, redactPath.c_str(), packetsTried);
+  CLog::Log(LOGDEBUG,"%s - measured %u ms to extract thumb from file <%s> in %d packets (%s decoder, lowres %d, %u ms scaling). ",
+            __FUNCTION__, nTotalTime, redactPath.c_str(), packetsTried, reused ? "reused" : "new", lowres, nScaleTime);
   return bOk;
 }
 
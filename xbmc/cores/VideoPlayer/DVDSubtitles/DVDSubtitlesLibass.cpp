@@ -172,6 +172,19 @@ ASS_Image* CDVDSubtitlesLibass::RenderImage(int frameWidth, int frameHeight, int
   return m_dll.ass_render_frame(m_renderer, m_track, DVD_TIME_TO_MSEC(pts), changes);
 }
 
+bool CDVDSubtitlesLibass::RenderImage(int frameWidth, int frameHeight, int videoWidth, int videoHeight, double pts, int useMargin, double position,
+                                      const std::function<void(ASS_Image* images, int changes)>& consume)
+{
+  CSingleLock lock(m_section);
+  if(!m_renderer || !m_track)
+    return false;
+
+  int changes = 0;
+  ASS_Image* images = RenderImage(frameWidth, frameHeight, videoWidth, videoHeight, pts, useMargin, position, &changes);
+  consume(images, changes);
+  return true;
+}
+
 ASS_Event* CDVDSubtitlesLibass::GetEvents()
 {
   CSingleLock lock(m_section);
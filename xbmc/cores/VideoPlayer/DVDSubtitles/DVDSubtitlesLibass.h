@@ -24,6 +24,8 @@
 #include "DVDResource.h"
 #include "threads/CriticalSection.h"
 
+#include <functional>
+
 /** Wrapper for Libass **/
 
 class CDVDSubtitlesLibass : public IDVDResourceCounted<CDVDSubtitlesLibass>
@@ -33,6 +35,13 @@ public:
   ~CDVDSubtitlesLibass() override;
 
   ASS_Image* RenderImage(int frameWidth, int frameHeight, int videoWidth, int videoHeight, double pts, int useMargin = 0, double position = 0.0, int* changes = NULL);
+  /*!
+   \brief render the subtitles shown at pts and hand the images to consume,
+   they are only valid until the next frame is rendered
+   \return false if libass isn't ready
+   */
+  bool RenderImage(int frameWidth, int frameHeight, int videoWidth, int videoHeight, double pts, int useMargin, double position,
+                   const std::function<void(ASS_Image* images, int changes)>& consume);
   ASS_Event* GetEvents();
 
   int GetNrOfEvents();
@@ -78,6 +78,14 @@ void CRenderer::AddOverlay(CDVDOverlay* o, double pts, int index)
   e.pts = pts;
   e.overlay_dvd = o->Acquire();
   m_buffers[index].push_back(e);
+
+  // libass subtitles are rendered while the frame waits to be shown
+  if (o->IsOverlayType(DVDOVERLAY_TYPE_SSA))
+  {
+    CAssRenderAhead::SParams params;
+    if (GetAssParams(params))
+      m_assRenderAhead.Queue(static_cast<CDVDOverlaySSA*>(o)->m_libass, pts, params);
+  }
 }
 
 void CRenderer::Release(std::vector<SElement>& list)
@@ -100,6 +108,7 @@ void CRenderer::Flush()
     Release(m_buffers[i]);
 
   ReleaseCache();
+  m_assRenderAhead.Flush();
 
   g_fontManager.Unload(m_font);
   g_fontManager.Unload(m_fontBorder);
@@ -118,6 +127,7 @@ void CRenderer::ReleaseCache()
     delete overlay.second;
   }
   m_textureCache.clear();
+  m_assGenerations.clear();
   m_textureid++;
 }
 
@@ -142,6 +152,7 @@ void CRenderer::ReleaseUnused()
     if (!found)
     {
       delete it->second;
+      m_assGenerations.erase(it->first);
       it = m_textureCache.erase(it);
     }
     else
@@ -316,20 +327,28 @@ bool CRenderer::HasOverlay(int idx)
 
 void CRenderer::SetVideoRect(CRect &source, CRect &dest, CRect &view)
 {
+  CSingleLock lock(m_section);
   m_rs = source;
   m_rd = dest;
   m_rv = view;
 }
 
-COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
+void CRenderer::GetSubtitleStats(unsigned int& ready, unsigned int& late, unsigned int& missed)
+{
+  m_assRenderAhead.GetStats(ready, late, missed);
+}
+
+bool CRenderer::GetAssParams(CAssRenderAhead::SParams& params)
 {
   // libass render in a target area which named as frame. the frame size may bigger than video size,
   // and including margins between video to frame edge. libass allow to render subtitles into the margins.
   // this has been used to show subtitles in the top or bottom "black bar" between video to frame border.
-  int videoWidth = MathUtils::round_int(m_rd.Width());
-  int videoHeight = MathUtils::round_int(m_rd.Height());
-  int targetWidth = MathUtils::round_int(m_rv.Width());
-  int targetHeight = MathUtils::round_int(m_rv.Height());
+  params.videoWidth = MathUtils::round_int(m_rd.Width());
+  params.videoHeight = MathUtils::round_int(m_rd.Height());
+  params.frameWidth = MathUtils::round_int(m_rv.Width());
+  params.frameHeight = MathUtils::round_int(m_rv.Height());
+  if (params.videoWidth <= 0 || params.videoHeight <= 0 || params.frameWidth <= 0 || params.frameHeight <= 0)
+    return false;
   int useMargin;
 
   int subalign = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_SUBTITLES_ALIGN);
@@ -353,12 +372,29 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
   }
   else
     position = 0.0;
-  int changes = 0;
-  ASS_Image* images = o->m_libass->RenderImage(targetWidth, targetHeight, videoWidth, videoHeight, pts, useMargin, position, &changes);
+  params.useMargin = useMargin;
+  params.position = position;
+  return true;
+}
+
+COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
+{
+  CAssRenderAhead::SParams params;
+  const bool valid = GetAssParams(params);
+  int videoWidth = params.videoWidth;
+  int videoHeight = params.videoHeight;
+  int targetWidth = params.frameWidth;
+  int targetHeight = params.frameHeight;
+
+  // usually rendered ahead, the frame keeps its generation while it shows the same images
+  CAssRenderAhead::SFrame frame;
+  if (valid)
+    m_assRenderAhead.Get(o->m_libass, pts, params, frame);
 
   if(o->m_textureid)
   {
-    if(changes == 0)
+    std::map<unsigned int, unsigned int>::iterator generation = m_assGenerations.find(o->m_textureid);
+    if(generation != m_assGenerations.end() && generation->second == frame.generation)
     {
       std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
       if (it != m_textureCache.end())
@@ -366,11 +402,13 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
     }
   }
 
+  SQuads empty;
+  const SQuads& quads = frame.quads ? *frame.quads : empty;
   COverlay *overlay = NULL;
 #if defined(HAS_GL) || defined(HAS_GLES)
-  overlay = new COverlayGlyphGL(images, targetWidth, targetHeight);
+  overlay = new COverlayGlyphGL(quads, targetWidth, targetHeight);
 #elif defined(HAS_DX)
-  overlay = new COverlayQuadsDX(images, targetWidth, targetHeight);
+  overlay = new COverlayQuadsDX(quads, targetWidth, targetHeight);
 #endif
   // scale to video dimensions
   if (overlay)
@@ -381,6 +419,7 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
     overlay->m_y = ((float)videoHeight - targetHeight) / 2 / videoHeight;
   }
   m_textureCache[m_textureid] = overlay;
+  m_assGenerations[m_textureid] = frame.generation;
   o->m_textureid = m_textureid;
   m_textureid++;
   return overlay;
@@ -23,6 +23,7 @@
 
 #include "threads/CriticalSection.h"
 #include "BaseRenderer.h"
+#include "OverlayRendererAss.h"
 
 #include <vector>
 #include <map>
@@ -87,6 +88,7 @@ namespace OVERLAY {
     void Release(int idx);
     bool HasOverlay(int idx);
     void SetVideoRect(CRect &source, CRect &dest, CRect &view);
+    void GetSubtitleStats(unsigned int& ready, unsigned int& late, unsigned int& missed);
 
   protected:
 
@@ -104,6 +106,7 @@ namespace OVERLAY {
     void Render(COverlay* o, float adjust_height);
     COverlay* Convert(CDVDOverlay* o, double pts);
     COverlay* Convert(CDVDOverlaySSA* o, double pts);
+    bool GetAssParams(CAssRenderAhead::SParams& params);
 
     void Release(std::vector<SElement>& list);
     void ReleaseCache();
@@ -112,6 +115,8 @@ namespace OVERLAY {
     CCriticalSection m_section;
     std::vector<SElement> m_buffers[NUM_BUFFERS];
     std::map<unsigned int, COverlay*> m_textureCache;
+    std::map<unsigned int, unsigned int> m_assGenerations; // generation of the ass frame shown by a texture
+    CAssRenderAhead m_assRenderAhead;
     static unsigned int m_textureid;
     CRect m_rv, m_rs, m_rd;
     std::string m_font, m_fontBorder;
@@ -0,0 +1,222 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "OverlayRendererAss.h"
+
+#include <algorithm>
+
+#include "OverlayRendererUtil.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitlesLibass.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+using namespace OVERLAY;
+
+// frames queued at most, about as many as the renderer has buffers
+#define MAX_JOBS 8
+
+bool CAssRenderAhead::SParams::operator==(const SParams& right) const
+{
+  return frameWidth == right.frameWidth &&
+         frameHeight == right.frameHeight &&
+         videoWidth == right.videoWidth &&
+         videoHeight == right.videoHeight &&
+         useMargin == right.useMargin &&
+         position == right.position;
+}
+
+CAssRenderAhead::SJob::SJob(CDVDSubtitlesLibass* subtitles, double time, const SParams& parameters)
+  : libass(subtitles->Acquire())
+  , pts(time)
+  , params(parameters)
+{
+}
+
+CAssRenderAhead::SJob::~SJob()
+{
+  libass->Release();
+}
+
+CAssRenderAhead::CAssRenderAhead()
+  : CThread("AssRenderAhead")
+{
+}
+
+CAssRenderAhead::~CAssRenderAhead()
+{
+  StopThread();
+  m_jobs.clear();
+  if (m_lastLibass)
+    m_lastLibass->Release();
+}
+
+void CAssRenderAhead::Queue(CDVDSubtitlesLibass* libass, double pts, const SParams& params)
+{
+  if (!libass || params.frameWidth <= 0 || params.frameHeight <= 0 ||
+      params.videoWidth <= 0 || params.videoHeight <= 0)
+    return;
+
+  CSingleLock lock(m_section);
+  for (const auto& job : m_jobs)
+  {
+    if (job->libass == libass && job->pts == pts && job->params == params)
+      return;
+  }
+
+  // the oldest frames have been skipped by the renderer
+  while (m_jobs.size() >= MAX_JOBS)
+    m_jobs.pop_front();
+
+  m_jobs.push_back(std::make_shared<SJob>(libass, pts, params));
+  if (!IsRunning())
+    Create();
+  m_queued.Set();
+}
+
+bool CAssRenderAhead::Get(CDVDSubtitlesLibass* libass, double pts, const SParams& params, SFrame& frame)
+{
+  CSingleLock lock(m_section);
+  auto it = std::find_if(m_jobs.begin(), m_jobs.end(), [&](const std::shared_ptr<SJob>& job) {
+    return job->libass == libass && job->pts == pts && job->params == params;
+  });
+  if (it == m_jobs.end())
+  {
+    m_missed++;
+    lock.Leave();
+    return Render(libass, pts, params, frame);
+  }
+
+  // the frames before won't be shown anymore
+  std::shared_ptr<SJob> job = *it;
+  m_jobs.erase(std::remove_if(m_jobs.begin(), m_jobs.end(), [&](const std::shared_ptr<SJob>& queued) {
+    return queued == job || queued->pts < pts;
+  }), m_jobs.end());
+
+  if (job->done)
+  {
+    m_ready++;
+    frame = job->frame;
+    return job->result;
+  }
+
+  m_late++;
+  if (job->running)
+  {
+    // the worker is on it, that's quicker than starting over
+    while (!job->done)
+    {
+      CSingleExit exit(m_section);
+      m_rendered.WaitMSec(100);
+    }
+    frame = job->frame;
+    return job->result;
+  }
+
+  lock.Leave();
+  return Render(libass, pts, params, frame);
+}
+
+void CAssRenderAhead::Flush()
+{
+  CSingleLock lock(m_section);
+  m_jobs.clear();
+  if (m_ready || m_late || m_missed)
+    CLog::Log(LOGDEBUG, "CAssRenderAhead: %u subtitle frames rendered ahead, %u late, %u missed",
+              m_ready, m_late, m_missed);
+  m_ready = m_late = m_missed = 0;
+
+  CSingleLock renderLock(m_renderSection);
+  if (m_lastLibass)
+    m_lastLibass->Release();
+  m_lastLibass = nullptr;
+  m_lastFrame = SFrame();
+}
+
+void CAssRenderAhead::GetStats(unsigned int& ready, unsigned int& late, unsigned int& missed)
+{
+  CSingleLock lock(m_section);
+  ready = m_ready;
+  late = m_late;
+  missed = m_missed;
+}
+
+void CAssRenderAhead::Process()
+{
+  while (!m_bStop)
+  {
+    std::shared_ptr<SJob> job;
+    {
+      CSingleLock lock(m_section);
+      auto it = std::find_if(m_jobs.begin(), m_jobs.end(), [](const std::shared_ptr<SJob>& job) { return !job->done; });
+      if (it != m_jobs.end())
+      {
+        job = *it;
+        job->running = true;
+      }
+    }
+
+    if (!job)
+    {
+      AbortableWait(m_queued);
+      continue;
+    }
+
+    SFrame frame;
+    const bool result = Render(job->libass, job->pts, job->params, frame);
+    {
+      CSingleLock lock(m_section);
+      job->frame = frame;
+      job->result = result;
+      job->done = true;
+      job->running = false;
+    }
+    m_rendered.Set();
+  }
+}
+
+bool CAssRenderAhead::Render(CDVDSubtitlesLibass* libass, double pts, const SParams& params, SFrame& frame)
+{
+  CSingleLock lock(m_renderSection);
+  return libass->RenderImage(params.frameWidth, params.frameHeight, params.videoWidth, params.videoHeight,
+                             pts, params.useMargin, params.position,
+                             [&](ASS_Image* images, int changes)
+  {
+    // changes tells if the images differ from the ones libass rendered last
+    if (changes == 0 && libass == m_lastLibass && params == m_lastParams)
+    {
+      frame = m_lastFrame;
+      return;
+    }
+
+    frame.quads = std::make_shared<SQuads>();
+    if (!convert_quad(images, *frame.quads, params.frameWidth))
+      frame.quads.reset();
+    frame.generation = ++m_generation;
+
+    if (libass != m_lastLibass)
+    {
+      if (m_lastLibass)
+        m_lastLibass->Release();
+      m_lastLibass = libass->Acquire();
+    }
+    m_lastParams = params;
+    m_lastFrame = frame;
+  });
+}
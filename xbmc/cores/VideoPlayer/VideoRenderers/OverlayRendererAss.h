@@ -0,0 +1,122 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+class CDVDSubtitlesLibass;
+
+namespace OVERLAY {
+
+  struct SQuads;
+
+  /*!
+   \brief Renders libass subtitles of the frames queued to the renderer on a
+   worker thread, so the render thread only uploads the packed glyphs.
+
+   libass compares each frame with the one it rendered before. A frame with
+   the same images as the one before shares its packed glyphs and their
+   generation, so the renderer keeps the texture it made of them.
+   */
+  class CAssRenderAhead : private CThread
+  {
+  public:
+    struct SParams
+    {
+      int frameWidth = 0;
+      int frameHeight = 0;
+      int videoWidth = 0;
+      int videoHeight = 0;
+      int useMargin = 0;
+      double position = 0.0;
+
+      bool operator==(const SParams& right) const;
+      bool operator!=(const SParams& right) const { return !(*this == right); }
+    };
+
+    struct SFrame
+    {
+      std::shared_ptr<SQuads> quads; // empty if no subtitles are shown
+      unsigned int generation = 0; // changes when the images change
+    };
+
+    CAssRenderAhead();
+    ~CAssRenderAhead() override;
+
+    //! render the subtitles of a frame that is going to be shown
+    void Queue(CDVDSubtitlesLibass* libass, double pts, const SParams& params);
+
+    /*!
+     \brief get the subtitles of a frame, they are rendered now if they weren't rendered ahead
+     \return false if libass can't render them
+     */
+    bool Get(CDVDSubtitlesLibass* libass, double pts, const SParams& params, SFrame& frame);
+
+    //! drop the frames rendered ahead and log how many were late
+    void Flush();
+
+    //! number of frames that were rendered ahead in time, late or not at all since the last flush
+    void GetStats(unsigned int& ready, unsigned int& late, unsigned int& missed);
+
+  protected:
+    void Process() override;
+
+  private:
+    struct SJob
+    {
+      SJob(CDVDSubtitlesLibass* subtitles, double time, const SParams& parameters);
+      ~SJob();
+      SJob(const SJob&) = delete;
+      SJob& operator=(const SJob&) = delete;
+
+      CDVDSubtitlesLibass* libass;
+      double pts;
+      SParams params;
+      bool running = false;
+      bool done = false;
+      bool result = false;
+      SFrame frame;
+    };
+
+    bool Render(CDVDSubtitlesLibass* libass, double pts, const SParams& params, SFrame& frame);
+
+    CCriticalSection m_section;
+    CEvent m_queued;
+    CEvent m_rendered;
+    std::deque<std::shared_ptr<SJob>> m_jobs;
+    unsigned int m_ready = 0;
+    unsigned int m_late = 0;
+    unsigned int m_missed = 0;
+
+    // libass and the frame it rendered last
+    CCriticalSection m_renderSection;
+    CDVDSubtitlesLibass* m_lastLibass = nullptr;
+    SParams m_lastParams;
+    SFrame m_lastFrame;
+    unsigned int m_generation = 0;
+  };
+
+}
@@ -725,6 +725,11 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 
       m_playerPort->GetDebugInfo(audio, video, player);
 
+      unsigned int subsReady, subsLate, subsMissed;
+      m_overlays.GetSubtitleStats(subsReady, subsLate, subsMissed);
+      if (subsReady || subsLate || subsMissed)
+        player += StringUtils::Format(" subs ahead:%u late:%u missed:%u", subsReady, subsLate, subsMissed);
+
       double refreshrate, clockspeed;
       int missedvblanks;
       vsync = StringUtils::Format("VSyncOff: %.1f latency: %.3f  ", m_clockSync.m_syncOffset / 1000, DVD_TIME_TO_MSEC(m_displayLatency) / 1000.0f);
@@ -26,6 +26,8 @@
 #include "ServiceBroker.h"
 #include "music/tags/MusicInfoTag.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
 #include "utils/log.h"
 #include <math.h>
 
@@ -66,15 +68,10 @@ void CAudioDecoder::Destroy()
   m_canPlay = false;
 }
 
-bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
+bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset, unsigned int bufferTime /* = 2 */)
 {
   Destroy();
 
-  CSingleLock lock(m_critSection);
-
-  // reset our playback timing variables
-  m_eof = false;
-
   // get correct cache size
   unsigned int filecache = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_CACHEAUDIO_INTERNET);
   if ( file.IsHD() )
@@ -85,14 +82,28 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     filecache = CServiceBroker::GetSettings().GetInt(CSettings::SETTING_CACHEAUDIO_LAN);
 
   // create our codec
-  m_codec=CodecFactory::CreateCodecDemux(file, filecache * 1024);
+  ICodec *codec = CodecFactory::CreateCodecDemux(file, filecache * 1024);
 
-  if (!m_codec || !m_codec->Init(file, filecache * 1024))
+  if (!codec || !codec->Init(file, filecache * 1024))
   {
     CLog::Log(LOGERROR, "CAudioDecoder: Unable to Init Codec while loading file %s", file.GetDynPath().c_str());
-    Destroy();
+    delete codec;
     return false;
   }
+
+  return Create(codec, file, seekOffset, bufferTime);
+}
+
+bool CAudioDecoder::Create(ICodec *codec, const CFileItem &file, int64_t seekOffset, unsigned int bufferTime /* = 2 */)
+{
+  Destroy();
+
+  CSingleLock lock(m_critSection);
+
+  // reset our playback timing variables
+  m_eof = false;
+  m_codec = codec;
+
   unsigned int blockSize = (m_codec->m_bitsPerSample >> 3) * m_codec->m_format.m_channelLayout.Count();
 
   if (blockSize == 0)
@@ -102,8 +113,13 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     return false;
   }
 
-  /* allocate the pcmBuffer for 2 seconds of audio */
-  m_pcmBuffer.Create(2 * blockSize * m_codec->m_format.m_sampleRate);
+  /* allocate the pcmBuffer for bufferTime seconds of audio, a long look-ahead
+     is capped for hi-res and multichannel audio */
+  const unsigned int bytesPerSecond = blockSize * m_codec->m_format.m_sampleRate;
+  bufferTime = std::max(bufferTime, 1u);
+  if (bufferTime > 2 && bufferTime * bytesPerSecond > MAX_BUFFER_SIZE)
+    bufferTime = std::max(MAX_BUFFER_SIZE / bytesPerSecond, 2u);
+  m_pcmBuffer.Create(bufferTime * bytesPerSecond);
 
   if (file.HasMusicInfoTag())
   {
@@ -140,6 +156,33 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
   return true;
 }
 
+bool CAudioDecoder::Prefill(unsigned int timeout, const std::atomic<bool> &abort)
+{
+  const unsigned int startTime = XbmcThreads::SystemClockMillis();
+
+  Start();
+  while (GetDataSize(true) == 0)
+  {
+    // don't hold up a transition or closing the player on a slow source,
+    // start with what has been decoded so far
+    if ((XbmcThreads::SystemClockMillis() - startTime >= timeout || abort) && GetBufferedTime() > 0)
+    {
+      m_status = STATUS_QUEUED;
+      break;
+    }
+
+    int result = RET_SLEEP;
+    if (m_status == STATUS_ENDED || m_status == STATUS_NO_FILE ||
+        (result = ReadSamples(PACKET_SIZE)) == RET_ERROR)
+      return false;
+
+    // yield our time if the codec has nothing for us yet
+    if (result == RET_SLEEP)
+      XbmcThreads::ThreadSleep(1);
+  }
+  return true;
+}
+
 AEAudioFormat CAudioDecoder::GetFormat()
 {
   AEAudioFormat format;
@@ -197,6 +240,18 @@ unsigned int CAudioDecoder::GetDataSize(bool checkPktSize)
   }
 }
 
+unsigned int CAudioDecoder::GetBufferedTime()
+{
+  if (!m_codec || m_codec->m_format.m_dataFormat == AE_FMT_RAW)
+    return 0;
+
+  unsigned int bytesPerSecond = (m_codec->m_bitsPerSample >> 3) * m_codec->m_format.m_channelLayout.Count() * m_codec->m_format.m_sampleRate;
+  if (bytesPerSecond == 0)
+    return 0;
+
+  return static_cast<unsigned int>(static_cast<uint64_t>(m_pcmBuffer.getMaxReadSize()) * 1000 / bytesPerSecond);
+}
+
 void *CAudioDecoder::GetData(unsigned int samples)
 {
   unsigned int size  = samples * (m_codec->m_bitsPerSample >> 3);
@@ -25,12 +25,16 @@
 #include "utils/RingBuffer.h"
 #include "cores/AudioEngine/Utils/AEChannelInfo.h"
 
+#include <atomic>
+
 class CFileItem;
 
 #define PACKET_SIZE 3840    // audio packet size - we keep 1 in reserve for gapless playback
                             // using a multiple of 1, 2, 3, 4, 5, 6 to guarantee track alignment
                             // note that 7 or higher channels won't work too well.
 
+#define MAX_BUFFER_SIZE (8 * 1024 * 1024) // max size of a pcm buffer longer than 2 seconds
+
 #define INPUT_SIZE PACKET_SIZE * 3      // input data size we read from the codecs at a time
                                         // * 3 to allow 24 bit audio
 
@@ -55,7 +59,31 @@ public:
   CAudioDecoder();
   ~CAudioDecoder();
 
-  bool Create(const CFileItem &file, int64_t seekOffset);
+  /*!
+   * \brief Open a file for decoding
+   * \param file the file to decode
+   * \param seekOffset position to start decoding at in ms
+   * \param bufferTime seconds of decoded audio to buffer, the decoder only
+   *        delivers data once the buffer is full or the end of the file is reached.
+   *        Long buffers are capped at MAX_BUFFER_SIZE bytes, but hold 2 seconds at least.
+   */
+  bool Create(const CFileItem &file, int64_t seekOffset, unsigned int bufferTime = 2);
+
+  /*!
+   * \brief Decode with a codec that is already initialized
+   * \param codec the codec to decode with, the decoder takes ownership
+   * \sa Create(const CFileItem&, int64_t, unsigned int)
+   */
+  bool Create(ICodec *codec, const CFileItem &file, int64_t seekOffset, unsigned int bufferTime = 2);
+
+  /*!
+   * \brief Decode until the buffer is full, so that playback starts from memory
+   * \param timeout ms after which decoding stops early and the stream starts
+   *        with the audio decoded so far
+   * \param abort stops decoding early like the timeout
+   * \return false if the file could not be decoded
+   */
+  bool Prefill(unsigned int timeout, const std::atomic<bool> &abort);
   void Destroy();
 
   int ReadSamples(int numsamples);
@@ -72,6 +100,7 @@ public:
   unsigned int GetChannels() { return GetFormat().m_channelLayout.Count(); }
   // Data management
   unsigned int GetDataSize(bool checkPktSize);
+  unsigned int GetBufferedTime(); // ms of decoded audio in the buffer
   void *GetData(unsigned int samples);
   uint8_t* GetRawData(int &size);
   ICodec *GetCodec() const { return m_codec; }
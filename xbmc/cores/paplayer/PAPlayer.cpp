@@ -26,6 +26,7 @@
 #include "music/tags/MusicInfoTag.h"
 #include "utils/log.h"
 #include "utils/JobManager.h"
+#include "threads/SystemClock.h"
 #include "video/Bookmark.h"
 
 #include "cores/AudioEngine/Interfaces/AE.h"
@@ -35,7 +36,8 @@
 #include "cores/VideoPlayer/Process/ProcessInfo.h"
 #include "Util.h"
 
-#define TIME_TO_CACHE_NEXT_FILE 5000 /* 5 seconds before end of song, start caching the next song */
+#include <climits>
+
 #define FAST_XFADE_TIME           80 /* 80 milliseconds */
 #define MAX_SKIP_XFADE_TIME     2000 /* max 2 seconds crossfade on track skip */
 
@@ -241,7 +243,7 @@ bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
     m_jobCounter++;
   }
   CJobManager::GetInstance().Submit([this, file]() {
-    QueueNextFileEx(file, false);
+    QueueNextFileEx(file, false, false);
   }, this, CJob::PRIORITY_NORMAL);
 
   CSingleLock lock(m_streamsLock);
@@ -306,13 +308,13 @@ bool PAPlayer::QueueNextFile(const CFileItem &file)
     m_jobCounter++;
   }
   CJobManager::GetInstance().Submit([this, file]() {
-    QueueNextFileEx(file, true);
+    QueueNextFileEx(file, true, true);
   }, this, CJob::PRIORITY_NORMAL);
 
   return true;
 }
 
-bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
+bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn, bool lookAhead)
 {
   if (m_currentStream)
   {
@@ -332,9 +334,14 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
     m_currentStream->m_nextFileItem.reset();
   }
 
+  // a track queued ahead is decoded for as long as it is queued early, so
+  // the player thread starts it from memory even on slow shares
+  const unsigned int bufferTime = lookAhead ? g_advancedSettings.m_audioLookAhead : 2;
+  const unsigned int startTime = XbmcThreads::SystemClockMillis();
+
   StreamInfo *si = new StreamInfo();
   si->m_fileItem = file;
-  if (!si->m_decoder.Create(file, si->m_fileItem.m_lStartOffset))
+  if (!si->m_decoder.Create(file, si->m_fileItem.m_lStartOffset, bufferTime))
   {
     CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
 
@@ -346,30 +353,25 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
     return false;
   }
 
-  /* decode until there is data-available */
-  si->m_decoder.Start();
-  while (si->m_decoder.GetDataSize(true) == 0)
+  /* decode until there is data-available, a track queued ahead starts with
+     what has been decoded after half the look-ahead */
+  if (!si->m_decoder.Prefill(lookAhead ? bufferTime * 500 : UINT_MAX, m_bStop))
   {
-    int status = si->m_decoder.GetStatus();
-    if (status == STATUS_ENDED   ||
-        status == STATUS_NO_FILE ||
-        si->m_decoder.ReadSamples(PACKET_SIZE) == RET_ERROR)
-    {
-      CLog::Log(LOGINFO, "PAPlayer::QueueNextFileEx - Error reading samples");
+    CLog::Log(LOGINFO, "PAPlayer::QueueNextFileEx - Error reading samples");
 
-      si->m_decoder.Destroy();
-      // advance playlist
-      m_callback.OnPlayBackStarted(si->m_fileItem);
-      m_callback.OnAVStarted(si->m_fileItem);
-      m_callback.OnQueueNextItem();
-      delete si;
-      return false;
-    }
-
-    /* yield our time so that the main PAP thread doesnt stall */
-    CThread::Sleep(1);
+    si->m_decoder.Destroy();
+    // advance playlist
+    m_callback.OnPlayBackStarted(si->m_fileItem);
+    m_callback.OnAVStarted(si->m_fileItem);
+    m_callback.OnQueueNextItem();
+    delete si;
+    return false;
   }
 
+  if (lookAhead)
+    CLog::Log(LOGDEBUG, "PAPlayer::QueueNextFileEx - Decoded %u ms ahead in %u ms",
+              si->m_decoder.GetBufferedTime(), XbmcThreads::SystemClockMillis() - startTime);
+
   // set m_upcomingCrossfadeMS depending on type of file and user settings
   UpdateCrossfadeTime(si->m_fileItem);
 
@@ -398,8 +400,9 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn)
   // cd drives don't really like it to be crossfaded or prepared
   if(!file.IsCDDA())
   {
-    if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-      si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
+    const int64_t timeToCacheNextFile = g_advancedSettings.m_audioLookAhead * 1000;
+    if (streamTotalTime >= timeToCacheNextFile + m_defaultCrossfadeMS)
+      si->m_prepareNextAtFrame = (int)((streamTotalTime - timeToCacheNextFile - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
   }
 
   if (m_currentStream && ((m_currentStream->m_audioFormat.m_dataFormat == AE_FMT_RAW) || (si->m_audioFormat.m_dataFormat == AE_FMT_RAW)))
@@ -792,8 +795,9 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &freeBufferTime)
 
       // calculate time when to prepare next stream
       si->m_prepareNextAtFrame = 0;
-      if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-        si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
+      const int64_t timeToCacheNextFile = g_advancedSettings.m_audioLookAhead * 1000;
+      if (streamTotalTime >= timeToCacheNextFile + m_defaultCrossfadeMS)
+        si->m_prepareNextAtFrame = (int)((streamTotalTime - timeToCacheNextFile - m_defaultCrossfadeMS) * si->m_audioFormat.m_sampleRate / 1000.0f);
 
       si->m_prepareTriggered = false;
       si->m_playNextAtFrame = 0;
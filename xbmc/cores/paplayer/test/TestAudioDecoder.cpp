@@ -0,0 +1,297 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/paplayer/AudioDecoder.h"
+#include "FileItem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <string.h>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+// how long reading from a share takes, in ms
+struct Share
+{
+  unsigned int openMs;    // for the first read, e.g. a disk spinning up
+  double decodeRatio;     // per ms of audio
+  unsigned int stallAtMs; // audio position of a stall, 0 for none
+  unsigned int stallMs;
+};
+
+const Share LOCAL = { 0, 0.0, 0, 0 };
+
+class CFakeCodec : public ICodec
+{
+public:
+  CFakeCodec(const Share &share, AEDataFormat format, AEStdChLayout layout, unsigned int sampleRate,
+             unsigned int totalMs, bool error = false)
+    : m_share(share), m_error(error)
+  {
+    m_format.m_dataFormat = format;
+    m_format.m_channelLayout = layout;
+    m_format.m_sampleRate = sampleRate;
+    m_bitsPerSample = format == AE_FMT_S32NE ? 32 : 16;
+    m_TotalTime = totalMs;
+    m_bytesPerMs = (m_bitsPerSample >> 3) * m_format.m_channelLayout.Count() * sampleRate / 1000.0;
+  }
+
+  bool Init(const CFileItem &file, unsigned int filecache) override { return true; }
+  bool Seek(int64_t iSeekTime) override { return false; }
+  bool CanInit() override { return true; }
+
+  int ReadPCM(unsigned char *pBuffer, int size, int *actualsize) override
+  {
+    *actualsize = 0;
+    if (m_error)
+      return READ_ERROR;
+
+    const double position = m_position / m_bytesPerMs;
+    if (position >= m_TotalTime)
+      return READ_EOF;
+
+    double cost = size / m_bytesPerMs * m_share.decodeRatio;
+    if (m_position == 0)
+      cost += m_share.openMs;
+    if (m_share.stallAtMs && position < m_share.stallAtMs && position + size / m_bytesPerMs >= m_share.stallAtMs)
+      cost += m_share.stallMs;
+    if (cost >= 1.0)
+      std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(cost * 1000)));
+
+    memset(pBuffer, 0, size);
+    m_position += size;
+    *actualsize = size;
+    return READ_SUCCESS;
+  }
+
+private:
+  Share m_share;
+  bool m_error;
+  double m_bytesPerMs;
+  uint64_t m_position = 0;
+};
+
+CFakeCodec *CreateCodec(const Share &share, unsigned int totalMs = 600000)
+{
+  return new CFakeCodec(share, AE_FMT_S16NE, AE_CH_LAYOUT_2_0, 44100, totalMs);
+}
+
+unsigned int ElapsedMs(const std::chrono::steady_clock::time_point &start)
+{
+  return static_cast<unsigned int>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+}
+
+TEST(TestAudioDecoder, Prefill)
+{
+  CAudioDecoder decoder;
+  ASSERT_TRUE(decoder.Create(CreateCodec(LOCAL), CFileItem(), 0, 5));
+
+  std::atomic<bool> abort(false);
+  ASSERT_TRUE(decoder.Prefill(UINT_MAX, abort));
+  EXPECT_EQ(STATUS_QUEUED, decoder.GetStatus());
+  EXPECT_GE(decoder.GetBufferedTime(), 4500u);
+  EXPECT_LE(decoder.GetBufferedTime(), 5000u);
+  EXPECT_GT(decoder.GetDataSize(true), 0u);
+}
+
+TEST(TestAudioDecoder, PrefillShortFile)
+{
+  CAudioDecoder decoder;
+  ASSERT_TRUE(decoder.Create(CreateCodec(LOCAL, 1000), CFileItem(), 0, 5));
+
+  std::atomic<bool> abort(false);
+  ASSERT_TRUE(decoder.Prefill(UINT_MAX, abort));
+  EXPECT_EQ(STATUS_ENDING, decoder.GetStatus());
+  EXPECT_GE(decoder.GetBufferedTime(), 1000u);
+}
+
+// a source slower than real time starts with what has been decoded when
+// the time is up or the player stops
+TEST(TestAudioDecoder, PrefillSlowSource)
+{
+  const Share slow = { 0, 2.0, 0, 0 };
+  std::atomic<bool> abort(false);
+
+  CAudioDecoder decoder;
+  ASSERT_TRUE(decoder.Create(CreateCodec(slow), CFileItem(), 0, 5));
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(decoder.Prefill(300, abort));
+  EXPECT_LT(ElapsedMs(start), 1000u);
+  EXPECT_EQ(STATUS_QUEUED, decoder.GetStatus());
+  EXPECT_GT(decoder.GetBufferedTime(), 0u);
+  EXPECT_LT(decoder.GetBufferedTime(), 1000u);
+
+  abort = true;
+  ASSERT_TRUE(decoder.Create(CreateCodec(slow), CFileItem(), 0, 5));
+  start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(decoder.Prefill(UINT_MAX, abort));
+  EXPECT_LT(ElapsedMs(start), 1000u);
+  EXPECT_EQ(STATUS_QUEUED, decoder.GetStatus());
+  EXPECT_GT(decoder.GetBufferedTime(), 0u);
+}
+
+TEST(TestAudioDecoder, PrefillError)
+{
+  CAudioDecoder decoder;
+  ASSERT_TRUE(decoder.Create(new CFakeCodec(LOCAL, AE_FMT_S16NE, AE_CH_LAYOUT_2_0, 44100, 600000, true),
+                             CFileItem(), 0, 5));
+
+  std::atomic<bool> abort(false);
+  EXPECT_FALSE(decoder.Prefill(UINT_MAX, abort));
+}
+
+// a long look-ahead is capped at MAX_BUFFER_SIZE, but never below the
+// 2 seconds buffered without one
+TEST(TestAudioDecoder, BufferSize)
+{
+  std::atomic<bool> abort(false);
+  CAudioDecoder decoder;
+
+  ASSERT_TRUE(decoder.Create(CreateCodec(LOCAL), CFileItem(), 0, 60));
+  ASSERT_TRUE(decoder.Prefill(UINT_MAX, abort));
+  const unsigned int cappedMs = MAX_BUFFER_SIZE / (2 * 2 * 44100) * 1000;
+  EXPECT_GE(decoder.GetBufferedTime(), cappedMs * 9 / 10);
+  EXPECT_LE(decoder.GetBufferedTime(), cappedMs);
+
+  ASSERT_TRUE(decoder.Create(new CFakeCodec(LOCAL, AE_FMT_S32NE, AE_CH_LAYOUT_7_1, 192000, 600000),
+                             CFileItem(), 0, 60));
+  ASSERT_TRUE(decoder.Prefill(UINT_MAX, abort));
+  EXPECT_GE(decoder.GetBufferedTime(), 1800u);
+  EXPECT_LE(decoder.GetBufferedTime(), 2000u);
+}
+
+namespace
+{
+
+struct Transition
+{
+  unsigned int queueAheadMs;
+  unsigned int bufferTime;
+  unsigned int timeout;
+};
+
+struct Playback
+{
+  int underruns;
+  unsigned int gapMs;
+};
+
+// Models the transition to the next track on a share: the queueing job
+// opens and prefills the track while the current one plays its last
+// queueAheadMs from memory. After that the player thread moves the decoded
+// audio into a stream buffer that plays in real time, and reads from the
+// codec once per round like PAPlayer::ProcessStream does.
+Playback PlayTransition(const Transition &transition, const Share &share)
+{
+  static const double STREAM_BUFFER_MS = 300.0;
+  static const double PLAY_MS = 8000.0;
+  static const double SAMPLES_PER_MS = 2 * 44.1;
+
+  CAudioDecoder decoder;
+  std::atomic<bool> stop(false);
+  std::atomic<bool> queued(false);
+  bool ok = false;
+  std::thread job([&]()
+  {
+    ok = decoder.Create(CreateCodec(share), CFileItem(), 0, transition.bufferTime) &&
+         decoder.Prefill(transition.timeout, stop);
+    queued = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(transition.queueAheadMs));
+
+  Playback playback = { 0, 0 };
+  double streamMs = STREAM_BUFFER_MS;
+  double playedMs = 0.0;
+  bool underrun = false;
+  auto last = std::chrono::steady_clock::now();
+  while (playedMs < PLAY_MS)
+  {
+    const auto now = std::chrono::steady_clock::now();
+    streamMs -= std::chrono::duration<double, std::milli>(now - last).count();
+    last = now;
+    if (streamMs < 0.0)
+    {
+      if (!underrun)
+        playback.underruns++;
+      underrun = true;
+      playback.gapMs += static_cast<unsigned int>(-streamMs);
+      streamMs = 0.0;
+    }
+
+    if (!queued)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+    if (!ok)
+      break;
+
+    unsigned int samples;
+    while (streamMs < STREAM_BUFFER_MS - 1.0 && (samples = decoder.GetDataSize(true)) > 0)
+    {
+      samples = std::min(samples, static_cast<unsigned int>((STREAM_BUFFER_MS - streamMs) * SAMPLES_PER_MS) & ~1u);
+      if (samples == 0 || decoder.GetData(samples) == nullptr)
+        break;
+      streamMs += samples / SAMPLES_PER_MS;
+      playedMs += samples / SAMPLES_PER_MS;
+      underrun = false;
+    }
+
+    decoder.ReadSamples(PACKET_SIZE);
+    if (streamMs >= STREAM_BUFFER_MS - 10.0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  stop = true;
+  job.join();
+  return playback;
+}
+
+}
+
+// Counts underruns and the audio missing for the first 8 seconds of the next
+// track on a share that takes 3 seconds for the first read, decodes at 0.7x
+// real time and stalls for a second 4 seconds into the track. Compares the
+// 2 seconds queued 5 seconds ahead used before the look-ahead with several
+// look-ahead times.
+TEST(TestAudioDecoder, DISABLED_Transition)
+{
+  const Share share = { 3000, 0.7, 4000, 1000 };
+
+  const Playback before = PlayTransition({ 5000, 2, UINT_MAX }, share);
+  RecordProperty("BeforeUnderruns", before.underruns);
+  RecordProperty("BeforeGapMs", static_cast<int>(before.gapMs));
+
+  for (unsigned int lookAhead : { 2u, 5u, 10u })
+  {
+    const Playback playback = PlayTransition({ lookAhead * 1000, lookAhead, lookAhead * 500 }, share);
+    const std::string name = "LookAhead" + std::to_string(lookAhead);
+    RecordProperty(name + "Underruns", playback.underruns);
+    RecordProperty(name + "GapMs", static_cast<int>(playback.gapMs));
+  }
+}
@@ -19,6 +19,11 @@
  */
 
 #include "Database.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <random>
+
 #include "settings/AdvancedSettings.h"
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/File.h"
@@ -690,3 +695,434 @@ bool CDatabase::BuildSQL(const std::string &strBaseDir, const std::string &strQu
 
   return BuildSQL(strQuery, filter, strSQL);
 }
+
+std::string CDatabase::FormatFullTextSearch(const std::string &search, bool wordStart, bool sqlite)
+{
+  // The expression only narrows down the rows the LIKE on the search string
+  // is evaluated on, so it may match more rows but never fewer. The search
+  // string is split into words the same way the full text tokenizers do: any
+  // ASCII character that isn't alphanumeric is a separator, anything else
+  // (including multi-byte UTF-8 sequences) is part of a word. A word that
+  // follows a separator starts a word of every match, if it is also followed
+  // by one it is a whole word. The first word may be the end of a longer word
+  // unless the LIKE only matches at the start of a word.
+  std::vector<std::pair<std::string, bool>> words; // word, whole word
+  std::string word;
+  bool startsWord = wordStart;
+  bool anchored = wordStart;
+  for (const char c : search)
+  {
+    const unsigned char uc = static_cast<unsigned char>(c);
+    if (uc >= 0x80 || isalnum(uc))
+    {
+      if (word.empty())
+        startsWord = anchored;
+      word += c;
+      continue;
+    }
+    if (!word.empty() && startsWord)
+      words.push_back(std::make_pair(word, true));
+    word.clear();
+    anchored = true;
+  }
+  if (!word.empty() && startsWord)
+    words.push_back(std::make_pair(word, false));
+
+  std::string expression;
+  for (const auto &it : words)
+  {
+    if (!sqlite && !IsMySQLFullTextWord(it.first, it.second))
+      continue;
+
+    if (!expression.empty())
+      expression += " ";
+
+    // SQLite FTS5: every phrase has to match (implicit AND), "word"* is a prefix query
+    // MySQL boolean mode: +word requires the word, word* is a prefix query
+    if (sqlite)
+      expression += "\"" + it.first + "\"";
+    else
+      expression += "+" + it.first;
+
+    if (!it.second)
+      expression += "*";
+  }
+
+  return expression;
+}
+
+bool CDatabase::IsMySQLFullTextWord(const std::string &word, bool wholeWord)
+{
+  // words shorter than the minimum token size of InnoDB (3) and MyISAM (4)
+  // and stopwords aren't indexed, so requiring them or a prefix of them
+  // would drop rows. The tables are created with InnoDB, these are the
+  // stopwords of its default list that are long enough to matter.
+  static const char* const stopwords[] = { "about", "from", "that", "this", "what", "when", "where", "will", "with" };
+
+  size_t length = 0;
+  for (const char c : word)
+  {
+    // count UTF-8 characters rather than bytes
+    if ((static_cast<unsigned char>(c) & 0xC0) != 0x80)
+      length++;
+  }
+  if (length < 4)
+    return false;
+
+  std::string lower(word);
+  StringUtils::ToLower(lower);
+  for (const char *stopword : stopwords)
+  {
+    if (wholeWord ? lower == stopword : StringUtils::StartsWith(stopword, lower))
+      return false;
+  }
+  return true;
+}
+
+bool CDatabase::GetRandomIDs(const std::string &table, const std::string &idColumn, const Filter &filter,
+                             unsigned int count, const std::set<int> &exclude, std::vector<int> &ids)
+{
+  ids.clear();
+  if (NULL == m_pDB.get() || NULL == m_pDS.get())
+    return false;
+
+  return GetRandomIDs(*m_pDS, table, idColumn, filter, count, exclude, ids);
+}
+
+bool CDatabase::FilterRandomIDs(const std::string &table, const std::string &idColumn, Filter &filter, unsigned int count)
+{
+  std::vector<int> ids;
+  if (!GetRandomIDs(table, idColumn, filter, count, std::set<int>(), ids))
+    return false;
+
+  std::vector<std::string> idList;
+  for (int id : ids)
+    idList.push_back(StringUtils::Format("%i", id));
+  filter.AppendWhere(idList.empty() ? "0" : idColumn + " IN (" + StringUtils::Join(idList, ",") + ")");
+  return true;
+}
+
+bool CDatabase::GetRandomIDs(Dataset &ds, const std::string &table, const std::string &idColumn,
+                             const Filter &filter, unsigned int count, const std::set<int> &exclude,
+                             std::vector<int> &ids)
+{
+  ids.clear();
+  if (count == 0)
+    return true;
+
+  try
+  {
+    // the id range of the whole table is a lookup in the primary key, the
+    // filter is only applied by the probes (MIN and MAX have to be separate
+    // queries, otherwise SQLite scans the table)
+    std::string strSQL = StringUtils::Format("SELECT (SELECT MIN(%s) FROM %s), (SELECT MAX(%s) FROM %s)",
+                                             idColumn.c_str(), table.c_str(), idColumn.c_str(), table.c_str());
+    if (!ds.query(strSQL))
+      return false;
+    if (ds.num_rows() != 1 || ds.fv(0).get_isNull())
+    {
+      ds.close();
+      return true;
+    }
+    int minId = ds.fv(0).get_asInt();
+    int maxId = ds.fv(1).get_asInt();
+    ds.close();
+
+    Filter sampleFilter = filter;
+    sampleFilter.order.clear();
+    sampleFilter.limit.clear();
+    const std::string select = StringUtils::Format("SELECT %s FROM %s ", idColumn.c_str(), table.c_str());
+
+    std::random_device rd;
+    std::mt19937 mt(rd());
+    std::set<int> picked;
+
+    // runs a probe and picks the id it found unless it is excluded or was
+    // picked before, hit tells whether an id was picked
+    auto probe = [&](const Filter &probeFilter, bool &hit) -> bool
+    {
+      if (!BuildSQL(select, probeFilter, strSQL) || !ds.query(strSQL))
+        return false;
+      const bool found = ds.num_rows() > 0;
+      const int id = found ? ds.fv(0).get_asInt() : 0;
+      ds.close();
+
+      hit = found && exclude.find(id) == exclude.end() && picked.insert(id).second;
+      if (hit)
+        ids.push_back(id);
+      return true;
+    };
+
+    // probe random ids of the id range, a probe hits if that very id matches,
+    // so every match is equally likely however the ids are distributed
+    unsigned int probes = 0;
+    const unsigned int maxProbes = 32 * count + 32;
+    while (ids.size() < count && probes < maxProbes)
+    {
+      probes++;
+      Filter probeFilter = sampleFilter;
+      probeFilter.AppendWhere(StringUtils::Format("%s = %i", idColumn.c_str(), std::uniform_int_distribution<int>(minId, maxId)(mt)));
+      bool hit;
+      if (!probe(probeFilter, hit))
+        return false;
+    }
+    if (ids.size() == count)
+      return true;
+
+    // the matches are too sparse in the id range, pick them by random rank
+    if (!BuildSQL(select, sampleFilter, strSQL) ||
+        !ds.query("SELECT COUNT(1) FROM (" + strSQL + ") AS matches"))
+      return false;
+    const unsigned int matches = ds.num_rows() > 0 ? ds.fv(0).get_asInt() : 0;
+    ds.close();
+
+    std::set<unsigned int> ranks;
+    unsigned int misses = 0;
+    const unsigned int maxMisses = 2 * count + 8;
+    while (ids.size() < count && ranks.size() < matches && misses < maxMisses)
+    {
+      const unsigned int rank = std::uniform_int_distribution<unsigned int>(0, matches - 1)(mt);
+      if (!ranks.insert(rank).second)
+        continue;
+
+      Filter probeFilter = sampleFilter;
+      probeFilter.order = idColumn;
+      probeFilter.limit = StringUtils::Format("%u, 1", rank);
+      bool hit;
+      if (!probe(probeFilter, hit))
+        return false;
+      if (!hit)
+        misses++;
+    }
+
+    if (ids.size() < count && ranks.size() < matches)
+    {
+      // most matching ids are excluded, sample the remaining ids from the
+      // full list of matches
+      if (!BuildSQL(select, sampleFilter, strSQL) || !ds.query(strSQL))
+        return false;
+
+      const unsigned int needed = count - ids.size();
+      std::vector<int> reservoir;
+      unsigned int seen = 0;
+      while (!ds.eof())
+      {
+        const int id = ds.fv(0).get_asInt();
+        ds.next();
+        if (exclude.find(id) != exclude.end() || picked.find(id) != picked.end())
+          continue;
+
+        seen++;
+        if (reservoir.size() < needed)
+          reservoir.push_back(id);
+        else
+        {
+          const unsigned int slot = std::uniform_int_distribution<unsigned int>(0, seen - 1)(mt);
+          if (slot < needed)
+            reservoir[slot] = id;
+        }
+      }
+      ds.close();
+
+      std::shuffle(reservoir.begin(), reservoir.end(), mt);
+      ids.insert(ids.end(), reservoir.begin(), reservoir.end());
+    }
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, table.c_str());
+  }
+  ds.close();
+  return false;
+}
+
+bool CDatabase::FullTextIndexExists(const std::string &index) const
+{
+  if (NULL == m_pDB.get())
+    return false;
+
+  try
+  {
+    std::unique_ptr<Dataset> ds(m_pDB->CreateDataset());
+    std::string strSQL;
+    if (m_sqlite)
+      strSQL = PrepareSQL("SELECT name FROM sqlite_master WHERE type='table' AND name='%s'", index.c_str());
+    else
+      // the fulltext indexes are dropped together with all other indexes on
+      // database upgrades, so check for them rather than for the table
+      strSQL = PrepareSQL("SELECT index_name FROM information_schema.statistics "
+                          "WHERE table_schema=DATABASE() AND table_name='%s' AND index_type='FULLTEXT'", index.c_str());
+
+    bool exists = ds->query(strSQL) && ds->num_rows() > 0;
+    ds->close();
+    return exists;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to look up full text index %s", __FUNCTION__, index.c_str());
+  }
+  return false;
+}
+
+bool CDatabase::HasFullTextIndex(const std::string &index) const
+{
+  if (!IsFullTextSearchEnabled())
+    return false;
+
+  auto it = m_fullTextIndexes.find(index);
+  if (it != m_fullTextIndexes.end())
+    return it->second;
+
+  bool exists = FullTextIndexExists(index);
+  m_fullTextIndexes[index] = exists;
+  return exists;
+}
+
+std::string CDatabase::GetFullTextSubQuery(const std::string &index, const std::vector<std::string> &columns,
+                                           const std::string &search, bool wordStart) const
+{
+  if (columns.empty() || !HasFullTextIndex(index))
+    return "";
+
+  std::string expression = FormatFullTextSearch(search, wordStart, m_sqlite);
+  if (expression.empty())
+    return "";
+
+  if (m_sqlite)
+  {
+    std::string match = "{" + StringUtils::Join(columns, " ") + "} : (" + expression + ")";
+    return "SELECT rowid FROM " + index + " WHERE " + index + PrepareSQL(" MATCH '%s'", match.c_str());
+  }
+
+  std::string where;
+  for (const auto &column : columns)
+  {
+    if (!where.empty())
+      where += " OR ";
+    where += "MATCH(" + column + ")" + PrepareSQL(" AGAINST('%s' IN BOOLEAN MODE)", expression.c_str());
+  }
+  return "SELECT id FROM " + index + " WHERE " + where;
+}
+
+std::string CDatabase::GetFullTextInsert(const FullTextIndex &index) const
+{
+  std::vector<std::string> names;
+  std::vector<std::string> expressions;
+  for (const auto &column : index.columns)
+  {
+    names.push_back(column.first);
+    expressions.push_back(column.second);
+  }
+
+  return "INSERT INTO " + index.name + " (" + (m_sqlite ? "rowid" : "id") + ", " + StringUtils::Join(names, ", ") + ") "
+         "SELECT " + index.idColumn + ", " + StringUtils::Join(expressions, ", ") + " FROM " + index.table;
+}
+
+bool CDatabase::CreateFullTextIndex(const FullTextIndex &index)
+{
+  std::vector<std::string> names;
+  for (const auto &column : index.columns)
+    names.push_back(column.first);
+
+  BeginTransaction();
+  try
+  {
+    CLog::Log(LOGINFO, "%s - creating full text index %s", __FUNCTION__, index.name.c_str());
+    m_pDS->exec("DROP TABLE IF EXISTS " + index.name);
+    if (m_sqlite)
+    {
+      m_pDS->exec("CREATE VIRTUAL TABLE " + index.name + " USING fts5(" + StringUtils::Join(names, ", ") +
+                  ", tokenize = 'unicode61 remove_diacritics 1')");
+    }
+    else
+    {
+      std::string strSQL = "CREATE TABLE " + index.name + " (id INTEGER PRIMARY KEY";
+      for (const auto &name : names)
+        strSQL += ", " + name + " TEXT";
+      for (const auto &name : names)
+        strSQL += ", FULLTEXT ix_" + index.name + "_" + name + " (" + name + ")";
+      // FormatFullTextSearch() leaves out the words InnoDB doesn't index
+      strSQL += ") ENGINE=InnoDB";
+      m_pDS->exec(strSQL);
+    }
+
+    m_pDS->exec(GetFullTextInsert(index));
+  }
+  catch (...)
+  {
+    // most likely SQLite was built without FTS5 or the MySQL server doesn't
+    // support FULLTEXT indexes on the used storage engine
+    CLog::Log(LOGERROR, "%s - unable to create full text index %s, full text search is not available",
+              __FUNCTION__, index.name.c_str());
+    RollbackTransaction();
+    return false;
+  }
+  return CommitTransaction();
+}
+
+void CDatabase::UpdateFullTextIndexes()
+{
+  if (NULL == m_pDB.get() || NULL == m_pDS.get())
+    return;
+
+  m_fullTextIndexes.clear();
+
+  bool enabled = IsFullTextSearchEnabled();
+  for (const auto &index : GetFullTextIndexes())
+  {
+    bool exists = FullTextIndexExists(index.name);
+    if (!enabled)
+    {
+      if (exists)
+      {
+        CLog::Log(LOGINFO, "%s - dropping full text index %s", __FUNCTION__, index.name.c_str());
+        ExecuteQuery("DROP TABLE " + index.name);
+      }
+      continue;
+    }
+
+    if (!exists)
+      CreateFullTextIndex(index);
+    else
+    {
+      const std::string id = m_sqlite ? "rowid" : "id";
+
+      // bulk deletes (e.g. library cleanup) don't go through DeleteFullTextEntry()
+      ExecuteQuery("DELETE FROM " + index.name + " WHERE " + id +
+                   " NOT IN (SELECT " + index.idColumn + " FROM " + index.table + ")");
+
+      // items added while the index was disabled or by an older version
+      // don't have an entry yet
+      ExecuteQuery(GetFullTextInsert(index) + " WHERE " + index.idColumn +
+                   " NOT IN (SELECT " + id + " FROM " + index.name + ")");
+    }
+  }
+
+  m_fullTextIndexes.clear();
+}
+
+void CDatabase::UpdateFullTextEntry(const std::string &index, int id)
+{
+  if (!HasFullTextIndex(index))
+    return;
+
+  const std::vector<FullTextIndex> indexes = GetFullTextIndexes();
+  auto definition = std::find_if(indexes.begin(), indexes.end(), [&index](const FullTextIndex &it)
+  {
+    return it.name == index;
+  });
+  if (definition == indexes.end())
+    return;
+
+  DeleteFullTextEntry(index, id);
+  ExecuteQuery(GetFullTextInsert(*definition) + PrepareSQL(" WHERE %s = %i", definition->idColumn.c_str(), id));
+}
+
+void CDatabase::DeleteFullTextEntry(const std::string &index, int id)
+{
+  if (!HasFullTextIndex(index))
+    return;
+
+  ExecuteQuery("DELETE FROM " + index + PrepareSQL(" WHERE %s = %i", m_sqlite ? "rowid" : "id", id));
+}
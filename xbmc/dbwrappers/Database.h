@@ -25,8 +25,11 @@ namespace dbiplus {
   class Dataset;
 }
 
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 class DatabaseSettings; // forward
@@ -170,6 +173,84 @@ public:
    */
   bool CommitInsertQueries();
 
+  /*!
+   * @brief Check whether the given full text search index is enabled and
+   *        present in the database.
+   * @param index The name of the index (see GetFullTextIndexes()).
+   * @return True if the index can be queried, false otherwise.
+   */
+  bool HasFullTextIndex(const std::string &index) const;
+
+  /*!
+   * @brief Build a sub query returning the ids of all items that may contain
+   *        the given search string, according to a full text search index.
+   * @remarks The sub query narrows down the items a LIKE on the search string
+   *          has to be evaluated on, it may return more items but never fewer.
+   *          Callers have to keep their LIKE condition.
+   * @param index The name of the index (see GetFullTextIndexes()).
+   * @param columns The indexed columns to search in.
+   * @param search The search string as entered by the user.
+   * @param wordStart Whether the LIKE only matches the search string at the
+   *        start of a word, e.g. LIKE 'search%' OR LIKE '% search%'.
+   * @return The sub query or an empty string if the index is not available
+   *         or can't narrow down the search.
+   */
+  std::string GetFullTextSubQuery(const std::string &index, const std::vector<std::string> &columns,
+                                  const std::string &search, bool wordStart) const;
+
+  /*!
+   * @brief Create, populate or drop the full text search indexes depending
+   *        on whether full text search is enabled for this database.
+   *        Called by CDatabaseManager once the database is up to date.
+   */
+  void UpdateFullTextIndexes();
+
+  /*!
+   * @brief Translate a user search string into a full text search expression
+   *        matching at least all texts containing the search string.
+   * @param search The search string as entered by the user.
+   * @param wordStart Whether the search string only has to be found at the
+   *        start of a word.
+   * @param sqlite True for a SQLite FTS5 MATCH expression, false for a
+   *        MySQL boolean mode AGAINST expression.
+   * @return The expression or an empty string if none of the words of the
+   *         search string can be required.
+   */
+  static std::string FormatFullTextSearch(const std::string &search, bool wordStart, bool sqlite);
+
+  /*!
+   * @brief Pick random ids matching a filter without sorting the whole
+   *        table by RANDOM().
+   * @remarks Every matching id is equally likely to be picked. Picks probe
+   *          random ids between the lowest and highest id of the table and
+   *          keep the ones that exist and match. If the matches are too sparse
+   *          for that, the matches are counted and picked by random rank. If
+   *          too many of those are excluded or already picked, the remaining
+   *          ids are picked by reservoir sampling over all matching ids.
+   * @param table The table or view to pick from.
+   * @param idColumn The integer primary key of the table (or the view's base table).
+   * @param filter The join, where and group clauses to apply, order and limit are ignored.
+   * @param count The number of ids to pick.
+   * @param exclude Ids that must not be picked, e.g. those picked before in this session.
+   * @param ids The picked ids in random order, fewer than count if not enough ids match.
+   * @return True if the queries were executed successfully, false otherwise.
+   */
+  bool GetRandomIDs(const std::string &table, const std::string &idColumn, const Filter &filter,
+                    unsigned int count, const std::set<int> &exclude, std::vector<int> &ids);
+  static bool GetRandomIDs(dbiplus::Dataset &ds, const std::string &table, const std::string &idColumn,
+                           const Filter &filter, unsigned int count, const std::set<int> &exclude,
+                           std::vector<int> &ids);
+
+  /*!
+   * @brief Restrict a filter to randomly picked ids, so a limited random
+   *        listing (e.g. a widget) only fetches the rows it shows.
+   * @param filter The filter of the listing, the picked ids are appended to its where clause.
+   * @param count The number of ids to pick.
+   * @return True if the queries were executed successfully, false otherwise.
+   * @sa GetRandomIDs
+   */
+  bool FilterRandomIDs(const std::string &table, const std::string &idColumn, Filter &filter, unsigned int count);
+
   virtual bool GetFilter(CDbUrl &dbUrl, Filter &filter, SortDescription &sorting) { return true; }
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl);
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl, SortDescription &sorting);
@@ -215,7 +296,41 @@ protected:
 
   int GetDBVersion();
 
-  bool BuildSQL(const std::string &strQuery, const Filter &filter, std::string &strSQL);
+  static bool BuildSQL(const std::string &strQuery, const Filter &filter, std::string &strSQL);
+
+  /*! \brief Definition of a full text search index shadowing a library table.
+   The index is keyed by the id of the shadowed table, every column is filled
+   from an SQL expression evaluated against a row of that table.
+   */
+  struct FullTextIndex
+  {
+    std::string name;     ///< name of the index table, e.g. "movie_fts"
+    std::string table;    ///< the shadowed table, e.g. "movie"
+    std::string idColumn; ///< the primary key of the shadowed table, e.g. "idMovie"
+    std::vector<std::pair<std::string, std::string> > columns; ///< column name and SQL expression
+  };
+
+  /* \brief The full text search indexes of this database.
+   */
+  virtual std::vector<FullTextIndex> GetFullTextIndexes() const { return std::vector<FullTextIndex>(); }
+
+  /* \brief Whether the full text search indexes should be maintained and used.
+   */
+  virtual bool IsFullTextSearchEnabled() const { return false; }
+
+  /*! \brief Refresh the full text search entry of a single item.
+   Does nothing if the index is not available.
+   \param index the name of the index.
+   \param id the id of the item in the shadowed table.
+   */
+  void UpdateFullTextEntry(const std::string &index, int id);
+
+  /*! \brief Remove the full text search entry of a single item.
+   Does nothing if the index is not available.
+   \param index the name of the index.
+   \param id the id of the item in the shadowed table.
+   */
+  void DeleteFullTextEntry(const std::string &index, int id);
 
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
@@ -236,4 +351,11 @@ private:
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  std::string GetFullTextInsert(const FullTextIndex &index) const;
+  bool CreateFullTextIndex(const FullTextIndex &index);
+  bool FullTextIndexExists(const std::string &index) const;
+  static bool IsMySQLFullTextWord(const std::string &word, bool wholeWord);
+
+  mutable std::map<std::string, bool> m_fullTextIndexes; ///< cached availability of the full text indexes
 };
@@ -0,0 +1,420 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "dbwrappers/Database.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "music/MusicDatabase.h"
+#include "playlists/SmartPlayList.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/StringUtils.h"
+#include "video/VideoDatabase.h"
+#include "video/VideoInfoTag.h"
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <stdlib.h>
+
+#include "gtest/gtest.h"
+
+TEST(TestFullTextSearch, FormatSQLite)
+{
+  EXPECT_EQ("\"love\"*", CDatabase::FormatFullTextSearch("love", true, true));
+  EXPECT_EQ("\"love\" \"story\"*", CDatabase::FormatFullTextSearch("love story", true, true));
+  EXPECT_EQ("\"love\" \"story\"", CDatabase::FormatFullTextSearch("  love,  story! ", true, true));
+  // a substring may start or end within a word, only the words after a
+  // separator can be required
+  EXPECT_EQ("", CDatabase::FormatFullTextSearch("love", false, true));
+  EXPECT_EQ("\"story\"*", CDatabase::FormatFullTextSearch("love story", false, true));
+  EXPECT_EQ("\"side\" \"of\"*", CDatabase::FormatFullTextSearch("dark side of", false, true));
+  EXPECT_EQ("\"love\"*", CDatabase::FormatFullTextSearch(" love", false, true));
+  // quotes and operators must never reach the MATCH expression
+  EXPECT_EQ("\"rock\" \"n\" \"roll\"*", CDatabase::FormatFullTextSearch("rock'n\"roll", true, true));
+  EXPECT_EQ("\"AND\" \"OR\"*", CDatabase::FormatFullTextSearch("AND OR", true, true));
+  // multi-byte characters are part of a word
+  EXPECT_EQ("\"am\xC3\xA9lie\"*", CDatabase::FormatFullTextSearch("am\xC3\xA9lie", true, true));
+  EXPECT_EQ("", CDatabase::FormatFullTextSearch(" -*- ", true, true));
+}
+
+TEST(TestFullTextSearch, FormatMySQL)
+{
+  EXPECT_EQ("+love*", CDatabase::FormatFullTextSearch("love", true, false));
+  EXPECT_EQ("+love +story*", CDatabase::FormatFullTextSearch("love story", true, false));
+  EXPECT_EQ("+love +story*", CDatabase::FormatFullTextSearch("+love -story", true, false));
+  EXPECT_EQ("+story*", CDatabase::FormatFullTextSearch("love story", false, false));
+  EXPECT_EQ("", CDatabase::FormatFullTextSearch("", true, false));
+  // short words and stopwords aren't indexed, neither are the words a prefix
+  // of a stopword could stand for
+  EXPECT_EQ("+dark +side", CDatabase::FormatFullTextSearch("the dark side of", true, false));
+  EXPECT_EQ("", CDatabase::FormatFullTextSearch("up", true, false));
+  EXPECT_EQ("", CDatabase::FormatFullTextSearch("Wher", true, false));
+  EXPECT_EQ("+love*", CDatabase::FormatFullTextSearch("with love", true, false));
+  EXPECT_EQ("+withe*", CDatabase::FormatFullTextSearch("withe", true, false));
+  EXPECT_EQ("", CDatabase::FormatFullTextSearch("\xC3\xA9t\xC3\xA9", true, false));
+}
+
+class TestVideoFullTextSearch : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_enabled = g_advancedSettings.m_bVideoLibraryFullTextSearch;
+    g_advancedSettings.m_bVideoLibraryFullTextSearch = true;
+
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    ASSERT_TRUE(m_db.Connect("TestVideoFullTextSearch", settings, true));
+    m_db.UpdateFullTextIndexes();
+  }
+
+  void TearDown() override
+  {
+    m_db.Close();
+    XFILE::CFile::Delete("special://temp/TestVideoFullTextSearch.db");
+    g_advancedSettings.m_bVideoLibraryFullTextSearch = m_enabled;
+  }
+
+  // number of movies found by a word prefix search of the given column
+  int Search(const std::string &column, const std::string &search)
+  {
+    std::string fullText = m_db.GetFullTextSubQuery("movie_fts", { column }, search, true);
+    if (fullText.empty())
+      return -1;
+    return atoi(m_db.GetSingleValue("SELECT COUNT(*) FROM movie WHERE idMovie IN (" + fullText + ")").c_str());
+  }
+
+  static CVideoInfoTag MakeMovie(const std::string &title, const std::string &actor, const std::string &tag)
+  {
+    CVideoInfoTag details;
+    details.SetTitle(title);
+    details.SetPlot("A story about " + title);
+    SActorInfo cast;
+    cast.strName = actor;
+    cast.order = 0;
+    details.m_cast.push_back(cast);
+    details.SetTags({ tag });
+    return details;
+  }
+
+  CVideoDatabase m_db;
+  bool m_enabled = false;
+};
+
+TEST_F(TestVideoFullTextSearch, SetDetailsForMovie)
+{
+  // SQLite was built without FTS5
+  if (!m_db.HasFullTextIndex("movie_fts"))
+    return;
+
+  const std::map<std::string, std::string> artwork;
+  CVideoInfoTag details = MakeMovie("Midnight River", "Jane Doe", "Favourite");
+  int idMovie = m_db.SetDetailsForMovie("/movies/Midnight River.mkv", details, artwork);
+  ASSERT_GT(idMovie, 0);
+
+  EXPECT_EQ(1, Search("title", "midn"));
+  EXPECT_EQ(1, Search("plot", "stor"));
+  EXPECT_EQ(1, Search("people", "jane"));
+  EXPECT_EQ(1, Search("tags", "favou"));
+
+  // refreshing the movie replaces its cast and tags
+  details = MakeMovie("Midnight River", "John Roe", "Classic");
+  ASSERT_EQ(idMovie, m_db.SetDetailsForMovie("/movies/Midnight River.mkv", details, artwork, idMovie));
+  EXPECT_EQ(0, Search("people", "jane"));
+  EXPECT_EQ(1, Search("people", "john"));
+  EXPECT_EQ(0, Search("tags", "favou"));
+  EXPECT_EQ(1, Search("tags", "class"));
+
+  m_db.RemoveTagsFromItem(idMovie, MediaTypeMovie);
+  EXPECT_EQ(0, Search("tags", "class"));
+  EXPECT_EQ(1, Search("title", "river"));
+}
+
+// Movies added while the index is disabled get their entries when the
+// database is opened with the index enabled again
+TEST_F(TestVideoFullTextSearch, UpdateFullTextIndexes)
+{
+  // SQLite was built without FTS5
+  if (!m_db.HasFullTextIndex("movie_fts"))
+    return;
+
+  const std::map<std::string, std::string> artwork;
+  CVideoInfoTag details = MakeMovie("Golden Shadow", "Jane Doe", "Favourite");
+  ASSERT_GT(m_db.SetDetailsForMovie("/movies/Golden Shadow.mkv", details, artwork), 0);
+
+  g_advancedSettings.m_bVideoLibraryFullTextSearch = false;
+  details = MakeMovie("Silver Shadow", "John Roe", "Classic");
+  ASSERT_GT(m_db.SetDetailsForMovie("/movies/Silver Shadow.mkv", details, artwork), 0);
+  g_advancedSettings.m_bVideoLibraryFullTextSearch = true;
+
+  EXPECT_EQ(1, Search("title", "shadow"));
+  EXPECT_EQ(0, Search("title", "silver"));
+
+  m_db.UpdateFullTextIndexes();
+  EXPECT_EQ(2, Search("title", "shadow"));
+  EXPECT_EQ(1, Search("title", "silver"));
+  EXPECT_EQ(1, Search("people", "john"));
+}
+
+class TestMusicFullTextSearch : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_enabled = g_advancedSettings.m_bMusicLibraryFullTextSearch;
+    g_advancedSettings.m_bMusicLibraryFullTextSearch = true;
+
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    ASSERT_TRUE(m_db.Connect("TestMusicFullTextSearch", settings, true));
+  }
+
+  void TearDown() override
+  {
+    m_db.Close();
+    XFILE::CFile::Delete("special://temp/TestMusicFullTextSearch.db");
+    g_advancedSettings.m_bMusicLibraryFullTextSearch = m_enabled;
+  }
+
+  // every title is used for a song, an album and an artist
+  void CreateLibrary(const std::vector<std::string> &titles)
+  {
+    m_db.BeginTransaction();
+    ASSERT_TRUE(m_db.ExecuteQuery("INSERT INTO path (idPath, strPath) VALUES (1, '/music/')"));
+    for (size_t i = 0; i < titles.size(); i++)
+    {
+      const int id = static_cast<int>(i) + 1;
+      ASSERT_TRUE(m_db.ExecuteQuery(m_db.PrepareSQL("INSERT INTO artist (idArtist, strArtist) VALUES (NULL, '%s')", titles[i].c_str())));
+      ASSERT_TRUE(m_db.ExecuteQuery(m_db.PrepareSQL("INSERT INTO album (idAlbum, strAlbum, strArtistDisp) VALUES (%i, '%s', 'Artist')", id, titles[i].c_str())));
+      ASSERT_TRUE(m_db.ExecuteQuery(m_db.PrepareSQL("INSERT INTO song (idSong, idAlbum, idPath, strTitle, strArtistDisp, strFileName) "
+                                                    "VALUES (%i, %i, 1, '%s', 'Artist', 'song%i.mp3')", id, id, titles[i].c_str(), id)));
+    }
+    ASSERT_TRUE(m_db.CommitTransaction());
+    m_db.UpdateFullTextIndexes();
+  }
+
+  std::set<std::string> Search(const std::string &search)
+  {
+    CFileItemList items;
+    m_db.Search(search, items);
+    std::set<std::string> paths;
+    for (int i = 0; i < items.Size(); i++)
+      paths.insert(items[i]->GetPath());
+    return paths;
+  }
+
+  int CountSongs(const std::string &rule)
+  {
+    CSmartPlaylist playlist;
+    if (!playlist.LoadFromJson("{ \"type\": \"songs\", \"rules\": { \"and\": [ " + rule + " ] } }"))
+      return -1;
+    std::set<std::string> referencedPlaylists;
+    const std::string where = playlist.GetWhereClause(m_db, referencedPlaylists);
+    return atoi(m_db.GetSingleValue("SELECT COUNT(*) FROM songview WHERE " + where).c_str());
+  }
+
+  CMusicDatabase m_db;
+  bool m_enabled = false;
+};
+
+// The index only narrows down the rows, searches find the same items as
+// without it
+TEST_F(TestMusicFullTextSearch, SameResults)
+{
+  CreateLibrary({ "Dark Side of the Moon", "Darkness", "Hard-rock Hallelujah", "Rock'n'roll Star",
+                  "Love Story", "Lovesong", "Glove", "Don't Stop", "Am\xC3\xA9lie", "Up", "100 Years" });
+
+  // SQLite was built without FTS5
+  if (!m_db.HasFullTextIndex("song_fts"))
+    return;
+
+  const std::vector<std::string> searches = { "love", "ove", "dark side", "side of", "rock", "n'roll", "k'n",
+                                              "am\xC3\xA9", "the", "up", "lo", " story", "100", "don't" };
+  const std::vector<std::string> rules = { "contains", "startswith", "doesnotcontain" };
+
+  std::map<std::string, std::set<std::string>> found;
+  std::map<std::string, int> counts;
+  for (const auto &search : searches)
+  {
+    found[search] = Search(search);
+    for (const auto &rule : rules)
+      counts[search + rule] = CountSongs("{ \"field\": \"title\", \"operator\": \"" + rule + "\", \"value\": \"" + search + "\" }");
+  }
+
+  // a song, an album and an artist each
+  EXPECT_EQ(6u, found["love"].size());
+  EXPECT_EQ(3u, found["dark side"].size());
+  EXPECT_EQ(3, counts["ovecontains"]);
+  EXPECT_EQ(1, counts["side ofcontains"]);
+  EXPECT_EQ(2, counts["lostartswith"]);
+
+  g_advancedSettings.m_bMusicLibraryFullTextSearch = false;
+  ASSERT_FALSE(m_db.HasFullTextIndex("song_fts"));
+  for (const auto &search : searches)
+  {
+    EXPECT_EQ(found[search], Search(search)) << search;
+    for (const auto &rule : rules)
+      EXPECT_EQ(counts[search + rule], CountSongs("{ \"field\": \"title\", \"operator\": \"" + rule + "\", \"value\": \"" + search + "\" }")) << search << " " << rule;
+  }
+}
+
+// Songs and albums added to the library get their entries
+TEST_F(TestMusicFullTextSearch, AddAlbum)
+{
+  CreateLibrary({ "Golden Shadow" });
+
+  // SQLite was built without FTS5
+  if (!m_db.HasFullTextIndex("song_fts"))
+    return;
+
+  CAlbum album;
+  album.strAlbum = "Silver Shadow";
+  album.strArtistDesc = "Jane Doe";
+  album.artistCredits.push_back(CArtistCredit("Jane Doe"));
+  CSong song;
+  song.strTitle = "Silver Shadow";
+  song.strFileName = "/music/silver.mp3";
+  song.strArtistDesc = "Jane Doe";
+  song.artistCredits.push_back(CArtistCredit("Jane Doe"));
+  album.songs.push_back(song);
+  ASSERT_TRUE(m_db.AddAlbum(album));
+
+  EXPECT_EQ(1, atoi(m_db.GetSingleValue("SELECT COUNT(*) FROM song WHERE idSong IN (" +
+                                        m_db.GetFullTextSubQuery("song_fts", { "title" }, "silv", true) + ")").c_str()));
+  EXPECT_EQ(1, atoi(m_db.GetSingleValue("SELECT COUNT(*) FROM album WHERE idAlbum IN (" +
+                                        m_db.GetFullTextSubQuery("album_fts", { "title" }, "silv", true) + ")").c_str()));
+  EXPECT_EQ(2u, Search("shadow").size() - Search("golden").size());
+}
+
+// Compares the search dialog and "contains" rules with and without the index
+// on a library of 100k songs and 20k movies, typing a search word by word
+TEST(TestFullTextSearchBenchmark, DISABLED_Library)
+{
+  static const int NUM_SONGS = 100000;
+  static const int NUM_MOVIES = 20000;
+  static const char* const SYLLABLES[] = { "ka", "lo", "mi", "ne", "ru", "sa", "ti", "vo", "ze", "da", "fi", "gu",
+                                           "ho", "ja", "be", "co", "pe", "qui", "we", "xa" };
+  static const int NUM_SYLLABLES = sizeof(SYLLABLES) / sizeof(SYLLABLES[0]);
+
+  // 8000 words of two or three syllables, picked pseudo randomly
+  unsigned int seed = 42;
+  auto word = [&seed]()
+  {
+    seed = seed * 1103515245 + 12345;
+    unsigned int value = (seed >> 8) % 8000;
+    std::string result = SYLLABLES[value % NUM_SYLLABLES];
+    result += SYLLABLES[(value / NUM_SYLLABLES) % NUM_SYLLABLES];
+    if (value >= 400)
+      result += SYLLABLES[value / 400];
+    return result;
+  };
+  auto words = [&word](int count)
+  {
+    std::string result = word();
+    for (int i = 1; i < count; i++)
+      result += " " + word();
+    return result;
+  };
+
+  const bool musicEnabled = g_advancedSettings.m_bMusicLibraryFullTextSearch;
+  const bool videoEnabled = g_advancedSettings.m_bVideoLibraryFullTextSearch;
+  g_advancedSettings.m_bMusicLibraryFullTextSearch = true;
+  g_advancedSettings.m_bVideoLibraryFullTextSearch = true;
+
+  DatabaseSettings settings;
+  settings.type = "sqlite3";
+  settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+
+  CMusicDatabase music;
+  ASSERT_TRUE(music.Connect("TestFullTextSearchMusic", settings, true));
+  music.BeginTransaction();
+  ASSERT_TRUE(music.ExecuteQuery("INSERT INTO path (idPath, strPath) VALUES (1, '/music/')"));
+  for (int i = 1; i <= NUM_SONGS / 10; i++)
+    ASSERT_TRUE(music.ExecuteQuery(music.PrepareSQL("INSERT INTO album (idAlbum, strAlbum, strArtistDisp) VALUES (%i, '%s', '%s')", i, words(2).c_str(), words(2).c_str())));
+  for (int i = 1; i <= NUM_SONGS; i++)
+    ASSERT_TRUE(music.ExecuteQuery(music.PrepareSQL("INSERT INTO song (idSong, idAlbum, idPath, strTitle, strArtistDisp, strFileName) "
+                                                    "VALUES (%i, %i, 1, '%s', '%s', 'song%i.mp3')", i, 1 + (i - 1) / 10, words(3).c_str(), words(2).c_str(), i)));
+  ASSERT_TRUE(music.CommitTransaction());
+  music.UpdateFullTextIndexes();
+
+  CVideoDatabase video;
+  ASSERT_TRUE(video.Connect("TestFullTextSearchVideo", settings, true));
+  video.BeginTransaction();
+  for (int i = 1; i <= NUM_MOVIES; i++)
+    ASSERT_TRUE(video.ExecuteQuery(video.PrepareSQL("INSERT INTO movie (idMovie, idFile, c%02d, c%02d) VALUES (%i, %i, '%s', '%s')",
+                                                    VIDEODB_ID_TITLE, VIDEODB_ID_PLOT, i, i, words(3).c_str(), words(40).c_str())));
+  ASSERT_TRUE(video.CommitTransaction());
+  video.UpdateFullTextIndexes();
+
+  if (music.HasFullTextIndex("song_fts") && video.HasFullTextIndex("movie_fts"))
+  {
+    // a word and a movie title of the library, typed one character at a time
+    seed = 7;
+    const std::string typed = word();
+    const std::string title = words(2);
+
+    std::map<bool, int64_t> musicUs;
+    std::map<bool, int64_t> movieUs;
+    std::map<bool, std::string> counts;
+    for (bool enabled : { true, false })
+    {
+      g_advancedSettings.m_bMusicLibraryFullTextSearch = enabled;
+      g_advancedSettings.m_bVideoLibraryFullTextSearch = enabled;
+
+      auto start = std::chrono::steady_clock::now();
+      for (size_t length = 1; length <= typed.size(); length++)
+      {
+        CFileItemList items;
+        music.Search(typed.substr(0, length), items);
+        counts[enabled] += StringUtils::Format("%i ", items.Size());
+      }
+      musicUs[enabled] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+      // GetMoviesByName() with a title of two words, as a contains rule
+      start = std::chrono::steady_clock::now();
+      for (size_t length = 1; length <= title.size(); length++)
+      {
+        const std::string search = title.substr(0, length);
+        std::string where = video.PrepareSQL("movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE, search.c_str());
+        std::string fullText = video.GetFullTextSubQuery("movie_fts", { "title" }, search, false);
+        if (!fullText.empty())
+          where = "movie.idMovie IN (" + fullText + ") AND " + where;
+        counts[enabled] += video.GetSingleValue("SELECT COUNT(*) FROM movie WHERE " + where) + " ";
+      }
+      movieUs[enabled] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+    EXPECT_EQ(counts[false], counts[true]);
+
+    RecordProperty("MusicSearchLikeUs", static_cast<int>(musicUs[false]));
+    RecordProperty("MusicSearchFullTextUs", static_cast<int>(musicUs[true]));
+    RecordProperty("MovieTitleLikeUs", static_cast<int>(movieUs[false]));
+    RecordProperty("MovieTitleFullTextUs", static_cast<int>(movieUs[true]));
+  }
+
+  music.Close();
+  video.Close();
+  XFILE::CFile::Delete("special://temp/TestFullTextSearchMusic.db");
+  XFILE::CFile::Delete("special://temp/TestFullTextSearchVideo.db");
+  g_advancedSettings.m_bMusicLibraryFullTextSearch = musicEnabled;
+  g_advancedSettings.m_bVideoLibraryFullTextSearch = videoEnabled;
+}
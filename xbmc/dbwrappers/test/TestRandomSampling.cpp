@@ -0,0 +1,254 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/Database.h"
+#include "dbwrappers/dataset.h"
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "music/MusicDatabase.h"
+#include "settings/AdvancedSettings.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class TestRandomSampling : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    file = XBMC_CREATETEMPFILE(".db");
+    ASSERT_TRUE(file != nullptr);
+    std::string path = XBMC_TEMPFILEPATH(file);
+    file->Close();
+
+    db.setHostName(URIUtils::GetDirectory(path).c_str());
+    db.setDatabase(URIUtils::GetFileName(path).c_str());
+    ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+    ds.reset(db.CreateDataset());
+  }
+
+  void TearDown() override
+  {
+    ds.reset();
+    db.disconnect();
+    XBMC_DELETETEMPFILE(file);
+  }
+
+  // every third song is a rock song, ids have a gap of 1000 after every 1000 songs
+  void CreateLibrary(int songs)
+  {
+    ds->exec("CREATE TABLE song (idSong INTEGER PRIMARY KEY, strGenres TEXT, iRating INTEGER)");
+    db.start_transaction();
+    for (int i = 0; i < songs; i++)
+    {
+      const int id = 1 + i + (i / 1000) * 1000;
+      ds->exec(StringUtils::Format("INSERT INTO song VALUES (%i, '%s', %i)", id, i % 3 == 0 ? "Rock" : "Pop", i % 10));
+    }
+    db.commit_transaction();
+  }
+
+  XFILE::CFile *file = nullptr;
+  dbiplus::SqliteDatabase db;
+  std::unique_ptr<dbiplus::Dataset> ds;
+};
+
+TEST_F(TestRandomSampling, Filter)
+{
+  CreateLibrary(10000);
+
+  std::vector<int> ids;
+  ASSERT_TRUE(CDatabase::GetRandomIDs(*ds, "song", "song.idSong", CDatabase::Filter("strGenres = 'Rock'"), 50, std::set<int>(), ids));
+  ASSERT_EQ(50u, ids.size());
+
+  std::set<int> unique(ids.begin(), ids.end());
+  EXPECT_EQ(50u, unique.size());
+  for (int id : ids)
+  {
+    ds->query(StringUtils::Format("SELECT strGenres FROM song WHERE idSong = %i", id));
+    ASSERT_EQ(1, ds->num_rows());
+    EXPECT_EQ("Rock", ds->fv(0).get_asString());
+    ds->close();
+  }
+
+  // nothing matches
+  ASSERT_TRUE(CDatabase::GetRandomIDs(*ds, "song", "song.idSong", CDatabase::Filter("strGenres = 'Jazz'"), 5, std::set<int>(), ids));
+  EXPECT_TRUE(ids.empty());
+
+  // fewer matches than requested
+  ASSERT_TRUE(CDatabase::GetRandomIDs(*ds, "song", "song.idSong", CDatabase::Filter("idSong < 5"), 10, std::set<int>(), ids));
+  EXPECT_EQ(4u, ids.size());
+}
+
+// Picking one song after the other while excluding the ones picked before
+// has to go through the whole filtered library without repeats
+TEST_F(TestRandomSampling, Exclude)
+{
+  CreateLibrary(3000);
+
+  std::set<int> picked;
+  std::vector<int> ids;
+  for (int i = 0; i < 1000; i++)
+  {
+    ASSERT_TRUE(CDatabase::GetRandomIDs(*ds, "song", "song.idSong", CDatabase::Filter("strGenres = 'Rock'"), 1, picked, ids));
+    ASSERT_EQ(1u, ids.size());
+    EXPECT_TRUE(picked.insert(ids.front()).second);
+  }
+
+  ASSERT_TRUE(CDatabase::GetRandomIDs(*ds, "song", "song.idSong", CDatabase::Filter("strGenres = 'Rock'"), 1, picked, ids));
+  EXPECT_TRUE(ids.empty());
+}
+
+class TestRandomSamplingSongview : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    ASSERT_TRUE(m_db.Connect("TestRandomSampling", settings, true));
+  }
+
+  void TearDown() override
+  {
+    m_db.Close();
+    XFILE::CFile::Delete("special://temp/TestRandomSampling.db");
+  }
+
+  CMusicDatabase m_db;
+};
+
+// Every rock song follows a run of pop songs that gets longer with each rock
+// song, probing for the next match after a random id would pick the last rock
+// songs far more often than the first ones
+TEST_F(TestRandomSamplingSongview, Distribution)
+{
+  static const int ROCK_SONGS = 20;
+  static const int PICKS = 2000;
+
+  m_db.BeginTransaction();
+  ASSERT_TRUE(m_db.ExecuteQuery("INSERT INTO path (idPath, strPath) VALUES (1, '/music/')"));
+  ASSERT_TRUE(m_db.ExecuteQuery("INSERT INTO album (idAlbum, strAlbum) VALUES (1, 'Album')"));
+  std::set<int> rockSongs;
+  int idSong = 1;
+  for (int i = 0; i < ROCK_SONGS; i++)
+  {
+    for (int j = 0; j < 5 * i; j++, idSong++)
+      ASSERT_TRUE(m_db.ExecuteQuery(StringUtils::Format("INSERT INTO song (idSong, idAlbum, idPath, strGenres, strTitle, strFileName) "
+                                                        "VALUES (%i, 1, 1, 'Pop', 'Pop', 'pop%i.mp3')", idSong, idSong)));
+    ASSERT_TRUE(m_db.ExecuteQuery(StringUtils::Format("INSERT INTO song (idSong, idAlbum, idPath, strGenres, strTitle, strFileName) "
+                                                      "VALUES (%i, 1, 1, 'Rock', 'Rock', 'rock%i.mp3')", idSong, idSong)));
+    rockSongs.insert(idSong++);
+  }
+  ASSERT_TRUE(m_db.CommitTransaction());
+
+  std::map<int, int> picks;
+  std::vector<int> ids;
+  for (int i = 0; i < PICKS; i++)
+  {
+    ASSERT_TRUE(m_db.GetRandomIDs("songview", "songview.idSong", CDatabase::Filter("songview.strGenres = 'Rock'"), 1, std::set<int>(), ids));
+    ASSERT_EQ(1u, ids.size());
+    ASSERT_TRUE(rockSongs.find(ids.front()) != rockSongs.end());
+    picks[ids.front()]++;
+  }
+  EXPECT_EQ(static_cast<size_t>(ROCK_SONGS), picks.size());
+
+  // with 19 degrees of freedom a uniform pick exceeds 55 by chance with a
+  // probability of 2.3e-5, the biased pick scores in the thousands
+  const double expected = static_cast<double>(PICKS) / ROCK_SONGS;
+  double chiSquare = 0.0;
+  for (const auto &pick : picks)
+    chiSquare += (pick.second - expected) * (pick.second - expected) / expected;
+  EXPECT_LT(chiSquare, 55.0);
+}
+
+// A limited random listing (e.g. a random albums widget) only fetches the
+// albums picked for it
+TEST_F(TestRandomSamplingSongview, FilterRandomIDs)
+{
+  m_db.BeginTransaction();
+  for (int i = 1; i <= 30; i++)
+    ASSERT_TRUE(m_db.ExecuteQuery(StringUtils::Format("INSERT INTO album (idAlbum, strAlbum) VALUES (%i, '%s %i')",
+                                                      i, i % 3 == 0 ? "Rock" : "Pop", i)));
+  ASSERT_TRUE(m_db.CommitTransaction());
+
+  CDatabase::Filter filter("albumview.strAlbum LIKE 'Rock%'");
+  ASSERT_TRUE(m_db.FilterRandomIDs("albumview", "albumview.idAlbum", filter, 5));
+  EXPECT_EQ("5", m_db.GetSingleValue("SELECT COUNT(1) FROM albumview WHERE " + filter.where));
+  EXPECT_EQ("5", m_db.GetSingleValue("SELECT COUNT(1) FROM albumview WHERE " + filter.where + " AND strAlbum LIKE 'Rock%'"));
+
+  filter = CDatabase::Filter("albumview.strAlbum LIKE 'Jazz%'");
+  ASSERT_TRUE(m_db.FilterRandomIDs("albumview", "albumview.idAlbum", filter, 5));
+  EXPECT_EQ("0", m_db.GetSingleValue("SELECT COUNT(1) FROM albumview WHERE " + filter.where));
+}
+
+// Compares picking party mode songs and random widget items with the
+// ORDER BY RANDOM() queries used before on a library of 200k songs
+TEST_F(TestRandomSampling, DISABLED_Benchmark)
+{
+  static const int NUM_SONGS = 200000;
+  static const int NUM_PICKS = 100;
+  CreateLibrary(NUM_SONGS);
+
+  const std::string filter = "strGenres = 'Rock' AND iRating > 2";
+  std::set<int> picked;
+  std::vector<int> ids;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < NUM_PICKS; i++)
+  {
+    ds->query("SELECT idSong FROM song WHERE " + filter + " ORDER BY RANDOM() LIMIT 1");
+    ds->close();
+  }
+  const auto orderByRandomUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < NUM_PICKS; i++)
+  {
+    ASSERT_TRUE(CDatabase::GetRandomIDs(*ds, "song", "song.idSong", CDatabase::Filter(filter), 1, picked, ids));
+    ASSERT_EQ(1u, ids.size());
+    picked.insert(ids.front());
+  }
+  const auto sampledUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  ds->query("SELECT idSong FROM song WHERE " + filter + " ORDER BY RANDOM() LIMIT 25");
+  ds->close();
+  const auto widgetOrderByRandomUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(CDatabase::GetRandomIDs(*ds, "song", "song.idSong", CDatabase::Filter(filter), 25, std::set<int>(), ids));
+  const auto widgetSampledUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(25u, ids.size());
+
+  RecordProperty("PartyModeOrderByRandomUs", static_cast<int>(orderByRandomUs));
+  RecordProperty("PartyModeSampledUs", static_cast<int>(sampledUs));
+  RecordProperty("WidgetOrderByRandomUs", static_cast<int>(widgetOrderByRandomUs));
+  RecordProperty("WidgetSampledUs", static_cast<int>(widgetSampledUs));
+}
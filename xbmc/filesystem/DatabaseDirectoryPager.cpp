@@ -0,0 +1,143 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DatabaseDirectoryPager.h"
+
+#include <algorithm>
+
+#include "LibraryDirectory.h"
+#include "MusicDatabaseDirectory.h"
+#include "URL.h"
+#include "VideoDatabaseDirectory.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/URIUtils.h"
+
+using namespace XFILE;
+
+// pages fetched from the database at once
+#define PAGES_PER_FETCH 4
+// number of directories read ahead at the same time
+#define MAX_CURSORS 4
+// how long pages read ahead are served, in ms
+#define CURSOR_LIFETIME 30000
+
+bool CDatabaseDirectoryPager::Cursor::Matches(const std::string& strPath, const SortDescription& description, int from, int count) const
+{
+  if (path != strPath ||
+      sorting.sortBy != description.sortBy ||
+      sorting.sortOrder != description.sortOrder ||
+      sorting.sortAttributes != description.sortAttributes)
+    return false;
+
+  // the page must lie within the items read, or the items must reach the end
+  const int end = start + static_cast<int>(items.size());
+  return from >= start && (from + count <= end || end >= total);
+}
+
+bool CDatabaseDirectoryPager::GetPage(const std::string& strPath, const SortDescription& sorting, int start, int count, CFileItemList& items, int& total)
+{
+  if (start < 0 || count <= 0)
+    return false;
+
+  CSingleLock lock(m_critSection);
+  const unsigned int now = XbmcThreads::SystemClockMillis();
+  m_cursors.erase(std::remove_if(m_cursors.begin(), m_cursors.end(),
+                                 [now](const Cursor& cursor) { return now - cursor.lastUsed > CURSOR_LIFETIME; }),
+                  m_cursors.end());
+
+  auto cursor = std::find_if(m_cursors.begin(), m_cursors.end(),
+                             [&](const Cursor& c) { return c.Matches(strPath, sorting, start, count); });
+  if (cursor == m_cursors.end())
+  {
+    // don't block other clients while the database is busy
+    lock.Leave();
+    const std::string dbPath = GetDatabasePath(strPath);
+    if (dbPath.empty())
+      return false;
+
+    Cursor fetched;
+    fetched.path = strPath;
+    fetched.sorting = sorting;
+    if (!Fetch(dbPath, sorting, start, count, fetched))
+      return false;
+    lock.Enter();
+
+    if (m_cursors.size() >= MAX_CURSORS)
+      m_cursors.erase(std::min_element(m_cursors.begin(), m_cursors.end(),
+                                       [now](const Cursor& a, const Cursor& b) { return now - a.lastUsed > now - b.lastUsed; }));
+    m_cursors.push_back(std::move(fetched));
+    cursor = m_cursors.end() - 1;
+  }
+
+  cursor->lastUsed = now;
+  items.SetPath(cursor->listPath);
+  items.SetLabel(cursor->label);
+  const size_t first = static_cast<size_t>(start - cursor->start);
+  const size_t last = std::min(first + count, cursor->items.size());
+  for (size_t i = first; i < last; ++i)
+    items.Add(CFileItemPtr(new CFileItem(*cursor->items[i])));
+  total = cursor->total;
+  return true;
+}
+
+void CDatabaseDirectoryPager::Clear()
+{
+  CSingleLock lock(m_critSection);
+  m_cursors.clear();
+}
+
+std::string CDatabaseDirectoryPager::GetDatabasePath(const std::string& strPath, const std::string& mask /* = "" */)
+{
+  if (URIUtils::IsLibraryFolder(strPath))
+  {
+    CLibraryDirectory library;
+    return GetDatabasePath(library.GetFolderPath(CURL(strPath)), mask);
+  }
+  // music library directories allow all items
+  if (URIUtils::IsMusicDb(strPath) || (URIUtils::IsVideoDb(strPath) && mask.empty()))
+    return strPath;
+  return "";
+}
+
+bool CDatabaseDirectoryPager::Fetch(const std::string& dbPath, const SortDescription& sorting, int start, int count, Cursor& cursor)
+{
+  SortDescription window(sorting);
+  window.limitStart = start;
+  window.limitEnd = start + count * PAGES_PER_FETCH;
+
+  CFileItemList items;
+  bool result;
+  if (URIUtils::IsMusicDb(dbPath))
+    result = CMusicDatabaseDirectory::GetDirectoryPage(dbPath, window, items);
+  else
+    result = CVideoDatabaseDirectory::GetDirectoryPage(dbPath, window, items);
+  if (!result)
+    return false;
+
+  cursor.listPath = items.GetPath();
+  cursor.label = items.GetLabel();
+  cursor.start = start;
+  cursor.total = static_cast<int>(items.GetProperty("total").asInteger(start + items.Size()));
+  cursor.items.reserve(items.Size());
+  for (int i = 0; i < items.Size(); ++i)
+    cursor.items.push_back(items.Get(i));
+  return true;
+}
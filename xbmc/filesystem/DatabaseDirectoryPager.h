@@ -0,0 +1,90 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include "FileItem.h"
+#include "threads/CriticalSection.h"
+#include "utils/SortUtils.h"
+
+namespace XFILE
+{
+  /*!
+   \brief Serves pages of music and video library directories to clients
+   browsing them page by page (UPnP, JSON-RPC).
+
+   The database sorts and limits the directory, so only the items around the
+   requested page are created. Each fetch reads a few pages ahead and keeps
+   them for a short while, so a client walking through a directory costs one
+   query every few pages.
+   */
+  class CDatabaseDirectoryPager
+  {
+  public:
+    CDatabaseDirectoryPager() = default;
+
+    /*!
+     \brief get a page of a directory
+     \param strPath musicdb://, videodb:// or library:// folder path of the directory
+     \param sorting how to sort the directory, its limits are ignored
+     \param start index of the first item of the page
+     \param count number of items of the page
+     \param items [out] the items of the page
+     \param total [out] number of items of the whole directory
+     \return false if the directory can't be paged, the caller should get all of it then
+     */
+    bool GetPage(const std::string& strPath, const SortDescription& sorting, int start, int count, CFileItemList& items, int& total);
+
+    //! forget the pages read ahead, e.g. after the library changed
+    void Clear();
+
+    /*!
+     \brief get the database path a directory is read from
+     \param strPath musicdb://, videodb:// or library:// path of the directory
+     \param mask extension mask the full listing would be fetched with. It drops
+     video library items with other paths (e.g. plugin:// entries) from the full
+     listing but not from a page, so such directories can't be paged.
+     \return the musicdb:// or videodb:// path, empty if the directory can't be paged
+     */
+    static std::string GetDatabasePath(const std::string& strPath, const std::string& mask = "");
+
+  private:
+    struct Cursor
+    {
+      std::string path;
+      SortDescription sorting;
+      std::string listPath;
+      std::string label;
+      int start = 0;
+      int total = 0;
+      std::vector<CFileItemPtr> items;
+      unsigned int lastUsed = 0;
+
+      bool Matches(const std::string& strPath, const SortDescription& description, int from, int count) const;
+    };
+
+    static bool Fetch(const std::string& dbPath, const SortDescription& sorting, int start, int count, Cursor& cursor);
+
+    CCriticalSection m_critSection;
+    std::vector<Cursor> m_cursors;
+  };
+}
@@ -106,6 +106,7 @@ CFileCache::CFileCache(const unsigned int flags)
   , m_forwardCacheSize(0)
   , m_fileSize(0)
   , m_flags(flags)
+  , m_passThrough(false)
 {
 }
 
@@ -116,6 +117,8 @@ CFileCache::CFileCache(CCacheStrategy *pCache, bool bDeleteCache /* = true */)
   , m_writeRate(0)
   , m_writeRateActual(0)
   , m_forwardCacheSize(0)
+  , m_flags(0)
+  , m_passThrough(false)
 {
   m_pCache = pCache;
   m_bDeleteCache = bDeleteCache;
@@ -177,6 +180,16 @@ bool CFileCache::Open(const CURL& url)
   m_chunkSize = CFile::GetChunkSize(m_source.GetChunkSize(), READ_CACHE_CHUNK_SIZE);
   m_fileSize = m_source.GetLength();
 
+  // a local file reading ahead on its own gains nothing from another copy of
+  // its data, it is read straight into the buffers of the caller instead
+  if (!m_pCache && m_source.IoControl(IOCTRL_READ_AHEAD, NULL) == 1)
+  {
+    CLog::Log(LOGDEBUG, "CFileCache::Open - source reads ahead, not caching <%s>", url.GetRedacted().c_str());
+    m_passThrough = true;
+    m_readPos = 0;
+    return true;
+  }
+
   if (!m_pCache)
   {
     if (g_advancedSettings.m_cacheMemSize == 0)
@@ -439,6 +452,14 @@ int CFileCache::Stat(const CURL& url, struct __stat64* buffer)
 ssize_t CFileCache::Read(void* lpBuf, size_t uiBufSize)
 {
   CSingleLock lock(m_sync);
+  if (m_passThrough)
+  {
+    const ssize_t iRead = m_source.Read(lpBuf, uiBufSize);
+    if (iRead > 0)
+      m_readPos += iRead;
+    return iRead;
+  }
+
   if (!m_pCache)
   {
     CLog::Log(LOGERROR,"%s - sanity failed. no cache strategy!", __FUNCTION__);
@@ -484,6 +505,14 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
 {
   CSingleLock lock(m_sync);
 
+  if (m_passThrough)
+  {
+    const int64_t iPos = m_source.Seek(iFilePosition, iWhence);
+    if (iPos >= 0)
+      m_readPos = iPos;
+    return iPos;
+  }
+
   if (!m_pCache)
   {
     CLog::Log(LOGERROR,"%s - sanity failed. no cache strategy!", __FUNCTION__);
@@ -546,6 +575,7 @@ void CFileCache::Close()
     m_pCache->Close();
 
   m_source.Close();
+  m_passThrough = false;
 }
 
 int64_t CFileCache::GetPosition()
@@ -555,6 +585,9 @@ int64_t CFileCache::GetPosition()
 
 int64_t CFileCache::GetLength()
 {
+  if (m_passThrough)
+    return m_source.GetLength();
+
   return m_fileSize;
 }
 
@@ -576,6 +609,10 @@ const std::string CFileCache::GetProperty(XFILE::FileProperty type, const std::s
 
 int CFileCache::IoControl(EIoControl request, void* param)
 {
+  // without a cache of our own the player mustn't wait for it to fill
+  if (m_passThrough && request == IOCTRL_CACHE_STATUS)
+    return -1;
+
   if (request == IOCTRL_CACHE_STATUS)
   {
     SCacheStatus* status = (SCacheStatus*)param;
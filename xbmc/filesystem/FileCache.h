@@ -84,6 +84,7 @@ namespace XFILE
     int64_t m_forwardCacheSize;
     std::atomic<int64_t> m_fileSize;
     unsigned int m_flags;
+    bool m_passThrough; //!< the source reads ahead on its own, read it directly
     CCriticalSection m_sync;
   };
 
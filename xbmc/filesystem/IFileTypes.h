@@ -73,6 +73,7 @@ typedef enum {
   IOCTRL_CACHE_SETRATE = 4,  /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE     = 8,  /**< CFileCache */
   IOCTRL_SET_RETRY     = 16, /**< Enable/disable retry within the protocol handler (if supported) */
+  IOCTRL_READ_AHEAD    = 32, /**< return 1 if the file reads ahead on its own and doesn't need to be cached */
 } EIoControl;
 
 enum CURLOPTIONTYPE
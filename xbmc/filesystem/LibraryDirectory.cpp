@@ -159,6 +159,23 @@ TiXmlElement *CLibraryDirectory::LoadXML(const std::string &xmlFile)
   return nullptr;
 }
 
+std::string CLibraryDirectory::GetFolderPath(const CURL& url)
+{
+  std::string libNode = GetNode(url);
+  if (!URIUtils::HasExtension(libNode, ".xml"))
+    return "";
+
+  TiXmlElement *node = LoadXML(libNode);
+  if (!node || XMLUtils::GetAttribute(node, "type") != "folder")
+    return "";
+
+  std::string path;
+  XMLUtils::GetPath(node, "path", path);
+  if (!path.empty())
+    URIUtils::AddSlashAtEnd(path);
+  return path;
+}
+
 bool CLibraryDirectory::Exists(const CURL& url)
 {
   return !GetNode(url).empty();
@@ -32,6 +32,12 @@ namespace XFILE
     bool GetDirectory(const CURL& url, CFileItemList &items) override;
     bool Exists(const CURL& url) override;
     bool AllowAll() const override { return true; }
+
+    /*! \brief get the path a folder node points to
+     \param url the library:// path of the node
+     \return the path of the folder, empty if the node is no folder node
+     */
+    std::string GetFolderPath(const CURL& url);
   private:
     /*! \brief parse the given path and return the node corresponding to this path
      \param path the library:// path to parse
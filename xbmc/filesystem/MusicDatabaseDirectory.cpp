@@ -49,6 +49,31 @@ bool CMusicDatabaseDirectory::GetDirectory(const CURL& url, CFileItemList &items
     return false;
 
   bool bResult = pNode->GetChilds(items);
+  FinalizeItems(items);
+  items.SetLabel(pNode->GetLocalizedName());
+
+  return bResult;
+}
+
+bool CMusicDatabaseDirectory::GetDirectoryPage(const std::string& strPath, const SortDescription& sorting, CFileItemList &items)
+{
+  std::string path = CLegacyPathTranslation::TranslateMusicDbPath(strPath);
+  items.SetPath(path);
+  items.m_dwSize = -1;  // No size
+
+  std::unique_ptr<CDirectoryNode> pNode(CDirectoryNode::ParseURL(path));
+
+  if (!pNode.get() || !pNode->GetChildsPage(items, sorting))
+    return false;
+
+  FinalizeItems(items);
+  items.SetLabel(pNode->GetLocalizedName());
+
+  return true;
+}
+
+void CMusicDatabaseDirectory::FinalizeItems(CFileItemList &items)
+{
   for (int i=0;i<items.Size();++i)
   {
     CFileItemPtr item = items[i];
@@ -59,9 +84,6 @@ bool CMusicDatabaseDirectory::GetDirectory(const CURL& url, CFileItemList &items
         item->SetIconImage(strImage);
     }
   }
-  items.SetLabel(pNode->GetLocalizedName());
-
-  return bResult;
 }
 
 NODE_TYPE CMusicDatabaseDirectory::GetDirectoryChildType(const std::string& strPath)
@@ -31,6 +31,15 @@ namespace XFILE
     CMusicDatabaseDirectory(void);
     ~CMusicDatabaseDirectory(void) override;
     bool GetDirectory(const CURL& url, CFileItemList &items) override;
+
+    /*!
+     \brief Get a page of a directory, sorted and limited by the database
+     \param strPath the directory
+     \param sorting how to sort the whole directory and which of its items to get
+     \param items [out] the items of the page, the "total" property holding the size of the directory
+     \return false if the directory can't be fetched by page or on error
+     */
+    static bool GetDirectoryPage(const std::string& strPath, const SortDescription& sorting, CFileItemList &items);
     bool AllowAll() const override { return true; }
     bool Exists(const CURL& url) override;
     static MUSICDATABASEDIRECTORY::NODE_TYPE GetDirectoryChildType(const std::string& strPath);
@@ -43,5 +52,8 @@ namespace XFILE
     bool ContainsSongs(const std::string &path);
     static bool CanCache(const std::string& strPath);
     static std::string GetIcon(const std::string& strDirectory);
+
+  private:
+    static void FinalizeItems(CFileItemList &items);
   };
 }
@@ -192,6 +192,11 @@ bool CDirectoryNode::GetContent(CFileItemList& items) const
   return false;
 }
 
+bool CDirectoryNode::GetContentPage(CFileItemList& items, const SortDescription& sorting) const
+{
+  return false;
+}
+
 //  Creates a musicdb url
 std::string CDirectoryNode::BuildPath() const
 {
@@ -279,6 +284,24 @@ bool CDirectoryNode::GetChilds(CFileItemList& items)
 }
 
 
+bool CDirectoryNode::GetChildsPage(CFileItemList& items, const SortDescription& sorting)
+{
+  std::unique_ptr<CDirectoryNode> pNode(CDirectoryNode::CreateNode(GetChildType(), "", this));
+
+  bool bSuccess = false;
+  if (pNode.get())
+  {
+    pNode->m_options = m_options;
+    bSuccess = pNode->GetContentPage(items, sorting);
+    if (!bSuccess)
+      items.Clear();
+
+    pNode->RemoveParent();
+  }
+
+  return bSuccess;
+}
+
 bool CDirectoryNode::CanCache() const
 {
   // JM: No need to cache these views, as caching is added in the mediawindow baseclass for anything that takes
@@ -22,6 +22,7 @@
 #include "utils/UrlOptions.h"
 
 class CFileItemList;
+struct SortDescription;
 
 namespace XFILE
 {
@@ -71,6 +72,14 @@ namespace XFILE
       NODE_TYPE GetType() const;
 
       bool GetChilds(CFileItemList& items);
+
+      /*!
+       \brief Get a page of the children sorted by the database
+       \param items [out] the children within the limits of the sort description
+       \param sorting how to sort all children and which of them to get
+       \return false if the children can't be fetched by page or on error
+       */
+      bool GetChildsPage(CFileItemList& items, const SortDescription& sorting);
       virtual NODE_TYPE GetChildType() const;
       virtual std::string GetLocalizedName() const;
 
@@ -91,6 +100,7 @@ namespace XFILE
       void RemoveParent();
 
       virtual bool GetContent(CFileItemList& items) const;
+      virtual bool GetContentPage(CFileItemList& items, const SortDescription& sorting) const;
 
     private:
       NODE_TYPE m_Type;
@@ -47,6 +47,11 @@ std::string CDirectoryNodeAlbum::GetLocalizedName() const
 }
 
 bool CDirectoryNodeAlbum::GetContent(CFileItemList& items) const
+{
+  return GetContentPage(items, SortDescription());
+}
+
+bool CDirectoryNodeAlbum::GetContentPage(CFileItemList& items, const SortDescription& sorting) const
 {
   CMusicDatabase musicdatabase;
   if (!musicdatabase.Open())
@@ -55,7 +60,7 @@ bool CDirectoryNodeAlbum::GetContent(CFileItemList& items) const
   CQueryParams params;
   CollectQueryParams(params);
 
-  bool bSuccess=musicdatabase.GetAlbumsNav(BuildPath(), items, params.GetGenreId(), params.GetArtistId());
+  bool bSuccess=musicdatabase.GetAlbumsNav(BuildPath(), items, params.GetGenreId(), params.GetArtistId(), CDatabase::Filter(), sorting);
 
   musicdatabase.Close();
 
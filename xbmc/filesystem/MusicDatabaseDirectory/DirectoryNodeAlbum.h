@@ -32,6 +32,7 @@ namespace XFILE
     protected:
       NODE_TYPE GetChildType() const override;
       bool GetContent(CFileItemList& items) const override;
+      bool GetContentPage(CFileItemList& items, const SortDescription& sorting) const override;
       std::string GetLocalizedName() const override;
     };
   }
@@ -49,6 +49,11 @@ std::string CDirectoryNodeArtist::GetLocalizedName() const
 }
 
 bool CDirectoryNodeArtist::GetContent(CFileItemList& items) const
+{
+  return GetContentPage(items, SortDescription());
+}
+
+bool CDirectoryNodeArtist::GetContentPage(CFileItemList& items, const SortDescription& sorting) const
 {
   CMusicDatabase musicdatabase;
   if (!musicdatabase.Open())
@@ -57,7 +62,7 @@ bool CDirectoryNodeArtist::GetContent(CFileItemList& items) const
   CQueryParams params;
   CollectQueryParams(params);
 
-  bool bSuccess = musicdatabase.GetArtistsNav(BuildPath(), items, !CServiceBroker::GetSettings().GetBool(CSettings::SETTING_MUSICLIBRARY_SHOWCOMPILATIONARTISTS), params.GetGenreId());
+  bool bSuccess = musicdatabase.GetArtistsNav(BuildPath(), items, !CServiceBroker::GetSettings().GetBool(CSettings::SETTING_MUSICLIBRARY_SHOWCOMPILATIONARTISTS), params.GetGenreId(), -1, -1, CDatabase::Filter(), sorting);
 
   musicdatabase.Close();
 
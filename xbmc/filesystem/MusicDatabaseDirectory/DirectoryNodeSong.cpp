@@ -31,6 +31,11 @@ CDirectoryNodeSong::CDirectoryNodeSong(const std::string& strName, CDirectoryNod
 }
 
 bool CDirectoryNodeSong::GetContent(CFileItemList& items) const
+{
+  return GetContentPage(items, SortDescription());
+}
+
+bool CDirectoryNodeSong::GetContentPage(CFileItemList& items, const SortDescription& sorting) const
 {
   CMusicDatabase musicdatabase;
   if (!musicdatabase.Open())
@@ -40,7 +45,7 @@ bool CDirectoryNodeSong::GetContent(CFileItemList& items) const
   CollectQueryParams(params);
 
   std::string strBaseDir=BuildPath();
-  bool bSuccess=musicdatabase.GetSongsNav(strBaseDir, items, params.GetGenreId(), params.GetArtistId(), params.GetAlbumId());
+  bool bSuccess=musicdatabase.GetSongsNav(strBaseDir, items, params.GetGenreId(), params.GetArtistId(), params.GetAlbumId(), sorting);
 
   musicdatabase.Close();
 
@@ -31,6 +31,7 @@ namespace XFILE
       CDirectoryNodeSong(const std::string& strEntryName, CDirectoryNode* pParent);
     protected:
       bool GetContent(CFileItemList& items) const override;
+      bool GetContentPage(CFileItemList& items, const SortDescription& sorting) const override;
     };
   }
 }
@@ -26,15 +26,59 @@
 #include "profiles/ProfilesManager.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
+#include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 
 #include <cassert>
+#include <unordered_map>
 #ifdef TARGET_POSIX
 #include <dirent.h>
-#include "utils/StringUtils.h"
 #endif
 
+// translations are forgotten all at once when there are more of them, most
+// lookups are for a few dozen paths below special://home, special://temp and
+// the profile folders
+#define TRANSLATION_CACHE_SIZE 1024
+
+namespace
+{
+
+// Translations of special:// paths that only depend on the folders set with
+// CSpecialProtocol::SetPath(). The roots mapped to settings, the profile
+// manager or the skin are translated on each call.
+struct TranslationCache
+{
+  CCriticalSection section;
+  std::unordered_map<std::string, std::string> paths;
+  unsigned int generation = 0; // bumped by each SetPath()
+};
+
+TranslationCache& GetTranslationCache()
+{
+  static TranslationCache cache;
+  return cache;
+}
+
+bool IsFixedRoot(const std::string &root)
+{
+  return root == "xbmc" ||
+         root == "xbmcbin" ||
+         root == "xbmcbinaddons" ||
+         root == "xbmcaltbinaddons" ||
+         root == "home" ||
+         root == "envhome" ||
+         root == "userhome" ||
+         root == "temp" ||
+         root == "profile" ||
+         root == "masterprofile" ||
+         root == "frameworks" ||
+         root == "logpath";
+}
+
+}
+
 const CProfilesManager *CSpecialProtocol::m_profileManager = nullptr;
 
 void CSpecialProtocol::RegisterProfileManager(const CProfilesManager &profileManager)
@@ -115,13 +159,37 @@ bool CSpecialProtocol::ComparePath(const std::string &path1, const std::string &
 
 std::string CSpecialProtocol::TranslatePath(const std::string &path)
 {
-  CURL url(path);
-  // check for special-protocol, if not, return
-  if (!url.IsProtocol("special"))
-  {
+  // check for special-protocol, if not, return without parsing the path
+  const size_t prefixLength = sizeof("special://") - 1;
+  if (!StringUtils::StartsWithNoCase(path, "special://"))
     return path;
+
+  const size_t rootEnd = path.find('/', prefixLength);
+  const bool cacheable = IsFixedRoot(path.substr(prefixLength, rootEnd == std::string::npos ? std::string::npos : rootEnd - prefixLength));
+  TranslationCache &cache = GetTranslationCache();
+  unsigned int generation = 0;
+  if (cacheable)
+  {
+    CSingleLock lock(cache.section);
+    auto it = cache.paths.find(path);
+    if (it != cache.paths.end())
+      return it->second;
+    generation = cache.generation;
   }
-  return TranslatePath(url);
+
+  const std::string translatedPath = TranslatePath(CURL(path));
+
+  // a folder set while translating may have made the translation stale
+  if (cacheable)
+  {
+    CSingleLock lock(cache.section);
+    if (cache.generation != generation)
+      return translatedPath;
+    if (cache.paths.size() >= TRANSLATION_CACHE_SIZE)
+      cache.paths.clear();
+    cache.paths.emplace(path, translatedPath);
+  }
+  return translatedPath;
 }
 
 std::string CSpecialProtocol::TranslatePath(const CURL &url)
@@ -179,18 +247,7 @@ std::string CSpecialProtocol::TranslatePath(const CURL &url)
     translatedPath = URIUtils::AddFileToFolder(CServiceBroker::GetWinSystem()->GetGfxContext().GetMediaDir(), FileName);
 
   // from here on, we have our "real" special paths
-  else if (RootDir == "xbmc" ||
-           RootDir == "xbmcbin" ||
-           RootDir == "xbmcbinaddons" ||
-           RootDir == "xbmcaltbinaddons" ||
-           RootDir == "home" ||
-           RootDir == "envhome" ||
-           RootDir == "userhome" ||
-           RootDir == "temp" ||
-           RootDir == "profile" ||
-           RootDir == "masterprofile" ||
-           RootDir == "frameworks" ||
-           RootDir == "logpath")
+  else if (IsFixedRoot(RootDir))
   {
     std::string basePath = GetPath(RootDir);
     if (!basePath.empty())
@@ -294,6 +351,11 @@ void CSpecialProtocol::LogPaths()
 void CSpecialProtocol::SetPath(const std::string &key, const std::string &path)
 {
   m_pathMap[key] = path;
+
+  TranslationCache &cache = GetTranslationCache();
+  CSingleLock lock(cache.section);
+  cache.paths.clear();
+  cache.generation++;
 }
 
 std::string CSpecialProtocol::GetPath(const std::string &key)
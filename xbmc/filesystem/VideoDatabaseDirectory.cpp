@@ -50,6 +50,31 @@ bool CVideoDatabaseDirectory::GetDirectory(const CURL& url, CFileItemList &items
     return false;
 
   bool bResult = pNode->GetChilds(items);
+  FinalizeItems(items);
+  items.SetLabel(pNode->GetLocalizedName());
+
+  return bResult;
+}
+
+bool CVideoDatabaseDirectory::GetDirectoryPage(const std::string& strPath, const SortDescription& sorting, CFileItemList &items)
+{
+  std::string path = CLegacyPathTranslation::TranslateVideoDbPath(strPath);
+  items.SetPath(path);
+  items.m_dwSize = -1;  // No size
+
+  std::unique_ptr<CDirectoryNode> pNode(CDirectoryNode::ParseURL(path));
+
+  if (!pNode.get() || !pNode->GetChildsPage(items, sorting))
+    return false;
+
+  FinalizeItems(items);
+  items.SetLabel(pNode->GetLocalizedName());
+
+  return true;
+}
+
+void CVideoDatabaseDirectory::FinalizeItems(CFileItemList &items)
+{
   for (int i=0;i<items.Size();++i)
   {
     CFileItemPtr item = items[i];
@@ -64,9 +89,6 @@ bool CVideoDatabaseDirectory::GetDirectory(const CURL& url, CFileItemList &items
       item->SetDynPath(item->GetVideoInfoTag()->GetPath());
     }
   }
-  items.SetLabel(pNode->GetLocalizedName());
-
-  return bResult;
 }
 
 NODE_TYPE CVideoDatabaseDirectory::GetDirectoryChildType(const std::string& strPath)
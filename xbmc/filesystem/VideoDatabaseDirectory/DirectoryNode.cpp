@@ -188,6 +188,11 @@ bool CDirectoryNode::GetContent(CFileItemList& items) const
   return false;
 }
 
+bool CDirectoryNode::GetContentPage(CFileItemList& items, const SortDescription& sorting) const
+{
+  return false;
+}
+
 //  Creates a videodb url
 std::string CDirectoryNode::BuildPath() const
 {
@@ -274,6 +279,24 @@ bool CDirectoryNode::GetChilds(CFileItemList& items)
   return bSuccess;
 }
 
+bool CDirectoryNode::GetChildsPage(CFileItemList& items, const SortDescription& sorting)
+{
+  std::unique_ptr<CDirectoryNode> pNode(CDirectoryNode::CreateNode(GetChildType(), "", this));
+
+  bool bSuccess = false;
+  if (pNode.get())
+  {
+    pNode->m_options = m_options;
+    bSuccess = pNode->GetContentPage(items, sorting);
+    if (!bSuccess)
+      items.Clear();
+
+    pNode->RemoveParent();
+  }
+
+  return bSuccess;
+}
+
 bool CDirectoryNode::CanCache() const
 {
   // no caching is required - the list is cached in CGUIMediaWindow::GetDirectory
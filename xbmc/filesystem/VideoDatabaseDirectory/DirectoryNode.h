@@ -23,6 +23,7 @@
 #include <string>
 
 class CFileItemList;
+struct SortDescription;
 
 namespace XFILE
 {
@@ -74,6 +75,14 @@ namespace XFILE
       NODE_TYPE GetType() const;
 
       bool GetChilds(CFileItemList& items);
+
+      /*!
+       \brief Get a page of the children sorted by the database
+       \param items [out] the children within the limits of the sort description
+       \param sorting how to sort all children and which of them to get
+       \return false if the children can't be fetched by page or on error
+       */
+      bool GetChildsPage(CFileItemList& items, const SortDescription& sorting);
       virtual NODE_TYPE GetChildType() const;
       virtual std::string GetLocalizedName() const;
 
@@ -94,6 +103,7 @@ namespace XFILE
       void RemoveParent();
 
       virtual bool GetContent(CFileItemList& items) const;
+      virtual bool GetContentPage(CFileItemList& items, const SortDescription& sorting) const;
 
 
     private:
@@ -31,6 +31,11 @@ CDirectoryNodeEpisodes::CDirectoryNodeEpisodes(const std::string& strName, CDire
 }
 
 bool CDirectoryNodeEpisodes::GetContent(CFileItemList& items) const
+{
+  return GetContentPage(items, SortDescription());
+}
+
+bool CDirectoryNodeEpisodes::GetContentPage(CFileItemList& items, const SortDescription& sorting) const
 {
   CVideoDatabase videodatabase;
   if (!videodatabase.Open())
@@ -43,7 +48,7 @@ bool CDirectoryNodeEpisodes::GetContent(CFileItemList& items) const
   if (season == -2)
     season = -1;
 
-  bool bSuccess=videodatabase.GetEpisodesNav(BuildPath(), items, params.GetGenreId(), params.GetYear(), params.GetActorId(), params.GetDirectorId(), params.GetTvShowId(), season);
+  bool bSuccess=videodatabase.GetEpisodesNav(BuildPath(), items, params.GetGenreId(), params.GetYear(), params.GetActorId(), params.GetDirectorId(), params.GetTvShowId(), season, sorting);
 
   videodatabase.Close();
 
@@ -31,6 +31,7 @@ namespace XFILE
       CDirectoryNodeEpisodes(const std::string& strEntryName, CDirectoryNode* pParent);
     protected:
       bool GetContent(CFileItemList& items) const override;
+      bool GetContentPage(CFileItemList& items, const SortDescription& sorting) const override;
       NODE_TYPE GetChildType() const override;
     };
   }
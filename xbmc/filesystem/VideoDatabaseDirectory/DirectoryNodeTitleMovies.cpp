@@ -31,6 +31,11 @@ CDirectoryNodeTitleMovies::CDirectoryNodeTitleMovies(const std::string& strName,
 }
 
 bool CDirectoryNodeTitleMovies::GetContent(CFileItemList& items) const
+{
+  return GetContentPage(items, SortDescription());
+}
+
+bool CDirectoryNodeTitleMovies::GetContentPage(CFileItemList& items, const SortDescription& sorting) const
 {
   CVideoDatabase videodatabase;
   if (!videodatabase.Open())
@@ -39,7 +44,7 @@ bool CDirectoryNodeTitleMovies::GetContent(CFileItemList& items) const
   CQueryParams params;
   CollectQueryParams(params);
 
-  bool bSuccess=videodatabase.GetMoviesNav(BuildPath(), items, params.GetGenreId(), params.GetYear(), params.GetActorId(), params.GetDirectorId(), params.GetStudioId(), params.GetCountryId(), params.GetSetId(), params.GetTagId());
+  bool bSuccess=videodatabase.GetMoviesNav(BuildPath(), items, params.GetGenreId(), params.GetYear(), params.GetActorId(), params.GetDirectorId(), params.GetStudioId(), params.GetCountryId(), params.GetSetId(), params.GetTagId(), sorting);
 
   videodatabase.Close();
 
@@ -31,6 +31,11 @@ CDirectoryNodeTitleMusicVideos::CDirectoryNodeTitleMusicVideos(const std::string
 }
 
 bool CDirectoryNodeTitleMusicVideos::GetContent(CFileItemList& items) const
+{
+  return GetContentPage(items, SortDescription());
+}
+
+bool CDirectoryNodeTitleMusicVideos::GetContentPage(CFileItemList& items, const SortDescription& sorting) const
 {
   CVideoDatabase videodatabase;
   if (!videodatabase.Open())
@@ -39,7 +44,7 @@ bool CDirectoryNodeTitleMusicVideos::GetContent(CFileItemList& items) const
   CQueryParams params;
   CollectQueryParams(params);
 
-  bool bSuccess=videodatabase.GetMusicVideosNav(BuildPath(), items, params.GetGenreId(), params.GetYear(), params.GetActorId(), params.GetDirectorId(), params.GetStudioId(), params.GetAlbumId(), params.GetTagId());
+  bool bSuccess=videodatabase.GetMusicVideosNav(BuildPath(), items, params.GetGenreId(), params.GetYear(), params.GetActorId(), params.GetDirectorId(), params.GetStudioId(), params.GetAlbumId(), params.GetTagId(), sorting);
 
   videodatabase.Close();
 
@@ -31,6 +31,7 @@ namespace XFILE
       CDirectoryNodeTitleMusicVideos(const std::string& strEntryName, CDirectoryNode* pParent);
     protected:
       bool GetContent(CFileItemList& item) const override;
+      bool GetContentPage(CFileItemList& items, const SortDescription& sorting) const override;
     };
   }
 }
@@ -44,6 +44,11 @@ std::string CDirectoryNodeTitleTvShows::GetLocalizedName() const
 }
 
 bool CDirectoryNodeTitleTvShows::GetContent(CFileItemList& items) const
+{
+  return GetContentPage(items, SortDescription());
+}
+
+bool CDirectoryNodeTitleTvShows::GetContentPage(CFileItemList& items, const SortDescription& sorting) const
 {
   CVideoDatabase videodatabase;
   if (!videodatabase.Open())
@@ -52,7 +57,7 @@ bool CDirectoryNodeTitleTvShows::GetContent(CFileItemList& items) const
   CQueryParams params;
   CollectQueryParams(params);
 
-  bool bSuccess=videodatabase.GetTvShowsNav(BuildPath(), items, params.GetGenreId(), params.GetYear(), params.GetActorId(), params.GetDirectorId(), params.GetStudioId(), params.GetTagId());
+  bool bSuccess=videodatabase.GetTvShowsNav(BuildPath(), items, params.GetGenreId(), params.GetYear(), params.GetActorId(), params.GetDirectorId(), params.GetStudioId(), params.GetTagId(), sorting);
 
   videodatabase.Close();
 
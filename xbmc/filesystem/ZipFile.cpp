@@ -20,16 +20,15 @@
 
 #include "ZipFile.h"
 #include "URL.h"
-#include "utils/URIUtils.h"
 #include "utils/auto_buffer.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <sys/stat.h>
 
 #if defined (TARGET_WINDOWS)
 #pragma comment(lib, "zlib.lib")
 #endif
-#define ZIP_CACHE_LIMIT 4*1024*1024
 
 using namespace XFILE;
 
@@ -38,8 +37,9 @@ CZipFile::CZipFile()
   m_szStringBuffer = NULL;
   m_szStartOfStringBuffer = NULL;
   m_iDataInStringBuffer = 0;
-  m_bCached = false;
   m_iRead = -1;
+  m_iWindowPos = 0;
+  m_iWindowSize = 0;
 }
 
 CZipFile::~CZipFile()
@@ -50,7 +50,6 @@ CZipFile::~CZipFile()
 
 bool CZipFile::Open(const CURL&url)
 {
-  std::string strOpts = url.GetOptions();
   CURL url2(url);
   url2.SetOptions("");
   if (!g_ZipManager.GetZipEntry(url2,mZipItem))
@@ -68,25 +67,17 @@ bool CZipFile::Open(const CURL&url)
     return false;
   }
 
-  if (mZipItem.method != 0 && mZipItem.usize > ZIP_CACHE_LIMIT && strOpts != "?cache=no")
-  {
-    if (!CFile::Exists("special://temp/" + URIUtils::GetFileName(url2)))
-    {
-      url2.SetOptions("?cache=no");
-      const CURL pathToUrl("special://temp/" + URIUtils::GetFileName(url2));
-      if (!CFile::Copy(url2, pathToUrl))
-        return false;
-    }
-    m_bCached = true;
-    return mFile.Open("special://temp/" + URIUtils::GetFileName(url2));
-  }
-
   if (!mFile.Open(url.GetHostName())) // this is the zip-file, always open binary
   {
     CLog::Log(LOGERROR,"FileZip: unable to open zip file %s!",url.GetHostName().c_str());
     return false;
   }
   mFile.Seek(mZipItem.offset,SEEK_SET);
+
+  // seeking in large deflated entries resumes from the points of the index
+  m_seekIndex = g_ZipManager.GetSeekIndex(url.GetHostName(), mZipItem);
+  if (m_seekIndex && !m_window)
+    m_window.reset(new unsigned char[CZipSeekIndex::WINDOW_SIZE]);
   return InitDecompress();
 }
 
@@ -95,8 +86,11 @@ bool CZipFile::InitDecompress()
   m_iRead = 1;
   m_iFilePos = 0;
   m_iZipFilePos = 0;
+  m_iOutBase = 0;
   m_iAvailBuffer = 0;
   m_bFlush = false;
+  m_iWindowPos = 0;
+  m_iWindowSize = 0;
   m_ZStream.zalloc = Z_NULL;
   m_ZStream.zfree = Z_NULL;
   m_ZStream.opaque = Z_NULL;
@@ -115,6 +109,107 @@ bool CZipFile::InitDecompress()
   return true;
 }
 
+bool CZipFile::RestartDecompress(const CZipSeekIndex::Point* point)
+{
+  inflateReset(&m_ZStream);
+  m_ZStream.next_in = (Bytef*)m_szBuffer;
+  m_ZStream.avail_in = 0;
+  m_bFlush = false;
+
+  if (!point) // from the start
+  {
+    m_iFilePos = 0;
+    m_iZipFilePos = 0;
+    m_iOutBase = 0;
+    m_iWindowPos = 0;
+    m_iWindowSize = 0;
+    return mFile.Seek(mZipItem.offset, SEEK_SET) == mZipItem.offset;
+  }
+
+  // the point may lie within a byte, its remaining bits are fed to zlib first
+  m_iZipFilePos = point->in - (point->bits ? 1 : 0);
+  if (mFile.Seek(mZipItem.offset + m_iZipFilePos, SEEK_SET) != mZipItem.offset + m_iZipFilePos)
+    return false;
+  if (point->bits)
+  {
+    if (!FillBuffer())
+      return false;
+    const int value = *m_ZStream.next_in;
+    m_ZStream.next_in++;
+    m_ZStream.avail_in--;
+    inflatePrime(&m_ZStream, point->bits, value >> (8 - point->bits));
+  }
+  inflateSetDictionary(&m_ZStream, point->window, CZipSeekIndex::WINDOW_SIZE);
+
+  memcpy(m_window.get(), point->window, CZipSeekIndex::WINDOW_SIZE);
+  m_iWindowPos = 0;
+  m_iWindowSize = CZipSeekIndex::WINDOW_SIZE;
+  m_iFilePos = point->out;
+  m_iOutBase = point->out;
+  return true;
+}
+
+int CZipFile::Inflate()
+{
+  if (!m_seekIndex)
+    return inflate(&m_ZStream, Z_SYNC_FLUSH);
+
+  // seek points can only be set at the end of a deflate block, so stop at
+  // each one only when the output may reach the data kept for the next point
+  const int64_t nextPoint = m_seekIndex->GetNextPoint();
+  if (m_iOutBase + m_ZStream.total_out + m_ZStream.avail_out + CZipSeekIndex::WINDOW_SIZE <= nextPoint)
+  {
+    m_iWindowSize = 0;
+    return inflate(&m_ZStream, Z_SYNC_FLUSH);
+  }
+
+  Bytef* out = m_ZStream.next_out;
+  int iMessage = inflate(&m_ZStream, Z_BLOCK);
+  // an end of block may be reached without using up any input or output
+  if (iMessage == Z_BUF_ERROR)
+    iMessage = Z_OK;
+  if (iMessage >= 0)
+    UpdateSeekIndex(out, m_ZStream.next_out - out, nextPoint);
+  return iMessage;
+}
+
+void CZipFile::UpdateSeekIndex(const unsigned char* data, size_t size, int64_t nextPoint)
+{
+  static const size_t windowSize = CZipSeekIndex::WINDOW_SIZE;
+  const int64_t out = m_iOutBase + m_ZStream.total_out;
+
+  // keep the data before the next point
+  if (out + static_cast<int64_t>(windowSize) <= nextPoint)
+    m_iWindowSize = 0;
+  else if (size >= windowSize)
+  {
+    memcpy(m_window.get(), data + size - windowSize, windowSize);
+    m_iWindowPos = 0;
+    m_iWindowSize = windowSize;
+  }
+  else if (size > 0)
+  {
+    const size_t first = std::min(size, windowSize - m_iWindowPos);
+    memcpy(m_window.get() + m_iWindowPos, data, first);
+    memcpy(m_window.get(), data + first, size - first);
+    m_iWindowPos = (m_iWindowPos + size) % windowSize;
+    m_iWindowSize = std::min(m_iWindowSize + size, windowSize);
+  }
+
+  // at the end of a block that isn't the last one
+  if (out < nextPoint || m_iWindowSize < windowSize ||
+      !(m_ZStream.data_type & 128) || (m_ZStream.data_type & 64))
+    return;
+
+  auto point = std::make_shared<CZipSeekIndex::Point>();
+  point->out = out;
+  point->in = m_iZipFilePos - m_ZStream.avail_in;
+  point->bits = m_ZStream.data_type & 7;
+  memcpy(point->window, m_window.get() + m_iWindowPos, windowSize - m_iWindowPos);
+  memcpy(point->window + windowSize - m_iWindowPos, m_window.get(), m_iWindowPos);
+  m_seekIndex->AddPoint(point);
+}
+
 int64_t CZipFile::GetLength()
 {
   return mZipItem.usize;
@@ -122,16 +217,11 @@ int64_t CZipFile::GetLength()
 
 int64_t CZipFile::GetPosition()
 {
-  if (m_bCached)
-    return mFile.GetPosition();
-
   return m_iFilePos;
 }
 
 int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
 {
-  if (m_bCached)
-    return mFile.Seek(iFilePosition,iWhence);
   if (mZipItem.method == 0) // this is easy
   {
     int64_t iResult;
@@ -168,7 +258,6 @@ int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
 
     }
   }
-  // here goes the stupid part..
   if (mZipItem.method == 8)
   {
     static const int blockSize = 128 * 1024;
@@ -180,19 +269,18 @@ int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
         return m_iFilePos; // mp3reader does this lots-of-times
       if (iFilePosition > mZipItem.usize || iFilePosition < 0)
         return -1;
-      // read until position in 128k blocks.. only way to do it due to format.
-      // can't start in the middle of data since then we'd have no clue where
-      // we are in uncompressed data..
-      if (iFilePosition < m_iFilePos)
       {
-        m_iFilePos = 0;
-        m_iZipFilePos = 0;
-        inflateEnd(&m_ZStream);
-        inflateInit2(&m_ZStream,-MAX_WBITS); // simply restart zlib
-        mFile.Seek(mZipItem.offset,SEEK_SET);
-        m_ZStream.next_in = (Bytef*)m_szBuffer;
-        m_ZStream.avail_in = 0;
-        m_ZStream.total_out = 0;
+        // deflated data can only be decompressed from the start or from a
+        // seek point, so restart from the last one before the position if
+        // going back or if it's ahead of us, then read up to the position
+        std::shared_ptr<const CZipSeekIndex::Point> point;
+        if (m_seekIndex)
+          point = m_seekIndex->FindPoint(iFilePosition);
+        if (iFilePosition < m_iFilePos || (point && point->out > m_iFilePos))
+        {
+          if (!RestartDecompress(point.get()))
+            return -1;
+        }
         while (m_iFilePos < iFilePosition)
         {
           unsigned int iToRead = (iFilePosition - m_iFilePos)>blockSize ? blockSize : (int)(iFilePosition - m_iFilePos);
@@ -201,37 +289,14 @@ int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
         }
         return m_iFilePos;
       }
-      else // seek forward
-        return Seek(iFilePosition-m_iFilePos,SEEK_CUR);
       break;
 
     case SEEK_CUR:
-      if (iFilePosition < 0)
-        return Seek(m_iFilePos+iFilePosition,SEEK_SET); // can't rewind stream
-      // read until requested position, drop data
-      if (m_iFilePos+iFilePosition > mZipItem.usize)
-        return -1;
-      iFilePosition += m_iFilePos;
-      while (m_iFilePos < iFilePosition)
-      {
-        unsigned int iToRead = (iFilePosition - m_iFilePos)>blockSize ? blockSize : (int)(iFilePosition - m_iFilePos);
-        if (Read(buf.get(), iToRead) != iToRead)
-          return -1;
-      }
-      return m_iFilePos;
+      return Seek(m_iFilePos+iFilePosition,SEEK_SET);
       break;
 
     case SEEK_END:
-      // now this is a nasty bastard, possibly takes lotsoftime
-      // uncompress, minding m_ZStream.total_out
-
-      while( (int)m_ZStream.total_out < mZipItem.usize+iFilePosition)
-      {
-        unsigned int iToRead = (mZipItem.usize + iFilePosition - m_ZStream.total_out > blockSize) ? blockSize : (int)(mZipItem.usize + iFilePosition - m_ZStream.total_out);
-        if (Read(buf.get(), iToRead) != iToRead)
-          return -1;
-      }
-      return m_iFilePos;
+      return Seek(mZipItem.usize+iFilePosition,SEEK_SET);
       break;
     default:
       return -1;
@@ -293,9 +358,6 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
   if (uiBufSize > SSIZE_MAX)
     uiBufSize = SSIZE_MAX;
 
-  if (m_bCached)
-    return mFile.Read(lpBuf,uiBufSize);
-
   // flush what might be left in the string buffer
   if (m_iDataInStringBuffer > 0)
   {
@@ -308,13 +370,13 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
   {
     uLong iDecompressed = 0;
     uLong prevOut = m_ZStream.total_out;
-    while ((iDecompressed < uiBufSize) && ((m_iZipFilePos < mZipItem.csize) || (m_bFlush)))
+    while ((iDecompressed < uiBufSize) && ((m_iZipFilePos < mZipItem.csize) || (m_ZStream.avail_in) || (m_bFlush)))
     {
       m_ZStream.next_out = (Bytef*)(lpBuf)+iDecompressed;
       m_ZStream.avail_out = static_cast<uInt>(uiBufSize-iDecompressed);
       if (m_bFlush) // need to flush buffer !
       {
-        int iMessage = inflate(&m_ZStream,Z_SYNC_FLUSH);
+        int iMessage = Inflate();
         m_bFlush = ((iMessage == Z_OK) && (m_ZStream.avail_out == 0))?true:false;
         if (!m_ZStream.avail_out) // flush filled buffer, get out of here
         {
@@ -332,7 +394,7 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
         }
       }
 
-      int iMessage = inflate(&m_ZStream,Z_SYNC_FLUSH);
+      int iMessage = Inflate();
       if (iMessage < 0)
       {
         Close();
@@ -342,6 +404,8 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
       m_bFlush = ((iMessage == Z_OK) && (m_ZStream.avail_out == 0))?true:false; // more info in input buffer
 
       iDecompressed = m_ZStream.total_out-prevOut;
+      if (iMessage == Z_STREAM_END)
+        break;
     }
     m_iFilePos += iDecompressed;
     return static_cast<unsigned int>(iDecompressed);
@@ -367,7 +431,7 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
 
 void CZipFile::Close()
 {
-  if (mZipItem.method == 8 && !m_bCached && m_iRead != -1)
+  if (mZipItem.method == 8 && m_iRead != -1)
     inflateEnd(&m_ZStream);
 
   mFile.Close();
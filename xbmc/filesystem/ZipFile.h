@@ -21,9 +21,11 @@
  */
 
 #include "IFile.h"
+#include <memory>
 #include <zlib.h>
 #include "File.h"
 #include "ZipManager.h"
+#include "ZipSeekIndex.h"
 
 namespace XFILE
 {
@@ -52,12 +54,16 @@ namespace XFILE
 
   private:
     bool InitDecompress();
+    bool RestartDecompress(const CZipSeekIndex::Point* point);
+    int Inflate();
+    void UpdateSeekIndex(const unsigned char* data, size_t size, int64_t nextPoint);
     bool FillBuffer();
     void DestroyBuffer(void* lpBuffer, int iBufSize);
     CFile mFile;
     SZipEntry mZipItem;
     int64_t m_iFilePos; // position in _uncompressed_ data read
     int64_t m_iZipFilePos; // position in _compressed_ data
+    int64_t m_iOutBase; // position in uncompressed data where zlib was (re)started
     int m_iAvailBuffer;
     z_stream m_ZStream;
     char m_szBuffer[65535];     // 64k buffer for compressed data
@@ -66,7 +72,10 @@ namespace XFILE
     size_t m_iDataInStringBuffer;
     int m_iRead;
     bool m_bFlush;
-    bool m_bCached;
+    std::shared_ptr<CZipSeekIndex> m_seekIndex;
+    std::unique_ptr<unsigned char[]> m_window; // last uncompressed data, for new seek points
+    size_t m_iWindowPos;
+    size_t m_iWindowSize;
   };
 }
 
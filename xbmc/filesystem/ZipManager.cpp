@@ -25,9 +25,11 @@
 
 #include "File.h"
 #include "URL.h"
+#include "ZipSeekIndex.h"
 #include "platform/linux/PlatformDefs.h"
 #include "utils/CharsetConverter.h"
 #include "utils/EndianSwap.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/RegExp.h"
 #include "utils/URIUtils.h"
@@ -35,6 +37,7 @@
 using namespace XFILE;
 
 static const size_t ZC_FLAG_EFS = 1 << 11; // general purpose bit 11 - zip holds utf-8 filenames
+static const size_t MAX_SEEK_INDEXES = 8; // seek indexes kept, they take up to 4 MB each
 
 CZipManager::CZipManager() = default;
 
@@ -327,6 +330,36 @@ void CZipManager::release(const std::string& strPath)
     mZipMap.erase(it);
     mZipDate.erase(it2);
   }
+
+  CSingleLock lock(m_seekIndexSection);
+  m_seekIndexes.remove_if([&url](const SeekIndex& index) { return index.zipPath == url.GetHostName(); });
+}
+
+std::shared_ptr<CZipSeekIndex> CZipManager::GetSeekIndex(const std::string& strZipPath, const SZipEntry& item)
+{
+  if (item.method != 8 || !CZipSeekIndex::IsUseful(item.usize))
+    return std::shared_ptr<CZipSeekIndex>();
+
+  CSingleLock lock(m_seekIndexSection);
+  auto it = std::find_if(m_seekIndexes.begin(), m_seekIndexes.end(),
+                         [&](const SeekIndex& index) {
+                           return index.zipPath == strZipPath && index.offset == item.offset && index.crc32 == item.crc32;
+                         });
+  if (it != m_seekIndexes.end())
+  {
+    m_seekIndexes.splice(m_seekIndexes.begin(), m_seekIndexes, it);
+    return it->index;
+  }
+
+  if (m_seekIndexes.size() >= MAX_SEEK_INDEXES)
+    m_seekIndexes.pop_back();
+  SeekIndex index;
+  index.zipPath = strZipPath;
+  index.offset = item.offset;
+  index.crc32 = item.crc32;
+  index.index = std::make_shared<CZipSeekIndex>(item.usize);
+  m_seekIndexes.push_front(index);
+  return index.index;
 }
 
 
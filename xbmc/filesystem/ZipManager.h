@@ -31,13 +31,22 @@
 #define CHDR_SIZE 46
 #define ECDREC_SIZE 22
 
+#include <list>
+#include <memory>
 #include <memory.h>
 #include <string>
 #include <vector>
 #include <map>
 
+#include "threads/CriticalSection.h"
+
 class CURL;
 
+namespace XFILE
+{
+  class CZipSeekIndex;
+}
+
 static const std::string PATH_TRAVERSAL(R"_((^|\/|\\)\.{2}($|\/|\\))_");
 
 struct SZipEntry {
@@ -110,11 +119,28 @@ public:
   bool ExtractArchive(const std::string& strArchive, const std::string& strPath);
   bool ExtractArchive(const CURL& archive, const std::string& strPath);
   void release(const std::string& strPath); // release resources used by list zip
+  /*!
+   \brief get the seek index of a deflated entry, shared by everyone reading it
+   \param strZipPath path of the zip file
+   \param item the entry
+   \return the index, empty if the entry isn't worth indexing
+   */
+  std::shared_ptr<XFILE::CZipSeekIndex> GetSeekIndex(const std::string& strZipPath, const SZipEntry& item);
   static void readHeader(const char* buffer, SZipEntry& info);
   static void readCHeader(const char* buffer, SZipEntry& info);
 private:
   std::map<std::string,std::vector<SZipEntry> > mZipMap;
   std::map<std::string,int64_t> mZipDate;
+
+  struct SeekIndex
+  {
+    std::string zipPath;
+    int64_t offset;
+    unsigned int crc32;
+    std::shared_ptr<XFILE::CZipSeekIndex> index;
+  };
+  CCriticalSection m_seekIndexSection;
+  std::list<SeekIndex> m_seekIndexes; // most recently used first
 };
 
 extern CZipManager g_ZipManager;
@@ -0,0 +1,73 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ZipSeekIndex.h"
+
+#include <algorithm>
+
+#include "threads/SingleLock.h"
+
+using namespace XFILE;
+
+// uncompressed data between two points, a seek decompresses less than that
+#define ZIP_SEEK_SPAN 1024*1024
+// points of an entry at most, each one takes 32k
+#define ZIP_SEEK_MAX_POINTS 128
+
+CZipSeekIndex::CZipSeekIndex(int64_t size)
+  : m_span(std::max<int64_t>(ZIP_SEEK_SPAN, size / ZIP_SEEK_MAX_POINTS))
+{
+}
+
+bool CZipSeekIndex::IsUseful(int64_t size)
+{
+  return size > ZIP_SEEK_SPAN;
+}
+
+int64_t CZipSeekIndex::GetNextPoint() const
+{
+  CSingleLock lock(m_critSection);
+  return m_points.empty() ? m_span : m_points.back()->out + m_span;
+}
+
+void CZipSeekIndex::AddPoint(const std::shared_ptr<const Point>& point)
+{
+  CSingleLock lock(m_critSection);
+  // another reader of the entry may have been there first
+  if (point->out < (m_points.empty() ? m_span : m_points.back()->out + m_span))
+    return;
+  m_points.push_back(point);
+}
+
+std::shared_ptr<const CZipSeekIndex::Point> CZipSeekIndex::FindPoint(int64_t position) const
+{
+  CSingleLock lock(m_critSection);
+  auto it = std::upper_bound(m_points.begin(), m_points.end(), position,
+                             [](int64_t pos, const std::shared_ptr<const Point>& point) { return pos < point->out; });
+  if (it == m_points.begin())
+    return std::shared_ptr<const Point>();
+  return *(--it);
+}
+
+size_t CZipSeekIndex::GetSize() const
+{
+  CSingleLock lock(m_critSection);
+  return m_points.size();
+}
@@ -0,0 +1,78 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+
+namespace XFILE
+{
+  /*!
+   \brief Points to resume decompressing a deflated zip entry from, so seeking
+   in it doesn't need to decompress everything before the position.
+
+   A point is set at the end of a deflate block about every span bytes of
+   uncompressed data and keeps the last 32k of data before it, which is all
+   inflate needs to go on from there (see zran.c of zlib). Points are added
+   while the entry is decompressed, so the index grows with the parts read.
+   */
+  class CZipSeekIndex
+  {
+  public:
+    //! uncompressed data saved with each point, the largest deflate distance
+    static const unsigned int WINDOW_SIZE = 32768;
+
+    struct Point
+    {
+      int64_t out; // position in uncompressed data
+      int64_t in; // position in compressed data of the first byte after the point
+      int bits; // number of bits of the byte before 'in' that come after the point
+      unsigned char window[WINDOW_SIZE]; // uncompressed data before the point
+    };
+
+    /*!
+     \brief create the index of an entry
+     \param size uncompressed size of the entry, the span of the points grows with it to bound the memory used
+     */
+    explicit CZipSeekIndex(int64_t size);
+
+    //! whether entries of the given uncompressed size are worth indexing
+    static bool IsUseful(int64_t size);
+
+    //! the uncompressed position from which the next point is taken
+    int64_t GetNextPoint() const;
+
+    //! add a point, ignored if it's before the next point
+    void AddPoint(const std::shared_ptr<const Point>& point);
+
+    //! get the last point at or before the position, empty if there is none
+    std::shared_ptr<const Point> FindPoint(int64_t position) const;
+
+    size_t GetSize() const;
+
+  private:
+    mutable CCriticalSection m_critSection;
+    std::vector<std::shared_ptr<const Point>> m_points;
+    int64_t m_span;
+  };
+}
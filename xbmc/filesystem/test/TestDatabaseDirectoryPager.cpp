@@ -0,0 +1,108 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DatabaseManager.h"
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "filesystem/DatabaseDirectoryPager.h"
+#include "filesystem/Directory.h"
+#include "music/MusicDatabase.h"
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+class TestDatabaseDirectoryPager : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // creates the databases in the profile of the test environment
+    CServiceBroker::GetDatabaseManager().Initialize();
+    ASSERT_TRUE(m_db.Open());
+  }
+
+  void TearDown() override
+  {
+    m_db.Close();
+  }
+
+  CMusicDatabase m_db;
+};
+
+// UPnP and JSON-RPC list directories either page by page or all at once, the
+// pages have to hold the same items in the same order as the full listing
+TEST_F(TestDatabaseDirectoryPager, SameItemsAsFullListing)
+{
+  static const int SONGS = 250;
+  static const int PAGE = 40;
+  // an extension mask like the one of UPnP
+  static const std::string MASK = ".mkv|.avi|.flac|.jpg";
+
+  m_db.BeginTransaction();
+  ASSERT_TRUE(m_db.ExecuteQuery("INSERT INTO path (idPath, strPath) VALUES (1, '/music/')"));
+  ASSERT_TRUE(m_db.ExecuteQuery("INSERT INTO album (idAlbum, strAlbum) VALUES (1, 'Album')"));
+  for (int i = 1; i <= SONGS; i++)
+  {
+    // the ids aren't in title order
+    ASSERT_TRUE(m_db.ExecuteQuery(StringUtils::Format("INSERT INTO song (idSong, idAlbum, idPath, strTitle, strFileName) "
+                                                      "VALUES (%i, 1, 1, 'Song %03i', 'song%i.mp3')", i, (i * 7) % SONGS, i)));
+  }
+  ASSERT_TRUE(m_db.CommitTransaction());
+
+  const std::string path = CDatabaseDirectoryPager::GetDatabasePath("musicdb://songs/", MASK);
+  ASSERT_EQ("musicdb://songs/", path);
+
+  SortDescription sorting;
+  sorting.sortBy = SortByTitle;
+
+  CFileItemList full;
+  ASSERT_TRUE(CDirectory::GetDirectory(path, full, MASK, DIR_FLAG_DEFAULTS));
+  ASSERT_EQ(SONGS, full.Size());
+  full.Sort(sorting);
+
+  CDatabaseDirectoryPager pager;
+  for (int start = 0; start < SONGS; start += PAGE)
+  {
+    CFileItemList page;
+    int total = 0;
+    ASSERT_TRUE(pager.GetPage(path, sorting, start, PAGE, page, total));
+    EXPECT_EQ(SONGS, total);
+    ASSERT_EQ(std::min(PAGE, SONGS - start), page.Size());
+    for (int i = 0; i < page.Size(); i++)
+    {
+      EXPECT_EQ(full[start + i]->GetPath(), page[i]->GetPath());
+      EXPECT_EQ(full[start + i]->GetLabel(), page[i]->GetLabel());
+    }
+  }
+}
+
+// the full listing drops video library items not matching the mask, pages
+// can't, so these directories are listed in full
+TEST(TestDatabaseDirectoryPagerPath, VideoLibraryWithMask)
+{
+  EXPECT_EQ("videodb://movies/titles/", CDatabaseDirectoryPager::GetDatabasePath("videodb://movies/titles/"));
+  EXPECT_EQ("", CDatabaseDirectoryPager::GetDatabasePath("videodb://movies/titles/", ".mkv|.avi"));
+  EXPECT_EQ("musicdb://albums/", CDatabaseDirectoryPager::GetDatabasePath("musicdb://albums/", ".mkv|.avi"));
+  EXPECT_EQ("", CDatabaseDirectoryPager::GetDatabasePath("smb://server/music/"));
+}
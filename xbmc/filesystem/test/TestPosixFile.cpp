@@ -0,0 +1,225 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "platform/posix/filesystem/PosixFile.h"
+#include "platform/posix/filesystem/PosixReadAhead.h"
+#include "test/TestUtils.h"
+#include "URL.h"
+
+#include <chrono>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+static const int64_t FILE_SIZE = 64 * 1024 * 1024;
+
+class TestPosixFile : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    file = XBMC_CREATETEMPFILE("");
+    ASSERT_TRUE(file != nullptr);
+    path = XBMC_TEMPFILEPATH(file);
+
+    std::vector<unsigned char> chunk(1024 * 1024);
+    for (int64_t offset = 0; offset < FILE_SIZE; offset += chunk.size())
+    {
+      for (size_t i = 0; i < chunk.size(); i++)
+        chunk[i] = Expected(offset + i);
+      ASSERT_EQ(static_cast<ssize_t>(chunk.size()), file->Write(chunk.data(), chunk.size()));
+    }
+    file->Flush();
+    file->Close();
+  }
+
+  void TearDown() override
+  {
+    XBMC_DELETETEMPFILE(file);
+  }
+
+  static unsigned char Expected(int64_t offset)
+  {
+    return static_cast<unsigned char>((offset * 7) % 251);
+  }
+
+  static bool Verify(const std::vector<unsigned char> &buffer, int64_t offset, ssize_t size)
+  {
+    for (ssize_t i = 0; i < size; i++)
+    {
+      if (buffer[i] != Expected(offset + i))
+        return false;
+    }
+    return true;
+  }
+
+  // as far as possible, have the benchmarks read from the disk
+  void DropCache()
+  {
+#if defined(HAVE_POSIX_FADVISE)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+      close(fd);
+    }
+#endif
+  }
+
+  CFile *file = nullptr;
+  std::string path;
+};
+
+TEST_F(TestPosixFile, SequentialRead)
+{
+  const CPosixReadAhead::Statistics before = CPosixReadAhead::GetInstance().GetStatistics();
+
+  CPosixFile posix;
+  ASSERT_TRUE(posix.Open(CURL(path)));
+  EXPECT_EQ(CPosixReadAhead::IsSupported() ? 1 : 0, posix.IoControl(IOCTRL_READ_AHEAD, NULL));
+
+  std::vector<unsigned char> buffer(64 * 1024);
+  int64_t offset = 0;
+  ssize_t read;
+  while ((read = posix.Read(buffer.data(), buffer.size())) > 0)
+  {
+    ASSERT_TRUE(Verify(buffer, offset, read)) << "at " << offset;
+    offset += read;
+  }
+  EXPECT_EQ(0, read);
+  EXPECT_EQ(FILE_SIZE, offset);
+  EXPECT_EQ(FILE_SIZE, posix.GetPosition());
+  posix.Close();
+
+  const CPosixReadAhead::Statistics after = CPosixReadAhead::GetInstance().GetStatistics();
+  if (CPosixReadAhead::IsSupported())
+    EXPECT_GT(after.requests + after.merged, before.requests + before.merged);
+}
+
+TEST_F(TestPosixFile, RandomRead)
+{
+  CPosixFile posix;
+  ASSERT_TRUE(posix.Open(CURL(path)));
+
+  std::vector<unsigned char> buffer(4096);
+  unsigned int seed = 1;
+  for (int i = 0; i < 1000; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    const int64_t offset = (static_cast<int64_t>(seed >> 8) * 4099) % (FILE_SIZE - buffer.size());
+    ASSERT_EQ(offset, posix.Seek(offset, SEEK_SET));
+    ASSERT_EQ(static_cast<ssize_t>(buffer.size()), posix.Read(buffer.data(), buffer.size()));
+    ASSERT_TRUE(Verify(buffer, offset, buffer.size())) << "at " << offset;
+
+    // skipping forward a little must not lose the position either
+    ASSERT_EQ(offset + 8192, posix.Seek(4096, SEEK_CUR));
+  }
+}
+
+// a local file that reads ahead on its own is passed through by the cache
+TEST_F(TestPosixFile, CachedPassThrough)
+{
+  CFile cached;
+  ASSERT_TRUE(cached.Open(path, READ_CACHED));
+  EXPECT_EQ(FILE_SIZE, cached.GetLength());
+
+  SCacheStatus status;
+  if (CPosixReadAhead::IsSupported())
+    EXPECT_EQ(-1, cached.IoControl(IOCTRL_CACHE_STATUS, &status));
+
+  std::vector<unsigned char> buffer(32 * 1024);
+  ASSERT_EQ(static_cast<ssize_t>(buffer.size()), cached.Read(buffer.data(), buffer.size()));
+  EXPECT_TRUE(Verify(buffer, 0, buffer.size()));
+
+  const int64_t offset = FILE_SIZE / 2 + 13;
+  ASSERT_EQ(offset, cached.Seek(offset, SEEK_SET));
+  ASSERT_EQ(static_cast<ssize_t>(buffer.size()), cached.Read(buffer.data(), buffer.size()));
+  EXPECT_TRUE(Verify(buffer, offset, buffer.size()));
+  EXPECT_EQ(offset + static_cast<int64_t>(buffer.size()), cached.GetPosition());
+}
+
+// Compares reading the file with plain read() calls to CPosixFile with its
+// access pattern hints and read-ahead
+TEST_F(TestPosixFile, DISABLED_Benchmark)
+{
+  std::vector<unsigned char> buffer(32 * 1024);
+
+  DropCache();
+  auto start = std::chrono::steady_clock::now();
+  int fd = open(path.c_str(), O_RDONLY);
+  ASSERT_GE(fd, 0);
+  int64_t total = 0;
+  ssize_t read;
+  while ((read = ::read(fd, buffer.data(), buffer.size())) > 0)
+    total += read;
+  close(fd);
+  EXPECT_EQ(FILE_SIZE, total);
+  const auto plainSequentialUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  DropCache();
+  start = std::chrono::steady_clock::now();
+  CPosixFile posix;
+  ASSERT_TRUE(posix.Open(CURL(path)));
+  total = 0;
+  while ((read = posix.Read(buffer.data(), buffer.size())) > 0)
+    total += read;
+  posix.Close();
+  EXPECT_EQ(FILE_SIZE, total);
+  const auto posixSequentialUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  static const int NUM_SEEKS = 2000;
+  DropCache();
+  start = std::chrono::steady_clock::now();
+  fd = open(path.c_str(), O_RDONLY);
+  ASSERT_GE(fd, 0);
+  unsigned int seed = 1;
+  for (int i = 0; i < NUM_SEEKS; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    lseek(fd, (static_cast<int64_t>(seed >> 8) * 4099) % (FILE_SIZE - 4096), SEEK_SET);
+    ASSERT_EQ(4096, ::read(fd, buffer.data(), 4096));
+  }
+  close(fd);
+  const auto plainRandomUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  DropCache();
+  start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(posix.Open(CURL(path)));
+  seed = 1;
+  for (int i = 0; i < NUM_SEEKS; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    posix.Seek((static_cast<int64_t>(seed >> 8) * 4099) % (FILE_SIZE - 4096), SEEK_SET);
+    ASSERT_EQ(4096, posix.Read(buffer.data(), 4096));
+  }
+  posix.Close();
+  const auto posixRandomUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  RecordProperty("SequentialReadUs", static_cast<int>(plainSequentialUs));
+  RecordProperty("SequentialPosixFileUs", static_cast<int>(posixSequentialUs));
+  RecordProperty("RandomReadUs", static_cast<int>(plainRandomUs));
+  RecordProperty("RandomPosixFileUs", static_cast<int>(posixRandomUs));
+}
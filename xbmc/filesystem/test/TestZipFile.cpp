@@ -21,6 +21,8 @@
 #include "ServiceBroker.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "filesystem/ZipManager.h"
+#include "filesystem/ZipSeekIndex.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "FileItem.h"
@@ -29,6 +31,9 @@
 #include "URL.h"
 
 #include <errno.h>
+#include <random>
+#include <vector>
+#include <zlib.h>
 
 #include "gtest/gtest.h"
 
@@ -59,6 +64,68 @@ protected:
   }
 };
 
+static void AppendLE(std::string& out, unsigned int value, int bytes)
+{
+  for (int i = 0; i < bytes; i++)
+    out += static_cast<char>((value >> (8 * i)) & 0xff);
+}
+
+// writes a zip file holding one deflated entry
+static bool WriteDeflatedZip(XFILE::CFile& file, const std::string& name, const std::string& data)
+{
+  z_stream stream = {};
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    return false;
+  std::string compressed(deflateBound(&stream, data.size()), '\0');
+  stream.next_in = (Bytef*)data.data();
+  stream.avail_in = data.size();
+  stream.next_out = (Bytef*)&compressed[0];
+  stream.avail_out = compressed.size();
+  const int result = deflate(&stream, Z_FINISH);
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  if (result != Z_STREAM_END)
+    return false;
+  const unsigned int crc = crc32(0, (const Bytef*)data.data(), data.size());
+
+  std::string local;
+  AppendLE(local, ZIP_LOCAL_HEADER, 4);
+  AppendLE(local, 20, 2); // version
+  AppendLE(local, 0, 2); // flags
+  AppendLE(local, 8, 2); // method
+  AppendLE(local, 0, 4); // time and date
+  AppendLE(local, crc, 4);
+  AppendLE(local, compressed.size(), 4);
+  AppendLE(local, data.size(), 4);
+  AppendLE(local, name.size(), 2);
+  AppendLE(local, 0, 2); // extra field
+  local += name;
+
+  std::string central;
+  AppendLE(central, ZIP_CENTRAL_HEADER, 4);
+  AppendLE(central, 20, 2); // version made by
+  central += local.substr(4, LHDR_SIZE - 4);
+  AppendLE(central, 0, 2); // comment
+  AppendLE(central, 0, 4); // disk and internal attributes
+  AppendLE(central, 0, 4); // external attributes
+  AppendLE(central, 0, 4); // offset of the local header
+  central += name;
+
+  std::string end;
+  AppendLE(end, ZIP_END_CENTRAL_HEADER, 4);
+  AppendLE(end, 0, 4); // disks
+  AppendLE(end, 1, 2);
+  AppendLE(end, 1, 2);
+  AppendLE(end, central.size(), 4);
+  AppendLE(end, local.size() + compressed.size(), 4);
+  AppendLE(end, 0, 2); // comment
+
+  return file.Write(local.data(), local.size()) == static_cast<ssize_t>(local.size()) &&
+         file.Write(compressed.data(), compressed.size()) == static_cast<ssize_t>(compressed.size()) &&
+         file.Write(central.data(), central.size()) == static_cast<ssize_t>(central.size()) &&
+         file.Write(end.data(), end.size()) == static_cast<ssize_t>(end.size());
+}
+
 TEST_F(TestZipFile, Read)
 {
   XFILE::CFile file;
@@ -218,3 +285,86 @@ TEST_F(TestZipFile, CorruptedFile)
   file->Close();
   XBMC_DELETETEMPFILE(file);
 }
+
+// Seeks back and forth in a large deflated entry. The first pass over the
+// entry indexes it, after that random reads only decompress the data from the
+// nearest seek point on.
+TEST_F(TestZipFile, SeekDeflated)
+{
+  static const size_t SIZE = 48 * 1024 * 1024;
+  static const int READS = 200;
+  static const size_t READ_SIZE = 4096;
+
+  std::string data;
+  data.reserve(SIZE);
+  std::mt19937 generator(1);
+  const char* words[] = { "kodi ", "media ", "center ", "zip ", "seek ", "index\n", "deflate ", "window " };
+  while (data.size() < SIZE)
+  {
+    if (generator() % 16 == 0)
+      data += static_cast<char>(generator());
+    else
+      data += words[generator() % 8];
+  }
+  data.resize(SIZE);
+
+  XFILE::CFile *zip = XBMC_CREATETEMPFILE(".zip");
+  ASSERT_NE(nullptr, zip);
+  const std::string zipPath = XBMC_TEMPFILEPATH(zip);
+  zip->Close();
+  ASSERT_TRUE(zip->OpenForWrite(zipPath, true));
+  ASSERT_TRUE(WriteDeflatedZip(*zip, "entry.bin", data));
+  zip->Close();
+
+  const std::string entryPath = URIUtils::CreateArchivePath("zip", CURL(zipPath), "entry.bin").Get();
+  XFILE::CFile file;
+  ASSERT_TRUE(file.Open(entryPath));
+  ASSERT_EQ(static_cast<int64_t>(SIZE), file.GetLength());
+
+  // the end first, before anything is indexed
+  std::vector<char> buf(READ_SIZE);
+  ASSERT_EQ(static_cast<int64_t>(SIZE - READ_SIZE), file.Seek(-static_cast<int64_t>(READ_SIZE), SEEK_END));
+  ASSERT_EQ(static_cast<ssize_t>(READ_SIZE), file.Read(buf.data(), READ_SIZE));
+  EXPECT_EQ(0, memcmp(buf.data(), data.data() + SIZE - READ_SIZE, READ_SIZE));
+
+  for (int i = 0; i < READS; i++)
+  {
+    const int64_t position = generator() % (SIZE - READ_SIZE);
+    switch (i % 3)
+    {
+    case 0:
+      ASSERT_EQ(position, file.Seek(position, SEEK_SET));
+      break;
+    case 1:
+      ASSERT_EQ(position, file.Seek(position - file.GetPosition(), SEEK_CUR));
+      break;
+    default:
+      ASSERT_EQ(position, file.Seek(position - static_cast<int64_t>(SIZE), SEEK_END));
+      break;
+    }
+    ASSERT_EQ(static_cast<ssize_t>(READ_SIZE), file.Read(buf.data(), READ_SIZE));
+    ASSERT_EQ(0, memcmp(buf.data(), data.data() + position, READ_SIZE)) << "at " << position;
+  }
+
+  // the reads left points behind to resume from
+  SZipEntry entry;
+  ASSERT_TRUE(g_ZipManager.GetZipEntry(CURL(entryPath), entry));
+  std::shared_ptr<XFILE::CZipSeekIndex> index = g_ZipManager.GetSeekIndex(zipPath, entry);
+  ASSERT_TRUE(index != nullptr);
+  EXPECT_GT(index->GetSize(), 0u);
+
+  // read to the end from the start
+  ASSERT_EQ(0, file.Seek(0, SEEK_SET));
+  size_t total = 0;
+  ssize_t read;
+  while ((read = file.Read(buf.data(), READ_SIZE)) > 0)
+  {
+    ASSERT_EQ(0, memcmp(buf.data(), data.data() + total, read)) << "at " << total;
+    total += read;
+  }
+  EXPECT_EQ(SIZE, total);
+  file.Close();
+
+  g_ZipManager.release(URIUtils::CreateArchivePath("zip", CURL(zipPath), "").Get());
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(zip));
+}
@@ -39,6 +39,7 @@ using namespace KODI;
 using namespace GAME;
 
 #define REWIND_FACTOR  0.25  // Rewind at 25% of gameplay speed
+#define REWIND_MEMORY  (128 * 1024 * 1024) // Max bytes taken by rewind deltas
 
 CGameClientReversiblePlayback::CGameClientReversiblePlayback(CGameClient* gameClient, double fps, size_t serializeSize) :
   m_gameClient(gameClient),
@@ -316,7 +317,7 @@ void CGameClientReversiblePlayback::UpdateMemoryStream()
 
     if (!m_memoryStream)
     {
-      m_memoryStream.reset(new CDeltaPairMemoryStream);
+      m_memoryStream.reset(new CDeltaPairMemoryStream(REWIND_MEMORY));
       m_memoryStream->Init(m_gameClient->SerializeSize(), frameCount);
     }
 
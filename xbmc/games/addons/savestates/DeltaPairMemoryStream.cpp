@@ -21,14 +21,146 @@
 #include "DeltaPairMemoryStream.h"
 #include "utils/log.h"
 
+#ifdef TARGET_WINDOWS_DESKTOP
+#ifdef NDEBUG
+#pragma comment(lib,"lzo2.lib")
+#elif defined _WIN64
+#pragma comment(lib, "lzo2d.lib")
+#else
+#pragma comment(lib, "lzo2-no_idb.lib")
+#endif
+#endif
+
+#include <lzo/lzo1x.h>
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#define DELTA_SSE2 1
+#endif
+
 using namespace KODI;
 using namespace GAME;
 
+// Unchanged words in between changed ones are stored as part of a run, unless
+// there are at least this many of them
+#define MIN_SKIP_WORDS  4
+
+namespace
+{
+#ifdef DELTA_SSE2
+  inline unsigned int FirstSetBit(unsigned int mask)
+  {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+  }
+#endif
+
+  /*!
+   * \brief Return the position of the first word at or after pos that
+   *        differs, or size if there is none
+   */
+  inline size_t FindChanged(const uint32_t* a, const uint32_t* b, size_t pos, size_t size)
+  {
+#ifdef DELTA_SSE2
+    const __m128i zero = _mm_setzero_si128();
+
+    // Most of a save state doesn't change, skip it 32 bytes at a time
+    for (; pos + 8 <= size; pos += 8)
+    {
+      const __m128i x1 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + pos)),
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + pos)));
+      const __m128i x2 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + pos + 4)),
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + pos + 4)));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(x1, x2), zero)) != 0xFFFF)
+      {
+        const unsigned int equal = _mm_movemask_epi8(_mm_cmpeq_epi32(x1, zero));
+        if (equal != 0xFFFF)
+          return pos + FirstSetBit(~equal & 0xFFFF) / 4;
+        return pos + 4 + FirstSetBit(~_mm_movemask_epi8(_mm_cmpeq_epi32(x2, zero)) & 0xFFFF) / 4;
+      }
+    }
+#endif
+
+    while (pos < size && a[pos] == b[pos])
+      pos++;
+
+    return pos;
+  }
+
+  /*!
+   * \brief out = a ^ b for count words
+   */
+  inline void XorWords(const uint32_t* a, const uint32_t* b, uint32_t* out, size_t count)
+  {
+    size_t i = 0;
+
+#ifdef DELTA_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+      const __m128i x = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                      _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), x);
+    }
+#endif
+
+    for (; i < count; i++)
+      out[i] = a[i] ^ b[i];
+  }
+
+  /*!
+   * \brief dest ^= delta for count words
+   */
+  inline void ApplyXor(uint32_t* dest, const uint32_t* delta, size_t count)
+  {
+    size_t i = 0;
+
+#ifdef DELTA_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128i* d = reinterpret_cast<__m128i*>(dest + i);
+      _mm_storeu_si128(d, _mm_xor_si128(_mm_loadu_si128(d), _mm_loadu_si128(reinterpret_cast<const __m128i*>(delta + i))));
+    }
+#endif
+
+    for (; i < count; i++)
+      dest[i] ^= delta[i];
+  }
+}
+
+CDeltaPairMemoryStream::CDeltaPairMemoryStream(size_t maxMemory /* = 0 */) :
+  m_maxMemory(maxMemory)
+{
+}
+
+void CDeltaPairMemoryStream::Init(size_t frameSize, size_t maxFrameCount)
+{
+  CLinearMemoryStream::Init(frameSize, maxFrameCount);
+
+  if (lzo_init() != LZO_E_OK)
+    CLog::Log(LOGERROR, "CDeltaPairMemoryStream: Failed to initialize LZO, deltas won't be compressed");
+  else if (!m_workMemory)
+    m_workMemory.reset(new uint8_t[LZO1X_1_MEM_COMPRESS]);
+}
+
 void CDeltaPairMemoryStream::Reset()
 {
   CLinearMemoryStream::Reset();
 
   m_rewindBuffer.clear();
+  m_memoryUsage = 0;
+
+  m_runs.clear();
+  m_runs.shrink_to_fit();
+  m_compressed.clear();
+  m_compressed.shrink_to_fit();
 }
 
 void CDeltaPairMemoryStream::SubmitFrameInternal()
@@ -39,19 +171,33 @@ void CDeltaPairMemoryStream::SubmitFrameInternal()
   // Record frame history
   frame.frameHistoryCount = m_currentFrameHistory++;
 
-  uint32_t* currentFrame = m_currentFrame.get();
-  uint32_t* nextFrame = m_nextFrame.get();
+  EncodeRuns(m_currentFrame.get(), m_nextFrame.get());
+  frame.runsSize = m_runs.size();
+  frame.compressedSize = 0;
 
-  for (size_t i = 0; i < m_paddedFrameSize; i++)
+  const lzo_uint runsBytes = m_runs.size() * sizeof(uint32_t);
+  if (m_workMemory && runsBytes > 0)
   {
-    uint32_t xor_val = currentFrame[i] ^ nextFrame[i];
-    if (xor_val)
+    // Worst case expansion of LZO1X, see lzo1x.h
+    m_compressed.resize((runsBytes + runsBytes / 16 + 64 + 3 + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+
+    lzo_uint compressedBytes = 0;
+    if (lzo1x_1_compress(reinterpret_cast<lzo_bytep>(m_runs.data()), runsBytes,
+                         reinterpret_cast<lzo_bytep>(m_compressed.data()), &compressedBytes,
+                         m_workMemory.get()) == LZO_E_OK &&
+        compressedBytes < runsBytes)
     {
-      DeltaPair pair = { i, xor_val };
-      frame.buffer.push_back(pair);
+      frame.compressedSize = compressedBytes;
     }
   }
 
+  if (frame.compressedSize > 0)
+    frame.buffer.assign(m_compressed.begin(), m_compressed.begin() + (frame.compressedSize + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+  else
+    frame.buffer.assign(m_runs.begin(), m_runs.end());
+
+  m_memoryUsage += sizeof(MemoryFrame) + frame.buffer.size() * sizeof(uint32_t);
+
   // Delta is generated, bring the new frame forward (m_nextFrame is now disposable)
   std::swap(m_currentFrame, m_nextFrame);
 
@@ -59,6 +205,60 @@ void CDeltaPairMemoryStream::SubmitFrameInternal()
 
   if (PastFramesAvailable() + 1 > MaxFrameCount())
     CullPastFrames(1);
+
+  while (m_maxMemory > 0 && m_memoryUsage > m_maxMemory && m_rewindBuffer.size() > 1)
+    CullPastFrames(1);
+}
+
+void CDeltaPairMemoryStream::EncodeRuns(const uint32_t* currentFrame, const uint32_t* nextFrame)
+{
+  m_runs.clear();
+
+  size_t pos = 0;
+  while (pos < m_paddedFrameSize)
+  {
+    const size_t changed = FindChanged(currentFrame, nextFrame, pos, m_paddedFrameSize);
+    if (changed >= m_paddedFrameSize)
+      break;
+
+    // The run ends where enough unchanged words follow
+    size_t end = changed + 1;
+    size_t unchanged = 0;
+    while (end < m_paddedFrameSize && unchanged < MIN_SKIP_WORDS)
+    {
+      if (currentFrame[end] == nextFrame[end])
+        unchanged++;
+      else
+        unchanged = 0;
+      end++;
+    }
+    end -= unchanged;
+
+    const size_t length = end - changed;
+    const size_t offset = m_runs.size();
+    m_runs.resize(offset + 2 + length);
+    m_runs[offset] = static_cast<uint32_t>(changed - pos);
+    m_runs[offset + 1] = static_cast<uint32_t>(length);
+    XorWords(currentFrame + changed, nextFrame + changed, m_runs.data() + offset + 2, length);
+
+    pos = end;
+  }
+}
+
+const uint32_t* CDeltaPairMemoryStream::DecodeRuns(const MemoryFrame& frame)
+{
+  if (frame.compressedSize == 0)
+    return frame.buffer.data();
+
+  m_runs.resize(frame.runsSize);
+
+  lzo_uint runsBytes = frame.runsSize * sizeof(uint32_t);
+  if (lzo1x_decompress_safe(reinterpret_cast<lzo_bytep>(const_cast<uint32_t*>(frame.buffer.data())), frame.compressedSize,
+                            reinterpret_cast<lzo_bytep>(m_runs.data()), &runsBytes, nullptr) != LZO_E_OK ||
+      runsBytes != frame.runsSize * sizeof(uint32_t))
+    return nullptr;
+
+  return m_runs.data();
 }
 
 unsigned int CDeltaPairMemoryStream::PastFramesAvailable() const
@@ -76,18 +276,38 @@ unsigned int CDeltaPairMemoryStream::RewindFrames(unsigned int frameCount)
       break;
 
     const MemoryFrame& frame = m_rewindBuffer.back();
-    const DeltaPair* buffer = frame.buffer.data();
 
-    size_t bufferSize = frame.buffer.size();
+    const uint32_t* runs = DecodeRuns(frame);
+    if (runs == nullptr)
+    {
+      CLog::Log(LOGERROR, "CDeltaPairMemoryStream: Failed to decompress delta, dropping rewind history");
+      m_rewindBuffer.clear();
+      m_memoryUsage = 0;
+      break;
+    }
+
+    uint32_t* currentFrame = m_currentFrame.get();
+    size_t pos = 0;
+    size_t i = 0;
+    while (i + 2 <= frame.runsSize)
+    {
+      pos += runs[i];
+      const size_t length = runs[i + 1];
+      i += 2;
+
+      if (i + length > frame.runsSize || pos + length > m_paddedFrameSize)
+        break;
 
-    // buffer pointer redirection violates data-dependency requirements...
-    // no vectorization for us :(
-    for (size_t i = 0; i < bufferSize; i++)
-      m_currentFrame[buffer[i].pos] ^= buffer[i].delta;
+      ApplyXor(currentFrame + pos, runs + i, length);
+
+      pos += length;
+      i += length;
+    }
 
     // Restore frame history
     m_currentFrameHistory = frame.frameHistoryCount;
 
+    m_memoryUsage -= sizeof(MemoryFrame) + frame.buffer.size() * sizeof(uint32_t);
     m_rewindBuffer.pop_back();
   }
 
@@ -103,6 +323,7 @@ void CDeltaPairMemoryStream::CullPastFrames(unsigned int frameCount)
       CLog::Log(LOGDEBUG, "CDeltaPairMemoryStream: Tried to cull %d frames too many. Check your math!", frameCount - removedCount);
       break;
     }
+    m_memoryUsage -= sizeof(MemoryFrame) + m_rewindBuffer.front().buffer.size() * sizeof(uint32_t);
     m_rewindBuffer.pop_front();
   }
 }
@@ -22,6 +22,7 @@
 #include "LinearMemoryStream.h"
 
 #include <deque>
+#include <memory>
 #include <vector>
 
 namespace KODI
@@ -34,15 +35,25 @@ namespace GAME
   class CDeltaPairMemoryStream : public CLinearMemoryStream
   {
   public:
-    CDeltaPairMemoryStream() = default;
+    /*!
+     * \param maxMemory The number of bytes the deltas of past frames may
+     *        take, 0 for no limit besides the max frame count
+     */
+    explicit CDeltaPairMemoryStream(size_t maxMemory = 0);
 
     virtual ~CDeltaPairMemoryStream() = default;
 
     // implementation of IMemoryStream via CLinearMemoryStream
+    virtual void         Init(size_t frameSize, size_t maxFrameCount) override;
     virtual void         Reset() override;
     virtual unsigned int PastFramesAvailable() const override;
     virtual unsigned int RewindFrames(unsigned int frameCount) override;
 
+    /*!
+     * \brief Return the number of bytes taken by the deltas of past frames
+     */
+    size_t MemoryUsage() const { return m_memoryUsage; }
+
   protected:
     // implementation of CLinearMemoryStream
     virtual void SubmitFrameInternal() override;
@@ -50,29 +61,40 @@ namespace GAME
 
     /*!
      * Rewinding is implemented by applying XOR deltas on the specific parts of
-     * the save state buffer which have changed. In practice, this is very fast
-     * and simple (linear scan) and allows deltas to be compressed down to 1-3%
-     * of original save state size depending on the system. The algorithm runs
-     * on 32 bits at a time for speed.
+     * the save state buffer which have changed. Only a small part of a save
+     * state changes from one frame to the next, so the XOR of two frames is
+     * stored as runs: the number of unchanged 32-bit words to skip, followed
+     * by the number of changed words and their XOR values. Comparing the
+     * frames and applying the runs work on 128 bits at a time where SSE2 is
+     * available.
+     *
+     * The runs of a frame are compressed with LZO if that makes them smaller,
+     * which brings a delta down to 1-3% of the save state size or less.
      *
      * Use std::deque here to achieve amortized O(1) on pop/push to front and
      * back.
      */
-    struct DeltaPair
-    {
-      size_t   pos;
-      uint32_t delta;
-    };
-
-    using DeltaPairVector = std::vector<DeltaPair>;
-
     struct MemoryFrame
     {
-      DeltaPairVector buffer;
-      uint64_t        frameHistoryCount;
+      std::vector<uint32_t> buffer;
+      size_t                runsSize;       // Words of runs, before compression
+      size_t                compressedSize; // Bytes of LZO data, 0 if not compressed
+      uint64_t              frameHistoryCount;
     };
 
     std::deque<MemoryFrame> m_rewindBuffer;
+
+  private:
+    void EncodeRuns(const uint32_t* currentFrame, const uint32_t* nextFrame);
+    const uint32_t* DecodeRuns(const MemoryFrame& frame);
+
+    const size_t m_maxMemory;
+    size_t m_memoryUsage = 0;
+
+    // Scratch buffers, kept between frames
+    std::vector<uint32_t> m_runs;
+    std::vector<uint32_t> m_compressed;
+    std::unique_ptr<uint8_t[]> m_workMemory;
   };
 }
 }
@@ -0,0 +1,165 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "games/addons/savestates/DeltaPairMemoryStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace KODI;
+using namespace GAME;
+
+// a save state of an emulated console: mostly static RAM and ROM mappings,
+// with a few counters, a sprite table and a scattered set of variables that
+// change every frame
+static void CreateSavestate(std::vector<uint8_t> &state, unsigned int frame)
+{
+  if (frame == 0)
+  {
+    for (size_t i = 0; i < state.size(); i++)
+      state[i] = static_cast<uint8_t>((i * 31) ^ (i >> 7));
+  }
+
+  // frame counter and timers
+  memcpy(state.data() + 16, &frame, sizeof(frame));
+  state[64] = static_cast<uint8_t>(frame * 3);
+
+  // sprite table moving around
+  for (size_t i = 0; i < 512; i++)
+    state[4096 + i] = static_cast<uint8_t>(state[4096 + i] + ((i & 3) == (frame & 3) ? 1 : 0));
+
+  // scattered variables
+  unsigned int seed = frame * 2654435761u;
+  for (int i = 0; i < 32; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    state[(seed >> 8) % state.size()] ^= static_cast<uint8_t>(seed >> 24);
+  }
+}
+
+static void Submit(CDeltaPairMemoryStream &stream, const std::vector<uint8_t> &state)
+{
+  memcpy(stream.BeginFrame(), state.data(), state.size());
+  stream.SubmitFrame();
+}
+
+TEST(TestDeltaPairMemoryStream, Rewind)
+{
+  static const size_t STATE_SIZE = 64 * 1024 + 3;
+  static const unsigned int NUM_FRAMES = 200;
+
+  CDeltaPairMemoryStream stream;
+  stream.Init(STATE_SIZE, NUM_FRAMES);
+
+  std::vector<std::vector<uint8_t>> history;
+  std::vector<uint8_t> state(STATE_SIZE);
+  for (unsigned int frame = 0; frame < NUM_FRAMES; frame++)
+  {
+    CreateSavestate(state, frame);
+    history.push_back(state);
+    Submit(stream, state);
+  }
+
+  ASSERT_EQ(NUM_FRAMES - 1, stream.PastFramesAvailable());
+  EXPECT_EQ(0, memcmp(stream.CurrentFrame(), history.back().data(), STATE_SIZE));
+
+  // rewind in steps of different sizes and compare with the frames submitted
+  unsigned int current = NUM_FRAMES - 1;
+  for (unsigned int step = 1; current > 0; step++)
+  {
+    const unsigned int rewound = stream.RewindFrames(step);
+    ASSERT_EQ(std::min(step, current), rewound);
+    current -= rewound;
+    ASSERT_EQ(0, memcmp(stream.CurrentFrame(), history[current].data(), STATE_SIZE)) << "frame " << current;
+  }
+
+  EXPECT_EQ(0u, stream.PastFramesAvailable());
+  EXPECT_EQ(0u, stream.MemoryUsage());
+  EXPECT_EQ(0u, stream.RewindFrames(1));
+}
+
+TEST(TestDeltaPairMemoryStream, MemoryBudget)
+{
+  static const size_t STATE_SIZE = 16 * 1024;
+  static const size_t MAX_MEMORY = 32 * 1024;
+
+  CDeltaPairMemoryStream stream(MAX_MEMORY);
+  stream.Init(STATE_SIZE, 10000);
+
+  std::vector<std::vector<uint8_t>> history;
+  std::vector<uint8_t> state(STATE_SIZE);
+  for (unsigned int frame = 0; frame < 1000; frame++)
+  {
+    CreateSavestate(state, frame);
+    history.push_back(state);
+    Submit(stream, state);
+    ASSERT_LE(stream.MemoryUsage(), MAX_MEMORY);
+  }
+
+  // the oldest frames are dropped, the ones left can still be restored
+  const unsigned int available = stream.PastFramesAvailable();
+  EXPECT_GT(available, 0u);
+  EXPECT_LT(available, 999u);
+
+  EXPECT_EQ(available, stream.RewindFrames(available));
+  EXPECT_EQ(0, memcmp(stream.CurrentFrame(), history[history.size() - 1 - available].data(), STATE_SIZE));
+  EXPECT_EQ(0u, stream.MemoryUsage());
+}
+
+// Measures the size of the deltas and the time it takes to store and restore
+// them for save states of the size of a 16-bit console
+TEST(TestDeltaPairMemoryStream, DISABLED_Benchmark)
+{
+  static const size_t STATE_SIZE = 512 * 1024;
+  static const unsigned int NUM_FRAMES = 600;
+
+  CDeltaPairMemoryStream stream;
+  stream.Init(STATE_SIZE, NUM_FRAMES);
+
+  std::vector<uint8_t> state(STATE_SIZE);
+  std::vector<std::vector<uint8_t>> states;
+  for (unsigned int frame = 0; frame < NUM_FRAMES; frame++)
+  {
+    CreateSavestate(state, frame);
+    states.push_back(state);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &frame : states)
+    Submit(stream, frame);
+  const auto submitUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  const size_t memoryUsage = stream.MemoryUsage();
+  const unsigned int frames = stream.PastFramesAvailable();
+
+  start = std::chrono::steady_clock::now();
+  EXPECT_EQ(frames, stream.RewindFrames(frames));
+  const auto rewindUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  EXPECT_EQ(0, memcmp(stream.CurrentFrame(), states.front().data(), STATE_SIZE));
+
+  RecordProperty("BytesPerDelta", static_cast<int>(memoryUsage / frames));
+  RecordProperty("SubmitUs", static_cast<int>(submitUs));
+  RecordProperty("RewindUs", static_cast<int>(rewindUs));
+}
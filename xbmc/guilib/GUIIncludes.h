@@ -73,6 +73,11 @@ public:
    */
   const INFO::CSkinVariableString* CreateSkinVariable(const std::string& name, int context);
 
+  /*!
+   \brief Get the include files loaded so far, in the order they were loaded.
+   */
+  const std::vector<std::string>& GetFiles() const { return m_files; }
+
 private:
   enum ResolveParamsResult
   {
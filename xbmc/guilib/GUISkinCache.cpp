@@ -0,0 +1,454 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUISkinCache.h"
+#include "GUIComponent.h"
+#include "GUIInfoManager.h"
+#include "ServiceBroker.h"
+#include "addons/Skin.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/auto_buffer.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <algorithm>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+#define SKIN_CACHE_PATH "special://temp/skincache/"
+
+using namespace XFILE;
+
+namespace
+{
+
+const uint32_t CACHE_MAGIC = 0x43534b4b; // "KKSC"
+const uint32_t CACHE_VERSION = 1;
+
+// deeper trees than this are not written by any skin, but by a corrupt file
+const unsigned int MAX_DEPTH = 256;
+
+enum NodeType : uint8_t
+{
+  NODE_ELEMENT = 1,
+  NODE_TEXT,
+  NODE_CDATA
+};
+
+void WriteUInt8(std::string &buffer, uint8_t value)
+{
+  buffer.push_back(static_cast<char>(value));
+}
+
+void WriteUInt32(std::string &buffer, uint32_t value)
+{
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteInt64(std::string &buffer, int64_t value)
+{
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(std::string &buffer, const std::string &value)
+{
+  WriteUInt32(buffer, static_cast<uint32_t>(value.size()));
+  buffer.append(value);
+}
+
+class CReader
+{
+public:
+  CReader(const char *data, size_t size, size_t offset = 0)
+    : m_data(data), m_size(size), m_offset(offset) {}
+
+  bool Read(void *value, size_t size)
+  {
+    if (m_size - m_offset < size)
+      return false;
+    memcpy(value, m_data + m_offset, size);
+    m_offset += size;
+    return true;
+  }
+
+  bool ReadUInt8(uint8_t &value) { return Read(&value, sizeof(value)); }
+  bool ReadUInt32(uint32_t &value) { return Read(&value, sizeof(value)); }
+  bool ReadInt64(int64_t &value) { return Read(&value, sizeof(value)); }
+
+  bool ReadString(std::string &value)
+  {
+    uint32_t length;
+    if (!ReadUInt32(length) || m_size - m_offset < length)
+      return false;
+    value.assign(m_data + m_offset, length);
+    m_offset += length;
+    return true;
+  }
+
+  size_t Remaining() const { return m_size - m_offset; }
+  size_t GetOffset() const { return m_offset; }
+
+private:
+  const char *m_data;
+  size_t m_size;
+  size_t m_offset;
+};
+
+class CTreeWriter
+{
+public:
+  void Write(const TiXmlElement &element)
+  {
+    WriteUInt8(m_nodes, NODE_ELEMENT);
+    WriteUInt32(m_nodes, Intern(element.ValueStr()));
+
+    uint32_t attributes = 0;
+    for (const TiXmlAttribute *attribute = element.FirstAttribute(); attribute; attribute = attribute->Next())
+      attributes++;
+    WriteUInt32(m_nodes, attributes);
+    for (const TiXmlAttribute *attribute = element.FirstAttribute(); attribute; attribute = attribute->Next())
+    {
+      WriteUInt32(m_nodes, Intern(attribute->NameTStr()));
+      WriteUInt32(m_nodes, Intern(attribute->ValueStr()));
+    }
+
+    uint32_t children = 0;
+    for (const TiXmlNode *child = element.FirstChild(); child; child = child->NextSibling())
+    {
+      if (child->ToElement() || child->ToText())
+        children++;
+    }
+    WriteUInt32(m_nodes, children);
+    for (const TiXmlNode *child = element.FirstChild(); child; child = child->NextSibling())
+    {
+      if (const TiXmlElement *childElement = child->ToElement())
+        Write(*childElement);
+      else if (const TiXmlText *text = child->ToText())
+      {
+        WriteUInt8(m_nodes, text->CDATA() ? NODE_CDATA : NODE_TEXT);
+        WriteUInt32(m_nodes, Intern(text->ValueStr()));
+      }
+    }
+  }
+
+  void Finish(std::string &buffer) const
+  {
+    WriteUInt32(buffer, static_cast<uint32_t>(m_strings.size()));
+    for (const auto &str : m_strings)
+      WriteString(buffer, *str);
+    buffer.append(m_nodes);
+  }
+
+private:
+  // skins repeat the same tag names, attributes and values all over
+  uint32_t Intern(const std::string &str)
+  {
+    auto it = m_index.find(str);
+    if (it != m_index.end())
+      return it->second;
+
+    uint32_t index = static_cast<uint32_t>(m_strings.size());
+    it = m_index.insert(std::make_pair(str, index)).first;
+    m_strings.push_back(&it->first);
+    return index;
+  }
+
+  std::unordered_map<std::string, uint32_t> m_index;
+  std::vector<const std::string*> m_strings;
+  std::string m_nodes;
+};
+
+class CTreeReader
+{
+public:
+  CTreeReader(CReader &reader) : m_reader(reader) {}
+
+  std::unique_ptr<TiXmlElement> Read()
+  {
+    uint32_t count;
+    // every string takes at least its length
+    if (!m_reader.ReadUInt32(count) || count > m_reader.Remaining() / sizeof(uint32_t))
+      return nullptr;
+    m_strings.resize(count);
+    for (auto &str : m_strings)
+    {
+      if (!m_reader.ReadString(str))
+        return nullptr;
+    }
+
+    uint8_t type;
+    if (!m_reader.ReadUInt8(type) || type != NODE_ELEMENT)
+      return nullptr;
+    return ReadElement(0);
+  }
+
+private:
+  const std::string* ReadString()
+  {
+    uint32_t index;
+    if (!m_reader.ReadUInt32(index) || index >= m_strings.size())
+      return nullptr;
+    return &m_strings[index];
+  }
+
+  std::unique_ptr<TiXmlElement> ReadElement(unsigned int depth)
+  {
+    const std::string *name = ReadString();
+    uint32_t attributes;
+    if (!name || depth > MAX_DEPTH || !m_reader.ReadUInt32(attributes))
+      return nullptr;
+
+    std::unique_ptr<TiXmlElement> element(new TiXmlElement(*name));
+    for (uint32_t i = 0; i < attributes; i++)
+    {
+      const std::string *attribute = ReadString();
+      const std::string *value = ReadString();
+      if (!attribute || !value)
+        return nullptr;
+      element->SetAttribute(*attribute, *value);
+    }
+
+    uint32_t children;
+    if (!m_reader.ReadUInt32(children))
+      return nullptr;
+    for (uint32_t i = 0; i < children; i++)
+    {
+      uint8_t type;
+      if (!m_reader.ReadUInt8(type))
+        return nullptr;
+
+      if (type == NODE_ELEMENT)
+      {
+        std::unique_ptr<TiXmlElement> child = ReadElement(depth + 1);
+        if (!child)
+          return nullptr;
+        element->LinkEndChild(child.release());
+      }
+      else if (type == NODE_TEXT || type == NODE_CDATA)
+      {
+        const std::string *value = ReadString();
+        if (!value)
+          return nullptr;
+        TiXmlText *text = new TiXmlText(*value);
+        text->SetCDATA(type == NODE_CDATA);
+        element->LinkEndChild(text);
+      }
+      else
+        return nullptr;
+    }
+    return element;
+  }
+
+  CReader &m_reader;
+  std::vector<std::string> m_strings;
+};
+
+}
+
+CGUISkinCache& CGUISkinCache::GetInstance()
+{
+  static CGUISkinCache skinCache;
+  return skinCache;
+}
+
+std::unique_ptr<TiXmlElement> CGUISkinCache::Load(const std::string &xmlFile, std::map<INFO::InfoPtr, bool>* includeConditions)
+{
+  if (!g_SkinInfo)
+    return nullptr;
+
+  XUTILS::auto_buffer buffer;
+  CFile file;
+  if (file.LoadFile(GetCachePath(xmlFile), buffer) <= 0)
+  {
+    CSingleLock lock(m_section);
+    m_stats.misses++;
+    return nullptr;
+  }
+  file.Close();
+
+  CReader reader(buffer.get(), buffer.size());
+  uint32_t magic, version;
+  std::string key;
+  if (!reader.ReadUInt32(magic) || magic != CACHE_MAGIC ||
+      !reader.ReadUInt32(version) || version != CACHE_VERSION ||
+      !reader.ReadString(key) || key != GetKey(xmlFile))
+  {
+    CSingleLock lock(m_section);
+    m_stats.misses++;
+    return nullptr;
+  }
+
+  // the window file comes first, followed by the include files loaded when
+  // the window was resolved
+  bool valid = true;
+  std::vector<std::string> files;
+  uint32_t count;
+  valid = reader.ReadUInt32(count) && count > 0;
+  for (uint32_t i = 0; valid && i < count; i++)
+  {
+    std::string path;
+    int64_t mtime, size;
+    struct __stat64 st;
+    valid = reader.ReadString(path) && reader.ReadInt64(mtime) && reader.ReadInt64(size) &&
+            CFile::Stat(path, &st) == 0 &&
+            static_cast<int64_t>(st.st_mtime) == mtime && static_cast<int64_t>(st.st_size) == size;
+    files.push_back(path);
+  }
+
+  // include conditions have to evaluate as they did when the window was resolved
+  std::map<INFO::InfoPtr, bool> conditions;
+  valid = valid && reader.ReadUInt32(count);
+  for (uint32_t i = 0; valid && i < count; i++)
+  {
+    std::string expression;
+    uint8_t value;
+    valid = reader.ReadString(expression) && reader.ReadUInt8(value);
+    if (valid)
+    {
+      INFO::InfoPtr condition = CServiceBroker::GetGUI()->GetInfoManager().Register(expression);
+      valid = condition && condition->Get() == (value != 0);
+      conditions.insert(std::make_pair(condition, value != 0));
+    }
+  }
+
+  std::unique_ptr<TiXmlElement> root;
+  if (valid)
+  {
+    size_t offset = reader.GetOffset();
+    root = Deserialize(buffer.get(), buffer.size(), offset);
+  }
+
+  if (!root)
+  {
+    CLog::Log(LOGDEBUG, "CGUISkinCache::%s - cached %s is out of date", __FUNCTION__, xmlFile.c_str());
+    CSingleLock lock(m_section);
+    m_stats.misses++;
+    return nullptr;
+  }
+
+  // includes of other windows may rely on include files only this one loaded
+  const std::vector<std::string> &loaded = g_SkinInfo->GetIncludeFiles();
+  for (auto it = files.begin() + 1; it != files.end(); ++it)
+  {
+    if (std::find(loaded.begin(), loaded.end(), *it) == loaded.end())
+      g_SkinInfo->LoadIncludeFile(*it);
+  }
+
+  if (includeConditions)
+    *includeConditions = std::move(conditions);
+
+  CSingleLock lock(m_section);
+  m_stats.hits++;
+  return root;
+}
+
+void CGUISkinCache::Save(const std::string &xmlFile, const TiXmlElement &resolved, const std::map<INFO::InfoPtr, bool> &includeConditions)
+{
+  if (!g_SkinInfo)
+    return;
+
+  std::string buffer;
+  WriteUInt32(buffer, CACHE_MAGIC);
+  WriteUInt32(buffer, CACHE_VERSION);
+  WriteString(buffer, GetKey(xmlFile));
+
+  std::vector<std::string> files(1, xmlFile);
+  const std::vector<std::string> &includeFiles = g_SkinInfo->GetIncludeFiles();
+  files.insert(files.end(), includeFiles.begin(), includeFiles.end());
+  WriteUInt32(buffer, static_cast<uint32_t>(files.size()));
+  for (const auto &path : files)
+  {
+    struct __stat64 st;
+    if (CFile::Stat(path, &st) != 0)
+      return;
+    WriteString(buffer, path);
+    WriteInt64(buffer, static_cast<int64_t>(st.st_mtime));
+    WriteInt64(buffer, static_cast<int64_t>(st.st_size));
+  }
+
+  WriteUInt32(buffer, static_cast<uint32_t>(includeConditions.size()));
+  for (const auto &condition : includeConditions)
+  {
+    WriteString(buffer, condition.first->GetExpression());
+    WriteUInt8(buffer, condition.second ? 1 : 0);
+  }
+
+  Serialize(resolved, buffer);
+
+  CDirectory::Create(SKIN_CACHE_PATH);
+  CFile file;
+  if (!file.OpenForWrite(GetCachePath(xmlFile), true) ||
+      file.Write(buffer.c_str(), buffer.size()) != static_cast<ssize_t>(buffer.size()))
+  {
+    file.Close();
+    CLog::Log(LOGWARNING, "CGUISkinCache::%s - unable to cache %s", __FUNCTION__, xmlFile.c_str());
+    CFile::Delete(GetCachePath(xmlFile));
+  }
+}
+
+void CGUISkinCache::AddLoadTime(bool cached, double ms)
+{
+  CSingleLock lock(m_section);
+  if (cached)
+    m_stats.hitTime += ms;
+  else
+    m_stats.missTime += ms;
+}
+
+CGUISkinCache::Statistics CGUISkinCache::GetStatistics() const
+{
+  CSingleLock lock(m_section);
+  return m_stats;
+}
+
+void CGUISkinCache::Serialize(const TiXmlElement &root, std::string &buffer)
+{
+  CTreeWriter writer;
+  writer.Write(root);
+  writer.Finish(buffer);
+}
+
+std::unique_ptr<TiXmlElement> CGUISkinCache::Deserialize(const char *data, size_t size, size_t &offset)
+{
+  if (offset > size)
+    return nullptr;
+
+  CReader reader(data, size, offset);
+  CTreeReader treeReader(reader);
+  std::unique_ptr<TiXmlElement> root = treeReader.Read();
+  if (root)
+    offset = reader.GetOffset();
+  return root;
+}
+
+std::string CGUISkinCache::GetCachePath(const std::string &xmlFile)
+{
+  return StringUtils::Format(SKIN_CACHE_PATH "%08x.bin", Crc32::ComputeFromLowerCase(xmlFile));
+}
+
+std::string CGUISkinCache::GetKey(const std::string &xmlFile)
+{
+  return g_SkinInfo->ID() + " " + g_SkinInfo->Version().asString() + " " + xmlFile;
+}
@@ -0,0 +1,100 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+#include "interfaces/info/InfoBool.h"
+#include "threads/CriticalSection.h"
+
+class TiXmlElement;
+
+/*!
+ \brief Cache of window XML files with all includes, constants and expressions
+ resolved, stored in a compact binary form.
+
+ An entry is only used while the window file and every include file loaded at
+ the time it was written are unchanged, and while all <include condition="...">
+ conditions evaluated during resolving still have the same value.
+ */
+class CGUISkinCache
+{
+public:
+  struct Statistics
+  {
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+    double hitTime = 0.0;   //!< ms spent loading windows from the cache
+    double missTime = 0.0;  //!< ms spent parsing and resolving windows
+  };
+
+  static CGUISkinCache& GetInstance();
+
+  /*!
+   \brief Get the resolved tree of a window from the cache
+   \param xmlFile path of the window XML file
+   \param includeConditions [out] the include conditions of the window and their values
+   \return the resolved root element, nullptr if there is no valid entry
+   */
+  std::unique_ptr<TiXmlElement> Load(const std::string &xmlFile, std::map<INFO::InfoPtr, bool>* includeConditions);
+
+  /*!
+   \brief Store the resolved tree of a window
+   \param xmlFile path of the window XML file
+   \param resolved the root element after resolving includes
+   \param includeConditions the include conditions evaluated while resolving
+   */
+  void Save(const std::string &xmlFile, const TiXmlElement &resolved, const std::map<INFO::InfoPtr, bool> &includeConditions);
+
+  /*!
+   \brief Account the time it took to get a window ready for the control factory
+   \param cached true if the window came from the cache
+   \param ms time spent
+   */
+  void AddLoadTime(bool cached, double ms);
+
+  Statistics GetStatistics() const;
+
+  /*!
+   \brief Serialize an element tree, comments and declarations are dropped
+   */
+  static void Serialize(const TiXmlElement &root, std::string &buffer);
+
+  /*!
+   \brief Rebuild an element tree written by Serialize
+   \param data the buffer
+   \param size size of the buffer
+   \param offset [in/out] position of the tree in the buffer, behind it on return
+   \return the root element, nullptr if the data is invalid
+   */
+  static std::unique_ptr<TiXmlElement> Deserialize(const char *data, size_t size, size_t &offset);
+
+private:
+  CGUISkinCache() = default;
+
+  static std::string GetCachePath(const std::string &xmlFile);
+  static std::string GetKey(const std::string &xmlFile);
+
+  mutable CCriticalSection m_section;
+  Statistics m_stats;
+};
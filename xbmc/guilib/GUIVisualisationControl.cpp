@@ -79,6 +79,7 @@ CGUIVisualisationControl::CGUIVisualisationControl(int parentID, int controlID,
     m_alreadyStarted(false),
     m_attemptedLoad(false),
     m_updateTrack(false),
+    m_audioRing(AUDIO_RING_SIZE),
     m_instance(nullptr)
 {
   ControlType = GUICONTROL_VISUALISATION;
@@ -89,6 +90,7 @@ CGUIVisualisationControl::CGUIVisualisationControl(const CGUIVisualisationContro
     m_callStart(false),
     m_alreadyStarted(false),
     m_attemptedLoad(false),
+    m_audioRing(AUDIO_RING_SIZE),
     m_instance(nullptr)
 {
   ControlType = GUICONTROL_VISUALISATION;
@@ -184,6 +186,9 @@ void CGUIVisualisationControl::Process(unsigned int currentTime, CDirtyRegionLis
         songTitle = tag->GetTitle();
       m_alreadyStarted = m_instance->Start(m_channels, m_samplesPerSec, m_bitsPerSample, songTitle);
       CServiceBroker::GetWinSystem()->GetGfxContext().ApplyStateBlock();
+      // the vis only reports its buffer needs once started
+      if (m_alreadyStarted)
+        CreateBuffers();
       m_callStart = false;
       m_updateTrack = true;
     }
@@ -194,6 +199,9 @@ void CGUIVisualisationControl::Process(unsigned int currentTime, CDirtyRegionLis
       m_updateTrack = false;
     }
 
+    if (m_alreadyStarted)
+      ProcessAudioData();
+
     MarkDirtyRegion();
   }
 
@@ -262,36 +270,51 @@ void CGUIVisualisationControl::OnAudioData(const float* audioData, unsigned int
   if (!m_instance || !m_alreadyStarted)
     return;
 
-  // Save our audio data in the buffers
-  std::unique_ptr<CAudioBuffer> pBuffer(new CAudioBuffer(audioDataLength));
-  pBuffer->Set(audioData, audioDataLength);
-  //m_vecBuffers.push_back(pBuffer.release());
-  m_vecBuffers.emplace_back(std::move(pBuffer));
-
-  if (m_vecBuffers.size() < m_numBuffers)
+  // Only copy the data here, the audio thread must not wait for the vis.
+  // If the GUI thread falls behind, the data is dropped.
+  std::vector<float>* slot = m_audioRing.GetWriteSlot();
+  if (!slot)
     return;
 
-  std::unique_ptr<CAudioBuffer> ptrAudioBuffer = std::move(m_vecBuffers.front());
-  m_vecBuffers.pop_front();
+  slot->assign(audioData, audioData + audioDataLength);
+  m_audioRing.Commit();
+}
 
-  // Fourier transform the data if the vis wants it...
-  if (m_wantsFreq)
+void CGUIVisualisationControl::ProcessAudioData()
+{
+  std::vector<float>* slot;
+  while ((slot = m_audioRing.GetReadSlot()) != nullptr)
   {
-    const float *psAudioData = ptrAudioBuffer->Get();
+    // Save our audio data in the buffers
+    std::unique_ptr<CAudioBuffer> pBuffer(new CAudioBuffer(slot->size()));
+    pBuffer->Set(slot->data(), slot->size());
+    m_audioRing.Release();
+    m_vecBuffers.emplace_back(std::move(pBuffer));
 
-    if (!m_transform)
-      m_transform.reset(new RFFT(AUDIO_BUFFER_SIZE/2, false)); // half due to stereo
+    if (m_vecBuffers.size() < m_numBuffers)
+      continue;
 
-    m_transform->calc(psAudioData, m_freq);
+    std::unique_ptr<CAudioBuffer> ptrAudioBuffer = std::move(m_vecBuffers.front());
+    m_vecBuffers.pop_front();
 
-    // Transfer data to our visualisation
-    m_instance->AudioData(psAudioData, ptrAudioBuffer->Size(), m_freq, AUDIO_BUFFER_SIZE/2); // half due to complex-conjugate
-  }
-  else
-  { // Transfer data to our visualisation
-    m_instance->AudioData(ptrAudioBuffer->Get(), ptrAudioBuffer->Size(), nullptr, 0);
+    // Fourier transform the data if the vis wants it...
+    if (m_wantsFreq)
+    {
+      const float *psAudioData = ptrAudioBuffer->Get();
+
+      if (!m_transform)
+        m_transform.reset(new RFFT(AUDIO_BUFFER_SIZE/2, false)); // half due to stereo
+
+      m_transform->calc(psAudioData, m_freq);
+
+      // Transfer data to our visualisation
+      m_instance->AudioData(psAudioData, ptrAudioBuffer->Size(), m_freq, AUDIO_BUFFER_SIZE/2); // half due to complex-conjugate
+    }
+    else
+    { // Transfer data to our visualisation
+      m_instance->AudioData(ptrAudioBuffer->Get(), ptrAudioBuffer->Size(), nullptr, 0);
+    }
   }
-  return;
 }
 
 void CGUIVisualisationControl::UpdateTrack()
@@ -465,6 +488,7 @@ void CGUIVisualisationControl::ClearBuffers()
 {
   m_wantsFreq = false;
   m_numBuffers = 0;
+  m_audioRing.Clear();
   m_vecBuffers.clear();
 
   for (int j = 0; j < AUDIO_BUFFER_SIZE; ++j)
@@ -22,10 +22,12 @@
 #include "GUIControl.h"
 #include "addons/Visualization.h"
 #include "cores/AudioEngine/Interfaces/IAudioCallback.h"
+#include "utils/LockFreeRingBuffer.h"
 #include "utils/rfft.h"
 
 #define AUDIO_BUFFER_SIZE 512 // MUST BE A POWER OF 2!!!
 #define MAX_AUDIO_BUFFERS 16
+#define AUDIO_RING_SIZE   32 // audio packets waiting for the GUI thread
 
 class CAudioBuffer
 {
@@ -79,12 +81,14 @@ private:
   void DeInitVisualization();
   inline void CreateBuffers();
   inline void ClearBuffers();
+  void ProcessAudioData();
 
   bool m_callStart;
   bool m_alreadyStarted;
   bool m_attemptedLoad;
   bool m_updateTrack;
 
+  CLockFreeRingBuffer<std::vector<float>> m_audioRing; /*!< Audio data passed from the audio thread */
   std::list<std::unique_ptr<CAudioBuffer>> m_vecBuffers;
   unsigned int m_numBuffers; /*!< Number of Audio buffers */
   bool m_wantsFreq;
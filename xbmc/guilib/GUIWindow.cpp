@@ -25,6 +25,7 @@
 #include "GUIControlFactory.h"
 #include "GUIControlGroup.h"
 #include "GUIControlProfiler.h"
+#include "GUISkinCache.h"
 
 #include "addons/Skin.h"
 #include "GUIInfoManager.h"
@@ -136,13 +137,25 @@ bool CGUIWindow::Load(const std::string& strFileName, bool bContainsPath)
 
 bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLowerPath)
 {
+  int64_t start = CurrentHostCounter();
+  bool cacheable = false;
+
   // load window xml if we don't have it stored yet
   if (!m_windowXMLRootElement)
   {
+    // the window may have been resolved before, possibly in an earlier session
+    std::unique_ptr<TiXmlElement> cached = CGUISkinCache::GetInstance().Load(strPath, &m_xmlIncludeConditions);
+    if (cached)
+    {
+      CGUISkinCache::GetInstance().AddLoadTime(true, 1000.0 * (CurrentHostCounter() - start) / CurrentHostFrequency());
+      return Load(cached.get());
+    }
+
     CXBMCTinyXML xmlDoc;
     std::string strPathLower = strPath;
     StringUtils::ToLower(strPathLower);
-    if (!xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(strPathLower) && !xmlDoc.LoadFile(strLowerPath))
+    cacheable = xmlDoc.LoadFile(strPath);
+    if (!cacheable && !xmlDoc.LoadFile(strPathLower) && !xmlDoc.LoadFile(strLowerPath))
     {
       CLog::Log(LOGERROR, "Unable to load window XML: %s. Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
       SetID(WINDOW_INVALID);
@@ -162,7 +175,12 @@ bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLower
   else
     CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
 
-  return Load(Prepare(m_windowXMLRootElement).get());
+  std::unique_ptr<TiXmlElement> preparedRoot = Prepare(m_windowXMLRootElement);
+  if (preparedRoot && cacheable)
+    CGUISkinCache::GetInstance().Save(strPath, *preparedRoot, m_xmlIncludeConditions);
+  CGUISkinCache::GetInstance().AddLoadTime(false, 1000.0 * (CurrentHostCounter() - start) / CurrentHostFrequency());
+
+  return Load(preparedRoot.get());
 }
 
 std::unique_ptr<TiXmlElement> CGUIWindow::Prepare(TiXmlElement *pRootElement)
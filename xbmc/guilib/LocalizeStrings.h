@@ -29,7 +29,7 @@
  */
 
 #include "threads/CriticalSection.h"
-#include "threads/SharedSection.h"
+#include "threads/ReadWriteSection.h"
 
 #include <map>
 #include <string>
@@ -76,8 +76,8 @@ protected:
   typedef std::map<uint32_t, LocStr>::const_iterator ciStrings;
   typedef std::map<uint32_t, LocStr>::iterator       iStrings;
 
-  CSharedSection m_stringsMutex;
-  CSharedSection m_addonStringsMutex;
+  CReadWriteSection m_stringsMutex{"CLocalizeStrings", CReadWriteSection::Preference::READERS};
+  CReadWriteSection m_addonStringsMutex{"CLocalizeStrings.Addons", CReadWriteSection::Preference::READERS};
 };
 
 /*!
@@ -21,6 +21,9 @@
 #include "guilib/guiinfo/LibraryGUIInfo.h"
 
 #include "Application.h"
+#include "GUIInfoManager.h"
+#include "ServiceBroker.h"
+#include "guilib/GUIComponent.h"
 #include "music/MusicDatabase.h"
 #include "utils/StringUtils.h"
 #include "video/VideoDatabase.h"
@@ -70,6 +73,7 @@ void CLibraryGUIInfo::SetLibraryBool(int condition, bool value)
     default:
       break;
   }
+  InvalidateLibraryInfos();
 }
 
 void CLibraryGUIInfo::ResetLibraryBools()
@@ -82,6 +86,15 @@ void CLibraryGUIInfo::ResetLibraryBools()
   m_libraryHasSingles = -1;
   m_libraryHasCompilations = -1;
   m_libraryRoleCounts.clear();
+  InvalidateLibraryInfos();
+}
+
+void CLibraryGUIInfo::InvalidateLibraryInfos()
+{
+  // the conditions on the library are only updated after it changed
+  CGUIComponent* gui = CServiceBroker::GetGUI();
+  if (gui)
+    gui->GetInfoManager().InvalidateInfo(INFO::SOURCE_LIBRARY);
 }
 
 bool CLibraryGUIInfo::InitCurrentItem(CFileItem *item)
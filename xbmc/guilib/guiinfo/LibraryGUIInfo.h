@@ -51,6 +51,8 @@ public:
   void ResetLibraryBools();
 
 private:
+  static void InvalidateLibraryInfos();
+
   mutable int m_libraryHasMusic;
   mutable int m_libraryHasMovies;
   mutable int m_libraryHasTVShows;
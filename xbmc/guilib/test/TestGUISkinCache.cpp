@@ -0,0 +1,137 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUISkinCache.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <chrono>
+#include <string>
+
+#include "gtest/gtest.h"
+
+static std::string Print(const TiXmlElement &element)
+{
+  TiXmlPrinter printer;
+  element.Accept(&printer);
+  return printer.Str();
+}
+
+// a window of the size of a home screen with its widgets after include expansion
+static std::string CreateWindow(int controls)
+{
+  std::string xml = "<window type=\"window\" id=\"1100\"><defaultcontrol always=\"true\">9000</defaultcontrol><controls>";
+  for (int i = 0; i < controls; i++)
+  {
+    xml += StringUtils::Format(
+      "<control type=\"button\" id=\"%i\">"
+      "<left>%i</left><top>%i</top><width>300</width><height>80</height>"
+      "<label>$INFO[ListItem.Label]</label>"
+      "<texturefocus colordiffuse=\"ff12b2e7\" border=\"10\">buttons/focus.png</texturefocus>"
+      "<texturenofocus border=\"10\">buttons/nofocus.png</texturenofocus>"
+      "<visible>Skin.HasSetting(widget%i) + !Window.IsActive(busydialog)</visible>"
+      "<animation effect=\"fade\" start=\"0\" end=\"100\" time=\"200\">WindowOpen</animation>"
+      "<onclick>ActivateWindow(Videos,videodb://movies/titles/,return)</onclick>"
+      "</control>", i, (i % 6) * 300, (i / 6) * 80, i % 10);
+  }
+  xml += "</controls></window>";
+  return xml;
+}
+
+TEST(TestGUISkinCache, RoundTrip)
+{
+  CXBMCTinyXML doc;
+  ASSERT_TRUE(doc.Parse(
+    "<window id=\"10\">"
+    "<!-- comments are not needed by the control factory -->"
+    "<controls>"
+    "<control type=\"label\" id=\"2\"><label>A &amp; B</label><visible>true</visible></control>"
+    "<control type=\"group\"><control type=\"image\"><texture></texture></control></control>"
+    "<description><![CDATA[<b>kept</b>]]></description>"
+    "</controls>"
+    "</window>", TIXML_ENCODING_UTF8));
+
+  std::string buffer = "header";
+  CGUISkinCache::Serialize(*doc.RootElement(), buffer);
+  EXPECT_EQ(0u, buffer.find("header"));
+
+  size_t offset = 6;
+  std::unique_ptr<TiXmlElement> root = CGUISkinCache::Deserialize(buffer.c_str(), buffer.size(), offset);
+  ASSERT_TRUE(root != nullptr);
+  EXPECT_EQ(buffer.size(), offset);
+
+  doc.RootElement()->RemoveChild(doc.RootElement()->FirstChild());
+  EXPECT_EQ(Print(*doc.RootElement()), Print(*root));
+
+  const TiXmlElement *label = root->FirstChildElement("controls")->FirstChildElement("control")->FirstChildElement("label");
+  ASSERT_TRUE(label != nullptr);
+  EXPECT_STREQ("A & B", label->FirstChild()->Value());
+}
+
+TEST(TestGUISkinCache, Corrupt)
+{
+  CXBMCTinyXML doc;
+  ASSERT_TRUE(doc.Parse(CreateWindow(10), TIXML_ENCODING_UTF8));
+  std::string buffer;
+  CGUISkinCache::Serialize(*doc.RootElement(), buffer);
+
+  // a cache file written only partially must never be taken
+  for (size_t size = 0; size < buffer.size(); size++)
+  {
+    size_t offset = 0;
+    EXPECT_TRUE(CGUISkinCache::Deserialize(buffer.c_str(), size, offset) == nullptr) << "size " << size;
+    EXPECT_EQ(0u, offset);
+  }
+}
+
+// Compares parsing a resolved window with TinyXML to rebuilding it from the
+// cache
+TEST(TestGUISkinCache, DISABLED_Benchmark)
+{
+  static const int NUM_CONTROLS = 2000;
+  static const int NUM_LOADS = 20;
+  const std::string xml = CreateWindow(NUM_CONTROLS);
+
+  CXBMCTinyXML doc;
+  ASSERT_TRUE(doc.Parse(xml, TIXML_ENCODING_UTF8));
+  std::string buffer;
+  CGUISkinCache::Serialize(*doc.RootElement(), buffer);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < NUM_LOADS; i++)
+  {
+    CXBMCTinyXML parsed;
+    ASSERT_TRUE(parsed.Parse(xml, TIXML_ENCODING_UTF8));
+  }
+  const auto parseUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < NUM_LOADS; i++)
+  {
+    size_t offset = 0;
+    ASSERT_TRUE(CGUISkinCache::Deserialize(buffer.c_str(), buffer.size(), offset) != nullptr);
+  }
+  const auto cachedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  RecordProperty("XmlBytes", static_cast<int>(xml.size()));
+  RecordProperty("CachedBytes", static_cast<int>(buffer.size()));
+  RecordProperty("TinyXmlUs", static_cast<int>(parseUs));
+  RecordProperty("CachedUs", static_cast<int>(cachedUs));
+}
@@ -23,13 +23,33 @@
 
 namespace INFO
 {
-  InfoBool::InfoBool(const std::string &expression, int context, unsigned int &refreshCounter)
+  CInfoSources::CInfoSources()
+    : m_lookups(0),
+      m_evaluations(0),
+      m_version(1)
+  {
+    for (unsigned int source = 0; source < SOURCE_COUNT; source++)
+      m_changed[source] = 0;
+  }
+
+  void CInfoSources::Invalidate(unsigned int sources)
+  {
+    const uint64_t version = ++m_version;
+    for (unsigned int source = 0; source < SOURCE_COUNT; source++)
+    {
+      if (sources & (1 << source))
+        m_changed[source] = version;
+    }
+  }
+
+  InfoBool::InfoBool(const std::string &expression, int context, CInfoSources &sources)
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
       m_expression(expression),
-      m_refreshCounter(0),
-      m_parentRefreshCounter(refreshCounter)
+      m_infoSources(SOURCE_FRAME),
+      m_version(0),
+      m_sources(sources)
   {
     StringUtils::ToLower(m_expression);
   }
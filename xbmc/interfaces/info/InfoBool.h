@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <stdint.h>
 #include <string>
 #include <memory>
 
@@ -27,6 +29,59 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief The data an info depends on, it is only updated after one of them changed
+ */
+enum InfoSource
+{
+  SOURCE_NONE    = 0,
+  SOURCE_FRAME   = 1 << 0, ///< anything not tracked otherwise, changes every frame
+  SOURCE_PLAYER  = 1 << 1, ///< playback state, changes every frame while there is a player
+  SOURCE_TIME    = 1 << 2, ///< wall clock, changes every second
+  SOURCE_LIBRARY = 1 << 3, ///< contents of the library
+  SOURCE_SKIN    = 1 << 4, ///< skin settings
+  SOURCE_ALL     = (1 << 5) - 1
+};
+
+/*!
+ \ingroup info
+ \brief Keeps track of when the sources of the infos changed
+ */
+class CInfoSources
+{
+public:
+  CInfoSources();
+
+  /*! \brief Mark the sources as changed, may be called from any thread
+   \param sources a combination of InfoSource
+   */
+  void Invalidate(unsigned int sources);
+
+  uint64_t GetVersion() const { return m_version; }
+
+  /*! \brief Whether any of the sources changed after the given version
+   */
+  inline bool ChangedSince(unsigned int sources, uint64_t version) const
+  {
+    for (unsigned int source = 0; sources != 0; source++, sources >>= 1)
+    {
+      if ((sources & 1) && m_changed[source] > version)
+        return true;
+    }
+    return false;
+  }
+
+  unsigned int m_lookups;     ///< infos looked up since the statistics were reset
+  unsigned int m_evaluations; ///< infos (re)evaluated since the statistics were reset
+
+private:
+  static const unsigned int SOURCE_COUNT = 5;
+
+  std::atomic<uint64_t> m_version;
+  std::atomic<uint64_t> m_changed[SOURCE_COUNT];
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -34,7 +89,7 @@ namespace INFO
 class InfoBool
 {
 public:
-  InfoBool(const std::string &expression, int context, unsigned int &refreshCounter);
+  InfoBool(const std::string &expression, int context, CInfoSources &sources);
   virtual ~InfoBool() = default;
 
   virtual void Initialize() {};
@@ -45,12 +100,22 @@ public:
    */
   inline bool Get(const CGUIListItem *item = NULL)
   {
+    m_sources.m_lookups++;
     if (item && m_listItemDependent)
+    {
+      m_sources.m_evaluations++;
       Update(item);
-    else if (m_refreshCounter != m_parentRefreshCounter || m_refreshCounter == 0)
+    }
+    else
     {
-      Update(NULL);
-      m_refreshCounter = m_parentRefreshCounter;
+      // fetched first, a source changing during the update marks us dirty again
+      const uint64_t version = m_sources.GetVersion();
+      if (m_version == 0 || m_sources.ChangedSince(m_infoSources, m_version))
+      {
+        m_sources.m_evaluations++;
+        Update(NULL);
+        m_version = version;
+      }
     }
     return m_value;
   }
@@ -78,16 +143,18 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+  unsigned int GetInfoSources() const { return m_infoSources; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
   std::string  m_expression;   ///< original expression
+  unsigned int m_infoSources;  ///< InfoSource the value depends on
 
 private:
-  unsigned int m_refreshCounter;
-  unsigned int &m_parentRefreshCounter;
+  uint64_t m_version;          ///< version of the sources at the last update, 0 if never updated
+  CInfoSources &m_sources;
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
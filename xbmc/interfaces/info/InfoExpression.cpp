@@ -24,6 +24,7 @@
 #include "GUIInfoManager.h"
 #include "guilib/GUIComponent.h"
 #include "ServiceBroker.h"
+#include <algorithm>
 #include <list>
 #include <memory>
 
@@ -31,7 +32,9 @@ using namespace INFO;
 
 void InfoSingle::Initialize()
 {
-  m_condition = CServiceBroker::GetGUI()->GetInfoManager().TranslateSingleString(m_expression, m_listItemDependent);
+  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
+  m_condition = infoMgr.TranslateSingleString(m_expression, m_listItemDependent);
+  m_infoSources = infoMgr.GetInfoSources(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -44,13 +47,18 @@ void InfoExpression::Initialize()
   if (!Parse(m_expression))
   {
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", m_expression.c_str());
-    m_expression_tree = std::make_shared<InfoLeaf>(CServiceBroker::GetGUI()->GetInfoManager().Register("false", 0), false);
+    InfoPtr info = CServiceBroker::GetGUI()->GetInfoManager().Register("false", 0);
+    m_infoSources = info->GetInfoSources();
+    m_program.clear();
+    m_leaves.clear();
+    Compile(std::make_shared<InfoLeaf>(info, false));
   }
 }
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  m_value = m_expression_tree->Evaluate(item);
+  size_t pc = 0;
+  m_value = Evaluate(pc, item);
 }
 
 /* Expressions are rewritten at parse time into a form which favours the
@@ -69,11 +77,61 @@ void InfoExpression::Update(const CGUIListItem *item)
  * 2) Combining adjacent AND or OR operations such that each path from the root
  *    to a leaf encounters a strictly alternating pattern of AND and OR
  *    operations. So [A|B]|[C|D+[[E|F]|G] becomes A|B|C|[D+[E|F|G]].
+ *
+ * The resulting tree is compiled into a flat program in prefix order: a group
+ * is followed by its children and knows the number of instructions it spans.
+ * This allows skipping the rest of a group once its value is known, and moving
+ * a child to the front of its group as a block, without chasing pointers
+ * through the tree for every evaluation.
  */
 
-bool InfoExpression::InfoLeaf::Evaluate(const CGUIListItem *item)
+void InfoExpression::Compile(const InfoSubexpressionPtr &node)
+{
+  if (node->Type() == NODE_LEAF)
+  {
+    const auto leaf = std::static_pointer_cast<InfoLeaf>(node);
+    m_program.push_back({ NODE_LEAF, leaf->m_invert, static_cast<unsigned int>(m_leaves.size()) });
+    m_leaves.push_back(leaf->m_info);
+    return;
+  }
+
+  const size_t start = m_program.size();
+  m_program.push_back({ node->Type(), false, 0 });
+  for (const auto &child : std::static_pointer_cast<InfoAssociativeGroup>(node)->m_children)
+    Compile(child);
+  m_program[start].arg = static_cast<unsigned int>(m_program.size() - start);
+}
+
+bool InfoExpression::Evaluate(size_t &pc, const CGUIListItem *item)
 {
-  return m_invert ^ m_info->Get(item);
+  const Instruction instruction = m_program[pc];
+  if (instruction.type == NODE_LEAF)
+  {
+    pc++;
+    return instruction.invert ^ m_leaves[instruction.arg]->Get(item);
+  }
+
+  /* Handle either AND or OR by using the relation
+   * A AND B == !(!A OR !B)
+   * to convert ANDs into ORs
+   */
+  const bool use_and = (instruction.type == NODE_AND);
+  const size_t first = pc + 1;
+  const size_t end = pc + instruction.arg;
+  pc = first;
+  while (pc < end)
+  {
+    const size_t child = pc;
+    if (use_and ^ Evaluate(pc, item))
+    {
+      /* Move this child to the head of the group so we evaluate faster next time */
+      if (child != first)
+        std::rotate(m_program.begin() + first, m_program.begin() + child, m_program.begin() + pc);
+      pc = end;
+      return !use_and;
+    }
+  }
+  return use_and;
 }
 
 InfoExpression::InfoAssociativeGroup::InfoAssociativeGroup(
@@ -96,29 +154,6 @@ void InfoExpression::InfoAssociativeGroup::Merge(std::shared_ptr<InfoAssociative
   m_children.splice(m_children.end(), other->m_children);
 }
 
-bool InfoExpression::InfoAssociativeGroup::Evaluate(const CGUIListItem *item)
-{
-  /* Handle either AND or OR by using the relation
-   * A AND B == !(!A OR !B)
-   * to convert ANDs into ORs
-   */
-  std::list<InfoSubexpressionPtr>::iterator last = m_children.end();
-  std::list<InfoSubexpressionPtr>::iterator it = m_children.begin();
-  bool use_and = (m_type == NODE_AND);
-  bool result = use_and ^ (*it)->Evaluate(item);
-  while (!result && ++it != last)
-  {
-    result = use_and ^ (*it)->Evaluate(item);
-    if (result)
-    {
-      /* Move this child to the head of the list so we evaluate faster next time */
-      m_children.push_front(*it);
-      m_children.erase(it);
-    }
-  }
-  return use_and ^ result;
-}
-
 /* Expressions are parsed using the shunting-yard algorithm. Binary operators
  * (AND/OR) are treated as right-associative so that we don't need to make a
  * special case for the unary NOT operator. This has no effect upon the answers
@@ -219,6 +254,7 @@ bool InfoExpression::Parse(const std::string &expression)
   int bracket_count = 0;
 
   CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
+  m_infoSources = SOURCE_NONE;
 
   char c;
   // Skip leading whitespace - don't want it to count as an operand if that's all there is
@@ -252,8 +288,9 @@ bool InfoExpression::Parse(const std::string &expression)
           CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
           return false;
         }
-        /* Propagate any listItem dependency from the operand to the expression */
+        /* Propagate any listItem dependency and the sources from the operand to the expression */
         m_listItemDependent |= info->ListItemDependent();
+        m_infoSources |= info->GetInfoSources();
         nodes.push(std::make_shared<InfoLeaf>(info, invert));
         /* Reuse operand string for next operand */
         operand.clear();
@@ -303,13 +340,14 @@ bool InfoExpression::Parse(const std::string &expression)
       CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
       return false;
     }
-    /* Propagate any listItem dependency from the operand to the expression */
+    /* Propagate any listItem dependency and the sources from the operand to the expression */
     m_listItemDependent |= info->ListItemDependent();
+    m_infoSources |= info->GetInfoSources();
     nodes.push(std::make_shared<InfoLeaf>(info, invert));
   }
   while (!operator_stack.empty())
     OperatorPop(operator_stack, invert, nodes);
 
-  m_expression_tree = nodes.top();
+  Compile(nodes.top());
   return true;
 }
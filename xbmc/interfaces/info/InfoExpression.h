@@ -34,8 +34,8 @@ namespace INFO
 class InfoSingle : public InfoBool
 {
 public:
-  InfoSingle(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoSingle(const std::string &expression, int context, CInfoSources &sources)
+    : InfoBool(expression, context, sources) {};
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
@@ -48,8 +48,8 @@ private:
 class InfoExpression : public InfoBool
 {
 public:
-  InfoExpression(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoExpression(const std::string &expression, int context, CInfoSources &sources)
+    : InfoBool(expression, context, sources) {};
   ~InfoExpression() override = default;
 
   void Initialize() override;
@@ -73,12 +73,11 @@ private:
     NODE_OR,
   } node_type_t;
 
-  // An abstract base class for nodes in the expression tree
+  // An abstract base class for nodes in the expression tree built while parsing
   class InfoSubexpression
   {
   public:
     virtual ~InfoSubexpression(void) = default; // so we can destruct derived classes using a pointer to their base class
-    virtual bool Evaluate(const CGUIListItem *item) = 0;
     virtual node_type_t Type() const=0;
   };
 
@@ -89,9 +88,8 @@ private:
   {
   public:
     InfoLeaf(InfoPtr info, bool invert) : m_info(info), m_invert(invert) {};
-    bool Evaluate(const CGUIListItem *item) override;
     node_type_t Type() const override { return NODE_LEAF; };
-  private:
+
     InfoPtr m_info;
     bool m_invert;
   };
@@ -103,17 +101,29 @@ private:
     InfoAssociativeGroup(node_type_t type, const InfoSubexpressionPtr &left, const InfoSubexpressionPtr &right);
     void AddChild(const InfoSubexpressionPtr &child);
     void Merge(std::shared_ptr<InfoAssociativeGroup> other);
-    bool Evaluate(const CGUIListItem *item) override;
     node_type_t Type() const override { return m_type; };
-  private:
+
     node_type_t m_type;
     std::list<InfoSubexpressionPtr> m_children;
   };
 
+  // An instruction of the compiled expression, a group is followed by the
+  // instructions of its children
+  struct Instruction
+  {
+    node_type_t type;
+    bool invert;        // leaves only
+    unsigned int arg;   // leaves: index into m_leaves, groups: number of instructions including the children
+  };
+
   static operator_t GetOperator(char ch);
   static void OperatorPop(std::stack<operator_t> &operator_stack, bool &invert, std::stack<InfoSubexpressionPtr> &nodes);
   bool Parse(const std::string &expression);
-  InfoSubexpressionPtr m_expression_tree;
+  void Compile(const InfoSubexpressionPtr &node);
+  bool Evaluate(size_t &pc, const CGUIListItem *item);
+
+  std::vector<Instruction> m_program;
+  std::vector<InfoPtr> m_leaves;
 };
 
 };
@@ -23,11 +23,14 @@
 #include "AudioLibrary.h"
 #include "MediaSource.h"
 #include "ServiceBroker.h"
+#include "filesystem/DatabaseDirectoryPager.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
 #include "FileItem.h"
+#include "interfaces/AnnouncementManager.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/MediaSourceSettings.h"
+#include "threads/SingleLock.h"
 #include "Util.h"
 #include "URL.h"
 #include "utils/FileExtensionProvider.h"
@@ -38,6 +41,52 @@
 
 using namespace XFILE;
 using namespace JSONRPC;
+using namespace ANNOUNCEMENT;
+
+namespace
+{
+/*!
+ * Pages of library directories read ahead for clients, forgotten whenever
+ * the library changes.
+ */
+class CLibraryDirectoryPager : public IAnnouncer
+{
+public:
+  CDatabaseDirectoryPager& Get()
+  {
+    // subscribe on first use, the announcement manager doesn't exist yet
+    // when file statics are constructed and drops its announcers on exit
+    CSingleLock lock(m_section);
+    if (!m_subscribed)
+    {
+      m_subscribed = true;
+      CAnnouncementManager::GetInstance().AddAnnouncer(this);
+    }
+    return m_pager;
+  }
+
+  void Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data) override
+  {
+    if (strcmp(sender, "xbmc"))
+      return;
+
+    if (strcmp(message, "OnUpdate") && strcmp(message, "OnRemove")
+        && strcmp(message, "OnScanFinished") && strcmp(message, "OnCleanFinished"))
+      return;
+
+    // pages read ahead may no longer match the library
+    if (flag == VideoLibrary || flag == AudioLibrary)
+      m_pager.Clear();
+  }
+
+private:
+  CCriticalSection m_section;
+  bool m_subscribed = false;
+  CDatabaseDirectoryPager m_pager;
+};
+
+CLibraryDirectoryPager s_directoryPager;
+}
 
 JSONRPC_STATUS CFileOperations::GetRootDirectory(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
@@ -105,7 +154,20 @@ JSONRPC_STATUS CFileOperations::GetDirectory(const std::string &method, ITranspo
     extensions = CServiceBroker::GetFileExtensionProvider().GetPictureExtensions();
   }
 
-  if (CDirectory::GetDirectory(strPath, items, extensions, DIR_FLAG_DEFAULTS))
+  // let the database sort and limit library listings so only the requested
+  // items are created. A page has to hold the same items as the full listing,
+  // so don't page if items might be excluded from it: by the exclusion
+  // regexps, or by the extension mask (see GetDatabasePath()).
+  int total = -1;
+  bool paged = false;
+  SortDescription sorting;
+  ParseLimits(parameterObject, sorting.limitStart, sorting.limitEnd);
+  if (regexps.empty() && sorting.limitStart >= 0 && sorting.limitEnd > sorting.limitStart &&
+      ParseSorting(parameterObject, sorting.sortBy, sorting.sortOrder, sorting.sortAttributes) &&
+      !CDatabaseDirectoryPager::GetDatabasePath(strPath, extensions).empty())
+    paged = s_directoryPager.Get().GetPage(strPath, sorting, sorting.limitStart, sorting.limitEnd - sorting.limitStart, items, total);
+
+  if (paged || CDirectory::GetDirectory(strPath, items, extensions, DIR_FLAG_DEFAULTS))
   {
     // we might need to get additional information for music items
     if (media == "music")
@@ -164,7 +226,10 @@ JSONRPC_STATUS CFileOperations::GetDirectory(const std::string &method, ITranspo
       param["properties"].append("file");
     param["properties"].append("filetype");
 
-    HandleFileItemList("id", true, "files", filteredFiles, param, result);
+    if (paged)
+      HandleFileItemList("id", true, "files", filteredFiles, param, result, total, false);
+    else
+      HandleFileItemList("id", true, "files", filteredFiles, param, result);
 
     return OK;
   }
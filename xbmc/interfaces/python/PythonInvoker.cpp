@@ -41,7 +41,9 @@
 #include "interfaces/python/pythreadstate.h"
 #include "interfaces/python/swig.h"
 #include "interfaces/python/XBPython.h"
+#include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #if defined(TARGET_WINDOWS)
 #include "utils/CharsetConverter.h"
 #endif // defined(TARGET_WINDOWS)
@@ -167,10 +169,28 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   std::vector<char *> argv = getCPointersToArguments(argvStorage);
 
   CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): start processing", GetId(), m_sourceFile.c_str());
+  const unsigned int startTime = XbmcThreads::SystemClockMillis();
+
+  std::string realFilename(CSpecialProtocol::TranslatePath(m_sourceFile));
+  std::string scriptDir = URIUtils::GetDirectory(realFilename);
+  URIUtils::RemoveSlashAtEnd(scriptDir);
+
+  // plugins are invoked over and over again for every directory listing, their
+  // interpreters can be kept warm for the next invocation of the same plugin
+  std::string poolKey;
+  if (g_advancedSettings.m_pythonInterpreterPoolSize > 0 && m_addon && m_addon->Type() == ADDON::ADDON_PLUGIN)
+    poolKey = m_addon->ID() + "-" + m_addon->Version().asString() + ":" + realFilename;
 
   // get the global lock
   PyEval_AcquireLock();
-  PyThreadState* state = Py_NewInterpreter();
+  PyThreadState* state = NULL;
+  PyInterpreterState* warmInterpreter = NULL;
+  if (!poolKey.empty())
+    warmInterpreter = static_cast<PyInterpreterState*>(g_pythonParser.AcquireInterpreter(poolKey));
+  if (warmInterpreter != NULL)
+    state = PyThreadState_New(warmInterpreter);
+  else
+    state = Py_NewInterpreter();
   if (state == NULL)
   {
     PyEval_ReleaseLock();
@@ -180,84 +200,104 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
   // swap in my thread state
   PyThreadState_Swap(state);
 
-  XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook> languageHook(new XBMCAddon::Python::PythonLanguageHook(state->interp));
-  languageHook->RegisterMe();
+  XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook> languageHook;
+  if (warmInterpreter != NULL)
+  {
+    // the language hook stays registered as long as the interpreter lives
+    CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): reusing warm interpreter", GetId(), m_sourceFile.c_str());
+    languageHook = XBMCAddon::Python::PythonLanguageHook::GetIfExists(warmInterpreter);
+    if (!ResetInterpreter(scriptDir, getInitializationScript()))
+      CLog::Log(LOGFATAL, "CPythonInvoker(%d, %s): initialize error", GetId(), m_sourceFile.c_str());
+  }
+  else
+  {
+    languageHook = new XBMCAddon::Python::PythonLanguageHook(state->interp);
+    languageHook->RegisterMe();
 
-  onInitialization();
+    onInitialization();
+  }
   setState(InvokerStateInitialized);
 
-  std::string realFilename(CSpecialProtocol::TranslatePath(m_sourceFile));
   if (realFilename == m_sourceFile)
     CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): the source file to load is \"%s\"", GetId(), m_sourceFile.c_str(), m_sourceFile.c_str());
   else
     CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): the source file to load is \"%s\" (\"%s\")", GetId(), m_sourceFile.c_str(), m_sourceFile.c_str(), realFilename.c_str());
 
-  // get path from script file name and add python path's
-  // this is used for python so it will search modules from script path first
-  std::string scriptDir = URIUtils::GetDirectory(realFilename);
-  URIUtils::RemoveSlashAtEnd(scriptDir);
-  addPath(scriptDir);
-
-  // add all addon module dependencies to path
-  if (m_addon)
+  // a warm interpreter already has the path of the same add-on
+  if (warmInterpreter == NULL)
   {
-    std::set<std::string> paths;
-    getAddonModuleDeps(m_addon, paths);
-    for (std::set<std::string>::const_iterator it = paths.begin(); it != paths.end(); ++it)
-      addPath(*it);
-  }
-  else
-  { // for backwards compatibility.
-    // we don't have any addon so just add all addon modules installed
-    CLog::Log(LOGWARNING, "CPythonInvoker(%d): Script invoked without an addon. Adding all addon "
-        "modules installed to python path as fallback. This behaviour will be removed in future "
-        "version.", GetId());
-    ADDON::VECADDONS addons;
-    CServiceBroker::GetAddonMgr().GetAddons(addons, ADDON::ADDON_SCRIPT_MODULE);
-    for (unsigned int i = 0; i < addons.size(); ++i)
-      addPath(CSpecialProtocol::TranslatePath(addons[i]->LibPath()));
-  }
+    // get path from script file name and add python path's
+    // this is used for python so it will search modules from script path first
+    addPath(scriptDir);
+
+    // add all addon module dependencies to path
+    if (m_addon)
+    {
+      std::set<std::string> paths;
+      getAddonModuleDeps(m_addon, paths);
+      for (std::set<std::string>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+        addPath(*it);
+    }
+    else
+    { // for backwards compatibility.
+      // we don't have any addon so just add all addon modules installed
+      CLog::Log(LOGWARNING, "CPythonInvoker(%d): Script invoked without an addon. Adding all addon "
+          "modules installed to python path as fallback. This behaviour will be removed in future "
+          "version.", GetId());
+      ADDON::VECADDONS addons;
+      CServiceBroker::GetAddonMgr().GetAddons(addons, ADDON::ADDON_SCRIPT_MODULE);
+      for (unsigned int i = 0; i < addons.size(); ++i)
+        addPath(CSpecialProtocol::TranslatePath(addons[i]->LibPath()));
+    }
 
-  // we want to use sys.path so it includes site-packages
-  // if this fails, default to using Py_GetPath
-  PyObject *sysMod(PyImport_ImportModule((char*)"sys")); // must call Py_DECREF when finished
-  PyObject *sysModDict(PyModule_GetDict(sysMod)); // borrowed ref, no need to delete
-  PyObject *pathObj(PyDict_GetItemString(sysModDict, "path")); // borrowed ref, no need to delete
+    // we want to use sys.path so it includes site-packages
+    // if this fails, default to using Py_GetPath
+    PyObject *sysMod(PyImport_ImportModule((char*)"sys")); // must call Py_DECREF when finished
+    PyObject *sysModDict(PyModule_GetDict(sysMod)); // borrowed ref, no need to delete
+    PyObject *pathObj(PyDict_GetItemString(sysModDict, "path")); // borrowed ref, no need to delete
 
-  if (pathObj != NULL && PyList_Check(pathObj))
-  {
-    for (int i = 0; i < PyList_Size(pathObj); i++)
+    if (pathObj != NULL && PyList_Check(pathObj))
     {
-      PyObject *e = PyList_GetItem(pathObj, i); // borrowed ref, no need to delete
-      if (e != NULL && PyString_Check(e))
-        addNativePath(PyString_AsString(e)); // returns internal data, don't delete or modify
-#ifdef TARGET_WINDOWS_STORE
-      // uwp python operates unicodes
-      else if (e != NULL && PyUnicode_Check(e))
+      for (int i = 0; i < PyList_Size(pathObj); i++)
       {
-        PyObject *utf8 = PyUnicode_AsUTF8String(e);
-        addNativePath(PyString_AsString(utf8));
-        Py_DECREF(utf8);
-      }
+        PyObject *e = PyList_GetItem(pathObj, i); // borrowed ref, no need to delete
+        if (e != NULL && PyString_Check(e))
+          addNativePath(PyString_AsString(e)); // returns internal data, don't delete or modify
+#ifdef TARGET_WINDOWS_STORE
+        // uwp python operates unicodes
+        else if (e != NULL && PyUnicode_Check(e))
+        {
+          PyObject *utf8 = PyUnicode_AsUTF8String(e);
+          addNativePath(PyString_AsString(utf8));
+          Py_DECREF(utf8);
+        }
 #endif
+      }
     }
-  }
-  else
-    addNativePath(Py_GetPath());
+    else
+      addNativePath(Py_GetPath());
 
-  Py_DECREF(sysMod); // release ref to sysMod
+    Py_DECREF(sysMod); // release ref to sysMod
+  }
 
   // set current directory and python's path.
-  PySys_SetArgv(argc, &argv[0]);
+  // a warm interpreter already has the script directory in its path
+  if (warmInterpreter != NULL)
+    PySys_SetArgvEx(argc, &argv[0], 0);
+  else
+    PySys_SetArgv(argc, &argv[0]);
 
+  if (warmInterpreter == NULL)
+  {
 #ifdef TARGET_WINDOWS
-  std::string pyPathUtf8;
-  g_charsetConverter.systemToUtf8(m_pythonPath, pyPathUtf8, false);
-  CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): setting the Python path to %s", GetId(), m_sourceFile.c_str(), pyPathUtf8.c_str());
+    std::string pyPathUtf8;
+    g_charsetConverter.systemToUtf8(m_pythonPath, pyPathUtf8, false);
+    CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): setting the Python path to %s", GetId(), m_sourceFile.c_str(), pyPathUtf8.c_str());
 #else // ! TARGET_WINDOWS
-  CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): setting the Python path to %s", GetId(), m_sourceFile.c_str(), m_pythonPath.c_str());
+    CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): setting the Python path to %s", GetId(), m_sourceFile.c_str(), m_pythonPath.c_str());
 #endif // ! TARGET_WINDOWS
-  PySys_SetPath((char *)m_pythonPath.c_str());
+    PySys_SetPath((char *)m_pythonPath.c_str());
+  }
 
   CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): entering source directory %s", GetId(), m_sourceFile.c_str(), scriptDir.c_str());
   PyObject* module = PyImport_AddModule((char*)"__main__");
@@ -426,6 +466,29 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
       PyRun_SimpleString(GC_SCRIPT) == -1)
     CLog::Log(LOGERROR, "CPythonInvoker(%d, %s): failed to run the gc to clean up after running prior to shutting down the Interpreter", GetId(), m_sourceFile.c_str());
 
+  // only keep interpreters of cleanly finished runs, anything left behind by
+  // an aborted or failing script could leak into the next run
+  if (!poolKey.empty() && !m_stop && !systemExitThrown && stateToSet == InvokerStateDone &&
+      !languageHook->HasRegisteredAddonClasses())
+  {
+    PyInterpreterState* interpreter = state->interp;
+    PyThreadState_Clear(state);
+    PyThreadState_Swap(NULL);
+    PyThreadState_Delete(state);
+    if (g_pythonParser.ReleaseInterpreter(poolKey, interpreter))
+    {
+      PyEval_ReleaseLock();
+      CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): finished in %u ms, keeping the interpreter warm",
+                GetId(), m_sourceFile.c_str(), XbmcThreads::SystemClockMillis() - startTime);
+      setState(stateToSet);
+      return true;
+    }
+
+    // Py_EndInterpreter() needs a thread state of the interpreter
+    state = PyThreadState_New(interpreter);
+    PyThreadState_Swap(state);
+  }
+
   Py_EndInterpreter(state);
 
   // If we still have objects left around, produce an error message detailing what's been left behind
@@ -439,6 +502,9 @@ bool CPythonInvoker::execute(const std::string &script, const std::vector<std::s
 
   PyEval_ReleaseLock();
 
+  CLog::Log(LOGDEBUG, "CPythonInvoker(%d, %s): finished in %u ms", GetId(), m_sourceFile.c_str(),
+            XbmcThreads::SystemClockMillis() - startTime);
+
   setState(stateToSet);
 
   return true;
@@ -557,6 +623,60 @@ std::map<std::string, CPythonInvoker::PythonModuleInitialization> CPythonInvoker
   return modules;
 }
 
+bool CPythonInvoker::ResetInterpreter(const std::string &scriptDir, const char *initializationScript)
+{
+  // modules and the import machinery stay loaded, the state of the script
+  // itself (__main__ and the modules of the add-on) is thrown away
+  PyObject *mainModule = PyImport_AddModule((char*)"__main__"); // borrowed ref
+  PyObject *mainDict = PyModule_GetDict(mainModule); // borrowed ref
+  PyDict_Clear(mainDict);
+  PyObject *builtins = PyImport_ImportModule((char*)"__builtin__");
+  if (builtins != NULL)
+  {
+    PyDict_SetItemString(mainDict, "__builtins__", builtins);
+    Py_DECREF(builtins);
+  }
+  PyObject *name = PyString_FromString("__main__");
+  PyDict_SetItemString(mainDict, "__name__", name);
+  Py_DECREF(name);
+  PyDict_SetItemString(mainDict, "__doc__", Py_None);
+
+  // modules of the add-on itself are imported again so that module level
+  // code (e.g. parsing sys.argv) runs for every invocation
+  std::string nativeScriptDir(scriptDir);
+  URIUtils::AddSlashAtEnd(nativeScriptDir);
+  PyObject *modules = PyImport_GetModuleDict(); // borrowed ref
+  PyObject *stale = PyList_New(0);
+  PyObject *key, *value;
+  Py_ssize_t pos = 0;
+  while (PyDict_Next(modules, &pos, &key, &value))
+  {
+    if (value == NULL || !PyModule_Check(value))
+      continue;
+    const char *file = PyModule_GetFilename(value);
+    if (file == NULL)
+    {
+      PyErr_Clear();
+      continue;
+    }
+    if (StringUtils::StartsWith(file, nativeScriptDir))
+      PyList_Append(stale, key);
+  }
+  for (Py_ssize_t i = 0; i < PyList_Size(stale); i++)
+    PyDict_DelItem(modules, PyList_GetItem(stale, i));
+  Py_DECREF(stale);
+
+  PyObject *xbmcModule = PyDict_GetItemString(modules, "xbmc"); // borrowed ref
+  if (xbmcModule != NULL && PyObject_SetAttrString(xbmcModule, (char*)"abortRequested", Py_False) == -1)
+    PyErr_Clear();
+
+  // the initialization script defined globals in __main__ that e.g. the
+  // redirected sys.stdout depends on
+  if (initializationScript == NULL || strlen(initializationScript) == 0)
+    return true;
+  return PyRun_SimpleString(initializationScript) != -1;
+}
+
 void CPythonInvoker::onInitialization()
 {
   XBMC_TRACE;
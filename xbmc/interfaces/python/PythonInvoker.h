@@ -37,6 +37,16 @@ public:
 
   bool IsStopping() const override { return m_stop || ILanguageInvoker::IsStopping(); }
 
+  /*!
+   \brief Prepare a warm interpreter of an earlier run for the next run of a
+   script in the given directory. The GIL and a thread state of the
+   interpreter have to be held.
+   \param scriptDir directory of the script, its modules are imported again
+   \param initializationScript run again as __main__ is recreated, may be NULL
+   \return false if the initialization script failed
+   */
+  static bool ResetInterpreter(const std::string &scriptDir, const char *initializationScript);
+
   typedef void (*PythonModuleInitialization)();
   
 protected:
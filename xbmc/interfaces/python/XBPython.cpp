@@ -44,6 +44,7 @@
 #include "interfaces/legacy/Monitor.h"
 #include "interfaces/legacy/AddonUtils.h"
 #include "interfaces/python/AddonPythonInvoker.h"
+#include "interfaces/python/LanguageHook.h"
 #include "interfaces/python/PythonInvoker.h"
 
 using namespace ANNOUNCEMENT;
@@ -498,6 +499,10 @@ void XBPython::Finalize()
       PyEval_AcquireLock();
       PyThreadState_Swap(curTs);
 
+      // sub-interpreters aren't cleaned up by Py_Finalize()
+      for (const auto &pooled : TakeInterpreters(false))
+        EndInterpreter(pooled.interpreter);
+
       Py_Finalize();
       PyEval_ReleaseLock();
     }
@@ -558,10 +563,23 @@ void XBPython::Process()
     //delete scripts which are done
     tmpvec.clear(); // boost releases the XBPyThreads which, if deleted, calls OnScriptFinalized
 
+    ExpireInterpreters();
+
     CSingleLock l2(m_critSection);
     if(m_iDllScriptCounter == 0 && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 )
     {
-      Finalize();
+      // warm interpreters keep python loaded until they expire
+      bool poolEmpty;
+      {
+        CSingleLock poolLock(m_interpreterSection);
+        poolEmpty = m_interpreterPool.empty();
+      }
+
+      // Finalize() waits for the GIL, so it must not be called with the pool
+      // lock held (invokers take the pool lock while holding the GIL). No
+      // interpreter can be added meanwhile, no script is running.
+      if (poolEmpty)
+        Finalize();
     }
   }
 }
@@ -742,3 +760,101 @@ bool XBPython::WaitForEvent(CEvent& hEvent, unsigned int milliseconds)
     m_globalEvent.Reset();
   return ret != NULL;
 }
+
+void* XBPython::AcquireInterpreter(const std::string &key)
+{
+  CSingleLock lock(m_interpreterSection);
+  for (auto it = m_interpreterPool.begin(); it != m_interpreterPool.end(); ++it)
+  {
+    if (it->key == key)
+    {
+      void *interpreter = it->interpreter;
+      m_interpreterPool.erase(it);
+      return interpreter;
+    }
+  }
+  return NULL;
+}
+
+bool XBPython::ReleaseInterpreter(const std::string &key, void *interpreter)
+{
+  const unsigned int poolSize = g_advancedSettings.m_pythonInterpreterPoolSize;
+  if (poolSize == 0 || key.empty() || interpreter == NULL)
+    return false;
+
+  std::vector<PooledInterpreter> evicted;
+  {
+    CSingleLock lock(m_interpreterSection);
+    PooledInterpreter pooled;
+    pooled.key = key;
+    pooled.interpreter = interpreter;
+    pooled.lastUsed = XbmcThreads::SystemClockMillis();
+    m_interpreterPool.push_back(pooled);
+
+    // the pool is ordered by last use, drop the ones used longest ago
+    while (m_interpreterPool.size() > poolSize)
+    {
+      evicted.push_back(m_interpreterPool.front());
+      m_interpreterPool.erase(m_interpreterPool.begin());
+    }
+  }
+
+  for (const auto &pooled : evicted)
+  {
+    CLog::Log(LOGDEBUG, "Python, ending warm interpreter of %s, the pool is full", pooled.key.c_str());
+    EndInterpreter(pooled.interpreter);
+  }
+  return true;
+}
+
+void XBPython::EndInterpreter(void *interpreter)
+{
+  PyInterpreterState *interp = static_cast<PyInterpreterState*>(interpreter);
+
+  // Py_EndInterpreter() needs a thread state of the interpreter, the one of
+  // the last run has been deleted when it was put into the pool
+  PyThreadState *state = PyThreadState_New(interp);
+  PyThreadState *old = PyThreadState_Swap(state);
+
+  XBMCAddon::AddonClass::Ref<XBMCAddon::Python::PythonLanguageHook> languageHook(XBMCAddon::Python::PythonLanguageHook::GetIfExists(interp));
+  Py_EndInterpreter(state);
+  languageHook->UnregisterMe();
+
+  PyThreadState_Swap(old);
+}
+
+std::vector<XBPython::PooledInterpreter> XBPython::TakeInterpreters(bool idleOnly)
+{
+  std::vector<PooledInterpreter> interpreters;
+
+  CSingleLock lock(m_interpreterSection);
+  const unsigned int idleTime = g_advancedSettings.m_pythonInterpreterIdleTime * 1000;
+  for (auto it = m_interpreterPool.begin(); it != m_interpreterPool.end();)
+  {
+    if (!idleOnly || XbmcThreads::SystemClockMillis() - it->lastUsed > idleTime)
+    {
+      interpreters.push_back(*it);
+      it = m_interpreterPool.erase(it);
+    }
+    else
+      ++it;
+  }
+  return interpreters;
+}
+
+void XBPython::ExpireInterpreters()
+{
+  // the pool lock must not be held while waiting for the GIL, invokers take
+  // the pool lock while holding the GIL
+  std::vector<PooledInterpreter> expired = TakeInterpreters(true);
+  if (expired.empty())
+    return;
+
+  PyEval_AcquireLock();
+  for (const auto &pooled : expired)
+  {
+    CLog::Log(LOGDEBUG, "Python, ending warm interpreter of %s, it hasn't been used for a while", pooled.key.c_str());
+    EndInterpreter(pooled.interpreter);
+  }
+  PyEval_ReleaseLock();
+}
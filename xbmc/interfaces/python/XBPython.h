@@ -29,6 +29,7 @@
 #include "ServiceBroker.h"
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #define g_pythonParser CServiceBroker::GetXBPython()
@@ -113,9 +114,40 @@ public:
   void UnregisterExtensionLib(LibraryLoader *pLib);
   void UnloadExtensionLibs();
 
+  /*!
+   \brief Take the warm interpreter of an earlier run with the same key out
+   of the interpreter pool. Must be called with the GIL held.
+   \return the interpreter (a PyInterpreterState*) or NULL if there is none
+   */
+  void* AcquireInterpreter(const std::string &key);
+
+  /*!
+   \brief Keep the interpreter of a finished run warm for the next run with
+   the same key. Must be called with the GIL held but without a thread state
+   of the interpreter.
+   \return false if the interpreter pool is disabled, the caller has to end
+   the interpreter itself then
+   */
+  bool ReleaseInterpreter(const std::string &key, void *interpreter);
+
 private:
   void Finalize();
 
+  struct PooledInterpreter
+  {
+    std::string key;
+    void *interpreter;
+    unsigned int lastUsed;
+  };
+
+  // must be called with the GIL held
+  static void EndInterpreter(void *interpreter);
+  void ExpireInterpreters();
+  std::vector<PooledInterpreter> TakeInterpreters(bool idleOnly);
+
+  CCriticalSection m_interpreterSection;
+  std::vector<PooledInterpreter> m_interpreterPool;
+
   CCriticalSection    m_critSection;
   bool              FileExist(const char* strFile);
 
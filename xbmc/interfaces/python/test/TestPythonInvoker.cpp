@@ -0,0 +1,144 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// python.h should always be included first before any other includes
+#include <Python.h>
+
+#include "../PythonInvoker.h"
+
+#include <chrono>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+// like the preamble of add-ons, the redirected sys.stdout depends on globals
+// of __main__
+const char* const PREAMBLE =
+  "import sys\n"
+  "written = []\n"
+  "class out:\n"
+  "  def write(self, data):\n"
+  "    written.append(data)\n"
+  "sys.stdout = out()\n";
+
+// a module of the add-on next to the script and one of the standard library
+const char* const SCRIPT =
+  "import json, os, sys, tempfile\n"
+  "if not os.path.isdir(sys.argv[0]):\n"
+  "  sys.argv[0] = tempfile.mkdtemp()\n"
+  "  open(os.path.join(sys.argv[0], 'plugin_module.py'), 'w').write('runs = []\\n')\n"
+  "  sys.path.insert(0, sys.argv[0])\n"
+  "import plugin_module\n"
+  "plugin_module.runs.append(1)\n"
+  "leftover = True\n"
+  "print 'run'\n";
+
+class TestPythonInvoker : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // the tests don't run XBPython, the main thread state holds the GIL
+    if (!Py_IsInitialized())
+      Py_Initialize();
+    m_mainState = PyThreadState_Get();
+    m_state = Py_NewInterpreter();
+    ASSERT_TRUE(m_state != nullptr);
+    char arg[] = "";
+    char *argv[] = { arg };
+    PySys_SetArgvEx(1, argv, 0);
+  }
+
+  void TearDown() override
+  {
+    if (m_state != nullptr)
+    {
+      PyRun_SimpleString("import shutil, sys\nshutil.rmtree(sys.argv[0], True)\n");
+      Py_EndInterpreter(m_state);
+    }
+    PyThreadState_Swap(m_mainState);
+  }
+
+  static std::string GetScriptDir()
+  {
+    PyObject *argv = PySys_GetObject((char*)"argv"); // borrowed ref
+    return PyString_AsString(PyList_GetItem(argv, 0));
+  }
+
+  PyThreadState *m_mainState = nullptr;
+  PyThreadState *m_state = nullptr;
+};
+
+}
+
+TEST_F(TestPythonInvoker, ReuseInterpreter)
+{
+  ASSERT_NE(-1, PyRun_SimpleString(PREAMBLE));
+  ASSERT_NE(-1, PyRun_SimpleString(SCRIPT));
+  EXPECT_NE(-1, PyRun_SimpleString("assert written == ['run', '\\n'], written\n"));
+
+  ASSERT_TRUE(CPythonInvoker::ResetInterpreter(GetScriptDir(), PREAMBLE));
+
+  // the state of the first run is gone, the module of the add-on runs again
+  // while the standard library stays loaded, and printing still works
+  EXPECT_NE(-1, PyRun_SimpleString("import sys\n"
+                                   "assert 'leftover' not in globals()\n"
+                                   "assert 'plugin_module' not in sys.modules\n"
+                                   "assert 'json' in sys.modules\n"));
+  ASSERT_NE(-1, PyRun_SimpleString(SCRIPT));
+  EXPECT_NE(-1, PyRun_SimpleString("assert plugin_module.runs == [1], plugin_module.runs\n"
+                                   "assert written == ['run', '\\n'], written\n"));
+}
+
+// Compares starting every run in a new interpreter that is ended afterwards
+// with resetting a warm one
+TEST_F(TestPythonInvoker, DISABLED_Benchmark)
+{
+  static const int RUNS = 20;
+  static const char* const IMPORTS = "import json, re, urllib2, xml.dom.minidom\n";
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < RUNS; i++)
+  {
+    PyThreadState *state = Py_NewInterpreter();
+    ASSERT_TRUE(state != nullptr);
+    ASSERT_NE(-1, PyRun_SimpleString(PREAMBLE));
+    ASSERT_NE(-1, PyRun_SimpleString(IMPORTS));
+    Py_EndInterpreter(state);
+    PyThreadState_Swap(m_state);
+  }
+  const auto coldUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  ASSERT_NE(-1, PyRun_SimpleString(PREAMBLE));
+  ASSERT_NE(-1, PyRun_SimpleString(IMPORTS));
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < RUNS; i++)
+  {
+    ASSERT_TRUE(CPythonInvoker::ResetInterpreter("/nonexistent", PREAMBLE));
+    ASSERT_NE(-1, PyRun_SimpleString(IMPORTS));
+  }
+  const auto warmUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  RecordProperty("ColdRunUs", static_cast<int>(coldUs / RUNS));
+  RecordProperty("WarmRunUs", static_cast<int>(warmUs / RUNS));
+}
@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <utility>
+#include "DirectoryProviderCache.h"
 #include "ServiceBroker.h"
 #include "addons/GUIDialogAddonInfo.h"
 #include "ContextMenuManager.h"
@@ -63,8 +64,13 @@ public:
       m_sort(sort),
       m_limit(limit),
       m_parentID(parentID)
-  { }
-  ~CDirectoryJob() override = default;
+  {
+    CDirectoryProviderCache::GetInstance().OnListRequested();
+  }
+  ~CDirectoryJob() override
+  {
+    CDirectoryProviderCache::GetInstance().OnListPopulated();
+  }
 
   const char* GetType() const override { return "directory"; }
   bool operator==(const CJob *job) const override
@@ -80,12 +86,11 @@ public:
 
   bool DoWork() override
   {
-    CFileItemList items;
-    if (CDirectory::GetDirectory(m_url, items, "", DIR_FLAG_DEFAULTS))
+    // the listing is shared with all other lists showing the same URL in the same order
+    std::shared_ptr<const CFileItemList> listing = CDirectoryProviderCache::GetInstance().GetDirectory(m_url, m_sort);
+    if (listing)
     {
-      // sort the items if necessary
-      if (m_sort.sortBy != SortByNone)
-        items.Sort(m_sort);
+      const CFileItemList &items = *listing;
 
       // limit must not exceed the number of items
       int limit = (m_limit == 0) ? items.Size() : std::min((int) m_limit, items.Size());
@@ -271,6 +276,9 @@ void CDirectoryProvider::Announce(AnnouncementFlag flag, const char *sender, con
           strcmp(message, "OnRemove") == 0)
         m_updateState = INVALIDATED;
     }
+
+    if (m_updateState == INVALIDATED)
+      CDirectoryProviderCache::GetInstance().Invalidate(m_currentUrl);
   }
 }
 
@@ -295,7 +303,10 @@ void CDirectoryProvider::OnAddonEvent(const ADDON::AddonEvent& event)
         typeid(event) == typeid(ADDON::AddonEvents::ReInstalled) ||
         typeid(event) == typeid(ADDON::AddonEvents::UnInstalled) ||
         typeid(event) == typeid(ADDON::AddonEvents::MetadataChanged))
+    {
       m_updateState = INVALIDATED;
+      CDirectoryProviderCache::GetInstance().Invalidate(m_currentUrl);
+    }
   }
 }
 
@@ -309,7 +320,10 @@ void CDirectoryProvider::OnPVRManagerEvent(const PVR::PVREvent& event)
         event == ManagerError ||
         event == ManagerInterrupted ||
         event == RecordingsInvalidated)
+    {
       m_updateState = INVALIDATED;
+      CDirectoryProviderCache::GetInstance().Invalidate(m_currentUrl);
+    }
   }
 }
 
@@ -317,7 +331,10 @@ void CDirectoryProvider::OnFavouritesEvent(const CFavouritesService::FavouritesU
 {
   CSingleLock lock(m_section);
   if (URIUtils::IsProtocol(m_currentUrl, "favourites"))
+  {
     m_updateState = INVALIDATED;
+    CDirectoryProviderCache::GetInstance().Invalidate(m_currentUrl);
+  }
 }
 
 void CDirectoryProvider::Reset()
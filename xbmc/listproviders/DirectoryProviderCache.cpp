@@ -0,0 +1,385 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DirectoryProviderCache.h"
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "addons/AddonManager.h"
+#include "filesystem/Directory.h"
+#include "interfaces/AnnouncementManager.h"
+#include "pvr/PVRManager.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/Variant.h"
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <string.h>
+#include <typeinfo>
+
+using namespace XFILE;
+using namespace ANNOUNCEMENT;
+using namespace PVR;
+
+// number of URLs whose listing is kept, the least recently used one is dropped first
+#define MAX_CACHED_DIRECTORIES 64
+
+namespace
+{
+
+// the cache is told about changes of these listings, see Announce() and the On*Event() handlers
+bool IsAnnounced(const std::string &url)
+{
+  return URIUtils::IsProtocol(url, "videodb") ||
+         URIUtils::IsProtocol(url, "musicdb") ||
+         URIUtils::IsProtocol(url, "library") ||
+         URIUtils::IsProtocol(url, "favourites") ||
+         URIUtils::IsProtocol(url, "addons") ||
+         URIUtils::IsProtocol(url, "pvr") ||
+         URIUtils::HasExtension(url, ".xsp");
+}
+
+// judged by the URL, the items of library nodes are folders that are neither
+// videos nor music
+bool IsVideoLibrary(const std::string &url)
+{
+  return URIUtils::IsProtocol(url, "videodb") ||
+         StringUtils::StartsWithNoCase(url, "library://video") ||
+         URIUtils::HasExtension(url, ".xsp");
+}
+
+bool IsMusicLibrary(const std::string &url)
+{
+  return URIUtils::IsProtocol(url, "musicdb") ||
+         StringUtils::StartsWithNoCase(url, "library://music") ||
+         URIUtils::HasExtension(url, ".xsp");
+}
+
+std::string GetSortKey(const SortDescription &sort)
+{
+  return StringUtils::Format("%i/%i/%i/%i/%i", sort.sortBy, sort.sortOrder, sort.sortAttributes,
+                             sort.limitStart, sort.limitEnd);
+}
+
+}
+
+CDirectoryProviderCache& CDirectoryProviderCache::GetInstance()
+{
+  static CDirectoryProviderCache cache;
+  return cache;
+}
+
+std::shared_ptr<CDirectoryProviderCache::Entry> CDirectoryProviderCache::GetEntry(const std::string &url)
+{
+  auto it = m_entries.find(url);
+  if (it != m_entries.end())
+    return it->second;
+
+  if (m_entries.size() >= MAX_CACHED_DIRECTORIES)
+  {
+    const unsigned int now = XbmcThreads::SystemClockMillis();
+    auto oldest = m_entries.end();
+    for (auto entry = m_entries.begin(); entry != m_entries.end(); ++entry)
+    {
+      if (entry->second->fetching)
+        continue;
+      if (oldest == m_entries.end() || now - entry->second->lastUsed > now - oldest->second->lastUsed)
+        oldest = entry;
+    }
+    if (oldest != m_entries.end())
+      m_entries.erase(oldest);
+  }
+
+  std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+  entry->video = IsVideoLibrary(url);
+  entry->audio = IsMusicLibrary(url);
+  m_entries.insert(std::make_pair(url, entry));
+  return entry;
+}
+
+std::shared_ptr<const CFileItemList> CDirectoryProviderCache::GetDirectory(const std::string &url, const SortDescription &sort)
+{
+  if (!IsAnnounced(url))
+  {
+    {
+      CSingleLock lock(m_section);
+      m_stats.uncached++;
+    }
+    std::shared_ptr<CFileItemList> items = std::make_shared<CFileItemList>();
+    if (!CDirectory::GetDirectory(url, *items, "", DIR_FLAG_DEFAULTS))
+      return nullptr;
+    items->Sort(sort);
+    return items;
+  }
+
+  Subscribe();
+
+  CSingleLock lock(m_section);
+  // keep our own reference, the entry may be dropped from the map while we wait or fetch
+  std::shared_ptr<Entry> entry = GetEntry(url);
+  entry->lastUsed = XbmcThreads::SystemClockMillis();
+
+  std::shared_ptr<const CFileItemList> items = GetItems(url, *entry, lock);
+  if (!items || sort.sortBy == SortByNone)
+    return items;
+
+  const std::string key = GetSortKey(sort);
+  if (entry->items == items)
+  {
+    auto it = entry->sorted.find(key);
+    if (it != entry->sorted.end())
+      return it->second;
+  }
+
+  // sorting sets the sort label of the items, so the copy gets its own
+  m_stats.sorts++;
+  lock.Leave();
+  std::shared_ptr<CFileItemList> sorted = std::make_shared<CFileItemList>();
+  sorted->Copy(*items);
+  sorted->Sort(sort);
+  lock.Enter();
+
+  if (entry->items == items)
+    entry->sorted.insert(std::make_pair(key, sorted));
+  return sorted;
+}
+
+std::shared_ptr<const CFileItemList> CDirectoryProviderCache::GetItems(const std::string &url, Entry &entry, CSingleLock &lock)
+{
+  bool waited = false;
+  while (true)
+  {
+    if (entry.items && entry.itemsGeneration == entry.generation)
+    {
+      if (waited)
+        m_stats.coalesced++;
+      else
+        m_stats.hits++;
+      return entry.items;
+    }
+
+    if (!entry.fetching || entry.fetchGeneration != entry.generation)
+      break;
+
+    // somebody is already fetching an up to date listing, wait for it
+    const unsigned int generation = entry.fetchGeneration;
+    while (entry.fetching && entry.fetchGeneration == generation)
+      m_fetchDone.wait(lock);
+
+    if (entry.fetchFailed && entry.fetchGeneration == generation)
+    {
+      m_stats.coalesced++;
+      return nullptr;
+    }
+    waited = true;
+  }
+
+  m_stats.misses++;
+  entry.fetching = true;
+  entry.fetchFailed = false;
+  const unsigned int generation = entry.fetchGeneration = entry.generation;
+
+  lock.Leave();
+  std::shared_ptr<CFileItemList> items = std::make_shared<CFileItemList>();
+  bool success = CDirectory::GetDirectory(url, *items, "", DIR_FLAG_DEFAULTS);
+  lock.Enter();
+
+  // a newer fetch may have been started after an invalidation, it owns the flags now
+  if (entry.fetchGeneration == generation)
+  {
+    entry.fetching = false;
+    entry.fetchFailed = !success;
+  }
+  if (success && (!entry.items || generation >= entry.itemsGeneration))
+  {
+    entry.items = items;
+    entry.itemsGeneration = generation;
+    entry.sorted.clear();
+  }
+  m_fetchDone.notifyAll();
+
+  if (!success)
+    return nullptr;
+  return items;
+}
+
+void CDirectoryProviderCache::Invalidate(const std::string &url)
+{
+  CSingleLock lock(m_section);
+  auto it = m_entries.find(url);
+  if (it != m_entries.end())
+    Invalidate(*it->second);
+}
+
+void CDirectoryProviderCache::Invalidate(Entry &entry)
+{
+  // nothing was fetched since the last invalidation, the next request will fetch anyway
+  if (entry.fetchGeneration != entry.generation)
+    return;
+
+  entry.generation++;
+  m_stats.invalidations++;
+}
+
+void CDirectoryProviderCache::InvalidateProtocol(const std::string &protocol)
+{
+  CSingleLock lock(m_section);
+  for (auto &entry : m_entries)
+  {
+    if (URIUtils::IsProtocol(entry.first, protocol))
+      Invalidate(*entry.second);
+  }
+}
+
+void CDirectoryProviderCache::Clear()
+{
+  {
+    CSingleLock lock(m_subscribeSection);
+    if (m_subscribed)
+    {
+      m_subscribed = false;
+      CAnnouncementManager::GetInstance().RemoveAnnouncer(this);
+      CServiceBroker::GetFavouritesService().Events().Unsubscribe(this);
+      CServiceBroker::GetAddonMgr().Events().Unsubscribe(this);
+      CServiceBroker::GetPVRManager().Events().Unsubscribe(this);
+    }
+  }
+
+  CSingleLock lock(m_section);
+  m_entries.clear();
+}
+
+void CDirectoryProviderCache::Subscribe()
+{
+  // the announcement manager calls Announce() with its own lock held, so
+  // don't (un)subscribe with m_section held
+  CSingleLock lock(m_subscribeSection);
+  if (m_subscribed)
+    return;
+
+  m_subscribed = true;
+  CAnnouncementManager::GetInstance().AddAnnouncer(this);
+  CServiceBroker::GetAddonMgr().Events().Subscribe(this, &CDirectoryProviderCache::OnAddonEvent);
+  CServiceBroker::GetPVRManager().Events().Subscribe(this, &CDirectoryProviderCache::OnPVRManagerEvent);
+  CServiceBroker::GetFavouritesService().Events().Subscribe(this, &CDirectoryProviderCache::OnFavouritesEvent);
+}
+
+void CDirectoryProviderCache::Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
+{
+  if ((flag & (VideoLibrary | AudioLibrary)) == 0)
+    return;
+
+  // if we're in a database transaction, wait for its end
+  if (data.isMember("transaction") && data["transaction"].asBoolean())
+    return;
+
+  if (strcmp(message, "OnScanFinished") != 0 &&
+      strcmp(message, "OnCleanFinished") != 0 &&
+      strcmp(message, "OnUpdate") != 0 &&
+      strcmp(message, "OnRemove") != 0)
+    return;
+
+  CSingleLock lock(m_section);
+  for (auto &it : m_entries)
+  {
+    // listings being fetched right now may miss the change
+    Entry &entry = *it.second;
+    if (entry.fetching ||
+        ((flag & VideoLibrary) && entry.video) ||
+        ((flag & AudioLibrary) && entry.audio))
+      Invalidate(entry);
+  }
+}
+
+void CDirectoryProviderCache::OnAddonEvent(const ADDON::AddonEvent& event)
+{
+  if (typeid(event) == typeid(ADDON::AddonEvents::Enabled) ||
+      typeid(event) == typeid(ADDON::AddonEvents::Disabled) ||
+      typeid(event) == typeid(ADDON::AddonEvents::ReInstalled) ||
+      typeid(event) == typeid(ADDON::AddonEvents::UnInstalled) ||
+      typeid(event) == typeid(ADDON::AddonEvents::MetadataChanged))
+    InvalidateProtocol("addons");
+}
+
+void CDirectoryProviderCache::OnPVRManagerEvent(const PVR::PVREvent& event)
+{
+  if (event == ManagerStarted ||
+      event == ManagerStopped ||
+      event == ManagerError ||
+      event == ManagerInterrupted ||
+      event == RecordingsInvalidated)
+    InvalidateProtocol("pvr");
+}
+
+void CDirectoryProviderCache::OnFavouritesEvent(const CFavouritesService::FavouritesUpdated& event)
+{
+  InvalidateProtocol("favourites");
+}
+
+void CDirectoryProviderCache::OnListRequested()
+{
+  CSingleLock lock(m_section);
+  if (m_pendingLists++ == 0)
+  {
+    m_populateStart = XbmcThreads::SystemClockMillis();
+    m_populateLists = 0;
+    m_populateStats = m_stats;
+  }
+  m_populateLists++;
+}
+
+void CDirectoryProviderCache::OnListPopulated()
+{
+  CSingleLock lock(m_section);
+  if (m_pendingLists == 0 || --m_pendingLists > 0)
+    return;
+
+  const unsigned int duration = XbmcThreads::SystemClockMillis() - m_populateStart;
+  m_stats.populates++;
+  m_stats.lastPopulateMs = duration;
+  if (duration > m_stats.maxPopulateMs)
+    m_stats.maxPopulateMs = duration;
+
+  CLog::Log(LOGDEBUG, "CDirectoryProviderCache: populated %u lists in %u ms (%" PRIu64 " cached, %" PRIu64 " shared, %" PRIu64 " fetched)",
+            m_populateLists, duration,
+            m_stats.hits - m_populateStats.hits,
+            m_stats.coalesced - m_populateStats.coalesced,
+            m_stats.misses - m_populateStats.misses);
+}
+
+CDirectoryProviderCache::Statistics CDirectoryProviderCache::GetStatistics() const
+{
+  CSingleLock lock(m_section);
+  return m_stats;
+}
+
+void CDirectoryProviderCache::LogStatistics() const
+{
+  const Statistics stats = GetStatistics();
+  CLog::Log(LOGDEBUG, "CDirectoryProviderCache: %" PRIu64 " cached, %" PRIu64 " shared, %" PRIu64 " fetched, "
+            "%" PRIu64 " not cacheable, %" PRIu64 " sorted, %" PRIu64 " invalidations, "
+            "populated lists %u times (last %u ms, max %u ms)",
+            stats.hits, stats.coalesced, stats.misses, stats.uncached, stats.sorts, stats.invalidations,
+            stats.populates, stats.lastPopulateMs, stats.maxPopulateMs);
+}
@@ -0,0 +1,152 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+#include "addons/AddonEvents.h"
+#include "favourites/FavouritesService.h"
+#include "interfaces/IAnnouncer.h"
+#include "pvr/PVREvent.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "utils/SortUtils.h"
+
+class CFileItemList;
+class CSingleLock;
+class CVariant;
+
+/*!
+ \brief Process wide cache of the directories listed by CDirectoryProvider.
+
+ Skins often have many widgets pointing at the same URL, differing only in
+ sort order and limit. The cache keeps the listing of every URL, along with
+ a copy for every sort order asked for, so that all of them share a single
+ CDirectory::GetDirectory() call:
+ - a listing is reused until it is invalidated, either by the cache itself
+   on library, favourites, add-on and PVR changes, or by one of the providers
+   showing it
+ - listings of URLs whose changes are not announced (e.g. plugins) are not
+   cached at all, every request lists them again
+ - concurrent requests for a URL that is currently being fetched wait for that
+   fetch instead of starting their own
+
+ Cached listings are shared and must not be modified.
+ */
+class CDirectoryProviderCache : public ANNOUNCEMENT::IAnnouncer
+{
+public:
+  struct Statistics
+  {
+    uint64_t hits = 0;          //!< requests answered from the cache
+    uint64_t coalesced = 0;     //!< requests that waited for a fetch of another request
+    uint64_t misses = 0;        //!< requests that fetched the directory
+    uint64_t uncached = 0;      //!< requests for URLs whose changes are not announced
+    uint64_t sorts = 0;         //!< sorted copies made of cached listings
+    uint64_t invalidations = 0;
+    unsigned int populates = 0;       //!< number of times all pending lists were populated
+    unsigned int lastPopulateMs = 0;  //!< time from the first list request until all lists were populated
+    unsigned int maxPopulateMs = 0;
+  };
+
+  static CDirectoryProviderCache& GetInstance();
+
+  /*!
+   \brief Get the listing of the given URL, fetching it if necessary.
+   May block until a running fetch of the same URL finished.
+   \param url the URL to list
+   \param sort the order of the listing, sorted listings are cached as well
+   \return the listing or nullptr if the directory could not be listed
+   */
+  std::shared_ptr<const CFileItemList> GetDirectory(const std::string &url, const SortDescription &sort = SortDescription());
+
+  /*!
+   \brief Mark the listing of the given URL as outdated.
+   Repeated invalidations without a request in between are merged, so every
+   provider showing the URL may call this for the same announcement.
+   */
+  void Invalidate(const std::string &url);
+
+  /*!
+   \brief Drop all listings and stop listening for changes until the next
+   request, e.g. when a different profile is loaded or on shutdown.
+   */
+  void Clear();
+
+  void Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data) override;
+
+  /*!
+   \brief Track lists waiting to be populated, used to measure how long it
+   takes to populate a window full of lists.
+   */
+  void OnListRequested();
+  void OnListPopulated();
+
+  Statistics GetStatistics() const;
+  void LogStatistics() const;
+
+private:
+  CDirectoryProviderCache() = default;
+  ~CDirectoryProviderCache() override = default;
+  CDirectoryProviderCache(const CDirectoryProviderCache&) = delete;
+  CDirectoryProviderCache& operator=(const CDirectoryProviderCache&) = delete;
+
+  struct Entry
+  {
+    std::shared_ptr<const CFileItemList> items;
+    unsigned int generation = 0;       //!< bumped on every invalidation
+    unsigned int itemsGeneration = 0;  //!< generation the items were fetched for
+    unsigned int fetchGeneration = 0;  //!< generation of the running (or last) fetch
+    bool fetching = false;
+    bool fetchFailed = false;
+    bool video = false;                //!< the URL lists the video library
+    bool audio = false;                //!< the URL lists the music library
+    unsigned int lastUsed = 0;
+    //! sorted copies of the items, dropped together with them
+    std::map<std::string, std::shared_ptr<const CFileItemList>> sorted;
+  };
+
+  std::shared_ptr<Entry> GetEntry(const std::string &url);
+  std::shared_ptr<const CFileItemList> GetItems(const std::string &url, Entry &entry, CSingleLock &lock);
+  void Invalidate(Entry &entry);
+  void InvalidateProtocol(const std::string &protocol);
+
+  void Subscribe();
+  void OnAddonEvent(const ADDON::AddonEvent& event);
+  void OnPVRManagerEvent(const PVR::PVREvent& event);
+  void OnFavouritesEvent(const CFavouritesService::FavouritesUpdated& event);
+
+  CCriticalSection m_subscribeSection; //!< never held together with m_section
+  bool m_subscribed = false;
+
+  mutable CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_fetchDone;
+  std::map<std::string, std::shared_ptr<Entry>> m_entries;
+  Statistics m_stats;
+
+  unsigned int m_pendingLists = 0;
+  unsigned int m_populateStart = 0;
+  unsigned int m_populateLists = 0;
+  Statistics m_populateStats;
+};
@@ -446,6 +446,8 @@ bool CMusicDatabase::AddAlbum(CAlbum& album)
   for (const auto &albumArt : album.art)
     SetArtForItem(album.idAlbum, MediaTypeAlbum, albumArt.first, albumArt.second);
 
+  UpdateFullTextEntry("album_fts", album.idAlbum);
+
   CommitTransaction();
   return true;
 }
@@ -500,6 +502,8 @@ bool CMusicDatabase::UpdateAlbum(CAlbum& album)
   if (!album.art.empty())
     SetArtForItem(album.idAlbum, MediaTypeAlbum, album.art);
 
+  UpdateFullTextEntry("album_fts", album.idAlbum);
+
   CommitTransaction();
   return true;
 }
@@ -598,6 +602,8 @@ int CMusicDatabase::AddSong(const int idAlbum,
 
     UpdateFileDateAdded(idSong, strPathAndFileName);
 
+    UpdateFullTextEntry("song_fts", idSong);
+
     AnnounceUpdate(MediaTypeSong, idSong, true);
   }
   catch (...)
@@ -757,7 +763,10 @@ int CMusicDatabase::UpdateSong(int idSong,
   UpdateFileDateAdded(idSong, strPathAndFileName);
 
   if (status)
+  {
+    UpdateFullTextEntry("song_fts", idSong);
     AnnounceUpdate(MediaTypeSong, idSong);
+  }
   return idSong;
 }
 
@@ -1175,6 +1184,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist, const std::string& s
           strSQL = PrepareSQL("UPDATE artist SET strArtist = '%s' WHERE idArtist = %i", strArtist.c_str(), idArtist);
           m_pDS->exec(strSQL);
           m_pDS->close();
+          UpdateFullTextEntry("artist_fts", idArtist);
         }
         return idArtist;
       }
@@ -1196,6 +1206,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist, const std::string& s
           bScrapedMBID,
           idArtist);
         m_pDS->exec(strSQL);
+        UpdateFullTextEntry("artist_fts", idArtist);
         return idArtist;
       }
 
@@ -1230,6 +1241,7 @@ int CMusicDatabase::AddArtist(const std::string& strArtist, const std::string& s
 
     m_pDS->exec(strSQL);
     int idArtist = (int)m_pDS->lastinsertid();
+    UpdateFullTextEntry("artist_fts", idArtist);
     return idArtist;
   }
   catch (...)
@@ -2386,6 +2398,11 @@ bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList &art
                                 "where strArtist like '%s%%' and strArtist <> '%s' "
                                 , search.c_str(), strVariousArtists.c_str() );
 
+    // the full text index narrows down the artists the like is evaluated on
+    std::string fullText = GetFullTextSubQuery("artist_fts", { "name" }, search, true);
+    if (!fullText.empty())
+      strSQL += "and idArtist in (" + fullText + ") ";
+
     if (!m_pDS->query(strSQL)) return false;
     if (m_pDS->num_rows() == 0)
     {
@@ -2921,11 +2938,18 @@ bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList &items
     if (!baseUrl.FromString("musicdb://songs/"))
       return false;
 
-    std::string strSQL;
+    std::string where;
     if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' or strTitle like '%% %s%%' limit 1000", search.c_str(), search.c_str());
+      where = PrepareSQL("(strTitle like '%s%%' or strTitle like '%% %s%%')", search.c_str(), search.c_str());
     else
-      strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' limit 1000", search.c_str());
+      where = PrepareSQL("strTitle like '%s%%'", search.c_str());
+
+    // the full text index narrows down the songs the like is evaluated on
+    std::string fullText = GetFullTextSubQuery("song_fts", { "title" }, search, true);
+    if (!fullText.empty())
+      where = "idSong in (" + fullText + ") and " + where;
+
+    std::string strSQL = "select * from songview where " + where + " limit 1000";
 
     if (!m_pDS->query(strSQL)) return false;
     if (m_pDS->num_rows() == 0) return false;
@@ -2957,11 +2981,18 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList &albu
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    std::string strSQL;
+    std::string where;
     if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%' or strAlbum like '%% %s%%'", search.c_str(), search.c_str());
+      where = PrepareSQL("(strAlbum like '%s%%' or strAlbum like '%% %s%%')", search.c_str(), search.c_str());
     else
-      strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%'", search.c_str());
+      where = PrepareSQL("strAlbum like '%s%%'", search.c_str());
+
+    // the full text index narrows down the albums the like is evaluated on
+    std::string fullText = GetFullTextSubQuery("album_fts", { "title" }, search, true);
+    if (!fullText.empty())
+      where = "idAlbum in (" + fullText + ") and " + where;
+
+    std::string strSQL = "select * from albumview where " + where;
 
     if (!m_pDS->query(strSQL)) return false;
 
@@ -4217,6 +4248,21 @@ bool CMusicDatabase::GetAlbumsByWhere(const std::string &baseDir, const Filter &
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
       strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
     }
+    // A limited random list (e.g. a random albums widget) only needs to fetch
+    // the randomly picked albums instead of all of them
+    else if (!countOnly && extFilter.limit.empty() &&
+             sortDescription.sortBy == SortByRandom &&
+             sortDescription.limitStart <= 0 && sortDescription.limitEnd > 0)
+    {
+      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
+
+      Filter randomFilter = extFilter;
+      if (!FilterRandomIDs("albumview", "albumview.idAlbum", randomFilter, sortDescription.limitEnd))
+        return false;
+      strSQLExtra.clear();
+      if (!BuildSQL(strSQLExtra, randomFilter, strSQLExtra))
+        return false;
+    }
 
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "albumview.*") + strSQLExtra;
 
@@ -4457,9 +4503,22 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0);
     if (limitedInSQL)
     {
-      if (sortDescription.sortBy == SortByRandom)
-        strSQLExtra += PrepareSQL(" ORDER BY RANDOM()");
-      strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      if (sortDescription.sortBy == SortByRandom && sortDescription.limitStart <= 0)
+      {
+        // pick the songs up front rather than sorting the whole view by RANDOM()
+        Filter randomFilter = extFilter;
+        if (!FilterRandomIDs("songview", "songview.idSong", randomFilter, sortDescription.limitEnd))
+          return false;
+        strSQLExtra.clear();
+        if (!BuildSQL(strSQLExtra, randomFilter, strSQLExtra))
+          return false;
+      }
+      else
+      {
+        if (sortDescription.sortBy == SortByRandom)
+          strSQLExtra += PrepareSQL(" ORDER BY RANDOM()");
+        strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
+      }
     }
 
     std::string strSQL;
@@ -5353,6 +5412,39 @@ int CMusicDatabase::GetSchemaVersion() const
   return 70;
 }
 
+std::vector<CDatabase::FullTextIndex> CMusicDatabase::GetFullTextIndexes() const
+{
+  std::vector<FullTextIndex> indexes;
+
+  FullTextIndex songs;
+  songs.name = "song_fts";
+  songs.table = "song";
+  songs.idColumn = "idSong";
+  songs.columns = { { "title", "strTitle" }, { "artist", "strArtistDisp" } };
+  indexes.push_back(songs);
+
+  FullTextIndex albums;
+  albums.name = "album_fts";
+  albums.table = "album";
+  albums.idColumn = "idAlbum";
+  albums.columns = { { "title", "strAlbum" }, { "artist", "strArtistDisp" } };
+  indexes.push_back(albums);
+
+  FullTextIndex artists;
+  artists.name = "artist_fts";
+  artists.table = "artist";
+  artists.idColumn = "idArtist";
+  artists.columns = { { "name", "strArtist" } };
+  indexes.push_back(artists);
+
+  return indexes;
+}
+
+bool CMusicDatabase::IsFullTextSearchEnabled() const
+{
+  return g_advancedSettings.m_bMusicLibraryFullTextSearch;
+}
+
 int CMusicDatabase::GetMusicNeedsTagScan()
 {
   try
@@ -6057,7 +6149,7 @@ int CMusicDatabase::GetGenreByName(const std::string& strGenre)
   return -1;
 }
 
-bool CMusicDatabase::GetRandomSong(CFileItem* item, int& idSong, const Filter &filter)
+bool CMusicDatabase::GetRandomSong(CFileItem* item, int& idSong, const Filter &filter, const std::set<int> &exclude /* = std::set<int>() */)
 {
   try
   {
@@ -6067,24 +6159,12 @@ bool CMusicDatabase::GetRandomSong(CFileItem* item, int& idSong, const Filter &f
     if (NULL == m_pDS.get()) return false;
 
     // Get a random song that matches filter criteria (which may exclude some songs)
-    // We don't use PrepareSQL here, as the WHERE clause is already formatted but must
-    // use songview as that is what the WHERE clause has as reference table
-    std::string strSQL = "SELECT idSong FROM songview ";
-    Filter extFilter = filter;
-    extFilter.AppendOrder(PrepareSQL("RANDOM()"));
-    extFilter.limit = "1";
-    if (!CDatabase::BuildSQL(strSQL, extFilter, strSQL))
-      return false;
-    if (!m_pDS->query(strSQL))
-      return false;
-    int iRowsFound = m_pDS->num_rows();
-    if (iRowsFound != 1)
-    {
-      m_pDS->close();
+    // The WHERE clause is already formatted but must use songview as that is
+    // what the WHERE clause has as reference table
+    std::vector<int> ids;
+    if (!GetRandomIDs("songview", "songview.idSong", filter, 1, exclude, ids) || ids.empty())
       return false;
-    }
-    idSong = m_pDS->fv("songview.idSong").get_asInt();
-    m_pDS->close();
+    idSong = ids.front();
 
     // Fetch the full song details, including contributors
     std::string baseDir = StringUtils::Format("musicdb://songs/?songid=%d", idSong);
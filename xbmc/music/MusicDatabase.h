@@ -438,7 +438,14 @@ public:
   bool GetAlbumsByWhere(const std::string &baseDir, const Filter &filter, CFileItemList &items, const SortDescription &sortDescription = SortDescription(), bool countOnly = false);
   bool GetAlbumsByWhere(const std::string &baseDir, const Filter &filter, VECALBUMS& albums, int& total, const SortDescription &sortDescription = SortDescription(), bool countOnly = false);
   bool GetArtistsByWhere(const std::string& strBaseDir, const Filter &filter, CFileItemList& items, const SortDescription &sortDescription = SortDescription(), bool countOnly = false);
-  bool GetRandomSong(CFileItem* item, int& idSong, const Filter &filter);
+  /*! \brief Get a random song matching the filter
+   \param item [out] the song
+   \param idSong [out] the id of the song
+   \param filter the filter to apply
+   \param exclude ids of songs that must not be picked, e.g. those played before
+   \return true if a song was found
+   */
+  bool GetRandomSong(CFileItem* item, int& idSong, const Filter &filter, const std::set<int> &exclude = std::set<int>());
   int GetSongsCount(const Filter &filter = Filter());
   unsigned int GetSongIDs(const Filter &filter, std::vector<std::pair<int,int> > &songIDs);
   bool GetFilter(CDbUrl &musicUrl, Filter &filter, SortDescription &sorting) override;
@@ -595,6 +602,8 @@ protected:
   int GetSchemaVersion() const override;
 
   const char *GetBaseDBName() const override { return "MyMusic"; };
+  std::vector<FullTextIndex> GetFullTextIndexes() const override;
+  bool IsFullTextSearchEnabled() const override;
 
 private:
   /*! \brief (Re)Create the generic database views for songs and albums
@@ -26,11 +26,9 @@
 #include "filesystem/MusicDatabaseDirectory/QueryParams.h"
 #include "utils/URIUtils.h"
 #include "music/tags/MusicInfoTag.h"
-#include "filesystem/File.h"
 #include "settings/Settings.h"
 #include "FileItem.h"
 #include "utils/log.h"
-#include "utils/Archive.h"
 #include "Artist.h"
 #include "Album.h"
 #include "MusicThumbLoader.h"
@@ -44,29 +42,22 @@ CMusicInfoLoader::CMusicInfoLoader()
   , m_databaseHits{0}
   , m_tagReads{0}
 {
-  m_mapFileItems = new CFileItemList;
-
   m_thumbLoader = new CMusicThumbLoader();
 }
 
 CMusicInfoLoader::~CMusicInfoLoader()
 {
   StopThread();
-  delete m_mapFileItems;
   delete m_thumbLoader;
 }
 
 void CMusicInfoLoader::OnLoaderStart()
 {
-  // Load previously cached items from HD
+  // Open previously cached items on HD, they are only deserialized when looked up
   if (!m_strCacheFileName.empty())
-    LoadCache(m_strCacheFileName, *m_mapFileItems);
+    m_cachedItems.Open(m_strCacheFileName);
   else
-  {
-    m_mapFileItems->SetPath(m_pVecItems->GetPath());
-    m_mapFileItems->Load();
-    m_mapFileItems->SetFastLookup(true);
-  }
+    m_cachedItems.Open(*m_pVecItems);
 
   m_strPrevPath.clear();
 
@@ -179,7 +170,7 @@ bool CMusicInfoLoader::LoadItemLookup(CFileItem* pItem)
   if (!pItem->HasMusicInfoTag() || !pItem->GetMusicInfoTag()->Loaded())
   {
     // first check the cached item
-    CFileItemPtr mapItem = (*m_mapFileItems)[pItem->GetPath()];
+    CFileItemPtr mapItem = m_cachedItems.Get(pItem->GetPath());
     if (mapItem && mapItem->m_dateTime==pItem->m_dateTime && mapItem->HasMusicInfoTag() && mapItem->GetMusicInfoTag()->Loaded())
     { // Query map if we previously cached the file on HD
       *pItem->GetMusicInfoTag() = *mapItem->GetMusicInfoTag();
@@ -249,11 +240,14 @@ void CMusicInfoLoader::OnLoaderFinish()
   m_songsMap.clear();
 
   // cleanup cache loaded from HD
-  m_mapFileItems->Clear();
+  m_cachedItems.Close();
 
   // Save loaded items to HD
   if (!m_strCacheFileName.empty())
-    SaveCache(m_strCacheFileName, *m_pVecItems);
+  {
+    if (m_pVecItems->Size() > 0)
+      CFileItemListCache::Save(*m_pVecItems, m_strCacheFileName);
+  }
   else if (!m_bStop && (m_databaseHits > 1 || m_tagReads > 0))
     m_pVecItems->Save();
 
@@ -267,48 +261,3 @@ void CMusicInfoLoader::UseCacheOnHD(const std::string& strFileName)
 {
   m_strCacheFileName = strFileName;
 }
-
-void CMusicInfoLoader::LoadCache(const std::string& strFileName, CFileItemList& items)
-{
-  CFile file;
-
-  if (file.Open(strFileName))
-  {
-    CArchive ar(&file, CArchive::load);
-    int iSize = 0;
-    ar >> iSize;
-    for (int i = 0; i < iSize; i++)
-    {
-      CFileItemPtr pItem(new CFileItem());
-      ar >> *pItem;
-      items.Add(pItem);
-    }
-    ar.Close();
-    file.Close();
-    items.SetFastLookup(true);
-  }
-}
-
-void CMusicInfoLoader::SaveCache(const std::string& strFileName, CFileItemList& items)
-{
-  int iSize = items.Size();
-
-  if (iSize <= 0)
-    return ;
-
-  CFile file;
-
-  if (file.OpenForWrite(strFileName))
-  {
-    CArchive ar(&file, CArchive::store);
-    ar << (int)items.Size();
-    for (int i = 0; i < iSize; i++)
-    {
-      CFileItemPtr pItem = items[i];
-      ar << *pItem;
-    }
-    ar.Close();
-    file.Close();
-  }
-
-}
@@ -19,9 +19,9 @@
  *
  */
 #include "BackgroundInfoLoader.h"
+#include "FileItemListCache.h"
 #include "MusicDatabase.h"
 
-class CFileItemList;
 class CMusicThumbLoader;
 
 namespace MUSIC_INFO
@@ -41,11 +41,9 @@ public:
 protected:
   void OnLoaderStart() override;
   void OnLoaderFinish() override;
-  void LoadCache(const std::string& strFileName, CFileItemList& items);
-  void SaveCache(const std::string& strFileName, CFileItemList& items);
 protected:
   std::string m_strCacheFileName;
-  CFileItemList* m_mapFileItems;
+  CFileItemListCache m_cachedItems;
   MAPSONGS m_songsMap;
   std::string m_strPrevPath;
   CMusicDatabase m_musicDatabase;
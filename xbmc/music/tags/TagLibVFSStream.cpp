@@ -20,6 +20,9 @@
 #include "limits.h"
 #include "TagLibVFSStream.h"
 #include "filesystem/File.h"
+#include "utils/URIUtils.h"
+#include <algorithm>
+#include <string.h>
 #include <taglib/tiostream.h>
 
 using namespace XFILE;
@@ -45,6 +48,14 @@ TagLibVFSStream::TagLibVFSStream(const std::string& strFileName, bool readOnly)
   }
   m_strFileName = strFileName;
   m_bIsReadOnly = readOnly || !m_bIsOpen;
+  m_bReadAhead = readOnly && m_bIsOpen && URIUtils::IsRemote(strFileName);
+}
+
+TagLibVFSStream::TagLibVFSStream(bool readAhead)
+{
+  m_bIsOpen = true;
+  m_bIsReadOnly = true;
+  m_bReadAhead = readAhead;
 }
 
 /*!
@@ -68,6 +79,21 @@ FileName TagLibVFSStream::name() const
  */
 ByteVector TagLibVFSStream::readBlock(TagLib::ulong length)
 {
+  if (m_bIsReadOnly)
+  {
+    ByteVector byteVector(static_cast<TagLib::uint>(length));
+    size_t done = 0;
+    while (done < length)
+    {
+      ssize_t read = ReadBuffered(byteVector.data() + done, length - done);
+      if (read <= 0)
+        break;
+      done += read;
+    }
+    byteVector.resize(static_cast<TagLib::uint>(done));
+    return byteVector;
+  }
+
   ByteVector byteVector(static_cast<TagLib::uint>(length));
   ssize_t read = m_file.Read(byteVector.data(), length);
   if (read > 0)
@@ -249,35 +275,37 @@ bool TagLibVFSStream::isOpen() const
 void TagLibVFSStream::seek(long offset, Position p)
 {
   const long fileLen = length();
-  if (m_bIsReadOnly && fileLen > 0)
+  if (m_bIsReadOnly)
   {
-    long startPos;
+    int64_t position;
     if (p == Beginning)
-      startPos = 0;
+      position = offset;
     else if (p == Current)
-      startPos = tell();
+      position = m_position + offset;
     else if (p == End)
-      startPos = fileLen;
-    else
-      return; // wrong Position value
-
-    // When parsing some broken files, taglib may try to seek above end of file.
-    // If underlying VFS does not move I/O pointer in this case, taglib will parse
-    // same part of file several times and ends with error. To prevent this
-    // situation, force seek to last valid position so VFS move I/O pointer.
-    if (startPos >= 0)
     {
-      if (offset < 0 && startPos + offset < 0)
-      {
-        m_file.Seek(0, SEEK_SET);
-        return;
-      }
-      if (offset > 0 && startPos + offset > fileLen)
+      // the length is unknown, let the VFS find the end
+      if (fileLen <= 0)
       {
-        m_file.Seek(fileLen, SEEK_SET);
+        const int64_t end = m_file.Seek(offset, SEEK_END);
+        if (end >= 0)
+          m_position = end;
         return;
       }
+      position = fileLen + offset;
     }
+    else
+      return; // wrong Position value
+
+    // When parsing some broken files, taglib may try to seek above end of file.
+    // Keep the position within the file, so taglib doesn't parse the same part
+    // of the file several times.
+    if (position < 0)
+      position = 0;
+    else if (fileLen > 0 && position > fileLen)
+      position = fileLen;
+    m_position = position;
+    return;
   }
 
   switch(p)
@@ -306,7 +334,7 @@ void TagLibVFSStream::clear()
  */
 long TagLibVFSStream::tell() const
 {
-  int64_t pos = m_file.GetPosition();
+  int64_t pos = m_bIsReadOnly ? m_position : m_file.GetPosition();
   if(pos > LONG_MAX)
     return -1;
   else
@@ -318,6 +346,12 @@ long TagLibVFSStream::tell() const
  */
 long TagLibVFSStream::length()
 {
+  if (m_bIsReadOnly)
+  {
+    if (m_length < 0)
+      m_length = GetFileLength();
+    return (long)m_length;
+  }
   return (long)m_file.GetLength();
 }
 
@@ -328,3 +362,97 @@ void TagLibVFSStream::truncate(long length)
 {
   m_file.Truncate(length);
 }
+
+ssize_t TagLibVFSStream::ReadAt(int64_t position, void *buffer, size_t size)
+{
+  if (m_file.GetPosition() != position && m_file.Seek(position, SEEK_SET) != position)
+    return -1;
+  return m_file.Read(buffer, size);
+}
+
+int64_t TagLibVFSStream::GetFileLength()
+{
+  return m_file.GetLength();
+}
+
+ssize_t TagLibVFSStream::ReadBuffered(char *buffer, size_t size)
+{
+  const int64_t fileLen = length();
+  if (!m_bReadAhead || fileLen <= 0)
+  {
+    ssize_t read = ReadAt(m_position, buffer, size);
+    if (read > 0)
+      m_position += read;
+    return read;
+  }
+
+  if (m_position >= fileLen)
+    return 0;
+
+  const Window *window = GetWindow(m_position);
+  const size_t offset = static_cast<size_t>(m_position - window->start);
+  if (offset >= window->data.size())
+    return 0; // the file ended early
+
+  size_t read = std::min(size, window->data.size() - offset);
+  memcpy(buffer, window->data.data() + offset, read);
+  m_position += read;
+
+  // a read beyond the window larger than a chunk, most likely embedded art,
+  // takes one request for the remainder instead of one per chunk
+  const size_t remaining = size - read;
+  if (remaining > ChunkSize() && m_position < fileLen)
+  {
+    const ssize_t direct = ReadAt(m_position, buffer + read,
+                                  static_cast<size_t>(std::min<int64_t>(remaining, fileLen - m_position)));
+    if (direct > 0)
+    {
+      read += direct;
+      m_position += direct;
+    }
+  }
+  return static_cast<ssize_t>(read);
+}
+
+const TagLibVFSStream::Window* TagLibVFSStream::GetWindow(int64_t position)
+{
+  const int64_t headEnd = std::min<int64_t>(HeadWindowSize(), m_length);
+  const int64_t tailStart = std::max<int64_t>(headEnd, m_length - TailWindowSize());
+
+  if (position < headEnd)
+  {
+    if (!m_head.loaded)
+      LoadWindow(m_head, 0, static_cast<size_t>(headEnd));
+    return &m_head;
+  }
+
+  if (position >= tailStart)
+  {
+    if (!m_tail.loaded)
+      LoadWindow(m_tail, tailStart, static_cast<size_t>(m_length - tailStart));
+    return &m_tail;
+  }
+
+  // in between, most likely embedded art beyond the head
+  if (!m_chunk.loaded || position < m_chunk.start ||
+      position >= m_chunk.start + static_cast<int64_t>(m_chunk.data.size()))
+    LoadWindow(m_chunk, position, static_cast<size_t>(std::min<int64_t>(ChunkSize(), tailStart - position)));
+  return &m_chunk;
+}
+
+void TagLibVFSStream::LoadWindow(Window &window, int64_t start, size_t size)
+{
+  window.start = start;
+  window.data.resize(size);
+  window.loaded = true;
+
+  size_t done = 0;
+  while (done < size)
+  {
+    ssize_t read = ReadAt(start + done, window.data.data() + done, size - done);
+    if (read <= 0)
+      break;
+    done += read;
+  }
+  window.data.resize(done);
+}
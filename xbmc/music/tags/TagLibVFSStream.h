@@ -19,7 +19,9 @@
  *
  */
 #include "filesystem/File.h"
+#include <stdint.h>
 #include <taglib/tiostream.h>
+#include <vector>
 
 namespace MUSIC_INFO
 {
@@ -29,6 +31,10 @@ namespace MUSIC_INFO
     /*!
      * Construct a File object and opens the \a file.  \a file should be a
      * be an XBMC Vfile.
+     *
+     * Remote files opened read only are read ahead: the head and the tail of
+     * the file, where the tags are, are fetched in one request each and
+     * TagLib's small reads are served from them.
      */
     TagLibVFSStream(const std::string& strFileName, bool readOnly);
 
@@ -115,17 +121,60 @@ namespace MUSIC_INFO
      */
     void truncate(long length) override;
 
+    /*!
+     * Returns the number of bytes fetched in one request in read ahead mode.
+     */
+    static size_t HeadWindowSize() { return 256 * 1024; }
+    static size_t TailWindowSize() { return 64 * 1024; }
+    static size_t ChunkSize() { return 64 * 1024; }
+
   protected:
+    /*!
+     * Construct a read only stream without opening a file, for streams
+     * reading from elsewhere by overriding ReadAt() and GetFileLength().
+     */
+    explicit TagLibVFSStream(bool readAhead);
+
+    /*!
+     * Reads up to \a size bytes at \a position of the file. All reads of read
+     * only streams go through here, one call per request to the file.
+     */
+    virtual ssize_t ReadAt(int64_t position, void *buffer, size_t size);
+
+    /*!
+     * Returns the length of the file, asked once by read only streams.
+     */
+    virtual int64_t GetFileLength();
+
     /*!
      * Returns the buffer size that is used for internal buffering.
      */
     static TagLib::uint bufferSize() { return 1024; };
 
   private:
+    struct Window
+    {
+      int64_t start = 0;
+      std::vector<char> data;
+      bool loaded = false;
+    };
+
+    ssize_t ReadBuffered(char *buffer, size_t size);
+    const Window* GetWindow(int64_t position);
+    void LoadWindow(Window &window, int64_t start, size_t size);
+
     std::string   m_strFileName;
     XFILE::CFile  m_file;
     bool          m_bIsReadOnly;
     bool          m_bIsOpen;
+
+    // read only streams keep their own position, the file is only seeked to read
+    bool          m_bReadAhead = false;
+    int64_t       m_position = 0;
+    int64_t       m_length = -1;
+    Window        m_head;
+    Window        m_tail;
+    Window        m_chunk; //!< last read between head and tail
   };
 }
 
@@ -0,0 +1,194 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "music/tags/TagLibVFSStream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace MUSIC_INFO;
+
+namespace
+{
+/*!
+ * Stand-in for a file on a network share: every request to the file takes
+ * the given latency and is counted.
+ */
+class CLatencyStream : public TagLibVFSStream
+{
+public:
+  CLatencyStream(const std::vector<char>& data, bool readAhead, std::chrono::microseconds latency)
+    : TagLibVFSStream(readAhead), m_data(data), m_latency(latency) {}
+
+  int m_requests = 0;
+
+protected:
+  ssize_t ReadAt(int64_t position, void *buffer, size_t size) override
+  {
+    Request();
+    if (position < 0 || position >= static_cast<int64_t>(m_data.size()))
+      return 0;
+    size = std::min(size, static_cast<size_t>(m_data.size() - position));
+    memcpy(buffer, m_data.data() + position, size);
+    return static_cast<ssize_t>(size);
+  }
+
+  int64_t GetFileLength() override
+  {
+    Request();
+    return static_cast<int64_t>(m_data.size());
+  }
+
+private:
+  void Request()
+  {
+    m_requests++;
+    if (m_latency.count() > 0)
+      std::this_thread::sleep_for(m_latency);
+  }
+
+  const std::vector<char>& m_data;
+  std::chrono::microseconds m_latency;
+};
+
+std::vector<char> CreateData(size_t size)
+{
+  std::vector<char> data(size);
+  for (size_t i = 0; i < size; i++)
+    data[i] = static_cast<char>(i * 7 + i / 251);
+  return data;
+}
+
+// the requests TagLib makes reading the tags and properties of an mp3 file
+void ReadTags(TagLib::IOStream& stream)
+{
+  stream.seek(0);
+  stream.readBlock(10);          // ID3v2 header
+  stream.readBlock(1024 * 1024); // ID3v2 frames with embedded art
+  for (int i = 0; i < 4; i++)
+    stream.readBlock(1024);      // first MPEG frame
+  stream.seek(-128, TagLib::IOStream::End);
+  stream.readBlock(128);         // ID3v1
+  stream.seek(-160, TagLib::IOStream::End);
+  stream.readBlock(32);          // APE footer
+  stream.seek(-4096, TagLib::IOStream::End);
+  for (int i = 0; i < 4; i++)
+    stream.readBlock(1024);      // last MPEG frame
+}
+}
+
+TEST(TestTagLibVFSStream, Content)
+{
+  const std::vector<char> data(CreateData(1024 * 1024));
+  CLatencyStream direct(data, false, std::chrono::microseconds(0));
+  CLatencyStream readAhead(data, true, std::chrono::microseconds(0));
+  EXPECT_TRUE(readAhead.readOnly());
+  EXPECT_EQ(static_cast<long>(data.size()), readAhead.length());
+
+  std::mt19937 random(7);
+  std::uniform_int_distribution<long> position(-1000, static_cast<long>(data.size()) + 1000);
+  std::uniform_int_distribution<unsigned long> length(0, 100000);
+  for (int i = 0; i < 500; i++)
+  {
+    const long offset = position(random);
+    const TagLib::ulong size = length(random);
+    const TagLib::IOStream::Position from = (i % 2) ? TagLib::IOStream::Beginning : TagLib::IOStream::End;
+    const long seekOffset = from == TagLib::IOStream::End ? offset - static_cast<long>(data.size()) : offset;
+
+    direct.seek(seekOffset, from);
+    readAhead.seek(seekOffset, from);
+    ASSERT_EQ(direct.tell(), readAhead.tell());
+    ASSERT_GE(readAhead.tell(), 0);
+    ASSERT_LE(readAhead.tell(), static_cast<long>(data.size()));
+
+    const long start = readAhead.tell();
+    const TagLib::ByteVector expected(direct.readBlock(size));
+    const TagLib::ByteVector actual(readAhead.readBlock(size));
+    ASSERT_EQ(std::min<size_t>(size, data.size() - start), actual.size());
+    ASSERT_TRUE(expected == actual);
+    ASSERT_EQ(0, memcmp(data.data() + start, actual.data(), actual.size()));
+    ASSERT_EQ(direct.tell(), readAhead.tell());
+  }
+}
+
+TEST(TestTagLibVFSStream, SmallFile)
+{
+  const std::vector<char> data(CreateData(1000));
+  CLatencyStream stream(data, true, std::chrono::microseconds(0));
+  ReadTags(stream);
+  stream.seek(0);
+  const TagLib::ByteVector all(stream.readBlock(2000));
+  ASSERT_EQ(data.size(), all.size());
+  EXPECT_EQ(0, memcmp(data.data(), all.data(), all.size()));
+  // length and one request for the whole file
+  EXPECT_EQ(2, stream.m_requests);
+}
+
+TEST(TestTagLibVFSStream, LargeRead)
+{
+  const std::vector<char> data(CreateData(4 * 1024 * 1024));
+  CLatencyStream stream(data, true, std::chrono::microseconds(0));
+  stream.seek(100);
+  const TagLib::ByteVector art(stream.readBlock(2 * 1024 * 1024));
+  ASSERT_EQ(2u * 1024 * 1024, art.size());
+  EXPECT_EQ(0, memcmp(data.data() + 100, art.data(), art.size()));
+  EXPECT_EQ(100 + 2 * 1024 * 1024, stream.tell());
+  // length, head and one request for the rest
+  EXPECT_EQ(3, stream.m_requests);
+}
+
+// Compares requests and files per second reading the tags of files on a
+// share with 2 ms latency per request
+TEST(TestTagLibVFSStream, DISABLED_Benchmark)
+{
+  static const int FILES = 20;
+  const std::vector<char> data(CreateData(8 * 1024 * 1024));
+  const std::chrono::microseconds latency(2000);
+
+  int requests[2] = { 0, 0 };
+  double filesPerSecond[2] = { 0, 0 };
+  for (int readAhead = 0; readAhead < 2; readAhead++)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < FILES; i++)
+    {
+      CLatencyStream stream(data, readAhead != 0, latency);
+      ReadTags(stream);
+      requests[readAhead] += stream.m_requests;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    filesPerSecond[readAhead] = FILES / seconds;
+  }
+
+  RecordProperty("DirectRequests", requests[0]);
+  RecordProperty("ReadAheadRequests", requests[1]);
+  RecordProperty("DirectFilesPerSecond", static_cast<int>(filesPerSecond[0]));
+  RecordProperty("ReadAheadFilesPerSecond", static_cast<int>(filesPerSecond[1]));
+
+  // length, head, the art beyond the head, a chunk for the first MPEG frame and tail
+  EXPECT_EQ(5 * FILES, requests[1]);
+  EXPECT_LT(requests[1], requests[0]);
+}
@@ -19,11 +19,22 @@
  */
 
 #include "TCPServer.h"
+#include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#if !defined(TARGET_WINDOWS)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#define TCPSERVER_EPOLL
+#endif
 
 #include "settings/AdvancedSettings.h"
 #include "interfaces/json-rpc/JSONRPC.h"
@@ -31,6 +42,7 @@
 #include "utils/log.h"
 #include "utils/Variant.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "websocket/WebSocketManager.h"
 #include "Network.h"
 
@@ -62,6 +74,41 @@ using namespace ANNOUNCEMENT;
 
 #define RECEIVEBUFFER 1024
 
+// connections waiting to be accepted, e.g. remotes reconnecting all at once after a restart
+#define LISTEN_BACKLOG 128
+
+// queued bytes above which a client doesn't get notifications until it caught up
+#define MAX_NOTIFICATION_BACKLOG (1024 * 1024)
+// queued bytes above which a client that doesn't read its responses is dropped
+#define MAX_SEND_BACKLOG (16 * 1024 * 1024)
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+
+static bool WouldBlock()
+{
+#if defined(TARGET_WINDOWS)
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+static void SetNonBlocking(SOCKET socket)
+{
+#if defined(TARGET_WINDOWS)
+  u_long nonblocking = 1;
+  ioctlsocket(socket, FIONBIO, &nonblocking);
+#else
+  int flags = fcntl(socket, F_GETFL, 0);
+  if (flags != -1)
+    fcntl(socket, F_SETFL, flags | O_NONBLOCK);
+#endif
+}
+
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
 bool CTCPServer::StartServer(int port, bool nonlocal)
@@ -95,6 +142,8 @@ void CTCPServer::StopServer(bool bWait)
 {
   if (ServerInstance)
   {
+    ServerInstance->m_bStop = true;
+    ServerInstance->Wakeup();
     ServerInstance->StopThread(bWait);
     if (bWait)
     {
@@ -117,118 +166,336 @@ CTCPServer::CTCPServer(int port, bool nonlocal) : CThread("TCPServer")
   m_port = port;
   m_nonlocal = nonlocal;
   m_sdpd = NULL;
+  m_pollfd = -1;
+  m_wakeupfd = -1;
+  m_notificationDeadline = 0;
+  m_coalescedNotifications = 0;
 }
 
 void CTCPServer::Process()
 {
   m_bStop = false;
 
+  if (!InitializePoller())
+    CLog::Log(LOGWARNING, "JSONRPC Server: Failed to create the event poller, falling back to select");
+
+  std::vector<CSocketEvent> events;
   while (!m_bStop)
   {
-    SOCKET          max_fd = 0;
-    fd_set          rfds;
-    struct timeval  to     = {1, 0};
-    FD_ZERO(&rfds);
-
-    for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); ++it)
-    {
-      FD_SET(*it, &rfds);
-      if ((intptr_t)*it > (intptr_t)max_fd)
-        max_fd = *it;
-    }
+    UpdateWatches();
 
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+    int timeout = 1000;
     {
-      FD_SET(m_connections[i]->m_socket, &rfds);
-      if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
-        max_fd = m_connections[i]->m_socket;
+      CSingleLock lock(m_notificationSection);
+      if (!m_pendingNotifications.empty())
+      {
+        int remaining = (int)(m_notificationDeadline - XbmcThreads::SystemClockMillis());
+        timeout = std::max(0, std::min(timeout, remaining));
+      }
     }
 
-    int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
-    if (res < 0)
+    if (!WaitForEvents(events, timeout))
     {
       CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
       Sleep(1000);
       Initialize();
+      continue;
     }
-    else if (res > 0)
+
+    for (const auto &event : events)
     {
-      for (int i = m_connections.size() - 1; i >= 0; i--)
+      if (std::find(m_servers.begin(), m_servers.end(), event.socket) != m_servers.end())
       {
-        int socket = m_connections[i]->m_socket;
-        if (FD_ISSET(socket, &rfds))
-        {
-          char buffer[RECEIVEBUFFER] = {};
-          int  nread = 0;
-          nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
-          bool close = false;
-          if (nread > 0)
-          {
-            std::string response;
-            if (m_connections[i]->IsNew())
-            {
-              CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
-
-              if (!response.empty())
-                m_connections[i]->Send(response.c_str(), response.size());
-
-              if (websocket != NULL)
-              {
-                // Replace the CTCPClient with a CWebSocketClient
-                CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[i]));
-                delete m_connections[i];
-                m_connections.erase(m_connections.begin() + i);
-                m_connections.insert(m_connections.begin() + i, websocketClient);
-              }
-            }
-
-            if (response.size() <= 0)
-              m_connections[i]->PushBuffer(this, buffer, nread);
-
-            close = m_connections[i]->Closing();
-          }
-          else
-            close = true;
+        // the backlog is short, take all connections waiting in it
+        if (event.readable)
+          while (AcceptConnection(event.socket));
+        continue;
+      }
 
-          if (close)
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
-            m_connections[i]->Disconnect();
-            delete m_connections[i];
-            m_connections.erase(m_connections.begin() + i);
-          }
-        }
+      int index = FindConnection(event.socket);
+      if (index < 0)
+        continue;
+
+      if (event.writable && !m_connections[index]->Flush())
+      {
+        CloseConnection(index);
+        continue;
       }
+      if (event.readable)
+        ReadFromClient(index);
+    }
+
+    // clients that didn't read their responses for too long
+    for (int i = m_connections.size() - 1; i >= 0; i--)
+    {
+      if (m_connections[i]->HasSendError())
+        CloseConnection(i);
+    }
+
+    FlushPendingNotifications(false);
+  }
+
+  Deinitialize();
+  DeinitializePoller();
+}
+
+bool CTCPServer::InitializePoller()
+{
+#ifdef TCPSERVER_EPOLL
+  m_pollfd = epoll_create1(EPOLL_CLOEXEC);
+  if (m_pollfd < 0)
+    return false;
+
+  m_wakeupfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_wakeupfd < 0)
+  {
+    close(m_pollfd);
+    m_pollfd = -1;
+    return false;
+  }
+
+  struct epoll_event ev = {};
+  ev.events = EPOLLIN;
+  ev.data.fd = m_wakeupfd;
+  epoll_ctl(m_pollfd, EPOLL_CTL_ADD, m_wakeupfd, &ev);
+  return true;
+#else
+  return true;
+#endif
+}
 
-      for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); ++it)
+void CTCPServer::DeinitializePoller()
+{
+#ifdef TCPSERVER_EPOLL
+  if (m_wakeupfd >= 0)
+    close(m_wakeupfd);
+  if (m_pollfd >= 0)
+    close(m_pollfd);
+#endif
+  m_wakeupfd = -1;
+  m_pollfd = -1;
+  m_watches.clear();
+}
+
+void CTCPServer::UpdateWatches()
+{
+  std::map<SOCKET, uint32_t> watches;
+  for (auto server : m_servers)
+    watches[server] = 0;
+  for (auto client : m_connections)
+  {
+    watches[client->m_socket] = client->WantsWrite() ? 1 : 0;
+  }
+
+#ifdef TCPSERVER_EPOLL
+  if (m_pollfd >= 0)
+  {
+    for (const auto &watch : m_watches)
+    {
+      if (watches.find(watch.first) == watches.end())
+        epoll_ctl(m_pollfd, EPOLL_CTL_DEL, watch.first, NULL);
+    }
+
+    for (const auto &watch : watches)
+    {
+      auto current = m_watches.find(watch.first);
+      if (current != m_watches.end() && current->second == watch.second)
+        continue;
+
+      struct epoll_event ev = {};
+      ev.events = EPOLLIN | (watch.second ? EPOLLOUT : 0);
+      ev.data.fd = watch.first;
+      if (current == m_watches.end())
       {
-        if (FD_ISSET(*it, &rfds))
-        {
-          CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
-          CTCPClient *newconnection = new CTCPClient();
-          newconnection->m_socket = accept(*it, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
+        if (epoll_ctl(m_pollfd, EPOLL_CTL_ADD, watch.first, &ev) < 0 && errno == EEXIST)
+          epoll_ctl(m_pollfd, EPOLL_CTL_MOD, watch.first, &ev);
+      }
+      else
+        epoll_ctl(m_pollfd, EPOLL_CTL_MOD, watch.first, &ev);
+    }
+  }
+#endif
 
-          if (newconnection->m_socket == INVALID_SOCKET)
-          {
-            CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
-            if (EBADF == errno)
-            {
-              Sleep(1000);
-              Initialize();
-              break;
-            }
-          }
-          else
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
-            m_connections.push_back(newconnection);
-          }
-        }
+  m_watches.swap(watches);
+}
+
+bool CTCPServer::WaitForEvents(std::vector<CSocketEvent> &events, int timeout)
+{
+  events.clear();
+
+#ifdef TCPSERVER_EPOLL
+  if (m_pollfd >= 0)
+  {
+    struct epoll_event ready[64];
+    int res = epoll_wait(m_pollfd, ready, 64, timeout);
+    if (res < 0)
+      return errno == EINTR;
+
+    for (int i = 0; i < res; i++)
+    {
+      if (ready[i].data.fd == m_wakeupfd)
+      {
+        uint64_t value;
+        while (read(m_wakeupfd, &value, sizeof(value)) > 0);
+        continue;
       }
+
+      CSocketEvent event;
+      event.socket = ready[i].data.fd;
+      // errors and hangups are reported by the following recv()
+      event.readable = (ready[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0;
+      event.writable = (ready[i].events & EPOLLOUT) != 0;
+      events.push_back(event);
     }
+    return true;
   }
+#endif
 
-  Deinitialize();
+  // without a wakeup fd queued data is picked up on the next round
+  for (const auto &watch : m_watches)
+  {
+    if (watch.second)
+    {
+      timeout = std::min(timeout, 50);
+      break;
+    }
+  }
+
+  SOCKET max_fd = 0;
+  fd_set rfds, wfds;
+  struct timeval to = {timeout / 1000, (timeout % 1000) * 1000};
+  FD_ZERO(&rfds);
+  FD_ZERO(&wfds);
+
+  for (const auto &watch : m_watches)
+  {
+    FD_SET(watch.first, &rfds);
+    if (watch.second)
+      FD_SET(watch.first, &wfds);
+    if ((intptr_t)watch.first > (intptr_t)max_fd)
+      max_fd = watch.first;
+  }
+
+  int res = select((intptr_t)max_fd+1, &rfds, &wfds, NULL, &to);
+  if (res < 0)
+    return false;
+
+  for (const auto &watch : m_watches)
+  {
+    CSocketEvent event;
+    event.socket = watch.first;
+    event.readable = FD_ISSET(watch.first, &rfds) != 0;
+    event.writable = FD_ISSET(watch.first, &wfds) != 0;
+    if (event.readable || event.writable)
+      events.push_back(event);
+  }
+  return true;
+}
+
+void CTCPServer::Wakeup()
+{
+#ifdef TCPSERVER_EPOLL
+  if (m_wakeupfd >= 0)
+  {
+    uint64_t value = 1;
+    if (write(m_wakeupfd, &value, sizeof(value)) < 0)
+      CLog::Log(LOGDEBUG, "JSONRPC Server: Failed to wake up the server thread");
+  }
+#endif
+}
+
+bool CTCPServer::AcceptConnection(SOCKET server)
+{
+  CTCPClient *newconnection = new CTCPClient();
+  newconnection->m_socket = accept(server, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
+
+  if (newconnection->m_socket == INVALID_SOCKET)
+  {
+    delete newconnection;
+    // no more connections waiting
+    if (WouldBlock())
+      return false;
+
+    CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
+    if (EBADF == errno)
+    {
+      Sleep(1000);
+      Initialize();
+    }
+    return false;
+  }
+
+  CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
+  SetNonBlocking(newconnection->m_socket);
+
+  CSingleLock lock(m_connectionsSection);
+  m_connections.push_back(newconnection);
+  return true;
+}
+
+void CTCPServer::ReadFromClient(size_t index)
+{
+  char buffer[RECEIVEBUFFER] = {};
+  int  nread = 0;
+  nread = recv(m_connections[index]->m_socket, (char*)&buffer, RECEIVEBUFFER, 0);
+  if (nread < 0 && WouldBlock())
+    return;
+
+  bool close = false;
+  if (nread > 0)
+  {
+    std::string response;
+    if (m_connections[index]->IsNew())
+    {
+      CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
+
+      if (!response.empty())
+        m_connections[index]->Send(response.c_str(), response.size());
+
+      if (websocket != NULL)
+      {
+        // Replace the CTCPClient with a CWebSocketClient
+        CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[index]));
+        CSingleLock lock(m_connectionsSection);
+        delete m_connections[index];
+        m_connections[index] = websocketClient;
+      }
+    }
+
+    if (response.size() <= 0)
+      m_connections[index]->PushBuffer(this, buffer, nread);
+
+    close = m_connections[index]->Closing();
+  }
+  else
+    close = true;
+
+  if (close)
+  {
+    CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
+    CloseConnection(index);
+  }
+}
+
+void CTCPServer::CloseConnection(size_t index)
+{
+  // closing the socket removes it from the epoll set, its number may be reused right away
+  m_watches.erase(m_connections[index]->m_socket);
+
+  CSingleLock lock(m_connectionsSection);
+  m_connections[index]->Disconnect();
+  delete m_connections[index];
+  m_connections.erase(m_connections.begin() + index);
+}
+
+int CTCPServer::FindConnection(SOCKET socket) const
+{
+  for (size_t i = 0; i < m_connections.size(); i++)
+  {
+    if (m_connections[i]->m_socket == socket)
+      return (int)i;
+  }
+  return -1;
 }
 
 bool CTCPServer::PrepareDownload(const char *path, CVariant &details, std::string &protocol)
@@ -248,18 +515,118 @@ int CTCPServer::GetCapabilities()
 
 void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
-  std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact);
+  // serialized once and shared by the send queues of all clients
+  CNotification notification;
+  notification.flag = flag;
+  notification.json = std::make_shared<const std::string>(IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact));
 
-  for (unsigned int i = 0; i < m_connections.size(); i++)
+  if (g_advancedSettings.m_jsonNotificationDelay == 0)
   {
+    DispatchNotifications(std::vector<CNotification>(1, notification));
+    return;
+  }
+
+  CSingleLock lock(m_notificationSection);
+  if (m_pendingNotifications.empty())
+    m_notificationDeadline = XbmcThreads::SystemClockMillis() + g_advancedSettings.m_jsonNotificationDelay;
+
+  // e.g. a library scan announces the same update over and over again
+  if (!m_pendingIndex.insert(notification).second)
+  {
+    m_coalescedNotifications++;
+    return;
+  }
+
+  m_pendingNotifications.push_back(notification);
+  lock.Leave();
+  Wakeup();
+}
+
+void CTCPServer::FlushPendingNotifications(bool force)
+{
+  std::vector<CNotification> notifications;
+  {
+    CSingleLock lock(m_notificationSection);
+    if (m_pendingNotifications.empty() ||
+        (!force && (int)(m_notificationDeadline - XbmcThreads::SystemClockMillis()) > 0))
+      return;
+
+    notifications.swap(m_pendingNotifications);
+    m_pendingIndex.clear();
+    if (m_coalescedNotifications > 0)
     {
-      CSingleLock lock (m_connections[i]->m_critSection);
-      if ((m_connections[i]->GetAnnouncementFlags() & flag) == 0)
-        continue;
+      CLog::Log(LOGDEBUG, "JSONRPC Server: sending %u notifications, %u duplicates were dropped",
+                (unsigned int)notifications.size(), m_coalescedNotifications);
+      m_coalescedNotifications = 0;
     }
+  }
+
+  DispatchNotifications(notifications);
+}
 
-    m_connections[i]->Send(str.c_str(), str.size());
+void CTCPServer::DispatchNotifications(const std::vector<CNotification> &notifications)
+{
+  // clients with the same announcement flags share one buffer
+  std::map<int, std::shared_ptr<const std::string>> batches;
+  bool queued = false;
+
+  CSingleLock lock(m_connectionsSection);
+  for (auto client : m_connections)
+  {
+    int flags;
+    {
+      CSingleLock clientLock(client->m_critSection);
+      flags = client->GetAnnouncementFlags();
+    }
+
+    // websocket clients expect one notification per message
+    if (!client->CanBatch())
+    {
+      for (const auto &notification : notifications)
+      {
+        if ((flags & notification.flag) != 0)
+          client->SendNotification(notification.json);
+      }
+      queued |= client->WantsWrite();
+      continue;
+    }
+
+    auto batch = batches.find(flags);
+    if (batch == batches.end())
+    {
+      std::shared_ptr<const std::string> data;
+      std::string concatenated;
+      for (const auto &notification : notifications)
+      {
+        if ((flags & notification.flag) == 0)
+          continue;
+        if (!data && concatenated.empty())
+          data = notification.json;
+        else
+        {
+          if (data)
+          {
+            concatenated = *data;
+            data.reset();
+          }
+          concatenated += *notification.json;
+        }
+      }
+      if (!concatenated.empty())
+        data = std::make_shared<const std::string>(std::move(concatenated));
+      batch = batches.insert(std::make_pair(flags, data)).first;
+    }
+
+    if (batch->second)
+      client->SendNotification(batch->second);
+    queued |= client->WantsWrite();
   }
+  lock.Leave();
+
+  // let the server thread pick up whatever couldn't be sent right away, most
+  // of the time every client took all of it and waking it up would be wasted
+  if (queued)
+    Wakeup();
 }
 
 bool CTCPServer::Initialize()
@@ -273,6 +640,10 @@ bool CTCPServer::Initialize()
 
   if (started)
   {
+    // all waiting connections are accepted at once, until accept() would block
+    for (auto server : m_servers)
+      SetNonBlocking(server);
+
     CAnnouncementManager::GetInstance().AddAnnouncer(this);
     CLog::Log(LOGINFO, "JSONRPC Server: Successfully initialized");
     return true;
@@ -478,7 +849,7 @@ bool CTCPServer::InitializeTCP()
 
   Deinitialize();
 
-  if ((fd = CreateTCPServerSocket(m_port, !m_nonlocal, 10, "JSONRPC")) == INVALID_SOCKET)
+  if ((fd = CreateTCPServerSocket(m_port, !m_nonlocal, LISTEN_BACKLOG, "JSONRPC")) == INVALID_SOCKET)
     return false;
 
   m_servers.push_back(fd);
@@ -487,6 +858,7 @@ bool CTCPServer::InitializeTCP()
 
 void CTCPServer::Deinitialize()
 {
+  CSingleLock lock(m_connectionsSection);
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
     m_connections[i]->Disconnect();
@@ -494,11 +866,14 @@ void CTCPServer::Deinitialize()
   }
 
   m_connections.clear();
+  lock.Leave();
 
   for (unsigned int i = 0; i < m_servers.size(); i++)
     closesocket(m_servers[i]);
 
   m_servers.clear();
+  // closed sockets have left the epoll set
+  m_watches.clear();
 
 #ifdef HAVE_LIBBLUETOOTH
   if (m_sdpd)
@@ -511,6 +886,10 @@ void CTCPServer::Deinitialize()
 
 CTCPServer::CTCPClient::CTCPClient()
 {
+  m_sendOffset = 0;
+  m_queuedBytes = 0;
+  m_droppedNotifications = 0;
+  m_sendError = false;
   m_new = true;
   m_announcementflags = ANNOUNCE_ALL;
   m_socket = INVALID_SOCKET;
@@ -551,12 +930,82 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
 
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
-  unsigned int sent = 0;
-  do
+  QueueData(std::make_shared<const std::string>(data, size), false);
+}
+
+void CTCPServer::CTCPClient::SendNotification(const std::shared_ptr<const std::string> &data)
+{
+  QueueData(data, true);
+}
+
+void CTCPServer::CTCPClient::QueueData(const std::shared_ptr<const std::string> &data, bool notification)
+{
+  CSingleLock lock (m_critSection);
+  if (m_sendError || m_socket == INVALID_SOCKET || data->empty())
+    return;
+
+  if (notification && m_queuedBytes > MAX_NOTIFICATION_BACKLOG)
   {
-    CSingleLock lock (m_critSection);
-    sent += send(m_socket, data + sent, size - sent, 0);
-  } while (sent < size);
+    if (m_droppedNotifications++ == 0)
+      CLog::Log(LOGWARNING, "JSONRPC Server: client doesn't keep up, dropping notifications");
+    return;
+  }
+
+  if (m_queuedBytes + data->size() > MAX_SEND_BACKLOG)
+  {
+    CLog::Log(LOGWARNING, "JSONRPC Server: client doesn't read its responses, disconnecting");
+    m_sendError = true;
+    return;
+  }
+
+  m_sendQueue.push_back(data);
+  m_queuedBytes += data->size();
+  if (m_sendQueue.size() == 1)
+    Flush();
+}
+
+bool CTCPServer::CTCPClient::Flush()
+{
+  CSingleLock lock (m_critSection);
+  while (!m_sendQueue.empty() && !m_sendError)
+  {
+    const std::string &data = *m_sendQueue.front();
+    int sent = send(m_socket, data.c_str() + m_sendOffset, data.size() - m_sendOffset, SEND_FLAGS);
+    if (sent < 0)
+    {
+      if (!WouldBlock())
+        m_sendError = true;
+      break;
+    }
+
+    m_sendOffset += sent;
+    if (m_sendOffset < data.size())
+      break;
+
+    m_queuedBytes -= data.size();
+    m_sendOffset = 0;
+    m_sendQueue.pop_front();
+  }
+
+  if (m_sendQueue.empty() && m_droppedNotifications > 0)
+  {
+    CLog::Log(LOGINFO, "JSONRPC Server: client caught up, %u notifications were dropped", m_droppedNotifications);
+    m_droppedNotifications = 0;
+  }
+
+  return !m_sendError;
+}
+
+bool CTCPServer::CTCPClient::WantsWrite()
+{
+  CSingleLock lock (m_critSection);
+  return !m_sendQueue.empty();
+}
+
+bool CTCPServer::CTCPClient::HasSendError()
+{
+  CSingleLock lock (m_critSection);
+  return m_sendError;
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -601,6 +1050,8 @@ void CTCPServer::CTCPClient::Disconnect()
   if (m_socket > 0)
   {
     CSingleLock lock (m_critSection);
+    // last chance for queued data (e.g. a websocket close frame)
+    Flush();
     shutdown(m_socket, SHUT_RDWR);
     closesocket(m_socket);
     m_socket = INVALID_SOCKET;
@@ -619,6 +1070,11 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_beginChar         = client.m_beginChar;
   m_endChar           = client.m_endChar;
   m_buffer            = client.m_buffer;
+  m_sendQueue         = client.m_sendQueue;
+  m_sendOffset        = client.m_sendOffset;
+  m_queuedBytes       = client.m_queuedBytes;
+  m_droppedNotifications = client.m_droppedNotifications;
+  m_sendError         = client.m_sendError;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
@@ -654,13 +1110,27 @@ CTCPServer::CWebSocketClient& CTCPServer::CWebSocketClient::operator=(const CWeb
 
 void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
 {
+  SendFrames(data, size, false);
+}
+
+void CTCPServer::CWebSocketClient::SendNotification(const std::shared_ptr<const std::string> &data)
+{
+  SendFrames(data->c_str(), (unsigned int)data->size(), true);
+}
+
+void CTCPServer::CWebSocketClient::SendFrames(const char *data, unsigned int size, bool notification)
+{
+  CSingleLock lock (m_critSection);
   const CWebSocketMessage *msg = m_websocket->Send(WebSocketTextFrame, data, size);
   if (msg == NULL || !msg->IsComplete())
     return;
 
+  // queued as a whole so that a notification is never dropped halfway
+  std::string frameData;
   std::vector<const CWebSocketFrame *> frames = msg->GetFrames();
   for (unsigned int index = 0; index < frames.size(); index++)
-    CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
+    frameData.append(frames.at(index)->GetFrameData(), (size_t)frames.at(index)->GetFrameLength());
+  QueueData(std::make_shared<const std::string>(std::move(frameData)), notification);
 }
 
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
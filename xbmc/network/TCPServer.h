@@ -19,6 +19,11 @@
  *
  */
 
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
 #include <vector>
 #include <sys/socket.h>
 
@@ -55,6 +60,38 @@ namespace JSONRPC
     bool InitializeTCP();
     void Deinitialize();
 
+    struct CNotification
+    {
+      ANNOUNCEMENT::AnnouncementFlag flag;
+      std::shared_ptr<const std::string> json;
+
+      bool operator<(const CNotification &other) const
+      {
+        return flag < other.flag || (flag == other.flag && *json < *other.json);
+      }
+    };
+
+    struct CSocketEvent
+    {
+      SOCKET socket;
+      bool readable;
+      bool writable;
+    };
+
+    bool InitializePoller();
+    void DeinitializePoller();
+    void UpdateWatches();
+    bool WaitForEvents(std::vector<CSocketEvent> &events, int timeout);
+    void Wakeup();
+
+    bool AcceptConnection(SOCKET server);
+    void ReadFromClient(size_t index);
+    void CloseConnection(size_t index);
+    int FindConnection(SOCKET socket) const;
+
+    void DispatchNotifications(const std::vector<CNotification> &notifications);
+    void FlushPendingNotifications(bool force);
+
     class CTCPClient : public IClient
     {
     public:
@@ -70,11 +107,21 @@ namespace JSONRPC
       bool SetAnnouncementFlags(int flags) override;
 
       virtual void Send(const char *data, unsigned int size);
+      virtual void SendNotification(const std::shared_ptr<const std::string> &data);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
       virtual bool IsNew() const { return m_new; }
       virtual bool Closing() const { return false; }
+      virtual bool CanBatch() const { return true; }
+
+      /*!
+       \brief Write as much of the send queue as the socket takes without blocking.
+       \return false if the connection broke
+       */
+      bool Flush();
+      bool WantsWrite();
+      bool HasSendError();
 
       SOCKET m_socket;
       sockaddr_storage m_cliaddr;
@@ -83,7 +130,18 @@ namespace JSONRPC
 
     protected:
       void Copy(const CTCPClient& client);
+      /*!
+       \brief Queue data for the client and try to send it right away.
+       Notifications are dropped while the client doesn't keep up reading.
+       */
+      void QueueData(const std::shared_ptr<const std::string> &data, bool notification);
     private:
+      std::deque<std::shared_ptr<const std::string>> m_sendQueue;
+      size_t m_sendOffset;
+      size_t m_queuedBytes;
+      unsigned int m_droppedNotifications;
+      bool m_sendError;
+
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
@@ -101,22 +159,37 @@ namespace JSONRPC
       ~CWebSocketClient() override;
 
       void Send(const char *data, unsigned int size) override;
+      void SendNotification(const std::shared_ptr<const std::string> &data) override;
       void PushBuffer(CTCPServer *host, const char *buffer, int length) override;
       void Disconnect() override;
 
       bool IsNew() const override { return m_websocket == NULL; }
+      bool CanBatch() const override { return false; }
       bool Closing() const override { return m_websocket != NULL && m_websocket->GetState() == WebSocketStateClosed; }
 
     private:
+      void SendFrames(const char *data, unsigned int size, bool notification);
+
       CWebSocket *m_websocket;
     };
 
     std::vector<CTCPClient*> m_connections;
+    CCriticalSection m_connectionsSection; //!< held by the server thread while changing m_connections
     std::vector<SOCKET> m_servers;
     int m_port;
     bool m_nonlocal;
     void* m_sdpd;
 
+    int m_pollfd;
+    int m_wakeupfd;
+    std::map<SOCKET, uint32_t> m_watches;
+
+    CCriticalSection m_notificationSection;
+    std::vector<CNotification> m_pendingNotifications;
+    std::set<CNotification> m_pendingIndex; //!< to drop duplicates of pending notifications
+    unsigned int m_notificationDeadline;
+    unsigned int m_coalescedNotifications;
+
     static CTCPServer *ServerInstance;
   };
 }
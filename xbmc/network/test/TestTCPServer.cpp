@@ -0,0 +1,237 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include "interfaces/AnnouncementManager.h"
+#include "interfaces/json-rpc/JSONRPC.h"
+#include "network/TCPServer.h"
+#include "threads/SystemClock.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#define NOTIFICATION_METHOD "Other.TestTCPServerLoad"
+
+class TestTCPServer : public testing::Test
+{
+protected:
+  TestTCPServer()
+  {
+    std::random_device rd;
+    std::mt19937 mt(rd());
+    std::uniform_int_distribution<uint16_t> dist(49152, 65535);
+    port = dist(mt);
+  }
+
+  void SetUp() override
+  {
+    JSONRPC::CJSONRPC::Initialize();
+    if (!ANNOUNCEMENT::CAnnouncementManager::GetInstance().IsRunning())
+      ANNOUNCEMENT::CAnnouncementManager::GetInstance().Start();
+    ASSERT_TRUE(JSONRPC::CTCPServer::StartServer(port, false));
+  }
+
+  void TearDown() override
+  {
+    for (auto& client : clients)
+      close(client.socket);
+    clients.clear();
+
+    JSONRPC::CTCPServer::StopServer(true);
+    JSONRPC::CJSONRPC::Cleanup();
+  }
+
+  struct Client
+  {
+    int socket;
+    std::string received;
+    size_t scanned;
+    unsigned int notifications;
+  };
+
+  bool Connect(unsigned int count)
+  {
+    for (unsigned int i = 0; i < count; i++)
+    {
+      // the server listens on ::1 only if the system supports IPv6
+      Client client = { ConnectIPv6(), "", 0, 0 };
+      if (client.socket < 0)
+        client.socket = ConnectIPv4();
+      if (client.socket < 0)
+        return false;
+      clients.push_back(client);
+    }
+
+    // once a client got its pong the server will send it notifications
+    const std::string ping = "{\"jsonrpc\":\"2.0\",\"method\":\"JSONRPC.Ping\",\"id\":1}";
+    for (auto& client : clients)
+    {
+      if (send(client.socket, ping.c_str(), ping.size(), 0) != (ssize_t)ping.size())
+        return false;
+    }
+    return Receive([](const Client& client) { return client.received.find("pong") != std::string::npos; }, 10000);
+  }
+
+  int ConnectIPv6()
+  {
+    int fd = socket(AF_INET6, SOCK_STREAM, 0);
+    if (fd < 0)
+      return -1;
+
+    sockaddr_in6 addr = {};
+    addr.sin6_family = AF_INET6;
+    addr.sin6_port = htons(port);
+    addr.sin6_addr = in6addr_loopback;
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0)
+    {
+      close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  int ConnectIPv4()
+  {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+      return -1;
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0)
+    {
+      close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  template<typename Done>
+  bool Receive(Done done, unsigned int timeout)
+  {
+    const std::string method = NOTIFICATION_METHOD;
+    const unsigned int start = XbmcThreads::SystemClockMillis();
+    while (XbmcThreads::SystemClockMillis() - start < timeout)
+    {
+      fd_set rfds;
+      FD_ZERO(&rfds);
+      int maxfd = 0;
+      bool finished = true;
+      for (auto& client : clients)
+      {
+        if (client.socket < 0 || done(client))
+          continue;
+        finished = false;
+        FD_SET(client.socket, &rfds);
+        maxfd = std::max(maxfd, client.socket);
+      }
+      if (finished)
+        return true;
+
+      struct timeval to = { 0, 100000 };
+      if (select(maxfd + 1, &rfds, NULL, NULL, &to) < 0)
+        return false;
+
+      for (auto& client : clients)
+      {
+        if (client.socket < 0 || !FD_ISSET(client.socket, &rfds))
+          continue;
+
+        char buffer[65536];
+        ssize_t nread = recv(client.socket, buffer, sizeof(buffer), 0);
+        if (nread <= 0)
+          return false;
+        client.received.append(buffer, nread);
+
+        size_t pos;
+        while ((pos = client.received.find(method, client.scanned)) != std::string::npos)
+        {
+          client.notifications++;
+          client.scanned = pos + method.size();
+        }
+        // keep memory low, only the tail may hold a partial method name
+        if (client.received.size() > 4 * method.size())
+        {
+          const size_t keep = std::max(client.received.size() - client.scanned, method.size());
+          client.received.erase(0, client.received.size() - keep);
+          client.scanned = 0;
+        }
+      }
+    }
+    return false;
+  }
+
+  void Announce(unsigned int count, size_t payload)
+  {
+    const std::string padding(payload, 'x');
+    for (unsigned int i = 0; i < count; i++)
+    {
+      CVariant data;
+      data["index"] = i;
+      data["padding"] = padding;
+      ANNOUNCEMENT::CAnnouncementManager::GetInstance().Announce(ANNOUNCEMENT::Other, "xbmc", "TestTCPServerLoad", data);
+    }
+  }
+
+  uint16_t port;
+  std::vector<Client> clients;
+};
+
+// many remote controls connected while a library scan floods them with notifications
+TEST_F(TestTCPServer, NotificationLoad)
+{
+  static const unsigned int NUM_CLIENTS = 64;
+  static const unsigned int NUM_NOTIFICATIONS = 2000;
+
+  ASSERT_TRUE(Connect(NUM_CLIENTS));
+
+  Announce(NUM_NOTIFICATIONS, 64);
+  EXPECT_TRUE(Receive([](const Client& client) { return client.notifications >= NUM_NOTIFICATIONS; }, 60000));
+
+  for (const auto& client : clients)
+    EXPECT_EQ(NUM_NOTIFICATIONS, client.notifications);
+}
+
+// a client that stops reading must not hold up the others
+TEST_F(TestTCPServer, StalledClient)
+{
+  static const unsigned int NUM_NOTIFICATIONS = 4000;
+
+  ASSERT_TRUE(Connect(2));
+  Client stalled = clients.back();
+  clients.pop_back();
+
+  Announce(NUM_NOTIFICATIONS, 1024);
+  EXPECT_TRUE(Receive([](const Client& client) { return client.notifications >= NUM_NOTIFICATIONS; }, 60000));
+  EXPECT_EQ(NUM_NOTIFICATIONS, clients.front().notifications);
+
+  close(stalled.socket);
+}
@@ -433,6 +433,10 @@ CUPnPServer::Announce(AnnouncementFlag flag, const char *sender, const char *mes
         && strcmp(message, "OnScanStarted") && strcmp(message, "OnScanFinished"))
         return;
 
+    // pages read ahead may no longer match the library
+    if (flag == VideoLibrary || flag == AudioLibrary)
+        m_pager.Clear();
+
     if (data.isNull()) {
         if (!strcmp(message, "OnScanStarted") || !strcmp(message, "OnCleanStarted")) {
             m_scanning = true;
@@ -654,6 +658,35 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
         return NPT_FAILURE;
     }
 
+    // Don't pass parent_id if action is Search not BrowseDirectChildren, as
+    // we want the engine to determine the best parent id, not necessarily the one
+    // passed
+    NPT_String action_name = action->GetActionDesc().GetName();
+    const char* response_parent_id = (action_name.Compare("Search", true)==0)?NULL:parent_id.GetChars();
+
+    // this is the only way to hide unplayable items in the 'files'
+    // view as we cannot tell what context (eg music vs video) the
+    // request came from
+    std::string supported = CServiceBroker::GetFileExtensionProvider().GetPictureExtensions() + "|"
+                          + CServiceBroker::GetFileExtensionProvider().GetVideoExtensions() + "|"
+                          + CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|"
+                          + CServiceBroker::GetFileExtensionProvider().GetPictureExtensions();
+
+    // let the database sort library listings and only build the requested
+    // page, as long as the page holds the same items as the full listing
+    std::string db_path = CDatabaseDirectoryPager::GetDatabasePath((const char*)parent_id, supported);
+    if (!db_path.empty()) {
+        CFileItemList page;
+        page.SetPath(db_path);
+        SortDescription sorting;
+        GetDefaultSort(page, sorting);
+
+        NPT_UInt32 max_count = (requested_count == 0)?m_MaxReturnedItems:std::min((unsigned long)requested_count, (unsigned long)m_MaxReturnedItems);
+        int total;
+        if (m_pager.GetPage(db_path, sorting, starting_index, max_count, page, total))
+            return BuildResponse(action, page, filter, starting_index, requested_count, sort_criteria, context, response_parent_id, total);
+    }
+
     items.SetPath(std::string(parent_id));
 
     // guard against loading while saving to the same cache file
@@ -684,13 +717,6 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
 
             items.Sort(SortByLabel, SortOrderAscending);
         } else {
-            // this is the only way to hide unplayable items in the 'files'
-            // view as we cannot tell what context (eg music vs video) the
-            // request came from
-            std::string supported = CServiceBroker::GetFileExtensionProvider().GetPictureExtensions() + "|"
-                                  + CServiceBroker::GetFileExtensionProvider().GetVideoExtensions() + "|"
-                                  + CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|"
-                                  + CServiceBroker::GetFileExtensionProvider().GetPictureExtensions();
             CDirectory::GetDirectory((const char*)parent_id, items, supported, DIR_FLAG_DEFAULTS);
             DefaultSortItems(items);
         }
@@ -717,10 +743,6 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
       }
     }
 
-    // Don't pass parent_id if action is Search not BrowseDirectChildren, as
-    // we want the engine to determine the best parent id, not necessarily the one
-    // passed
-    NPT_String action_name = action->GetActionDesc().GetName();
     return BuildResponse(
         action,
         items,
@@ -729,7 +751,7 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
         requested_count,
         sort_criteria,
         context,
-        (action_name.Compare("Search", true)==0)?NULL:parent_id.GetChars());
+        response_parent_id);
 }
 
 /*----------------------------------------------------------------------
@@ -743,7 +765,8 @@ CUPnPServer::BuildResponse(PLT_ActionReference&          action,
                            NPT_UInt32                    requested_count,
                            const char*                   sort_criteria,
                            const PLT_HttpRequestContext& context,
-                           const char*                   parent_id /* = NULL */)
+                           const char*                   parent_id /* = NULL */,
+                           int                           total_matches /* = -1 */)
 {
     NPT_COMPILER_UNUSED(sort_criteria);
 
@@ -786,6 +809,13 @@ CUPnPServer::BuildResponse(PLT_ActionReference&          action,
 
     NPT_Cardinal count = 0;
     NPT_Cardinal total = items.Size();
+    // items of a paged listing only hold the requested page
+    if (total_matches >= 0) {
+        stop_index = std::min((unsigned long)max_count, (unsigned long)items.Size());
+        starting_index = 0;
+        total = total_matches;
+    }
+
     NPT_String didl = didl_header;
     PLT_MediaObjectReference object;
     for (unsigned long i=starting_index; i<stop_index; ++i) {
@@ -1310,13 +1340,21 @@ CUPnPServer::SortItems(CFileItemList& items, const char* sort_criteria)
 void
 CUPnPServer::DefaultSortItems(CFileItemList& items)
 {
-  CGUIViewState* viewState = CGUIViewState::GetViewState(items.IsVideoDb() ? WINDOW_VIDEO_NAV : -1, items);
-  if (viewState)
-  {
-    SortDescription sorting = viewState->GetSortMethod();
+  SortDescription sorting;
+  if (GetDefaultSort(items, sorting))
     items.Sort(sorting.sortBy, sorting.sortOrder, sorting.sortAttributes);
-    delete viewState;
-  }
+}
+
+bool
+CUPnPServer::GetDefaultSort(const CFileItemList& items, SortDescription& sorting)
+{
+  CGUIViewState* viewState = CGUIViewState::GetViewState(items.IsVideoDb() ? WINDOW_VIDEO_NAV : -1, items);
+  if (!viewState)
+    return false;
+
+  sorting = viewState->GetSortMethod();
+  delete viewState;
+  return true;
 }
 
 NPT_Result
@@ -22,6 +22,7 @@
 #include <Platinum/Source/Devices/MediaConnect/PltMediaConnect.h>
 
 #include "FileItem.h"
+#include "filesystem/DatabaseDirectoryPager.h"
 #include "interfaces/IAnnouncer.h"
 
 class CVariant;
@@ -121,11 +122,13 @@ private:
                              NPT_UInt32                    requested_count,
                              const char*                   sort_criteria,
                              const PLT_HttpRequestContext& context,
-                             const char*                   parent_id /* = NULL */);
+                             const char*                   parent_id /* = NULL */,
+                             int                           total_matches = -1);
 
     // class methods
     static bool SortItems(CFileItemList& items, const char* sort_criteria);
     static void DefaultSortItems(CFileItemList& items);
+    static bool GetDefaultSort(const CFileItemList& items, SortDescription& sorting);
     static NPT_String GetParentFolder(NPT_String file_path) {
         int index = file_path.ReverseFind("\\");
         if (index == -1) return "";
@@ -140,6 +143,7 @@ private:
 
     std::map<std::string, std::pair<bool, unsigned long> > m_UpdateIDs;
     bool m_scanning;
+    XFILE::CDatabaseDirectoryPager m_pager;
 public:
     // class members
     static NPT_UInt32 m_MaxReturnedItems;
@@ -95,7 +95,7 @@ void CPeripheralAddon::ResetProperties(void)
 
 bool CPeripheralAddon::CreateAddon(void)
 {
-  CExclusiveLock lock(m_dllSection);
+  CWriteLock lock(m_dllSection);
 
   // Reset all properties to defaults
   ResetProperties();
@@ -133,7 +133,7 @@ void CPeripheralAddon::DestroyAddon()
   }
 
   {
-    CExclusiveLock lock(m_dllSection);
+    CWriteLock lock(m_dllSection);
     DestroyInstance();
   }
 }
@@ -341,7 +341,7 @@ bool CPeripheralAddon::PerformDeviceScan(PeripheralScanResults &results)
   PERIPHERAL_INFO*  pScanResults;
   PERIPHERAL_ERROR  retVal;
 
-  CSharedLock lock(m_dllSection);
+  CReadLock lock(m_dllSection);
 
   if (!m_struct.toAddon.perform_device_scan)
     return false;
@@ -388,7 +388,7 @@ bool CPeripheralAddon::ProcessEvents(void)
   if (!m_bProvidesJoysticks)
     return false;
 
-  CSharedLock lock(m_dllSection);
+  CReadLock lock(m_dllSection);
 
   if (!m_struct.toAddon.get_events)
     return false;
@@ -462,7 +462,7 @@ bool CPeripheralAddon::SendRumbleEvent(unsigned int peripheralIndex, unsigned in
   if (!m_bProvidesJoysticks)
     return false;
 
-  CSharedLock lock(m_dllSection);
+  CReadLock lock(m_dllSection);
 
   if (!m_struct.toAddon.send_event)
     return false;
@@ -482,7 +482,7 @@ bool CPeripheralAddon::GetJoystickProperties(unsigned int index, CPeripheralJoys
   if (!m_bProvidesJoysticks)
     return false;
 
-  CSharedLock lock(m_dllSection);
+  CReadLock lock(m_dllSection);
 
   if (!m_struct.toAddon.get_joystick_info)
     return false;
@@ -512,7 +512,7 @@ bool CPeripheralAddon::GetFeatures(const CPeripheral* device,
   if (!m_bProvidesButtonMaps)
     return false;
 
-  CSharedLock lock(m_dllSection);
+  CReadLock lock(m_dllSection);
 
   if (!m_struct.toAddon.get_features)
     return false;
@@ -557,7 +557,7 @@ bool CPeripheralAddon::MapFeature(const CPeripheral* device,
   if (!m_bProvidesButtonMaps)
     return false;
 
-  CSharedLock lock(m_dllSection);
+  CReadLock lock(m_dllSection);
 
   if (!m_struct.toAddon.map_features)
     return false;
@@ -587,7 +587,7 @@ bool CPeripheralAddon::GetIgnoredPrimitives(const CPeripheral* device, Primitive
   if (!m_bProvidesButtonMaps)
     return false;
 
-  CSharedLock lock(m_dllSection);
+  CReadLock lock(m_dllSection);
 
   if (!m_struct.toAddon.get_ignored_primitives)
     return false;
@@ -627,7 +627,7 @@ bool CPeripheralAddon::SetIgnoredPrimitives(const CPeripheral* device, const Pri
   if (!m_bProvidesButtonMaps)
     return false;
 
-  CSharedLock lock(m_dllSection);
+  CReadLock lock(m_dllSection);
 
   if (!m_struct.toAddon.set_ignored_primitives)
     return false;
@@ -657,7 +657,7 @@ void CPeripheralAddon::SaveButtonMap(const CPeripheral* device)
   if (!m_bProvidesButtonMaps)
     return;
 
-  CSharedLock lock(m_dllSection);
+  CReadLock lock(m_dllSection);
 
   if (!m_struct.toAddon.save_button_map)
     return;
@@ -681,7 +681,7 @@ void CPeripheralAddon::RevertButtonMap(const CPeripheral* device)
   if (!m_bProvidesButtonMaps)
     return;
 
-  CSharedLock lock(m_dllSection);
+  CReadLock lock(m_dllSection);
 
   if (!m_struct.toAddon.revert_button_map)
     return;
@@ -724,7 +724,7 @@ void CPeripheralAddon::PowerOffJoystick(unsigned int index)
   if (!SupportsFeature(FEATURE_POWER_OFF))
     return;
 
-  CSharedLock lock(m_dllSection);
+  CReadLock lock(m_dllSection);
 
   if (!m_struct.toAddon.power_off_joystick)
     return;
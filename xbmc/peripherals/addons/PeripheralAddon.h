@@ -26,7 +26,7 @@
 #include "input/joysticks/JoystickTypes.h"
 #include "peripherals/PeripheralTypes.h"
 #include "threads/CriticalSection.h"
-#include "threads/SharedSection.h"
+#include "threads/ReadWriteSection.h"
 
 #include <map>
 #include <memory>
@@ -179,6 +179,6 @@ namespace PERIPHERALS
     
     AddonInstance_Peripheral m_struct;
 
-    CSharedSection      m_dllSection;
+    CReadWriteSection   m_dllSection{"CPeripheralAddon", CReadWriteSection::Preference::READERS};
   };
 }
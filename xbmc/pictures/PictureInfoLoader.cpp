@@ -26,22 +26,18 @@
 
 CPictureInfoLoader::CPictureInfoLoader()
 {
-  m_mapFileItems = new CFileItemList;
   m_tagReads = 0;
 }
 
 CPictureInfoLoader::~CPictureInfoLoader()
 {
   StopThread();
-  delete m_mapFileItems;
 }
 
 void CPictureInfoLoader::OnLoaderStart()
 {
-  // Load previously cached items from HD
-  m_mapFileItems->SetPath(m_pVecItems->GetPath());
-  m_mapFileItems->Load();
-  m_mapFileItems->SetFastLookup(true);
+  // Open previously cached items on HD, they are only deserialized when looked up
+  m_cachedItems.Open(*m_pVecItems);
 
   m_tagReads = 0;
   m_loadTags = CServiceBroker::GetSettings().GetBool(CSettings::SETTING_PICTURES_USETAGS);
@@ -67,7 +63,7 @@ bool CPictureInfoLoader::LoadItemCached(CFileItem* pItem)
     return true;
 
   // Check the cached item
-  CFileItemPtr mapItem = (*m_mapFileItems)[pItem->GetPath()];
+  CFileItemPtr mapItem = m_cachedItems.Get(pItem->GetPath());
   if (mapItem && mapItem->m_dateTime==pItem->m_dateTime && mapItem->HasPictureInfoTag())
   { // Query map if we previously cached the file on HD
     *pItem->GetPictureInfoTag() = *mapItem->GetPictureInfoTag();
@@ -101,7 +97,7 @@ bool CPictureInfoLoader::LoadItemLookup(CFileItem* pItem)
 void CPictureInfoLoader::OnLoaderFinish()
 {
   // cleanup cache loaded from HD
-  m_mapFileItems->Clear();
+  m_cachedItems.Close();
 
   // Save loaded items to HD
   if (!m_bStop && m_tagReads > 0)
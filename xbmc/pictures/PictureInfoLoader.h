@@ -20,6 +20,7 @@
  */
 
 #include "BackgroundInfoLoader.h"
+#include "FileItemListCache.h"
 #include <string>
 
 class CPictureInfoLoader : public CBackgroundInfoLoader
@@ -37,7 +38,7 @@ protected:
   void OnLoaderStart() override;
   void OnLoaderFinish() override;
 
-  CFileItemList* m_mapFileItems;
+  CFileItemListCache m_cachedItems;
   unsigned int m_tagReads;
   bool m_loadTags;
 };
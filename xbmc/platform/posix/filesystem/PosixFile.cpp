@@ -35,14 +35,25 @@
 #include <sys/ioctl.h>
 #include <errno.h>
 
+// a reader having read this much without seeking is sequential
+#define SEQUENTIAL_RUN     (256 * 1024)
+// a reader seeking this often without a sequential run in between is random
+#define RANDOM_SEEKS       3
+#define READ_AHEAD_MIN     (1024 * 1024)
+#define READ_AHEAD_MAX     (16 * 1024 * 1024)
+
 using namespace XFILE;
 
 CPosixFile::CPosixFile() :
-  m_fd(-1), m_filePos(-1), m_lastDropPos(-1), m_allowWrite(false)
+  m_fd(-1), m_filePos(-1), m_lastDropPos(-1), m_allowWrite(false),
+  m_pattern(ACCESS_UNKNOWN), m_runLength(0), m_seeks(0),
+  m_readAheadEnd(-1), m_readAheadWindow(READ_AHEAD_MIN)
 { }
 
 CPosixFile::~CPosixFile()
 {
+  if (m_readAhead)
+    CPosixReadAhead::GetInstance().Cancel(*m_readAhead);
   if (m_fd >= 0)
     close(m_fd);
 }
@@ -101,6 +112,10 @@ void CPosixFile::Close()
     m_filePos = -1;
     m_lastDropPos = -1;
     m_allowWrite = false;
+    m_pattern = ACCESS_UNKNOWN;
+    m_seeks = 0;
+    ResetReadAhead();
+    m_readAhead.reset();
   }
 }
 
@@ -142,6 +157,8 @@ ssize_t CPosixFile::Read(void* lpBuf, size_t uiBufSize)
         m_lastDropPos = end_drop;
     }
 #endif
+    if (!m_allowWrite)
+      OnRead(res);
   }
 
   return res;
@@ -176,7 +193,8 @@ int64_t CPosixFile::Seek(int64_t iFilePosition, int iWhence /* = SEEK_SET*/)
 {
   if (m_fd < 0)
     return -1;
-  
+
+  const int64_t oldPos = m_filePos;
 #ifdef TARGET_ANDROID
   //! @todo properly support with detection in configure
   //! Android special case: Android doesn't substitute off64_t for off_t and similar functions
@@ -189,7 +207,10 @@ int64_t CPosixFile::Seek(int64_t iFilePosition, int iWhence /* = SEEK_SET*/)
   
   m_filePos = lseek(m_fd, filePosOffT, iWhence);
 #endif // !TARGET_ANDROID
-  
+
+  if (!m_allowWrite && m_filePos >= 0 && m_filePos != oldPos)
+    OnSeek(oldPos, m_filePos);
+
   return m_filePos;
 }
 
@@ -278,10 +299,83 @@ int CPosixFile::IoControl(EIoControl request, void* param)
         return 0; // size of file is 1 byte or more and seeking not possible
     }
   }
-  
+  else if (request == IOCTRL_READ_AHEAD)
+    return !m_allowWrite && CPosixReadAhead::IsSupported() ? 1 : 0;
+
   return -1;
 }
 
+void CPosixFile::OnRead(ssize_t size)
+{
+  m_runLength += size;
+  if (m_runLength >= SEQUENTIAL_RUN && m_pattern != ACCESS_SEQUENTIAL)
+    SetAccessPattern(ACCESS_SEQUENTIAL);
+  if (m_runLength >= SEQUENTIAL_RUN)
+    m_seeks = 0;
+
+  if (m_pattern == ACCESS_SEQUENTIAL)
+    ReadAhead();
+}
+
+void CPosixFile::OnSeek(int64_t oldPos, int64_t newPos)
+{
+  // skipping forward within what is read ahead already, e.g. a demuxer
+  // skipping a packet of a stream it doesn't need
+  if (m_pattern == ACCESS_SEQUENTIAL && oldPos >= 0 && newPos > oldPos && newPos < m_readAheadEnd)
+    return;
+
+  ResetReadAhead();
+
+  if (++m_seeks >= RANDOM_SEEKS && m_pattern != ACCESS_RANDOM)
+    SetAccessPattern(ACCESS_RANDOM);
+}
+
+void CPosixFile::SetAccessPattern(AccessPattern pattern)
+{
+  // sequential doubles the read-ahead of the OS, random turns it off so
+  // reading indexes and tags doesn't drag in data that is never used
+#if defined(HAVE_POSIX_FADVISE)
+  int advice = POSIX_FADV_NORMAL;
+  if (pattern == ACCESS_SEQUENTIAL)
+    advice = POSIX_FADV_SEQUENTIAL;
+  else if (pattern == ACCESS_RANDOM)
+    advice = POSIX_FADV_RANDOM;
+  posix_fadvise(m_fd, 0, 0, advice);
+#elif defined(TARGET_DARWIN)
+  fcntl(m_fd, F_RDAHEAD, pattern == ACCESS_RANDOM ? 0 : 1);
+#endif
+  m_pattern = pattern;
+}
+
+void CPosixFile::ReadAhead()
+{
+  if (!CPosixReadAhead::IsSupported())
+    return;
+
+  // keep at least half a window queued in front of the reader, the window
+  // grows while the reader stays sequential
+  if (m_readAheadEnd - m_filePos > m_readAheadWindow / 2)
+    return;
+
+  if (!m_readAhead)
+    m_readAhead = std::make_shared<CPosixReadAhead::CStream>(m_fd);
+
+  const int64_t start = std::max(m_readAheadEnd, m_filePos);
+  const int64_t end = m_filePos + m_readAheadWindow;
+  CPosixReadAhead::GetInstance().Queue(m_readAhead, start, end - start);
+  m_readAheadEnd = end;
+  m_readAheadWindow = std::min<int64_t>(m_readAheadWindow * 2, READ_AHEAD_MAX);
+}
+
+void CPosixFile::ResetReadAhead()
+{
+  if (m_readAhead)
+    CPosixReadAhead::GetInstance().Cancel(*m_readAhead);
+  m_readAheadEnd = -1;
+  m_readAheadWindow = READ_AHEAD_MIN;
+  m_runLength = 0;
+}
+
 
 bool CPosixFile::Delete(const CURL& url)
 {
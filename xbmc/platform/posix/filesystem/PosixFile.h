@@ -20,6 +20,9 @@
  */
 
 #include "filesystem/IFile.h"
+#include "PosixReadAhead.h"
+
+#include <memory>
 
 namespace XFILE
 {
@@ -50,10 +53,30 @@ namespace XFILE
     int Stat(struct __stat64* buffer) override;
 
   protected:
+    enum AccessPattern
+    {
+      ACCESS_UNKNOWN,
+      ACCESS_SEQUENTIAL,
+      ACCESS_RANDOM
+    };
+
+    void OnRead(ssize_t size);
+    void OnSeek(int64_t oldPos, int64_t newPos);
+    void SetAccessPattern(AccessPattern pattern);
+    void ReadAhead();
+    void ResetReadAhead();
+
     int     m_fd;
     int64_t m_filePos;
     int64_t m_lastDropPos;
     bool    m_allowWrite;
+
+    AccessPattern m_pattern;
+    int64_t m_runLength;        //!< bytes read since the last seek
+    unsigned int m_seeks;       //!< seeks since the reader was last found to be sequential
+    int64_t m_readAheadEnd;     //!< end of the range queued for read-ahead, -1 if none
+    int64_t m_readAheadWindow;
+    std::shared_ptr<CPosixReadAhead::CStream> m_readAhead;
   };
   
 }
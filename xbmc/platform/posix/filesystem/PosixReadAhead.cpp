@@ -0,0 +1,175 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#if defined(TARGET_POSIX)
+
+#include "PosixReadAhead.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+
+using namespace XFILE;
+
+CPosixReadAhead::CStream::CStream(int fd)
+  : m_fd(fd >= 0 ? dup(fd) : -1)
+{
+}
+
+CPosixReadAhead::CStream::~CStream()
+{
+  if (m_fd >= 0)
+    close(m_fd);
+}
+
+CPosixReadAhead& CPosixReadAhead::GetInstance()
+{
+  // intentionally leaked: files owned by globals may still be read during
+  // static destruction
+  static CPosixReadAhead* readAhead = new CPosixReadAhead;
+  return *readAhead;
+}
+
+bool CPosixReadAhead::IsSupported()
+{
+#if defined(HAVE_POSIX_FADVISE) || defined(TARGET_DARWIN)
+  return true;
+#else
+  return false;
+#endif
+}
+
+CPosixReadAhead::CPosixReadAhead()
+  : CThread("PosixReadAhead")
+{
+}
+
+CPosixReadAhead::~CPosixReadAhead()
+{
+  {
+    CSingleLock lock(m_section);
+    m_bStop = true;
+    m_wakeup.notifyAll();
+  }
+  StopThread(true);
+}
+
+void CPosixReadAhead::Queue(const std::shared_ptr<CStream> &stream, int64_t offset, int64_t length)
+{
+  if (!stream || !stream->IsValid() || length <= 0 || !IsSupported())
+    return;
+
+  CSingleLock lock(m_section);
+  if (stream->m_queued)
+  {
+    // the reader got ahead of us, join the ranges if they touch, otherwise
+    // only the newer range is of interest
+    const int64_t end = stream->m_offset + stream->m_length;
+    if (stream->m_length > 0 && offset <= end && offset + length >= stream->m_offset)
+    {
+      const int64_t start = std::min(stream->m_offset, offset);
+      stream->m_length = std::max(end, offset + length) - start;
+      stream->m_offset = start;
+    }
+    else
+    {
+      stream->m_offset = offset;
+      stream->m_length = length;
+    }
+    m_stats.merged++;
+    return;
+  }
+
+  stream->m_offset = offset;
+  stream->m_length = length;
+  stream->m_queued = true;
+  m_queue.push_back(stream);
+
+  if (!IsRunning())
+    Create();
+  m_wakeup.notifyAll();
+}
+
+void CPosixReadAhead::Cancel(CStream &stream)
+{
+  CSingleLock lock(m_section);
+  // the entry stays in the queue and is skipped when its turn comes
+  stream.m_length = 0;
+}
+
+CPosixReadAhead::Statistics CPosixReadAhead::GetStatistics() const
+{
+  CSingleLock lock(m_section);
+  return m_stats;
+}
+
+void CPosixReadAhead::Process()
+{
+  CSingleLock lock(m_section);
+  while (!m_bStop)
+  {
+    if (m_queue.empty())
+    {
+      m_wakeup.wait(lock);
+      continue;
+    }
+
+    std::shared_ptr<CStream> stream = m_queue.front();
+    m_queue.pop_front();
+    stream->m_queued = false;
+
+    const int64_t offset = stream->m_offset;
+    const int64_t length = stream->m_length;
+    stream->m_length = 0;
+    if (length <= 0)
+      continue;
+
+    m_stats.requests++;
+    m_stats.bytes += length;
+
+    lock.Leave();
+    Advise(stream->m_fd, offset, length);
+    // the last reference to a closed file may be dropped here
+    stream.reset();
+    lock.Enter();
+  }
+}
+
+void CPosixReadAhead::Advise(int fd, int64_t offset, int64_t length)
+{
+#if defined(HAVE_POSIX_FADVISE)
+  posix_fadvise(fd, offset, length, POSIX_FADV_WILLNEED);
+#elif defined(TARGET_DARWIN)
+  while (length > 0)
+  {
+    struct radvisory advisory;
+    advisory.ra_offset = offset;
+    advisory.ra_count = static_cast<int>(std::min<int64_t>(length, INT_MAX));
+    if (fcntl(fd, F_RDADVISE, &advisory) < 0)
+      break;
+    offset += advisory.ra_count;
+    length -= advisory.ra_count;
+  }
+#endif
+}
+
+#endif // TARGET_POSIX
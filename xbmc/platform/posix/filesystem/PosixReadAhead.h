@@ -0,0 +1,108 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <memory>
+#include <stdint.h>
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+namespace XFILE
+{
+  /*!
+   \brief Reads ahead of sequential readers of local files on a shared thread.
+
+   The data is only brought into the page cache of the OS, the reader still
+   read()s it straight into its own buffer. Requests are issued from a
+   separate thread so a reader never blocks when the request queue of a slow
+   disk is full.
+   */
+  class CPosixReadAhead : private CThread
+  {
+  public:
+    /*!
+     \brief A file read ahead of, holds its own descriptor so the file may be
+     closed while a request is still queued.
+     */
+    class CStream
+    {
+    public:
+      explicit CStream(int fd);
+      ~CStream();
+      CStream(const CStream&) = delete;
+      CStream& operator=(const CStream&) = delete;
+
+      bool IsValid() const { return m_fd >= 0; }
+
+    private:
+      friend class CPosixReadAhead;
+
+      int m_fd;
+      int64_t m_offset = 0;
+      int64_t m_length = 0; //!< range still to be requested, 0 if none
+      bool m_queued = false;
+    };
+
+    struct Statistics
+    {
+      uint64_t requests = 0; //!< ranges handed to the OS
+      uint64_t merged = 0;   //!< requests joined with one of the same stream still waiting
+      uint64_t bytes = 0;
+    };
+
+    static CPosixReadAhead& GetInstance();
+
+    /*!
+     \return false if the platform has no way to read ahead asynchronously
+     */
+    static bool IsSupported();
+
+    /*!
+     \brief Queue reading [offset, offset + length) of the stream. A range of
+     the stream that is still waiting is extended instead of queuing another.
+     */
+    void Queue(const std::shared_ptr<CStream> &stream, int64_t offset, int64_t length);
+
+    /*!
+     \brief Drop the range of the stream that is still waiting, e.g. after its
+     reader seeked away.
+     */
+    void Cancel(CStream &stream);
+
+    Statistics GetStatistics() const;
+
+  protected:
+    void Process() override;
+
+  private:
+    CPosixReadAhead();
+    ~CPosixReadAhead() override;
+
+    static void Advise(int fd, int64_t offset, int64_t length);
+
+    mutable CCriticalSection m_section;
+    XbmcThreads::ConditionVariable m_wakeup;
+    std::deque<std::shared_ptr<CStream>> m_queue;
+    Statistics m_stats;
+  };
+}
@@ -952,10 +952,62 @@ std::string CSmartPlaylistRule::FormatWhereClause(const std::string &negate, con
     }
   }
   if (query.empty())
+  {
     query = CDatabaseQueryRule::FormatWhereClause(negate, oper, param, db, strType);
+
+    // the full text index narrows down the rows the LIKE is evaluated on
+    std::string fullText = FormatFullTextQuery(param, db, strType);
+    if (!fullText.empty())
+      query = fullText + " AND (" + query + ")";
+  }
   return query;
 }
 
+std::string CSmartPlaylistRule::FormatFullTextQuery(const std::string &param, const CDatabase &db,
+                                                    const std::string &strType) const
+{
+  // a negated LIKE can't be narrowed down by the rows it doesn't match
+  if (m_operator != OPERATOR_CONTAINS && m_operator != OPERATOR_STARTS_WITH)
+    return "";
+
+  // the full text index (if the user enabled it) of an indexed text field
+  std::string index;
+  std::string column;
+  if (strType == "songs" && m_field == FieldTitle)
+  {
+    index = "song_fts";
+    column = "title";
+  }
+  else if (strType == "albums" && m_field == FieldAlbum)
+  {
+    index = "album_fts";
+    column = "title";
+  }
+  else if (strType == "artists" && m_field == FieldArtist)
+  {
+    index = "artist_fts";
+    column = "name";
+  }
+  else if (strType == "movies" && (m_field == FieldTitle || m_field == FieldPlot))
+  {
+    index = "movie_fts";
+    column = m_field == FieldTitle ? "title" : "plot";
+  }
+  else if (strType == "tvshows" && (m_field == FieldTitle || m_field == FieldPlot))
+  {
+    index = "tvshow_fts";
+    column = m_field == FieldTitle ? "title" : "plot";
+  }
+  else
+    return "";
+
+  std::string subQuery = db.GetFullTextSubQuery(index, { column }, param, m_operator == OPERATOR_STARTS_WITH);
+  if (subQuery.empty())
+    return "";
+
+  return GetField(FieldId, strType) + " IN (" + subQuery + ")";
+}
+
 std::string CSmartPlaylistRule::GetField(int field, const std::string &type) const
 {
   if (field >= FieldUnknown && field < FieldMax)
@@ -77,6 +77,7 @@ protected:
 
 private:
   std::string GetVideoResolutionQuery(const std::string &parameter) const;
+  std::string FormatFullTextQuery(const std::string &param, const CDatabase &db, const std::string &strType) const;
   static std::string FormatLinkQuery(const char *field, const char *table, const MediaType& mediaType, const std::string& mediaField, const std::string& parameter);
 };
 
@@ -42,6 +42,7 @@
 #include "guilib/GUIWindowManager.h"
 #include "guilib/LocalizeStrings.h"
 #include "input/InputManager.h"
+#include "listproviders/DirectoryProviderCache.h"
 #include "settings/Settings.h"
 #include "settings/lib/SettingsManager.h"
 #if !defined(TARGET_WINDOWS) && defined(HAS_DVD_DRIVE)
@@ -313,6 +314,7 @@ bool CProfilesManager::LoadProfile(size_t index)
 
   CUtil::DeleteDirectoryCache();
   g_directoryCache.Clear();
+  CDirectoryProviderCache::GetInstance().Clear();
 
   return true;
 }
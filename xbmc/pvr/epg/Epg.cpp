@@ -261,9 +261,10 @@ CPVREpgInfoTagPtr CPVREpg::GetTagByBroadcastId(unsigned int iUniqueBroadcastId)
 CPVREpgInfoTagPtr CPVREpg::GetTagBetween(const CDateTime &beginTime, const CDateTime &endTime) const
 {
   CSingleLock lock(m_critSection);
-  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+  // tags are keyed by start time
+  for (std::map<CDateTime, CPVREpgInfoTagPtr>::const_iterator it = m_tags.lower_bound(beginTime); it != m_tags.end(); ++it)
   {
-    if (it->second->StartAsUTC() >= beginTime && it->second->EndAsUTC() <= endTime)
+    if (it->second->EndAsUTC() <= endTime)
       return it->second;
   }
 
@@ -275,15 +276,13 @@ std::vector<CPVREpgInfoTagPtr> CPVREpg::GetTagsBetween(const CDateTime &beginTim
   std::vector<CPVREpgInfoTagPtr> epgTags;
 
   CSingleLock lock(m_critSection);
-  for (const auto &infoTag : m_tags)
+  // tags are keyed by start time
+  for (auto it = m_tags.lower_bound(beginTime); it != m_tags.end(); ++it)
   {
-    if (infoTag.second->StartAsUTC() >= beginTime)
-    {
-      if (infoTag.second->EndAsUTC() <= endTime)
-        epgTags.emplace_back(infoTag.second);
-      else
-        break; // done.
-    }
+    if (it->second->EndAsUTC() <= endTime)
+      epgTags.emplace_back(it->second);
+    else
+      break; // done.
   }
 
   return epgTags;
@@ -40,6 +40,29 @@
 using namespace PVR;
 using namespace KODI::MESSAGING;
 
+namespace
+{
+  // Old Method of identifying TV show title and subtitle using m_strDirectory and strPlotOutline (deprecated)
+  bool GetDeprecatedTitles(const std::string &strDirectory, const std::string &strPlotOutline,
+                           std::string &strTitle, std::string &strShowTitle)
+  {
+    std::string strShow = StringUtils::Format("%s - ", g_localizeStrings.Get(20364).c_str());
+    if (!StringUtils::StartsWithNoCase(strPlotOutline, strShow))
+      return false;
+
+    std::string strEpisode = strPlotOutline;
+    strTitle = strDirectory;
+
+    size_t pos = strTitle.rfind('/');
+    strTitle.erase(0, pos + 1);
+    strEpisode.erase(0, strShow.size());
+    pos = strEpisode.find('-');
+    strEpisode.erase(0, pos + 2);
+    strShowTitle = strEpisode;
+    return true;
+  }
+}
+
 CPVRRecordingUid::CPVRRecordingUid(int iClientId, const std::string& strRecordingId) :
   m_iClientId(iClientId),
   m_strRecordingId(strRecordingId)
@@ -377,27 +400,66 @@ void CPVRRecording::Update(const CPVRRecording &tag)
   CVideoInfoTag::SetResumePoint(tag.GetLocalResumePoint());
   SetDuration(tag.GetDuration());
 
-  //Old Method of identifying TV show title and subtitle using m_strDirectory and strPlotOutline (deprecated)
-  std::string strShow = StringUtils::Format("%s - ", g_localizeStrings.Get(20364).c_str());
-  if (StringUtils::StartsWithNoCase(m_strPlotOutline, strShow))
-  {
+  if (GetDeprecatedTitles(m_strDirectory, m_strPlotOutline, m_strTitle, m_strShowTitle))
     CLog::Log(LOGDEBUG,"CPVRRecording::Update - PVR addon provides episode name in strPlotOutline which is deprecated");
-    std::string strEpisode = m_strPlotOutline;
-    std::string strTitle = m_strDirectory;
-
-    size_t pos = strTitle.rfind('/');
-    strTitle.erase(0, pos + 1);
-    strEpisode.erase(0, strShow.size());
-    m_strTitle = strTitle;
-    pos = strEpisode.find('-');
-    strEpisode.erase(0, pos + 2);
-    m_strShowTitle = strEpisode;
-  }
 
   if (m_bIsDeleted)
     OnDelete();
 
   UpdatePath();
+
+  // play count and resume point may have been overwritten, get them again
+  m_bGotMetaData = false;
+}
+
+bool CPVRRecording::DiffersFrom(const CPVRRecording &tag) const
+{
+  // compare the titles the way Update() would set them
+  std::string strTitle(tag.m_strTitle);
+  std::string strShowTitle(tag.m_strShowTitle);
+  GetDeprecatedTitles(tag.m_strDirectory, tag.m_strPlotOutline, strTitle, strShowTitle);
+
+  if (m_strRecordingId    != tag.m_strRecordingId ||
+      m_iClientId         != tag.m_iClientId ||
+      m_strTitle          != strTitle ||
+      m_strShowTitle      != strShowTitle ||
+      m_iSeason           != tag.m_iSeason ||
+      m_iEpisode          != tag.m_iEpisode ||
+      GetPremiered()      != tag.GetPremiered() ||
+      m_recordingTime     != tag.m_recordingTime ||
+      m_iPriority         != tag.m_iPriority ||
+      m_iLifetime         != tag.m_iLifetime ||
+      m_strDirectory      != tag.m_strDirectory ||
+      m_strPlot           != tag.m_strPlot ||
+      m_strPlotOutline    != tag.m_strPlotOutline ||
+      m_strChannelName    != tag.m_strChannelName ||
+      m_genre             != tag.m_genre ||
+      m_strIconPath       != tag.m_strIconPath ||
+      m_strThumbnailPath  != tag.m_strThumbnailPath ||
+      m_strFanartPath     != tag.m_strFanartPath ||
+      m_bIsDeleted        != tag.m_bIsDeleted ||
+      m_iEpgEventId       != tag.m_iEpgEventId ||
+      m_iChannelUid       != tag.m_iChannelUid ||
+      m_bRadio            != tag.m_bRadio ||
+      GetDuration()       != tag.GetDuration())
+    return true;
+
+  // play count and resume point of clients not supporting them are taken from the database
+  const CPVRClientCapabilities capabilities(CServiceBroker::GetPVRManager().Clients()->GetClientCapabilities(m_iClientId));
+  if (capabilities.SupportsRecordingsPlayCount() &&
+      GetLocalPlayCount() != tag.GetLocalPlayCount())
+    return true;
+
+  if (capabilities.SupportsRecordingsLastPlayedPosition())
+  {
+    const CBookmark resumePoint(GetLocalResumePoint());
+    const CBookmark tagResumePoint(tag.GetLocalResumePoint());
+    if (resumePoint.timeInSeconds != tagResumePoint.timeInSeconds ||
+        resumePoint.totalTimeInSeconds != tagResumePoint.totalTimeInSeconds)
+      return true;
+  }
+
+  return false;
 }
 
 void CPVRRecording::UpdatePath(void)
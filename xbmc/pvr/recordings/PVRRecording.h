@@ -196,6 +196,13 @@ namespace PVR
      */
     void Update(const CPVRRecording &tag);
 
+    /*!
+     * @brief Check whether updating this tag with the given tag would change it.
+     * @param tag The new tag info.
+     * @return True if the tags differ, false otherwise.
+     */
+    bool DiffersFrom(const CPVRRecording &tag) const;
+
     /*!
      * @brief Retrieve the recording start as UTC time
      * @return the recording start time
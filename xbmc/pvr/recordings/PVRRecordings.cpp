@@ -20,6 +20,7 @@
 
 #include "PVRRecordings.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "FileItem.h"
@@ -48,7 +49,9 @@ CPVRRecordings::CPVRRecordings(void) :
     m_bDeletedTVRecordings(false),
     m_bDeletedRadioRecordings(false),
     m_iTVRecordings(0),
-    m_iRadioRecordings(0)
+    m_iRadioRecordings(0),
+    m_iAdded(0),
+    m_iChanged(0)
 {
 }
 
@@ -58,12 +61,80 @@ CPVRRecordings::~CPVRRecordings()
     m_database->Close();
 }
 
-void CPVRRecordings::UpdateFromClients(void)
+bool CPVRRecordings::UpdateFromClients(void)
 {
   CSingleLock lock(m_critSection);
-  Unload();
-  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, false);
-  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, true);
+
+  // whatever the clients don't send again is gone
+  m_unchecked.clear();
+  for (const auto &recording : m_recordings)
+    m_unchecked.insert(recording.first);
+  m_iAdded = 0;
+  m_iChanged = 0;
+
+  std::vector<int> failedClients;
+  std::vector<int> failedClientsDeleted;
+  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, false, failedClients);
+  CServiceBroker::GetPVRManager().Clients()->GetRecordings(this, true, failedClientsDeleted);
+  failedClients.insert(failedClients.end(), failedClientsDeleted.begin(), failedClientsDeleted.end());
+
+  unsigned int iRemoved = 0;
+  for (const auto &uid : m_unchecked)
+  {
+    // keep the recordings of clients that could not be asked
+    if (std::find(failedClients.begin(), failedClients.end(), uid.m_iClientId) != failedClients.end())
+      continue;
+
+    const auto it = m_recordings.find(uid);
+    if (it == m_recordings.end())
+      continue;
+
+    if (it->second->BroadcastUid() != EPG_TAG_INVALID_UID)
+    {
+      const CPVRChannelPtr channel(it->second->Channel());
+      if (channel)
+      {
+        const CPVREpgInfoTagPtr epgTag = CServiceBroker::GetPVRManager().EpgContainer().GetTagById(channel, it->second->BroadcastUid());
+        if (epgTag && epgTag->Recording() == it->second)
+          epgTag->ClearRecording();
+      }
+    }
+
+    m_recordings.erase(it);
+    ++iRemoved;
+  }
+  m_unchecked.clear();
+
+  UpdateCounts();
+
+  CLog::Log(LOGDEBUG, "CPVRRecordings - %s - %u recordings: %u added, %u changed, %u removed", __FUNCTION__,
+            static_cast<unsigned int>(m_recordings.size()), m_iAdded, m_iChanged, iRemoved);
+
+  return m_iAdded > 0 || m_iChanged > 0 || iRemoved > 0;
+}
+
+void CPVRRecordings::UpdateCounts(void)
+{
+  m_bDeletedTVRecordings = false;
+  m_bDeletedRadioRecordings = false;
+  m_iTVRecordings = 0;
+  m_iRadioRecordings = 0;
+
+  for (const auto &recording : m_recordings)
+  {
+    if (recording.second->IsDeleted())
+    {
+      if (recording.second->IsRadio())
+        m_bDeletedRadioRecordings = true;
+      else
+        m_bDeletedTVRecordings = true;
+    }
+
+    if (recording.second->IsRadio())
+      ++m_iRadioRecordings;
+    else
+      ++m_iTVRecordings;
+  }
 }
 
 std::string CPVRRecordings::TrimSlashes(const std::string &strOrig) const
@@ -170,15 +241,18 @@ void CPVRRecordings::Update(void)
   lock.Leave();
 
   CLog::Log(LOGDEBUG, "CPVRRecordings - %s - updating recordings", __FUNCTION__);
-  UpdateFromClients();
+  const bool bChanged = UpdateFromClients();
 
   lock.Enter();
   m_bIsUpdating = false;
   lock.Leave();
 
-  CServiceBroker::GetPVRManager().SetChanged();
-  CServiceBroker::GetPVRManager().NotifyObservers(ObservableMessageRecordings);
-  CServiceBroker::GetPVRManager().PublishEvent(RecordingsInvalidated);
+  if (bChanged)
+  {
+    CServiceBroker::GetPVRManager().SetChanged();
+    CServiceBroker::GetPVRManager().NotifyObservers(ObservableMessageRecordings);
+    CServiceBroker::GetPVRManager().PublishEvent(RecordingsInvalidated);
+  }
 }
 
 int CPVRRecordings::GetNumTVRecordings() const
@@ -425,18 +499,17 @@ void CPVRRecordings::UpdateFromClient(const CPVRRecordingPtr &tag)
 {
   CSingleLock lock(m_critSection);
 
-  if (tag->IsDeleted())
-  {
-    if (tag->IsRadio())
-      m_bDeletedRadioRecordings = true;
-    else
-      m_bDeletedTVRecordings = true;
-  }
+  const CPVRRecordingUid uid(tag->m_iClientId, tag->m_strRecordingId);
+  m_unchecked.erase(uid);
 
   CPVRRecordingPtr newTag = GetById(tag->m_iClientId, tag->m_strRecordingId);
   if (newTag)
   {
-    newTag->Update(*tag);
+    if (newTag->DiffersFrom(*tag))
+    {
+      newTag->Update(*tag);
+      ++m_iChanged;
+    }
   }
   else
   {
@@ -453,11 +526,8 @@ void CPVRRecordings::UpdateFromClient(const CPVRRecordingPtr &tag)
       }
     }
     newTag->m_iRecordingId = ++m_iLastId;
-    m_recordings.insert(std::make_pair(CPVRRecordingUid(newTag->m_iClientId, newTag->m_strRecordingId), newTag));
-    if (newTag->IsRadio())
-      ++m_iRadioRecordings;
-    else
-      ++m_iTVRecordings;
+    m_recordings.insert(std::make_pair(uid, newTag));
+    ++m_iAdded;
   }
 }
 
@@ -21,6 +21,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 
 #include "FileItem.h"
 #include "video/VideoDatabase.h"
@@ -53,6 +54,10 @@ namespace PVR
 
     /**
      * @brief refresh the recordings list from the clients.
+     *
+     * Recordings are matched by client and recording id. Only recordings that
+     * were added, changed or removed are touched, observers are only notified
+     * if there was such a change.
      */
     void Update(void);
 
@@ -110,7 +115,16 @@ namespace PVR
     unsigned int m_iTVRecordings;
     unsigned int m_iRadioRecordings;
 
-    void UpdateFromClients(void);
+    std::set<CPVRRecordingUid> m_unchecked; //!< recordings not yet sent by their client during an update
+    unsigned int m_iAdded;
+    unsigned int m_iChanged;
+
+    /**
+     * @brief get the recordings from the clients and update the existing ones.
+     * @return true if recordings were added, changed or removed, false otherwise.
+     */
+    bool UpdateFromClients(void);
+    void UpdateCounts(void);
     std::string TrimSlashes(const std::string &strOrig) const;
     bool IsDirectoryMember(const std::string &strDirectory, const std::string &strEntryDirectory, bool bGrouped) const;
     void GetSubDirectories(const CPVRRecordingsPath &recParentPath, CFileItemList *results);
@@ -583,6 +583,47 @@ bool CPVRTimerInfoTag::UpdateEntry(const CPVRTimerInfoTagPtr &tag)
   return true;
 }
 
+bool CPVRTimerInfoTag::DiffersFrom(const CPVRTimerInfoTagPtr &tag) const
+{
+  CSingleLock lock(m_critSection);
+
+  bool bTypesMatch = true;
+  if (m_timerType && tag->m_timerType)
+    bTypesMatch = *m_timerType == *tag->m_timerType;
+  else if (m_timerType != tag->m_timerType)
+    bTypesMatch = false;
+
+  // the summary is generated from the other fields if the client doesn't send one
+  return !bTypesMatch ||
+         (!tag->m_strSummary.empty() && m_strSummary != tag->m_strSummary) ||
+         m_iClientId           != tag->m_iClientId ||
+         m_iClientIndex        != tag->m_iClientIndex ||
+         m_iParentClientIndex  != tag->m_iParentClientIndex ||
+         m_strTitle            != tag->m_strTitle ||
+         m_strEpgSearchString  != tag->m_strEpgSearchString ||
+         m_bFullTextEpgSearch  != tag->m_bFullTextEpgSearch ||
+         m_strDirectory        != tag->m_strDirectory ||
+         m_iClientChannelUid   != tag->m_iClientChannelUid ||
+         m_StartTime           != tag->m_StartTime ||
+         m_StopTime            != tag->m_StopTime ||
+         m_bStartAnyTime       != tag->m_bStartAnyTime ||
+         m_bEndAnyTime         != tag->m_bEndAnyTime ||
+         m_FirstDay            != tag->m_FirstDay ||
+         m_iPriority           != tag->m_iPriority ||
+         m_iLifetime           != tag->m_iLifetime ||
+         m_iMaxRecordings      != tag->m_iMaxRecordings ||
+         m_state               != tag->m_state ||
+         m_iPreventDupEpisodes != tag->m_iPreventDupEpisodes ||
+         m_iRecordingGroup     != tag->m_iRecordingGroup ||
+         m_iWeekdays           != tag->m_iWeekdays ||
+         m_bIsRadio            != tag->m_bIsRadio ||
+         m_iMarginStart        != tag->m_iMarginStart ||
+         m_iMarginEnd          != tag->m_iMarginEnd ||
+         m_strSeriesLink       != tag->m_strSeriesLink ||
+         m_iEpgUid             != tag->m_iEpgUid ||
+         m_channel             != tag->m_channel;
+}
+
 bool CPVRTimerInfoTag::UpdateChildState(const CPVRTimerInfoTagPtr &childTimer)
 {
   if (!childTimer || childTimer->m_iParentClientIndex != m_iClientIndex)
@@ -116,6 +116,13 @@ namespace PVR
      */
     bool UpdateEntry(const CPVRTimerInfoTagPtr &tag);
 
+    /*!
+     * @brief Check whether updating this timer with the given tag would change it.
+     * @param tag The new timer info.
+     * @return True if the timers differ, false otherwise.
+     */
+    bool DiffersFrom(const CPVRTimerInfoTagPtr &tag) const;
+
     /*!
      * @brief merge in the state of this child timer. Run for each child after using ResetChildState.
      * @return true if the child timer's state was merged successfully
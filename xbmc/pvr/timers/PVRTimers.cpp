@@ -48,31 +48,40 @@ bool CPVRTimersContainer::UpdateFromClient(const CPVRTimerInfoTagPtr &timer)
   {
     tag.reset(new CPVRTimerInfoTag());
     tag->m_iTimerId = ++m_iLastId;
+    tag->UpdateEntry(timer);
     InsertTimer(tag);
+    return true;
   }
 
-  return tag->UpdateEntry(timer);
+  const bool bChanged = tag->UpdateEntry(timer);
+  IndexTimer(tag);
+  return bChanged;
 }
 
 CPVRTimerInfoTagPtr CPVRTimersContainer::GetByClient(int iClientId, unsigned int iClientTimerId) const
 {
   CSingleLock lock(m_critSection);
-  for (const auto startDates : m_tags)
-  {
-    for (const auto timer : startDates.second)
-    {
-      if (timer->m_iClientId == iClientId && timer->m_iClientIndex == iClientTimerId)
-      {
-        return timer;
-      }
-    }
-  }
+  const auto it = m_clientTags.find(std::make_pair(iClientId, iClientTimerId));
+  if (it != m_clientTags.end())
+    return it->second;
 
   return CPVRTimerInfoTagPtr();
 }
 
+void CPVRTimersContainer::RemoveTimer(const CPVRTimerInfoTagPtr &timer)
+{
+  const auto it = m_clientTags.find(std::make_pair(timer->m_iClientId, timer->m_iClientIndex));
+  if (it != m_clientTags.end() && it->second == timer)
+    m_clientTags.erase(it);
+
+  UnindexTimer(timer);
+}
+
 void CPVRTimersContainer::InsertTimer(const CPVRTimerInfoTagPtr &newTimer)
 {
+  m_clientTags[std::make_pair(newTimer->m_iClientId, newTimer->m_iClientIndex)] = newTimer;
+  IndexTimer(newTimer);
+
   auto it = m_tags.find(newTimer->m_bStartAnyTime ? CDateTime() : newTimer->StartAsUTC());
   if (it == m_tags.end())
   {
@@ -85,6 +94,29 @@ void CPVRTimersContainer::InsertTimer(const CPVRTimerInfoTagPtr &newTimer)
   }
 }
 
+void CPVRTimersContainer::IndexTimer(const CPVRTimerInfoTagPtr &timer)
+{
+  UnindexTimer(timer);
+
+  if (timer->IsTimerRule())
+    return;
+
+  const CDateTime start(timer->StartAsUTC());
+  const CDateTime end(timer->EndAsUTC());
+  m_intervals.Insert(start, end, timer);
+  m_indexedTimes[timer->m_iTimerId] = std::make_pair(start, end);
+}
+
+void CPVRTimersContainer::UnindexTimer(const CPVRTimerInfoTagPtr &timer)
+{
+  const auto it = m_indexedTimes.find(timer->m_iTimerId);
+  if (it == m_indexedTimes.end())
+    return;
+
+  m_intervals.Erase(it->second.first, it->second.second, timer);
+  m_indexedTimes.erase(it);
+}
+
 CPVRTimers::CPVRTimers(void)
 : m_bIsUpdating(false),
   m_settings({
@@ -122,6 +154,9 @@ void CPVRTimers::Unload()
   // remove all tags
   CSingleLock lock(m_critSection);
   m_tags.clear();
+  m_clientTags.clear();
+  m_intervals.Clear();
+  m_indexedTimes.clear();
 }
 
 bool CPVRTimers::Update(void)
@@ -205,15 +240,22 @@ bool CPVRTimers::UpdateEntries(const CPVRTimersContainer &timers, const std::vec
       CPVRTimerInfoTagPtr existingTimer = GetByClient((*timerIt)->m_iClientId, (*timerIt)->m_iClientIndex);
       if (existingTimer)
       {
-        /* if it's present, update the current tag */
+        /* if it's present and has changed, update the current tag. an unchanged
+           timer is updated as well if the epg tag it matches has changed, so
+           the epg tags get their timer assigned again */
+        if (!existingTimer->DiffersFrom(*timerIt) &&
+            existingTimer->GetEpgInfoTag(false) == (*timerIt)->GetEpgInfoTag(false))
+          continue;
+
         bool bStateChanged(existingTimer->m_state != (*timerIt)->m_state);
         ClearEpgTagTimer(existingTimer);
-        if (existingTimer->UpdateEntry(*timerIt))
+        const bool bUpdated = existingTimer->UpdateEntry(*timerIt);
+        IndexTimer(existingTimer);
+        if (bUpdated)
         {
           SetEpgTagTimer(existingTimer);
 
           bChanged = true;
-          existingTimer->ResetChildState();
 
           if (bStateChanged)
           {
@@ -283,6 +325,7 @@ bool CPVRTimers::UpdateEntries(const CPVRTimersContainer &timers, const std::vec
 
         ClearEpgTagTimer(timer);
 
+        RemoveTimer(timer);
         it2 = it->second.erase(it2);
 
         bChanged = true;
@@ -324,16 +367,25 @@ bool CPVRTimers::UpdateEntries(const CPVRTimersContainer &timers, const std::vec
     InsertTimer(*timerIt);
   }
 
-  /* update child information for all parent timers */
-  for (const auto &tagsEntry : m_tags)
+  /* update child information for all parent timers, if any timer changed */
+  if (bChanged)
   {
-    for (const auto &timersEntry : tagsEntry.second)
+    for (const auto &tagsEntry : m_tags)
+    {
+      for (const auto &timersEntry : tagsEntry.second)
+        timersEntry->ResetChildState();
+    }
+
+    for (const auto &tagsEntry : m_tags)
     {
-      if (timersEntry->GetTimerRuleId() != PVR_TIMER_NO_PARENT)
+      for (const auto &timersEntry : tagsEntry.second)
       {
-        const CPVRTimerInfoTagPtr parentTimer(GetByClient(timersEntry->m_iClientId, timersEntry->GetTimerRuleId()));
-        if (parentTimer)
-          parentTimer->UpdateChildState(timersEntry);
+        if (timersEntry->GetTimerRuleId() != PVR_TIMER_NO_PARENT)
+        {
+          const CPVRTimerInfoTagPtr parentTimer(GetByClient(timersEntry->m_iClientId, timersEntry->GetTimerRuleId()));
+          if (parentTimer)
+            parentTimer->UpdateChildState(timersEntry);
+        }
       }
     }
   }
@@ -761,36 +813,50 @@ CPVRTimerInfoTagPtr CPVRTimers::GetTimerForEpgTag(const CPVREpgInfoTagPtr &epgTa
     {
       CSingleLock lock(m_critSection);
 
-      for (const auto &tagsEntry : m_tags)
+      // a timer for the tag runs at least partly at the time of the tag
+      CPVRTimerInfoTagPtr match;
+      m_intervals.ForEachOverlapping(epgTag->StartAsUTC(), epgTag->EndAsUTC(),
+        [&match, &epgTag, &channel](const CDateTime &start, const CDateTime &end, const CPVRTimerInfoTagPtr &timer)
       {
-        for (const auto &timersEntry : tagsEntry.second)
-        {
-          if (timersEntry->IsTimerRule())
-            continue;
-
-          if (timersEntry->GetEpgInfoTag(false) == epgTag)
-            return timersEntry;
+        if (match)
+          return;
 
-          if (timersEntry->m_iClientChannelUid != PVR_CHANNEL_INVALID_UID &&
-              timersEntry->m_iClientChannelUid == channel->UniqueID())
-          {
-            if (timersEntry->UniqueBroadcastID() != EPG_TAG_INVALID_UID &&
-                timersEntry->UniqueBroadcastID() == epgTag->UniqueBroadcastID())
-              return timersEntry;
-
-            if (timersEntry->m_bIsRadio == channel->IsRadio() &&
-                timersEntry->StartAsUTC() <= epgTag->StartAsUTC() &&
-                timersEntry->EndAsUTC() >= epgTag->EndAsUTC())
-              return timersEntry;
-          }
+        if (timer->GetEpgInfoTag(false) == epgTag)
+        {
+          match = timer;
         }
-      }
+        else if (timer->m_iClientChannelUid != PVR_CHANNEL_INVALID_UID &&
+                 timer->m_iClientChannelUid == channel->UniqueID())
+        {
+          if (timer->UniqueBroadcastID() != EPG_TAG_INVALID_UID &&
+              timer->UniqueBroadcastID() == epgTag->UniqueBroadcastID())
+            match = timer;
+          else if (timer->m_bIsRadio == channel->IsRadio() &&
+                   start <= epgTag->StartAsUTC() &&
+                   end >= epgTag->EndAsUTC())
+            match = timer;
+        }
+      });
+      return match;
     }
   }
 
   return CPVRTimerInfoTagPtr();
 }
 
+std::vector<CPVRTimerInfoTagPtr> CPVRTimers::GetOverlappingTimers(const CDateTime &start, const CDateTime &end) const
+{
+  std::vector<CPVRTimerInfoTagPtr> timers;
+
+  CSingleLock lock(m_critSection);
+  m_intervals.ForEachOverlapping(start, end,
+    [&timers](const CDateTime &, const CDateTime &, const CPVRTimerInfoTagPtr &timer)
+  {
+    timers.emplace_back(timer);
+  });
+  return timers;
+}
+
 bool CPVRTimers::HasRecordingTimerForRecording(const CPVRRecording &recording) const
 {
   return GetRecordingTimerForRecording(recording) != nullptr;
@@ -25,6 +25,7 @@
 
 #include "XBDateTime.h"
 #include "addons/kodi-addon-dev-kit/include/kodi/xbmc_pvr_types.h"
+#include "utils/IntervalTree.h"
 #include "utils/Observer.h"
 
 #include "pvr/PVRSettings.h"
@@ -71,10 +72,32 @@ namespace PVR
 
   protected:
     void InsertTimer(const CPVRTimerInfoTagPtr &newTimer);
+    void RemoveTimer(const CPVRTimerInfoTagPtr &timer);
+
+    /*!
+     * @brief Add a timer to the interval index or move it to its current start and end time.
+     * @param timer The timer.
+     */
+    void IndexTimer(const CPVRTimerInfoTagPtr &timer);
+
+    /*!
+     * @brief Remove a timer from the interval index.
+     * @param timer The timer.
+     */
+    void UnindexTimer(const CPVRTimerInfoTagPtr &timer);
 
     CCriticalSection m_critSection;
     unsigned int m_iLastId;
     MapTags m_tags;
+
+    typedef std::map<std::pair<int, unsigned int>, CPVRTimerInfoTagPtr> MapClientTags;
+    MapClientTags m_clientTags; //!< the timers of m_tags by client id and client timer id
+
+    typedef CIntervalTree<CDateTime, CPVRTimerInfoTagPtr> TimerIntervals;
+    TimerIntervals m_intervals; //!< the timers of m_tags which are not timer rules, by start and end time
+
+    typedef std::map<unsigned int, std::pair<CDateTime, CDateTime>> MapIndexedTimes;
+    MapIndexedTimes m_indexedTimes; //!< the start and end time each timer was indexed with, by timer id
   };
 
   class CPVRTimers : public CPVRTimersContainer, public Observer
@@ -254,6 +277,14 @@ namespace PVR
      */
     CPVRTimerInfoTagPtr GetTimerForEpgTag(const CPVREpgInfoTagPtr &epgTag) const;
 
+    /*!
+     * @brief Get the timers overlapping the given time span. Timer rules are not included.
+     * @param start The start of the time span (UTC).
+     * @param end The end of the time span (UTC).
+     * @return The timers, ordered by start time.
+     */
+    std::vector<CPVRTimerInfoTagPtr> GetOverlappingTimers(const CDateTime &start, const CDateTime &end) const;
+
     /*!
      * @brief Check whether there is a timer currently recording the given recording.
      * @param recording The recording to check.
@@ -124,6 +124,7 @@ void CAdvancedSettings::Initialize()
 
   m_audioDefaultPlayer = "paplayer";
   m_audioPlayCountMinimumPercent = 90.0f;
+  m_audioLookAhead = 5;
 
   m_videoSubsDelayRange = 60;
   m_videoAudioDelayRange = 10;
@@ -277,6 +278,7 @@ void CAdvancedSettings::Initialize()
   m_bMusicLibraryAllItemsOnBottom = false;
   m_bMusicLibraryCleanOnUpdate = false;
   m_bMusicLibraryArtistSortOnUpdate = false;
+  m_bMusicLibraryFullTextSearch = false;
   m_iMusicLibraryRecentlyAddedItems = 25;
   m_strMusicLibraryAlbumFormat = "";
   m_prioritiseAPEv2tags = false;
@@ -293,6 +295,7 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryExportAutoThumbs = false;
   m_bVideoLibraryImportWatchedState = false;
   m_bVideoLibraryImportResumePoint = false;
+  m_bVideoLibraryFullTextSearch = false;
   m_bVideoScannerIgnoreErrors = false;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
 
@@ -367,6 +370,10 @@ void CAdvancedSettings::Initialize()
 
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
+  m_jsonNotificationDelay = 0;
+
+  m_pythonInterpreterPoolSize = 0;
+  m_pythonInterpreterIdleTime = 300;
 
   m_enableMultimediaKeys = false;
 
@@ -501,6 +508,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetString(pElement, "defaultplayer", m_audioDefaultPlayer);
     // 101 on purpose - can be used to never automark as watched
     XMLUtils::GetFloat(pElement, "playcountminimumpercent", m_audioPlayCountMinimumPercent, 0.0f, 101.0f);
+    XMLUtils::GetInt(pElement, "lookahead", m_audioLookAhead, 2, 10);
 
     XMLUtils::GetBoolean(pElement, "usetimeseeking", m_musicUseTimeSeeking);
     XMLUtils::GetInt(pElement, "timeseekforward", m_musicTimeSeekForward, 0, 6000);
@@ -730,6 +738,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "allitemsonbottom", m_bMusicLibraryAllItemsOnBottom);
     XMLUtils::GetBoolean(pElement, "cleanonupdate", m_bMusicLibraryCleanOnUpdate);
     XMLUtils::GetBoolean(pElement, "artistsortonupdate", m_bMusicLibraryArtistSortOnUpdate);
+    XMLUtils::GetBoolean(pElement, "fulltextsearch", m_bMusicLibraryFullTextSearch);
     XMLUtils::GetBoolean(pElement, "useartistsortname", m_musicUseArtistSortName);
     XMLUtils::GetString(pElement, "albumformat", m_strMusicLibraryAlbumFormat);
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
@@ -760,6 +769,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "exportautothumbs", m_bVideoLibraryExportAutoThumbs);
     XMLUtils::GetBoolean(pElement, "importwatchedstate", m_bVideoLibraryImportWatchedState);
     XMLUtils::GetBoolean(pElement, "importresumepoint", m_bVideoLibraryImportResumePoint);
+    XMLUtils::GetBoolean(pElement, "fulltextsearch", m_bVideoLibraryFullTextSearch);
     XMLUtils::GetInt(pElement, "dateadded", m_iVideoLibraryDateAdded);
   }
 
@@ -805,6 +815,14 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   {
     XMLUtils::GetBoolean(pElement, "compactoutput", m_jsonOutputCompact);
     XMLUtils::GetUInt(pElement, "tcpport", m_jsonTcpPort);
+    XMLUtils::GetUInt(pElement, "notificationdelay", m_jsonNotificationDelay, 0, 5000);
+  }
+
+  pElement = pRootElement->FirstChildElement("python");
+  if (pElement)
+  {
+    XMLUtils::GetUInt(pElement, "interpreterpoolsize", m_pythonInterpreterPoolSize, 0, 16);
+    XMLUtils::GetUInt(pElement, "interpreteridletime", m_pythonInterpreterIdleTime, 1, 86400);
   }
 
   pElement = pRootElement->FirstChildElement("samba");
@@ -139,6 +139,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     float m_ac3Gain;
     std::string m_audioDefaultPlayer;
     float m_audioPlayCountMinimumPercent;
+    int m_audioLookAhead; // seconds of the next track to open and decode before the transition
     bool m_VideoPlayerIgnoreDTSinWAV;
     float m_limiterHold;
     float m_limiterRelease;
@@ -257,6 +258,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bMusicLibraryAllItemsOnBottom;
     bool m_bMusicLibraryCleanOnUpdate;
     bool m_bMusicLibraryArtistSortOnUpdate;
+    bool m_bMusicLibraryFullTextSearch; ///< maintain and use a full text index for library searches
     std::string m_strMusicLibraryAlbumFormat;
     bool m_prioritiseAPEv2tags;
     std::string m_musicItemSeparator;
@@ -272,6 +274,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bVideoLibraryExportAutoThumbs;
     bool m_bVideoLibraryImportWatchedState;
     bool m_bVideoLibraryImportResumePoint;
+    bool m_bVideoLibraryFullTextSearch; ///< maintain and use a full text index for library searches
 
     bool m_bVideoScannerIgnoreErrors;
     int m_iVideoLibraryDateAdded;
@@ -349,6 +352,10 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
+    unsigned int m_jsonNotificationDelay; ///< ms notifications are collected before they are sent to TCP clients, 0 to send them right away
+
+    unsigned int m_pythonInterpreterPoolSize; ///< number of plugin interpreters kept warm between invocations, 0 to disable
+    unsigned int m_pythonInterpreterIdleTime; ///< seconds a warm plugin interpreter is kept unused
 
     bool m_enableMultimediaKeys;
     std::vector<std::string> m_settingsFiles;
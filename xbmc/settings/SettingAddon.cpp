@@ -46,7 +46,7 @@ SettingPtr CSettingAddon::Clone(const std::string &id) const
 
 bool CSettingAddon::Deserialize(const TiXmlNode *node, bool update /* = false */)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   if (!CSettingString::Deserialize(node, update))
     return false;
@@ -85,6 +85,6 @@ void CSettingAddon::copyaddontype(const CSettingAddon &setting)
 {
   CSettingString::Copy(setting);
   
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   m_addonType = setting.m_addonType;
 }
@@ -40,7 +40,7 @@ SettingPtr CSettingDate::Clone(const std::string &id) const
 
 bool CSettingDate::CheckValidity(const std::string &value) const
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
 
   if (!CSettingString::CheckValidity(value))
     return false;
@@ -67,7 +67,7 @@ SettingPtr CSettingTime::Clone(const std::string &id) const
 
 bool CSettingTime::CheckValidity(const std::string &value) const
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
 
   if (!CSettingString::CheckValidity(value))
     return false;
@@ -299,7 +299,7 @@ SettingPtr CSettingList::Clone(const std::string &id) const
 
 bool CSettingList::Deserialize(const TiXmlNode *node, bool update /* = false */)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   if (m_definition == nullptr)
     return false;
@@ -357,7 +357,7 @@ bool CSettingList::Deserialize(const TiXmlNode *node, bool update /* = false */)
 
 SettingType CSettingList::GetElementType() const
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   
   if (m_definition == nullptr)
     return SettingType::Unknown;
@@ -406,7 +406,7 @@ bool CSettingList::CheckValidity(const std::string &value) const
 
 void CSettingList::Reset()
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   SettingList values;
   for (auto it : m_defaults)
     values.push_back(SettingPtr(it->Clone(it->GetId())));
@@ -425,7 +425,7 @@ bool CSettingList::FromString(const std::vector<std::string> &value)
 
 bool CSettingList::SetValue(const SettingList &values)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   if ((int)values.size() < m_minimumItems ||
      (m_maximumItems > 0 && (int)values.size() > m_maximumItems))
@@ -468,7 +468,7 @@ bool CSettingList::SetValue(const SettingList &values)
 
 void CSettingList::SetDefault(const SettingList &values)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   m_defaults.clear();
   m_defaults.insert(m_defaults.begin(), values.begin(), values.end());
@@ -586,7 +586,7 @@ SettingPtr CSettingBool::Clone(const std::string &id) const
 
 bool CSettingBool::Deserialize(const TiXmlNode *node, bool update /* = false */)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   if (!CSetting::Deserialize(node, update))
     return false;
@@ -632,7 +632,7 @@ bool CSettingBool::CheckValidity(const std::string &value) const
 
 bool CSettingBool::SetValue(bool value)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   if (value == m_value)
     return true;
@@ -659,7 +659,7 @@ bool CSettingBool::SetValue(bool value)
   
 void CSettingBool::SetDefault(bool value)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   m_default = value;
   if (!m_changed)
@@ -735,7 +735,7 @@ SettingPtr CSettingInt::Clone(const std::string &id) const
 
 bool CSettingInt::Deserialize(const TiXmlNode *node, bool update /* = false */)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   if (!CSetting::Deserialize(node, update))
     return false;
@@ -847,7 +847,7 @@ bool CSettingInt::CheckValidity(int value) const
 
 bool CSettingInt::SetValue(int value)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   if (value == m_value)
     return true;
@@ -877,7 +877,7 @@ bool CSettingInt::SetValue(int value)
 
 void CSettingInt::SetDefault(int value)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   m_default = value;
   if (!m_changed)
@@ -886,7 +886,7 @@ void CSettingInt::SetDefault(int value)
 
 SettingOptionsType CSettingInt::GetOptionsType() const
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   if (!m_translatableOptions.empty())
     return SettingOptionsType::StaticTranslatable;
   if (!m_options.empty())
@@ -899,7 +899,7 @@ SettingOptionsType CSettingInt::GetOptionsType() const
 
 IntegerSettingOptions CSettingInt::UpdateDynamicOptions()
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   IntegerSettingOptions options;
   if (m_optionsFiller == nullptr &&
      (m_optionsFillerName.empty() || m_settingsManager == nullptr))
@@ -948,7 +948,7 @@ void CSettingInt::copy(const CSettingInt &setting)
 {
   CSetting::Copy(setting);
 
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   m_value = setting.m_value;
   m_default = setting.m_default;
@@ -1012,7 +1012,7 @@ SettingPtr CSettingNumber::Clone(const std::string &id) const
 
 bool CSettingNumber::Deserialize(const TiXmlNode *node, bool update /* = false */)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   if (!CSetting::Deserialize(node, update))
     return false;
@@ -1061,7 +1061,7 @@ std::string CSettingNumber::ToString() const
 bool CSettingNumber::Equals(const std::string &value) const
 {
   double dValue;
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   return (fromString(value, dValue) && m_value == dValue);
 }
 
@@ -1076,7 +1076,7 @@ bool CSettingNumber::CheckValidity(const std::string &value) const
 
 bool CSettingNumber::CheckValidity(double value) const
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   if (m_min != m_max &&
      (value < m_min || value > m_max))
     return false;
@@ -1086,7 +1086,7 @@ bool CSettingNumber::CheckValidity(double value) const
 
 bool CSettingNumber::SetValue(double value)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   if (value == m_value)
     return true;
@@ -1116,7 +1116,7 @@ bool CSettingNumber::SetValue(double value)
 
 void CSettingNumber::SetDefault(double value)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   m_default = value;
   if (!m_changed)
@@ -1126,7 +1126,7 @@ void CSettingNumber::SetDefault(double value)
 void CSettingNumber::copy(const CSettingNumber &setting)
 {
   CSetting::Copy(setting);
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   m_value = setting.m_value;
   m_default = setting.m_default;
@@ -1173,7 +1173,7 @@ SettingPtr CSettingString::Clone(const std::string &id) const
 
 bool CSettingString::Deserialize(const TiXmlNode *node, bool update /* = false */)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   if (!CSetting::Deserialize(node, update))
     return false;
@@ -1231,7 +1231,7 @@ bool CSettingString::Deserialize(const TiXmlNode *node, bool update /* = false *
 
 bool CSettingString::CheckValidity(const std::string &value) const
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   if (!m_allowEmpty && value.empty())
     return false;
 
@@ -1251,7 +1251,7 @@ bool CSettingString::CheckValidity(const std::string &value) const
 
 bool CSettingString::SetValue(const std::string &value)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
 
   if (value == m_value)
     return true;
@@ -1281,7 +1281,7 @@ bool CSettingString::SetValue(const std::string &value)
 
 void CSettingString::SetDefault(const std::string &value)
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
 
   m_default = value;
   if (!m_changed)
@@ -1290,7 +1290,7 @@ void CSettingString::SetDefault(const std::string &value)
 
 SettingOptionsType CSettingString::GetOptionsType() const
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   if (!m_translatableOptions.empty())
     return SettingOptionsType::StaticTranslatable;
   if (!m_options.empty())
@@ -1303,7 +1303,7 @@ SettingOptionsType CSettingString::GetOptionsType() const
 
 StringSettingOptions CSettingString::UpdateDynamicOptions()
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   StringSettingOptions options;
   if (m_optionsFiller == nullptr &&
      (m_optionsFillerName.empty() || m_settingsManager == nullptr))
@@ -1353,7 +1353,7 @@ void CSettingString::copy(const CSettingString &setting)
 {
   CSetting::Copy(setting);
 
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   m_value = setting.m_value;
   m_default = setting.m_default;
   m_allowEmpty = setting.m_allowEmpty;
@@ -1387,7 +1387,7 @@ SettingPtr CSettingAction::Clone(const std::string &id) const
 
 bool CSettingAction::Deserialize(const TiXmlNode *node, bool update /* = false */)
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
 
   if (!CSetting::Deserialize(node, update))
     return false;
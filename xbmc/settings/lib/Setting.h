@@ -33,7 +33,7 @@
 #include "SettingLevel.h"
 #include "SettingType.h"
 #include "SettingUpdate.h"
-#include "threads/SharedSection.h"
+#include "threads/ReadWriteSection.h"
 
 enum class SettingOptionsType {
   Unknown = 0,
@@ -117,7 +117,7 @@ protected:
   SettingDependencies m_dependencies;
   std::set<CSettingUpdate> m_updates;
   bool m_changed = false;
-  CSharedSection m_critical;
+  CReadWriteSection m_critical{"CSetting", CReadWriteSection::Preference::READERS};
 };
 
 template<typename TValue, SettingType TSettingType>
@@ -245,7 +245,7 @@ public:
   bool CheckValidity(const std::string &value) const override;
   void Reset() override { SetValue(m_default); }
 
-  bool GetValue() const { CSharedLock lock(m_critical); return m_value; }
+  bool GetValue() const { CReadLock lock(m_critical); return m_value; }
   bool SetValue(bool value);
   bool GetDefault() const { return m_default; }
   void SetDefault(bool value);
@@ -284,7 +284,7 @@ public:
   virtual bool CheckValidity(int value) const;
   void Reset() override { SetValue(m_default); }
 
-  int GetValue() const { CSharedLock lock(m_critical); return m_value; }
+  int GetValue() const { CReadLock lock(m_critical); return m_value; }
   bool SetValue(int value);
   int GetDefault() const { return m_default; }
   void SetDefault(int value);
@@ -356,7 +356,7 @@ public:
   virtual bool CheckValidity(double value) const;
   void Reset() override { SetValue(m_default); }
 
-  double GetValue() const { CSharedLock lock(m_critical); return m_value; }
+  double GetValue() const { CReadLock lock(m_critical); return m_value; }
   bool SetValue(double value);
   double GetDefault() const { return m_default; }
   void SetDefault(double value);
@@ -402,7 +402,7 @@ public:
   bool CheckValidity(const std::string &value) const override;
   void Reset() override { SetValue(m_default); }
 
-  virtual const std::string& GetValue() const { CSharedLock lock(m_critical); return m_value; }
+  virtual const std::string& GetValue() const { CReadLock lock(m_critical); return m_value; }
   virtual bool SetValue(const std::string &value);
   virtual const std::string& GetDefault() const { return m_default; }
   virtual void SetDefault(const std::string &value);
@@ -83,8 +83,8 @@ uint32_t CSettingsManager::ParseVersion(const TiXmlElement* root) const
 
 bool CSettingsManager::Initialize(const TiXmlElement *root)
 {
-  CExclusiveLock lock(m_critical);
-  CExclusiveLock settingsLock(m_settingsCritical);
+  CWriteLock lock(m_critical);
+  CWriteLock settingsLock(m_settingsCritical);
   if (m_initialized || root == nullptr)
     return false;
 
@@ -140,8 +140,8 @@ bool CSettingsManager::Initialize(const TiXmlElement *root)
 
 bool CSettingsManager::Load(const TiXmlElement *root, bool &updated, bool triggerEvents /* = true */, std::map<std::string, SettingPtr> *loadedSettings /* = nullptr */)
 {
-  CSharedLock lock(m_critical);
-  CExclusiveLock settingsLock(m_settingsCritical);
+  CReadLock lock(m_critical);
+  CWriteLock settingsLock(m_settingsCritical);
   if (m_loaded || root == nullptr)
     return false;
 
@@ -180,8 +180,8 @@ bool CSettingsManager::Load(const TiXmlElement *root, bool &updated, bool trigge
 
 bool CSettingsManager::Save(TiXmlNode *root) const
 {
-  CSharedLock lock(m_critical);
-  CSharedLock settingsLock(m_settingsCritical);
+  CReadLock lock(m_critical);
+  CReadLock settingsLock(m_settingsCritical);
   if (!m_initialized || root == nullptr)
     return false;
 
@@ -217,7 +217,7 @@ bool CSettingsManager::Save(TiXmlNode *root) const
 
 void CSettingsManager::Unload()
 {
-  CExclusiveLock lock(m_settingsCritical);
+  CWriteLock lock(m_settingsCritical);
   if (!m_loaded)
     return;
 
@@ -233,7 +233,7 @@ void CSettingsManager::Unload()
 
 void CSettingsManager::Clear()
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   Unload();
 
   m_settings.clear();
@@ -269,7 +269,7 @@ bool CSettingsManager::LoadSetting(const TiXmlNode *node, const std::string &set
 
 void CSettingsManager::SetInitialized()
 {
-  CExclusiveLock lock(m_settingsCritical);
+  CWriteLock lock(m_settingsCritical);
   if (m_initialized)
     return;
 
@@ -292,8 +292,8 @@ void CSettingsManager::AddSection(SettingSectionPtr section)
   if (section == nullptr)
     return;
 
-  CExclusiveLock lock(m_critical);
-  CExclusiveLock settingsLock(m_settingsCritical);
+  CWriteLock lock(m_critical);
+  CWriteLock settingsLock(m_settingsCritical);
 
   section->CheckRequirements();
   m_sections[section->GetId()] = section;
@@ -335,8 +335,8 @@ bool CSettingsManager::AddSetting(std::shared_ptr<CSetting> setting, std::shared
   if (setting == nullptr || section == nullptr || category == nullptr || group == nullptr)
     return false;
 
-  CExclusiveLock lock(m_critical);
-  CExclusiveLock settingsLock(m_settingsCritical);
+  CWriteLock lock(m_critical);
+  CWriteLock settingsLock(m_settingsCritical);
 
   // check if a setting with the given ID already exists
   if (FindSetting(setting->GetId()) != m_settings.end())
@@ -385,7 +385,7 @@ bool CSettingsManager::AddSetting(std::shared_ptr<CSetting> setting, std::shared
 
 void CSettingsManager::RegisterCallback(ISettingCallback *callback, const std::set<std::string> &settingList)
 {
-  CExclusiveLock lock(m_settingsCritical);
+  CWriteLock lock(m_settingsCritical);
   if (callback == nullptr)
     return;
 
@@ -408,14 +408,14 @@ void CSettingsManager::RegisterCallback(ISettingCallback *callback, const std::s
 
 void CSettingsManager::UnregisterCallback(ISettingCallback *callback)
 {
-  CExclusiveLock lock(m_settingsCritical);
+  CWriteLock lock(m_settingsCritical);
   for (auto& setting : m_settings)
     setting.second.callbacks.erase(callback);
 }
 
 void CSettingsManager::RegisterSettingType(const std::string &settingType, ISettingCreator *settingCreator)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   if (settingType.empty() || settingCreator == nullptr)
     return;
 
@@ -429,7 +429,7 @@ void CSettingsManager::RegisterSettingControl(const std::string &controlType, IS
   if (controlType.empty() || settingControlCreator == nullptr)
     return;
 
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   auto creatorIt = m_settingControlCreators.find(controlType);
   if (creatorIt == m_settingControlCreators.end())
     m_settingControlCreators.insert(std::make_pair(controlType, settingControlCreator));
@@ -440,7 +440,7 @@ void CSettingsManager::RegisterSettingsHandler(ISettingsHandler *settingsHandler
   if (settingsHandler == nullptr)
     return;
 
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   if (find(m_settingsHandlers.begin(), m_settingsHandlers.end(), settingsHandler) == m_settingsHandlers.end())
     m_settingsHandlers.push_back(settingsHandler);
 }
@@ -450,7 +450,7 @@ void CSettingsManager::UnregisterSettingsHandler(ISettingsHandler *settingsHandl
   if (settingsHandler == nullptr)
     return;
 
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   auto it = std::find(m_settingsHandlers.begin(), m_settingsHandlers.end(), settingsHandler);
   if (it != m_settingsHandlers.end())
     m_settingsHandlers.erase(it);
@@ -458,7 +458,7 @@ void CSettingsManager::UnregisterSettingsHandler(ISettingsHandler *settingsHandl
 
 void CSettingsManager::RegisterSubSettings(ISubSettings *subSettings)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   if (subSettings == nullptr)
     return;
 
@@ -467,7 +467,7 @@ void CSettingsManager::RegisterSubSettings(ISubSettings *subSettings)
 
 void CSettingsManager::UnregisterSubSettings(ISubSettings *subSettings)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   if (subSettings == nullptr)
     return;
 
@@ -492,13 +492,13 @@ void CSettingsManager::RegisterSettingOptionsFiller(const std::string &identifie
 
 void CSettingsManager::UnregisterSettingOptionsFiller(const std::string &identifier)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   m_optionsFillers.erase(identifier);
 }
 
 void* CSettingsManager::GetSettingOptionsFiller(SettingConstPtr setting)
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   if (setting == nullptr)
     return nullptr;
 
@@ -548,7 +548,7 @@ void* CSettingsManager::GetSettingOptionsFiller(SettingConstPtr setting)
 
 SettingPtr CSettingsManager::GetSetting(const std::string &id) const
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   if (id.empty())
     return nullptr;
 
@@ -562,7 +562,7 @@ SettingPtr CSettingsManager::GetSetting(const std::string &id) const
 
 SettingSectionList CSettingsManager::GetSections() const
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   SettingSectionList sections;
   for (const auto& section : m_sections)
     sections.push_back(section.second);
@@ -572,7 +572,7 @@ SettingSectionList CSettingsManager::GetSections() const
 
 SettingSectionPtr CSettingsManager::GetSection(std::string section) const
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   if (section.empty())
     return nullptr;
 
@@ -588,7 +588,7 @@ SettingSectionPtr CSettingsManager::GetSection(std::string section) const
 
 SettingDependencyMap CSettingsManager::GetDependencies(const std::string &id) const
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   auto setting = FindSetting(id);
   if (setting == m_settings.end())
     return SettingDependencyMap();
@@ -606,7 +606,7 @@ SettingDependencyMap CSettingsManager::GetDependencies(SettingConstPtr setting)
 
 bool CSettingsManager::GetBool(const std::string &id) const
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::Boolean)
     return false;
@@ -616,7 +616,7 @@ bool CSettingsManager::GetBool(const std::string &id) const
 
 bool CSettingsManager::SetBool(const std::string &id, bool value)
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::Boolean)
     return false;
@@ -626,7 +626,7 @@ bool CSettingsManager::SetBool(const std::string &id, bool value)
 
 bool CSettingsManager::ToggleBool(const std::string &id)
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::Boolean)
     return false;
@@ -636,7 +636,7 @@ bool CSettingsManager::ToggleBool(const std::string &id)
 
 int CSettingsManager::GetInt(const std::string &id) const
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::Integer)
     return 0;
@@ -646,7 +646,7 @@ int CSettingsManager::GetInt(const std::string &id) const
 
 bool CSettingsManager::SetInt(const std::string &id, int value)
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::Integer)
     return false;
@@ -656,7 +656,7 @@ bool CSettingsManager::SetInt(const std::string &id, int value)
 
 double CSettingsManager::GetNumber(const std::string &id) const
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::Number)
     return 0.0;
@@ -666,7 +666,7 @@ double CSettingsManager::GetNumber(const std::string &id) const
 
 bool CSettingsManager::SetNumber(const std::string &id, double value)
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::Number)
     return false;
@@ -676,7 +676,7 @@ bool CSettingsManager::SetNumber(const std::string &id, double value)
 
 std::string CSettingsManager::GetString(const std::string &id) const
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::String)
     return "";
@@ -686,7 +686,7 @@ std::string CSettingsManager::GetString(const std::string &id) const
 
 bool CSettingsManager::SetString(const std::string &id, const std::string &value)
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::String)
     return false;
@@ -696,7 +696,7 @@ bool CSettingsManager::SetString(const std::string &id, const std::string &value
 
 std::vector< std::shared_ptr<CSetting> > CSettingsManager::GetList(const std::string &id) const
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::List)
     return std::vector< std::shared_ptr<CSetting> >();
@@ -706,7 +706,7 @@ std::vector< std::shared_ptr<CSetting> > CSettingsManager::GetList(const std::st
 
 bool CSettingsManager::SetList(const std::string &id, const std::vector< std::shared_ptr<CSetting> > &value)
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr || setting->GetType() != SettingType::List)
     return false;
@@ -716,7 +716,7 @@ bool CSettingsManager::SetList(const std::string &id, const std::vector< std::sh
 
 bool CSettingsManager::SetDefault(const std::string &id)
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   SettingPtr setting = GetSetting(id);
   if (setting == nullptr)
     return false;
@@ -727,14 +727,14 @@ bool CSettingsManager::SetDefault(const std::string &id)
 
 void CSettingsManager::SetDefaults()
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   for (auto& setting : m_settings)
     setting.second.setting->Reset();
 }
 
 void CSettingsManager::AddCondition(const std::string &condition)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   if (condition.empty())
     return;
 
@@ -743,7 +743,7 @@ void CSettingsManager::AddCondition(const std::string &condition)
 
 void CSettingsManager::AddCondition(const std::string &identifier, SettingConditionCheck condition, void *data /*= nullptr*/)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   if (identifier.empty() || condition == nullptr)
     return;
 
@@ -755,7 +755,7 @@ bool CSettingsManager::Serialize(TiXmlNode *parent) const
   if (parent == nullptr)
     return false;
 
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
 
   for (const auto& setting : m_settings)
   {
@@ -790,7 +790,7 @@ bool CSettingsManager::Deserialize(const TiXmlNode *node, bool &updated, std::ma
   if (node == nullptr)
     return false;
 
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
 
   // TODO: ideally this would be done by going through all <setting> elements
   // in node but as long as we have to support the v1- format that's not possible
@@ -813,7 +813,7 @@ bool CSettingsManager::OnSettingChanging(std::shared_ptr<const CSetting> setting
   if (setting == nullptr)
     return false;
 
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   if (!m_loaded)
     return true;
 
@@ -836,7 +836,7 @@ bool CSettingsManager::OnSettingChanging(std::shared_ptr<const CSetting> setting
   
 void CSettingsManager::OnSettingChanged(std::shared_ptr<const CSetting> setting)
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   if (!m_loaded || setting == nullptr)
     return;
     
@@ -862,7 +862,7 @@ void CSettingsManager::OnSettingChanged(std::shared_ptr<const CSetting> setting)
 
 void CSettingsManager::OnSettingAction(std::shared_ptr<const CSetting> setting)
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   if (!m_loaded || setting == nullptr)
     return;
 
@@ -880,7 +880,7 @@ void CSettingsManager::OnSettingAction(std::shared_ptr<const CSetting> setting)
 
 bool CSettingsManager::OnSettingUpdate(SettingPtr setting, const char *oldSettingId, const TiXmlNode *oldSettingNode)
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   if (setting == nullptr)
     return false;
 
@@ -901,7 +901,7 @@ bool CSettingsManager::OnSettingUpdate(SettingPtr setting, const char *oldSettin
 
 void CSettingsManager::OnSettingPropertyChanged(std::shared_ptr<const CSetting> setting, const char *propertyName)
 {
-  CSharedLock lock(m_settingsCritical);
+  CReadLock lock(m_settingsCritical);
   if (!m_loaded || setting == nullptr)
     return;
 
@@ -955,7 +955,7 @@ SettingPtr CSettingsManager::CreateSetting(const std::string &settingType, const
       return std::make_shared<CSettingList>(settingId, elementSetting, const_cast<CSettingsManager*>(this));
   }
 
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   auto creator = m_settingCreators.find(settingType);
   if (creator != m_settingCreators.end())
     return creator->second->CreateSetting(settingType, settingId, const_cast<CSettingsManager*>(this));
@@ -968,7 +968,7 @@ std::shared_ptr<ISettingControl> CSettingsManager::CreateControl(const std::stri
   if (controlType.empty())
     return nullptr;
 
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   auto creator = m_settingControlCreators.find(controlType);
   if (creator != m_settingControlCreators.end() && creator->second != nullptr)
     return creator->second->CreateControl(controlType);
@@ -978,7 +978,7 @@ std::shared_ptr<ISettingControl> CSettingsManager::CreateControl(const std::stri
 
 bool CSettingsManager::OnSettingsLoading()
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   for (const auto& settingsHandler : m_settingsHandlers)
   {
     if (!settingsHandler->OnSettingsLoading())
@@ -990,21 +990,21 @@ bool CSettingsManager::OnSettingsLoading()
 
 void CSettingsManager::OnSettingsUnloaded()
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   for (const auto& settingsHandler : m_settingsHandlers)
     settingsHandler->OnSettingsUnloaded();
 }
 
 void CSettingsManager::OnSettingsLoaded()
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   for (const auto& settingsHandler : m_settingsHandlers)
     settingsHandler->OnSettingsLoaded();
 }
 
 bool CSettingsManager::OnSettingsSaving() const
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   for (const auto& settingsHandler : m_settingsHandlers)
   {
     if (!settingsHandler->OnSettingsSaving())
@@ -1016,14 +1016,14 @@ bool CSettingsManager::OnSettingsSaving() const
 
 void CSettingsManager::OnSettingsSaved() const
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   for (const auto& settingsHandler : m_settingsHandlers)
     settingsHandler->OnSettingsSaved();
 }
 
 void CSettingsManager::OnSettingsCleared()
 {
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   for (const auto& settingsHandler : m_settingsHandlers)
     settingsHandler->OnSettingsCleared();
 }
@@ -1031,7 +1031,7 @@ void CSettingsManager::OnSettingsCleared()
 bool CSettingsManager::Load(const TiXmlNode *settings)
 {
   bool ok = true;
-  CSharedLock lock(m_critical);
+  CReadLock lock(m_critical);
   for (const auto& subSetting : m_subSettings)
     ok &= subSetting->Load(settings);
 
@@ -1272,7 +1272,7 @@ void CSettingsManager::CleanupIncompleteSettings()
 
 void CSettingsManager::RegisterSettingOptionsFiller(const std::string &identifier, void *filler, SettingOptionsFillerType type)
 {
-  CExclusiveLock lock(m_critical);
+  CWriteLock lock(m_critical);
   auto it = m_optionsFillers.find(identifier);
   if (it != m_optionsFillers.end())
     return;
@@ -32,7 +32,7 @@
 #include "SettingConditions.h"
 #include "SettingDefinitions.h"
 #include "SettingDependency.h"
-#include "threads/SharedSection.h"
+#include "threads/ReadWriteSection.h"
 
 class CSettingCategory;
 class CSettingGroup;
@@ -537,6 +537,6 @@ private:
   using SettingOptionsFillerMap = std::map<std::string, SettingOptionsFiller>;
   SettingOptionsFillerMap m_optionsFillers;
 
-  CSharedSection m_critical;
-  CSharedSection m_settingsCritical;
+  CReadWriteSection m_critical{"CSettingsManager", CReadWriteSection::Preference::READERS};
+  CReadWriteSection m_settingsCritical{"CSettingsManager.Settings", CReadWriteSection::Preference::READERS};
 };
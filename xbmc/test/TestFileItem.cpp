@@ -21,6 +21,9 @@
 #include "FileItem.h"
 #include "URL.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/SystemClock.h"
+#include "utils/StringUtils.h"
+
 
 #include "gtest/gtest.h"
 
@@ -136,3 +139,83 @@ const TestFileData BaseMovies[] = {{ "c:\\dir\\filename.avi", false, "c:\\dir\\f
                                    { "/home/user/movies/movie_name/BDMV/index.bdmv", true, "/home/user/movies/movie_name/" }};
 
 INSTANTIATE_TEST_CASE_P(BaseNameMovies, TestFileItemBasePath, ValuesIn(BaseMovies));
+
+class TestFileItemListStack : public AdvancedSettingsResetBase
+{
+protected:
+  static void AddFile(CFileItemList &items, const std::string &name)
+  {
+    CFileItemPtr item(new CFileItem(items.GetPath() + name, false));
+    item->SetLabel(name);
+    items.Add(item);
+  }
+};
+
+TEST_F(TestFileItemListStack, StackFiles)
+{
+  CFileItemList items("/movies/");
+  AddFile(items, "Casino part2.mkv");
+  AddFile(items, "Alien cd1.avi");
+  AddFile(items, "Brazil.avi");
+  AddFile(items, "Casino part1.mkv");
+  AddFile(items, "Alien cd2.avi");
+  AddFile(items, "Casino part3.mkv");
+  AddFile(items, "Dune cd1.avi");
+  AddFile(items, "Dune cd1.nfo");
+
+  items.Stack();
+
+  ASSERT_EQ(5, items.Size());
+  EXPECT_EQ("stack:///movies/Alien cd1.avi , /movies/Alien cd2.avi", items[0]->GetPath());
+  EXPECT_EQ("/movies/Brazil.avi", items[1]->GetPath());
+  EXPECT_EQ("stack:///movies/Casino part1.mkv , /movies/Casino part2.mkv , /movies/Casino part3.mkv", items[2]->GetPath());
+  EXPECT_EQ("/movies/Dune cd1.avi", items[3]->GetPath());
+  EXPECT_EQ("/movies/Dune cd1.nfo", items[4]->GetPath());
+}
+
+// A camera or music video folder with 50k files, half of which are split in two parts
+TEST_F(TestFileItemListStack, DISABLED_Benchmark)
+{
+  static const int NUM_FILES = 50000;
+
+  CFileItemList items("/videos/");
+  for (int i = 0; i < NUM_FILES; i++)
+  {
+    if (i % 4 < 2)
+      AddFile(items, StringUtils::Format("clip %05i cd%i.mkv", i / 4, i % 4 + 1));
+    else
+      AddFile(items, StringUtils::Format("clip %05i %s.mkv", i / 4, i % 4 == 2 ? "live" : "studio"));
+  }
+
+  const unsigned int start = XbmcThreads::SystemClockMillis();
+  items.Stack();
+  const unsigned int elapsed = XbmcThreads::SystemClockMillis() - start;
+
+  EXPECT_EQ(NUM_FILES * 3 / 4, items.Size());
+  RecordProperty("StackMs", static_cast<int>(elapsed));
+}
+
+TEST(TestFileItemPathClassification, FollowsPath)
+{
+  CFileItem item("smb://server/share/movie.avi", false);
+  EXPECT_TRUE(item.IsSmb());
+  EXPECT_TRUE(item.IsRemote());
+
+  CFileItem copy(item);
+  item.SetPath("/home/user/movie.avi");
+  EXPECT_FALSE(item.IsSmb());
+  EXPECT_FALSE(item.IsRemote());
+  EXPECT_TRUE(copy.IsSmb());
+
+  copy.SetURL(CURL("stack:///home/user/movie cd1.avi , /home/user/movie cd2.avi"));
+  EXPECT_FALSE(copy.IsSmb());
+  EXPECT_TRUE(copy.IsStack());
+
+  copy = item;
+  EXPECT_FALSE(copy.IsStack());
+
+  item.SetPath("smb://server/share/movie.avi");
+  EXPECT_TRUE(item.IsRemote());
+  item.Reset();
+  EXPECT_FALSE(item.IsRemote());
+}
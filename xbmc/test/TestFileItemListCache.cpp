@@ -0,0 +1,273 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "FileItemListCache.h"
+#include "filesystem/File.h"
+#include "music/tags/MusicInfoTag.h"
+#include "test/TestUtils.h"
+#include "utils/Archive.h"
+#include "utils/StringUtils.h"
+
+#include <chrono>
+#include <string.h>
+
+#include "gtest/gtest.h"
+
+static void CreateList(CFileItemList &items, int count)
+{
+  items.SetPath("musicdb://albums/");
+  items.SetContent("songs");
+  items.AddSortMethod(SortByTitle, 556, LABEL_MASKS("%T", "%D"));
+  items.SetCacheToDisc(CFileItemList::CACHE_ALWAYS);
+
+  for (int i = 0; i < count; i++)
+  {
+    CFileItemPtr item(new CFileItem(StringUtils::Format("Track %05i", i)));
+    item->SetPath(StringUtils::Format("smb://server/music/Artist %i/Album/%05i.flac", i / 100, i));
+    item->m_bIsFolder = (i % 10) == 0;
+    MUSIC_INFO::CMusicInfoTag *tag = item->GetMusicInfoTag();
+    tag->SetTitle(item->GetLabel());
+    tag->SetArtist(StringUtils::Format("Artist %i", i / 100));
+    tag->SetAlbum("Album");
+    tag->SetGenre("Rock");
+    tag->SetTrackNumber(i % 100);
+    tag->SetDuration(180 + i % 60);
+    tag->SetLoaded(true);
+    items.Add(item);
+  }
+}
+
+TEST(TestFileItemListCache, Items)
+{
+  CFileItemList items;
+  CreateList(items, 100);
+
+  std::vector<uint8_t> data;
+  ASSERT_TRUE(CFileItemListCache::Write(items, data));
+
+  CFileItemListCache cache;
+  ASSERT_TRUE(cache.Open(data));
+  ASSERT_EQ(100, cache.Size());
+
+  EXPECT_EQ(items[42]->GetPath(), cache.GetPath(42));
+  EXPECT_EQ("Track 00042", cache.GetLabel(42));
+  EXPECT_TRUE(cache.IsFolder(40));
+  EXPECT_FALSE(cache.IsFolder(42));
+
+  CFileItemPtr item = cache.Get(42);
+  ASSERT_TRUE(item != nullptr);
+  EXPECT_EQ(item, cache.Get(42));
+  EXPECT_EQ("Track 00042", item->GetMusicInfoTag()->GetTitle());
+  EXPECT_EQ(222, item->GetMusicInfoTag()->GetDuration());
+
+  EXPECT_EQ(item, cache.Get(items[42]->GetPath()));
+  EXPECT_TRUE(cache.Get("smb://server/music/missing.flac") == nullptr);
+  EXPECT_TRUE(cache.Get(100) == nullptr);
+  EXPECT_TRUE(cache.Get(-1) == nullptr);
+  EXPECT_EQ("", cache.GetPath(100));
+}
+
+TEST(TestFileItemListCache, DuplicatePaths)
+{
+  CFileItemList items;
+  CreateList(items, 10);
+  items[7]->SetPath(items[3]->GetPath());
+
+  std::vector<uint8_t> data;
+  ASSERT_TRUE(CFileItemListCache::Write(items, data));
+
+  // the first item with a path is found, like in a list
+  CFileItemListCache cache;
+  ASSERT_TRUE(cache.Open(data));
+  CFileItemPtr item = cache.Get(items[3]->GetPath());
+  ASSERT_TRUE(item != nullptr);
+  EXPECT_EQ("Track 00003", item->GetLabel());
+  EXPECT_EQ(item, cache.Get(3));
+
+  // the index is dropped with the data
+  ASSERT_TRUE(cache.Open(std::vector<uint8_t>(data)));
+  EXPECT_EQ("Track 00009", cache.Get(items[9]->GetPath())->GetLabel());
+  cache.Close();
+  EXPECT_TRUE(cache.Get(items[9]->GetPath()) == nullptr);
+}
+
+TEST(TestFileItemListCache, Load)
+{
+  CFileItemList items;
+  CreateList(items, 100);
+
+  std::vector<uint8_t> data;
+  ASSERT_TRUE(CFileItemListCache::Write(items, data));
+
+  // the parent folder item of the list loaded into is kept
+  CFileItemList loaded;
+  CFileItemPtr parent(new CFileItem(".."));
+  parent->SetPath("musicdb://");
+  parent->m_bIsFolder = true;
+  loaded.Add(parent);
+
+  CFileItemListCache cache;
+  ASSERT_TRUE(cache.Open(data));
+  ASSERT_TRUE(cache.Load(loaded));
+
+  ASSERT_EQ(101, loaded.Size());
+  EXPECT_TRUE(loaded[0]->IsParentFolder());
+  EXPECT_EQ("musicdb://albums/", loaded.GetPath());
+  EXPECT_EQ("songs", loaded.GetContent());
+  EXPECT_TRUE(loaded.CacheToDiscAlways());
+  ASSERT_EQ(1u, loaded.GetSortDetails().size());
+  EXPECT_EQ(SortByTitle, loaded.GetSortDetails()[0].m_sortDescription.sortBy);
+  for (int i = 0; i < 100; i++)
+  {
+    EXPECT_EQ(items[i]->GetPath(), loaded[i + 1]->GetPath());
+    EXPECT_EQ(items[i]->m_bIsFolder, loaded[i + 1]->m_bIsFolder);
+    EXPECT_EQ(items[i]->GetMusicInfoTag()->GetArtistString(), loaded[i + 1]->GetMusicInfoTag()->GetArtistString());
+  }
+}
+
+TEST(TestFileItemListCache, Invalid)
+{
+  CFileItemList items;
+  CreateList(items, 10);
+
+  std::vector<uint8_t> data;
+  ASSERT_TRUE(CFileItemListCache::Write(items, data));
+
+  CFileItemListCache cache;
+
+  // magic
+  std::vector<uint8_t> corrupt(data);
+  corrupt[0] = 'X';
+  EXPECT_FALSE(cache.Open(corrupt));
+
+  // version
+  corrupt = data;
+  uint32_t version = CFileItemListCache::VERSION + 1;
+  memcpy(corrupt.data() + 4, &version, sizeof(version));
+  EXPECT_FALSE(cache.Open(corrupt));
+
+  // truncated
+  corrupt.assign(data.begin(), data.end() - 1);
+  EXPECT_FALSE(cache.Open(corrupt));
+
+  // an archive of the old format
+  corrupt.clear();
+  {
+    CArchive ar(corrupt);
+    ar << items;
+  }
+  EXPECT_FALSE(cache.Open(corrupt));
+  EXPECT_EQ(0, cache.Size());
+  EXPECT_TRUE(cache.Get(0) == nullptr);
+
+  EXPECT_TRUE(cache.Open(data));
+}
+
+// Compares loading a large listing from a cache file with loading it from a
+// plain CArchive, fully and for the items of the first page only, and looking
+// up the files of the listing by path like the info loaders do
+TEST(TestFileItemListCache, DISABLED_Benchmark)
+{
+  static const int COUNT = 20000;
+  static const int PAGE = 50;
+
+  CFileItemList items;
+  CreateList(items, COUNT);
+
+  XFILE::CFile *archiveFile = XBMC_CREATETEMPFILE(".fi");
+  ASSERT_NE(nullptr, archiveFile);
+  {
+    CArchive ar(archiveFile, CArchive::store);
+    ar << items;
+  }
+
+  XFILE::CFile *cacheFile = XBMC_CREATETEMPFILE(".fi");
+  ASSERT_NE(nullptr, cacheFile);
+  const std::string cachePath = XBMC_TEMPFILEPATH(cacheFile);
+  cacheFile->Close();
+  ASSERT_TRUE(CFileItemListCache::Save(items, cachePath));
+
+  auto start = std::chrono::steady_clock::now();
+  CFileItemList archived;
+  ASSERT_EQ(0, archiveFile->Seek(0, SEEK_SET));
+  {
+    CArchive ar(archiveFile, CArchive::load);
+    ar >> archived;
+  }
+  const auto archiveUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(COUNT, archived.Size());
+
+  start = std::chrono::steady_clock::now();
+  CFileItemList loaded;
+  {
+    CFileItemListCache cache;
+    ASSERT_TRUE(cache.Open(cachePath));
+    ASSERT_TRUE(cache.Load(loaded));
+  }
+  const auto loadUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(COUNT, loaded.Size());
+
+  start = std::chrono::steady_clock::now();
+  {
+    CFileItemListCache cache;
+    ASSERT_TRUE(cache.Open(cachePath));
+    for (int i = 0; i < PAGE; i++)
+      ASSERT_TRUE(cache.Get(i) != nullptr);
+  }
+  const auto pageUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  // the info loaders used to load the whole list into a fast lookup map
+  start = std::chrono::steady_clock::now();
+  {
+    CFileItemList map;
+    CFileItemListCache cache;
+    ASSERT_TRUE(cache.Open(cachePath));
+    ASSERT_TRUE(cache.Load(map));
+    map.SetFastLookup(true);
+    for (int i = 0; i < COUNT; i++)
+    {
+      if (!items[i]->m_bIsFolder)
+        ASSERT_TRUE(map.Get(items[i]->GetPath()) != nullptr);
+    }
+  }
+  const auto mapLookupUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  {
+    CFileItemListCache cache;
+    ASSERT_TRUE(cache.Open(cachePath));
+    for (int i = 0; i < COUNT; i++)
+    {
+      if (!items[i]->m_bIsFolder)
+        ASSERT_TRUE(cache.Get(items[i]->GetPath()) != nullptr);
+    }
+  }
+  const auto cacheLookupUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  RecordProperty("ArchiveUs", static_cast<int>(archiveUs));
+  RecordProperty("CacheUs", static_cast<int>(loadUs));
+  RecordProperty("CachePageUs", static_cast<int>(pageUs));
+  RecordProperty("MapLookupUs", static_cast<int>(mapLookupUs));
+  RecordProperty("CacheLookupUs", static_cast<int>(cacheLookupUs));
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(archiveFile));
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(cacheFile));
+}
@@ -0,0 +1,398 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ReadWriteSection.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+namespace
+{
+
+// intentionally leaked: sections owned by globals (e.g. g_localizeStrings)
+// are destroyed during static destruction
+CCriticalSection& GetRegistryLock()
+{
+  static CCriticalSection* lock = new CCriticalSection;
+  return *lock;
+}
+
+class CWaitTimer
+{
+public:
+  CWaitTimer() : m_start(std::chrono::steady_clock::now()) {}
+
+  uint64_t ElapsedUs() const
+  {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count();
+  }
+
+private:
+  std::chrono::steady_clock::time_point m_start;
+};
+
+}
+
+// The counters of all sections sharing a name, e.g. of all CSetting
+// instances. Registered once per name and never freed.
+struct CReadWriteSection::Counters
+{
+  explicit Counters(const std::string& name_) : name(name_) {}
+
+  const std::string name;
+  std::atomic<unsigned int> instances{0};
+
+  std::atomic<uint64_t> sharedAcquisitions{0};
+  std::atomic<uint64_t> exclusiveAcquisitions{0};
+  std::atomic<uint64_t> sharedContentions{0};
+  std::atomic<uint64_t> exclusiveContentions{0};
+  std::atomic<uint64_t> sharedWaitUs{0};
+  std::atomic<uint64_t> exclusiveWaitUs{0};
+  std::atomic<uint64_t> maxWaitUs{0};
+
+  std::atomic<unsigned int> sharedHolders{0};
+  std::atomic<unsigned int> exclusiveHolders{0};
+  std::atomic<unsigned int> waitingReaders{0};
+  std::atomic<unsigned int> waitingWriters{0};
+};
+
+std::vector<CReadWriteSection::Counters*>& CReadWriteSection::GetRegistry()
+{
+  static std::vector<Counters*>* registry = new std::vector<Counters*>;
+  return *registry;
+}
+
+CReadWriteSection::Counters* CReadWriteSection::GetCounters(const char* name)
+{
+  if (name == nullptr || *name == '\0')
+    return nullptr;
+
+  CSingleLock lock(GetRegistryLock());
+  std::vector<Counters*>& registry = GetRegistry();
+  auto counters = std::find_if(registry.begin(), registry.end(), [name](const Counters* it)
+  {
+    return it->name == name;
+  });
+  if (counters != registry.end())
+    return *counters;
+
+  registry.push_back(new Counters(name));
+  return registry.back();
+}
+
+CReadWriteSection::CReadWriteSection(const char* name /* = nullptr */, Preference preference /* = Preference::WRITERS */)
+  : m_name(name ? name : ""),
+    m_preference(preference),
+    m_counters(GetCounters(name))
+{
+  m_stats.name = m_name;
+
+  if (m_counters)
+    m_counters->instances++;
+}
+
+CReadWriteSection::~CReadWriteSection()
+{
+  if (m_counters)
+    m_counters->instances--;
+}
+
+void CReadWriteSection::lock()
+{
+  const std::thread::id self = std::this_thread::get_id();
+
+  CSingleLock lock(m_section);
+  CountAcquisition(true);
+
+  if (IsExclusiveOwner(self))
+  {
+    m_exclusiveCount++;
+    return;
+  }
+
+  if (m_exclusiveCount > 0 || m_sharedCount > 0)
+  {
+    CWaitTimer timer;
+    CountWaiter(true, 1);
+    while (m_exclusiveCount > 0 || m_sharedCount > 0)
+      m_cond.wait(lock);
+    CountWaiter(true, -1);
+    RecordWait(timer.ElapsedUs(), true);
+  }
+
+  m_owner = self;
+  m_exclusiveCount = 1;
+  CountHolder(true, 1);
+}
+
+bool CReadWriteSection::try_lock()
+{
+  const std::thread::id self = std::this_thread::get_id();
+
+  CSingleLock lock(m_section);
+  if (IsExclusiveOwner(self))
+    m_exclusiveCount++;
+  else if (m_exclusiveCount == 0 && m_sharedCount == 0)
+  {
+    m_owner = self;
+    m_exclusiveCount = 1;
+    CountHolder(true, 1);
+  }
+  else
+    return false;
+
+  CountAcquisition(true);
+  return true;
+}
+
+void CReadWriteSection::unlock()
+{
+  CSingleLock lock(m_section);
+  if (--m_exclusiveCount == 0)
+  {
+    m_owner = std::thread::id();
+    CountHolder(true, -1);
+    m_cond.notifyAll();
+  }
+}
+
+void CReadWriteSection::lock_shared()
+{
+  const std::thread::id self = std::this_thread::get_id();
+
+  CSingleLock lock(m_section);
+  CountAcquisition(false);
+
+  if (!CanLockShared(self))
+  {
+    CWaitTimer timer;
+    CountWaiter(false, 1);
+    while (!CanLockShared(self))
+      m_cond.wait(lock);
+    CountWaiter(false, -1);
+    RecordWait(timer.ElapsedUs(), false);
+  }
+
+  AddReader(self);
+}
+
+bool CReadWriteSection::try_lock_shared()
+{
+  const std::thread::id self = std::this_thread::get_id();
+
+  CSingleLock lock(m_section);
+  if (!CanLockShared(self))
+    return false;
+
+  CountAcquisition(false);
+  AddReader(self);
+  return true;
+}
+
+void CReadWriteSection::unlock_shared()
+{
+  const std::thread::id self = std::this_thread::get_id();
+
+  CSingleLock lock(m_section);
+  auto reader = FindReader(self);
+  if (reader != m_readers.end() && --reader->second == 0)
+  {
+    m_readers.erase(reader);
+    CountHolder(false, -1);
+  }
+
+  if (--m_sharedCount == 0)
+    m_cond.notifyAll();
+}
+
+CReadWriteSection::Statistics CReadWriteSection::GetStatistics() const
+{
+  CSingleLock lock(m_section);
+  Statistics stats = m_stats;
+  stats.instances = 1;
+  stats.sharedHolders = static_cast<unsigned int>(m_readers.size());
+  stats.exclusiveHolders = m_exclusiveCount > 0 ? 1 : 0;
+  stats.waitingReaders = m_waitingReaders;
+  stats.waitingWriters = m_waitingWriters;
+  return stats;
+}
+
+void CReadWriteSection::ResetStatistics()
+{
+  CSingleLock lock(m_section);
+  m_stats = Statistics();
+  m_stats.name = m_name;
+}
+
+std::vector<CReadWriteSection::Statistics> CReadWriteSection::GetAllStatistics()
+{
+  std::vector<Statistics> result;
+  {
+    CSingleLock lock(GetRegistryLock());
+    for (const Counters* counters : GetRegistry())
+    {
+      Statistics stats;
+      stats.name = counters->name;
+      stats.instances = counters->instances;
+      stats.sharedAcquisitions = counters->sharedAcquisitions;
+      stats.exclusiveAcquisitions = counters->exclusiveAcquisitions;
+      stats.sharedContentions = counters->sharedContentions;
+      stats.exclusiveContentions = counters->exclusiveContentions;
+      stats.sharedWaitUs = counters->sharedWaitUs;
+      stats.exclusiveWaitUs = counters->exclusiveWaitUs;
+      stats.maxWaitUs = counters->maxWaitUs;
+      stats.sharedHolders = counters->sharedHolders;
+      stats.exclusiveHolders = counters->exclusiveHolders;
+      stats.waitingReaders = counters->waitingReaders;
+      stats.waitingWriters = counters->waitingWriters;
+      result.push_back(stats);
+    }
+  }
+
+  // hottest locks first
+  std::sort(result.begin(), result.end(), [](const Statistics& lhs, const Statistics& rhs)
+  {
+    return lhs.sharedWaitUs + lhs.exclusiveWaitUs > rhs.sharedWaitUs + rhs.exclusiveWaitUs;
+  });
+
+  return result;
+}
+
+void CReadWriteSection::LogStatistics()
+{
+  for (const auto& stats : GetAllStatistics())
+  {
+    CLog::Log(LOGDEBUG, "CReadWriteSection[%s] (%u instances): shared %" PRIu64 " (%" PRIu64 " contended, %" PRIu64 " us), "
+              "exclusive %" PRIu64 " (%" PRIu64 " contended, %" PRIu64 " us), max wait %" PRIu64 " us, "
+              "holders %u/%u, waiting %u/%u",
+              stats.name.c_str(), stats.instances,
+              stats.sharedAcquisitions, stats.sharedContentions, stats.sharedWaitUs,
+              stats.exclusiveAcquisitions, stats.exclusiveContentions, stats.exclusiveWaitUs,
+              stats.maxWaitUs,
+              stats.sharedHolders, stats.exclusiveHolders,
+              stats.waitingReaders, stats.waitingWriters);
+  }
+}
+
+bool CReadWriteSection::IsExclusiveOwner(const std::thread::id& self) const
+{
+  return m_exclusiveCount > 0 && m_owner == self;
+}
+
+std::vector<CReadWriteSection::ReaderEntry>::iterator CReadWriteSection::FindReader(const std::thread::id& self)
+{
+  return std::find_if(m_readers.begin(), m_readers.end(), [&self](const ReaderEntry& entry)
+  {
+    return entry.first == self;
+  });
+}
+
+bool CReadWriteSection::CanLockShared(const std::thread::id& self)
+{
+  if (IsExclusiveOwner(self))
+    return true;
+
+  if (m_exclusiveCount > 0)
+    return false;
+
+  if (m_preference == Preference::READERS || m_waitingWriters == 0)
+    return true;
+
+  // a thread that already holds the shared lock must be let through even if
+  // a writer is waiting, otherwise recursive read locking deadlocks
+  return FindReader(self) != m_readers.end();
+}
+
+void CReadWriteSection::AddReader(const std::thread::id& self)
+{
+  m_sharedCount++;
+
+  auto reader = FindReader(self);
+  if (reader != m_readers.end())
+    reader->second++;
+  else
+  {
+    m_readers.emplace_back(self, 1);
+    CountHolder(false, 1);
+  }
+}
+
+void CReadWriteSection::CountAcquisition(bool exclusive)
+{
+  if (exclusive)
+    m_stats.exclusiveAcquisitions++;
+  else
+    m_stats.sharedAcquisitions++;
+
+  if (m_counters)
+    (exclusive ? m_counters->exclusiveAcquisitions : m_counters->sharedAcquisitions)++;
+}
+
+void CReadWriteSection::CountHolder(bool exclusive, int delta)
+{
+  if (m_counters)
+    (exclusive ? m_counters->exclusiveHolders : m_counters->sharedHolders) += delta;
+}
+
+void CReadWriteSection::CountWaiter(bool exclusive, int delta)
+{
+  (exclusive ? m_waitingWriters : m_waitingReaders) += delta;
+
+  if (m_counters)
+    (exclusive ? m_counters->waitingWriters : m_counters->waitingReaders) += delta;
+}
+
+void CReadWriteSection::RecordWait(uint64_t waitUs, bool exclusive)
+{
+  if (exclusive)
+  {
+    m_stats.exclusiveContentions++;
+    m_stats.exclusiveWaitUs += waitUs;
+  }
+  else
+  {
+    m_stats.sharedContentions++;
+    m_stats.sharedWaitUs += waitUs;
+  }
+  m_stats.maxWaitUs = std::max(m_stats.maxWaitUs, waitUs);
+
+  if (!m_counters)
+    return;
+
+  if (exclusive)
+  {
+    m_counters->exclusiveContentions++;
+    m_counters->exclusiveWaitUs += waitUs;
+  }
+  else
+  {
+    m_counters->sharedContentions++;
+    m_counters->sharedWaitUs += waitUs;
+  }
+  uint64_t maxWaitUs = m_counters->maxWaitUs;
+  while (waitUs > maxWaitUs && !m_counters->maxWaitUs.compare_exchange_weak(maxWaitUs, waitUs))
+    ;
+}
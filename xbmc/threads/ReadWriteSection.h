@@ -0,0 +1,177 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Lockables.h"
+
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * A CReadWriteSection is a mutex that satisfies the Shared Lockable concept
+ * (see Lockables.h), like CSharedSection, but with two additions:
+ *
+ * - a configurable preference deciding who goes first when readers and
+ *   writers compete. With Preference::WRITERS (the default) new readers
+ *   queue up behind a waiting writer, so a steady stream of readers can no
+ *   longer starve it. Preference::READERS keeps the CSharedSection behaviour.
+ *
+ * - contention counters (acquisitions, how often and how long callers had to
+ *   wait, current holders and waiters). The counters of named sections are
+ *   summed up per name, usually the class owning the sections, and can be
+ *   inspected through GetAllStatistics() / LogStatistics().
+ *
+ * Both the exclusive and the shared lock are recursive for the owning
+ * thread, and the exclusive owner may also take the shared lock. Upgrading a
+ * shared lock to an exclusive one is not supported (it deadlocks, exactly as
+ * it does with CSharedSection).
+ *
+ * Writer preference is only safe if no thread holding the shared lock waits
+ * for another thread that takes it as well (e.g. through nested locks of
+ * different sections or callbacks run on other threads): the other thread
+ * queues up behind a waiting writer, which in turn waits for the first
+ * thread. Code written for CSharedSection should use Preference::READERS.
+ */
+class CReadWriteSection
+{
+public:
+  enum class Preference
+  {
+    READERS,
+    WRITERS
+  };
+
+  struct Statistics
+  {
+    std::string name;
+    unsigned int instances = 0;
+
+    uint64_t sharedAcquisitions = 0;
+    uint64_t exclusiveAcquisitions = 0;
+    uint64_t sharedContentions = 0;     //!< shared acquisitions that had to wait
+    uint64_t exclusiveContentions = 0;  //!< exclusive acquisitions that had to wait
+    uint64_t sharedWaitUs = 0;          //!< total time spent waiting for the shared lock
+    uint64_t exclusiveWaitUs = 0;       //!< total time spent waiting for the exclusive lock
+    uint64_t maxWaitUs = 0;
+
+    unsigned int sharedHolders = 0;
+    unsigned int exclusiveHolders = 0;
+    unsigned int waitingReaders = 0;
+    unsigned int waitingWriters = 0;
+  };
+
+  /*!
+   \param name Name under which the section is reported by GetAllStatistics(),
+               all sections sharing a name add up to one entry. nullptr only
+               keeps the statistics of the section itself.
+   \param preference Whether waiting writers block new readers.
+   */
+  explicit CReadWriteSection(const char* name = nullptr, Preference preference = Preference::WRITERS);
+  ~CReadWriteSection();
+
+  CReadWriteSection(const CReadWriteSection&) = delete;
+  CReadWriteSection& operator=(const CReadWriteSection&) = delete;
+
+  // Lockable concept
+  void lock();
+  bool try_lock();
+  void unlock();
+
+  // Shared Lockable concept
+  void lock_shared();
+  bool try_lock_shared();
+  void unlock_shared();
+
+  Preference GetPreference() const { return m_preference; }
+  const std::string& GetName() const { return m_name; }
+
+  Statistics GetStatistics() const;
+  void ResetStatistics();
+
+  /*!
+   \brief Get the statistics of all named sections, one entry per name.
+   */
+  static std::vector<Statistics> GetAllStatistics();
+
+  /*!
+   \brief Write the statistics of all named sections to the debug log.
+   */
+  static void LogStatistics();
+
+private:
+  struct Counters;
+  typedef std::pair<std::thread::id, unsigned int> ReaderEntry;
+
+  static std::vector<Counters*>& GetRegistry();
+  static Counters* GetCounters(const char* name);
+
+  bool IsExclusiveOwner(const std::thread::id& self) const;
+  std::vector<ReaderEntry>::iterator FindReader(const std::thread::id& self);
+  bool CanLockShared(const std::thread::id& self);
+  void AddReader(const std::thread::id& self);
+  void CountAcquisition(bool exclusive);
+  void CountHolder(bool exclusive, int delta);
+  void CountWaiter(bool exclusive, int delta);
+  void RecordWait(uint64_t waitUs, bool exclusive);
+
+  const std::string m_name;
+  const Preference m_preference;
+  Counters* const m_counters; //!< shared by all sections with the name, nullptr if unnamed
+
+  mutable CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_cond;
+
+  std::thread::id m_owner;
+  unsigned int m_exclusiveCount = 0;
+  unsigned int m_sharedCount = 0;
+  std::vector<ReaderEntry> m_readers;
+  unsigned int m_waitingReaders = 0;
+  unsigned int m_waitingWriters = 0;
+
+  Statistics m_stats;
+};
+
+class CReadLock : public XbmcThreads::SharedLock<CReadWriteSection>
+{
+public:
+  inline explicit CReadLock(CReadWriteSection& cs) : XbmcThreads::SharedLock<CReadWriteSection>(cs) {}
+  inline explicit CReadLock(const CReadWriteSection& cs) : XbmcThreads::SharedLock<CReadWriteSection>((CReadWriteSection&)cs) {}
+
+  inline bool IsOwner() const { return owns_lock(); }
+  inline void Enter() { lock(); }
+  inline void Leave() { unlock(); }
+};
+
+class CWriteLock : public XbmcThreads::UniqueLock<CReadWriteSection>
+{
+public:
+  inline explicit CWriteLock(CReadWriteSection& cs) : XbmcThreads::UniqueLock<CReadWriteSection>(cs) {}
+  inline explicit CWriteLock(const CReadWriteSection& cs) : XbmcThreads::UniqueLock<CReadWriteSection>((CReadWriteSection&)cs) {}
+
+  inline bool IsOwner() const { return owns_lock(); }
+  inline void Leave() { unlock(); }
+  inline void Enter() { lock(); }
+};
@@ -18,17 +18,18 @@
  *
  */
 
-#include <algorithm>
-
 #include "Timer.h"
+#include "SingleLock.h"
 #include "SystemClock.h"
 
 CTimer::CTimer(std::function<void()> const& callback)
-  : CThread("Timer"),
-    m_callback(callback),
+  : m_callback(callback),
     m_timeout(0),
     m_interval(false),
-    m_endTime(0)
+    m_endTime(0),
+    m_stopped(true),
+    m_restarted(false),
+    m_entry(std::bind(&CTimer::OnExpired, this), true)
 { }
 
 CTimer::CTimer(ITimerCallback *callback)
@@ -45,10 +46,14 @@ bool CTimer::Start(uint32_t timeout, bool interval /* = false */)
   if (m_callback == NULL || timeout == 0 || IsRunning())
     return false;
 
+  CSingleLock lock(m_critSection);
   m_timeout = timeout;
   m_interval = interval;
+  m_endTime = XbmcThreads::SystemClockMillis() + timeout;
+  m_stopped = false;
+  m_restarted = false;
 
-  Create();
+  CTimerWheel::GetInstance().Schedule(m_entry, timeout);
   return true;
 }
 
@@ -57,18 +62,24 @@ bool CTimer::Stop(bool wait /* = false */)
   if (!IsRunning())
     return false;
 
-  m_bStop = true;
-  m_eventTimeout.Set();
-  StopThread(wait);
+  {
+    CSingleLock lock(m_critSection);
+    m_stopped = true;
+  }
+  // must not hold our lock while waiting for the callback
+  CTimerWheel::GetInstance().Cancel(m_entry, wait);
 
   return true;
 }
 
 void CTimer::RestartAsync(uint32_t timeout)
 {
+  CSingleLock lock(m_critSection);
   m_timeout = timeout;
   m_endTime = XbmcThreads::SystemClockMillis() + timeout;
-  m_eventTimeout.Set();
+  // if the timer is firing right now it is rescheduled once the callback returns
+  if (!m_stopped && !CTimerWheel::GetInstance().Reschedule(m_entry, timeout))
+    m_restarted = true;
 }
 
 bool CTimer::Restart()
@@ -80,6 +91,12 @@ bool CTimer::Restart()
   return Start(m_timeout, m_interval);
 }
 
+bool CTimer::IsRunning() const
+{
+  const CTimerWheel &wheel = CTimerWheel::GetInstance();
+  return wheel.IsScheduled(m_entry) || wheel.IsFiring(m_entry);
+}
+
 float CTimer::GetElapsedSeconds() const
 {
   return GetElapsedMilliseconds() / 1000.0f;
@@ -93,26 +110,24 @@ float CTimer::GetElapsedMilliseconds() const
   return (float)(XbmcThreads::SystemClockMillis() - (m_endTime - m_timeout));
 }
 
-void CTimer::Process()
+void CTimer::OnExpired()
 {
-  while (!m_bStop)
   {
-    uint32_t currentTime = XbmcThreads::SystemClockMillis();
-    m_endTime = currentTime + m_timeout;
-
-    // wait the necessary time
-    if (!m_eventTimeout.WaitMSec(m_endTime - currentTime))
-    {
-      currentTime = XbmcThreads::SystemClockMillis();
-      if (m_endTime <= currentTime)
-      {
-        // execute OnTimeout() callback
-        m_callback();
-
-        // continue if this is an interval timer, or if it was restarted during callback
-        if (!m_interval && m_endTime <= currentTime)
-          break;
-      }
-    }
+    CSingleLock lock(m_critSection);
+    if (m_stopped)
+      return;
+    m_restarted = false;
+  }
+
+  // execute OnTimeout() callback
+  m_callback();
+
+  // continue if this is an interval timer, or if it was restarted during callback
+  CSingleLock lock(m_critSection);
+  if (!m_stopped && (m_interval || m_restarted))
+  {
+    m_restarted = false;
+    m_endTime = XbmcThreads::SystemClockMillis() + m_timeout;
+    CTimerWheel::GetInstance().Schedule(m_entry, m_timeout);
   }
-}
\ No newline at end of file
+}
@@ -21,8 +21,8 @@
 
 #include <functional>
 
-#include "Event.h"
-#include "Thread.h"
+#include "CriticalSection.h"
+#include "TimerWheel.h"
 
 class ITimerCallback
 {
@@ -32,30 +32,39 @@ public:
   virtual void OnTimeout() = 0;
 };
 
-class CTimer : protected CThread
+/*!
+ \brief One shot or interval timer.
+
+ Timers don't have a thread of their own, they are scheduled by CTimerWheel
+ and the callback runs as a job, so a slow callback doesn't delay other
+ timers.
+ */
+class CTimer
 {
 public:
   explicit CTimer(ITimerCallback *callback);
   explicit CTimer(std::function<void()> const& callback);
-  ~CTimer() override;
+  virtual ~CTimer();
 
   bool Start(uint32_t timeout, bool interval = false);
   bool Stop(bool wait = false);
   bool Restart();
   void RestartAsync(uint32_t timeout);
 
-  bool IsRunning() const { return CThread::IsRunning(); }
+  bool IsRunning() const;
 
   float GetElapsedSeconds() const;
   float GetElapsedMilliseconds() const;
   
-protected:
-  void Process() override;
-  
 private:
+  void OnExpired();
+
   std::function<void()> m_callback;
   uint32_t m_timeout;
   bool m_interval;
   uint32_t m_endTime;
-  CEvent m_eventTimeout;
+  bool m_stopped;
+  bool m_restarted;
+  CCriticalSection m_critSection;
+  CTimerWheel::CEntry m_entry;
 };
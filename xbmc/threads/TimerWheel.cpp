@@ -0,0 +1,426 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TimerWheel.h"
+#include "SingleLock.h"
+#include "SystemClock.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+#include <limits>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+// callbacks blocking the dispatcher thread for longer than this are logged
+#define SLOW_CALLBACK_MS 100
+
+/*!
+ \brief Runs the callback of an asynchronous entry.
+ The entry stops firing when the job is destroyed, which also happens if the
+ job manager drops the job without running it on shutdown.
+ */
+class CTimerWheel::CFireJob : public CJob
+{
+public:
+  CFireJob(CTimerWheel &wheel, CEntry &entry) : m_wheel(wheel), m_entry(entry) {}
+  ~CFireJob() override { m_wheel.Fired(m_entry); }
+
+  const char* GetType() const override { return "timer"; }
+  bool operator==(const CJob *job) const override { return this == job; }
+
+  bool DoWork() override
+  {
+    {
+      CSingleLock lock(m_wheel.m_section);
+      m_entry.m_firingThread = std::this_thread::get_id();
+    }
+    m_entry.m_callback();
+    return true;
+  }
+
+private:
+  CTimerWheel &m_wheel;
+  CEntry &m_entry;
+};
+
+CTimerWheel& CTimerWheel::GetInstance()
+{
+  // intentionally leaked: timers owned by globals are stopped during static
+  // destruction
+  static CTimerWheel* wheel = new CTimerWheel;
+  return *wheel;
+}
+
+CTimerWheel::CTimerWheel()
+  : CThread("TimerWheel"),
+    m_lastMillis(XbmcThreads::SystemClockMillis())
+{
+  for (unsigned int level = 0; level < LEVELS; level++)
+  {
+    m_occupied[level] = 0;
+    for (unsigned int slot = 0; slot < SLOTS; slot++)
+      m_slots[level][slot] = nullptr;
+  }
+}
+
+CTimerWheel::~CTimerWheel()
+{
+  {
+    CSingleLock lock(m_section);
+    m_bStop = true;
+    m_wakeup.notifyAll();
+  }
+  StopThread(true);
+}
+
+void CTimerWheel::Schedule(CEntry &entry, uint32_t delay)
+{
+  CSingleLock lock(m_section);
+  Unlink(entry);
+  entry.m_pending = false;
+  Advance(Now());
+  entry.m_expires = Now() + delay;
+  Insert(entry);
+
+  if (!IsRunning())
+    Create();
+  m_wakeup.notifyAll();
+}
+
+bool CTimerWheel::Reschedule(CEntry &entry, uint32_t delay)
+{
+  CSingleLock lock(m_section);
+  if (entry.m_level < 0 && !entry.m_pending)
+    return false;
+
+  Unlink(entry);
+  entry.m_pending = false;
+  Advance(Now());
+  entry.m_expires = Now() + delay;
+  Insert(entry);
+  m_wakeup.notifyAll();
+  return true;
+}
+
+bool CTimerWheel::Cancel(CEntry &entry, bool wait)
+{
+  CSingleLock lock(m_section);
+  bool scheduled = entry.m_level >= 0 || entry.m_pending;
+  Unlink(entry);
+  entry.m_pending = false;
+
+  if (wait)
+  {
+    // a callback cancelling its own timer must not wait for itself
+    while (entry.m_firing && entry.m_firingThread != std::this_thread::get_id())
+      m_fired.wait(lock);
+  }
+  return scheduled;
+}
+
+bool CTimerWheel::IsScheduled(const CEntry &entry) const
+{
+  CSingleLock lock(m_section);
+  return entry.m_level >= 0 || entry.m_pending;
+}
+
+bool CTimerWheel::IsFiring(const CEntry &entry) const
+{
+  CSingleLock lock(m_section);
+  return entry.m_firing;
+}
+
+CTimerWheel::Statistics CTimerWheel::GetStatistics() const
+{
+  CSingleLock lock(m_section);
+  return m_stats;
+}
+
+void CTimerWheel::LogStatistics() const
+{
+  const Statistics stats = GetStatistics();
+  CLog::Log(LOGDEBUG, "CTimerWheel: %u timers waiting (peak %u), fired %" PRIu64 " (%" PRIu64 " as jobs), "
+            "%" PRIu64 " late, average lateness %" PRIu64 " ms, max lateness %" PRIu64 " ms, slowest callback %" PRIu64 " ms",
+            stats.scheduled, stats.peakScheduled, stats.fired, stats.firedAsync, stats.late,
+            stats.fired > 0 ? stats.totalLatenessMs / stats.fired : 0, stats.maxLatenessMs, stats.maxCallbackMs);
+}
+
+void CTimerWheel::Process()
+{
+  CSingleLock lock(m_section);
+  while (!m_bStop)
+  {
+    Advance(Now());
+
+    while (m_ready && !m_bStop)
+    {
+      CEntry &entry = *m_ready;
+      Unlink(entry);
+      if (entry.m_firing)
+      {
+        // the job of the previous expiry is still running, it fires again
+        // once that one is done
+        entry.m_pending = true;
+        continue;
+      }
+
+      entry.m_firing = true;
+      const uint64_t now = Now();
+      const uint64_t lateness = now > entry.m_expires ? now - entry.m_expires : 0;
+      m_stats.fired++;
+      m_stats.totalLatenessMs += lateness;
+      if (lateness > m_stats.maxLatenessMs)
+        m_stats.maxLatenessMs = lateness;
+      if (lateness > LATE_THRESHOLD)
+        m_stats.late++;
+
+      if (entry.m_async)
+      {
+        // the job manager must not be called with our lock held, it destroys
+        // dropped jobs with its own lock held
+        lock.Leave();
+        CFireJob *job = new CFireJob(*this, entry);
+        const bool queued = CJobManager::GetInstance().AddJob(job, nullptr, CJob::PRIORITY_DEDICATED) != 0;
+        if (!queued)
+        {
+          // the job manager has been stopped, run it ourselves
+          job->DoWork();
+          delete job;
+        }
+        lock.Enter();
+
+        if (queued)
+          m_stats.firedAsync++;
+        continue;
+      }
+
+      entry.m_firingThread = std::this_thread::get_id();
+      lock.Leave();
+      entry.m_callback();
+      lock.Enter();
+
+      const uint64_t duration = Now() - now;
+      if (duration > m_stats.maxCallbackMs)
+        m_stats.maxCallbackMs = duration;
+      if (duration > SLOW_CALLBACK_MS)
+        CLog::Log(LOGDEBUG, "CTimerWheel: a timer callback blocked the dispatcher for %" PRIu64 " ms", duration);
+
+      entry.m_firing = false;
+      entry.m_firingThread = std::thread::id();
+      m_fired.notifyAll();
+    }
+
+    if (m_bStop)
+      break;
+
+    const uint64_t now = Now();
+    Advance(now);
+    if (m_ready)
+      continue;
+
+    const uint64_t next = NextExpiry();
+    if (next == std::numeric_limits<uint64_t>::max())
+      m_wakeup.wait(lock);
+    else if (next > now)
+      m_wakeup.wait(lock, static_cast<unsigned long>(next - now));
+  }
+}
+
+void CTimerWheel::Fired(CEntry &entry)
+{
+  CSingleLock lock(m_section);
+  entry.m_firing = false;
+  entry.m_firingThread = std::thread::id();
+  m_fired.notifyAll();
+
+  if (entry.m_pending)
+  {
+    // it is due already, keeping its expiry accounts for the delay as lateness
+    entry.m_pending = false;
+    Insert(entry);
+    m_wakeup.notifyAll();
+  }
+}
+
+uint64_t CTimerWheel::Now() const
+{
+  // called with m_section held
+  const unsigned int millis = XbmcThreads::SystemClockMillis();
+  m_now += millis - m_lastMillis;
+  m_lastMillis = millis;
+  return m_now;
+}
+
+void CTimerWheel::Insert(CEntry &entry)
+{
+  const uint64_t expires = entry.m_expires > m_current ? entry.m_expires : m_current;
+  const uint64_t delta = expires - m_current;
+
+  for (unsigned int level = 0; level < LEVELS; level++)
+  {
+    if (delta < (1ULL << (SLOT_BITS * (level + 1))))
+    {
+      Link(entry, level, (expires >> (SLOT_BITS * level)) & (SLOTS - 1));
+      return;
+    }
+  }
+
+  // beyond the range of the wheel, park it in the farthest slot, it is
+  // inserted again when that slot is cascaded
+  const uint64_t farthest = m_current + (1ULL << (SLOT_BITS * LEVELS)) - 1;
+  Link(entry, LEVELS - 1, (farthest >> (SLOT_BITS * (LEVELS - 1))) & (SLOTS - 1));
+}
+
+void CTimerWheel::Link(CEntry &entry, int level, unsigned int slot)
+{
+  entry.m_level = level;
+  entry.m_slot = slot;
+
+  if (level == LEVEL_READY)
+  {
+    // keep due timers in the order they expired
+    entry.m_prev = m_readyTail;
+    entry.m_next = nullptr;
+    if (m_readyTail)
+      m_readyTail->m_next = &entry;
+    else
+      m_ready = &entry;
+    m_readyTail = &entry;
+  }
+  else
+  {
+    CEntry *&head = m_slots[level][slot];
+    entry.m_prev = nullptr;
+    entry.m_next = head;
+    if (head)
+      head->m_prev = &entry;
+    head = &entry;
+    m_occupied[level] |= 1ULL << slot;
+  }
+
+  m_stats.scheduled++;
+  if (m_stats.scheduled > m_stats.peakScheduled)
+    m_stats.peakScheduled = m_stats.scheduled;
+}
+
+void CTimerWheel::Unlink(CEntry &entry)
+{
+  if (entry.m_level < 0)
+    return;
+
+  if (entry.m_level == LEVEL_READY)
+  {
+    if (entry.m_prev)
+      entry.m_prev->m_next = entry.m_next;
+    else
+      m_ready = entry.m_next;
+    if (entry.m_next)
+      entry.m_next->m_prev = entry.m_prev;
+    else
+      m_readyTail = entry.m_prev;
+  }
+  else
+  {
+    CEntry *&head = m_slots[entry.m_level][entry.m_slot];
+    if (entry.m_prev)
+      entry.m_prev->m_next = entry.m_next;
+    else
+      head = entry.m_next;
+    if (entry.m_next)
+      entry.m_next->m_prev = entry.m_prev;
+    if (!head)
+      m_occupied[entry.m_level] &= ~(1ULL << entry.m_slot);
+  }
+
+  entry.m_level = -1;
+  entry.m_prev = entry.m_next = nullptr;
+  m_stats.scheduled--;
+}
+
+void CTimerWheel::Cascade(unsigned int level)
+{
+  const unsigned int slot = (m_current >> (SLOT_BITS * level)) & (SLOTS - 1);
+  while (CEntry *entry = m_slots[level][slot])
+  {
+    Unlink(*entry);
+    Insert(*entry);
+  }
+}
+
+void CTimerWheel::Advance(uint64_t now)
+{
+  while (m_current <= now)
+  {
+    // the slots of the upper levels are redistributed when the lower
+    // levels wrap around, farthest first
+    unsigned int cascade = 0;
+    while (cascade + 1 < LEVELS && (m_current & ((1ULL << (SLOT_BITS * (cascade + 1))) - 1)) == 0)
+      cascade++;
+    for (unsigned int level = cascade; level > 0; level--)
+      Cascade(level);
+
+    const unsigned int slot = m_current & (SLOTS - 1);
+    while (CEntry *entry = m_slots[0][slot])
+    {
+      Unlink(*entry);
+      Link(*entry, LEVEL_READY, 0);
+    }
+    m_current++;
+
+    // nothing can happen before the next wrap around of the highest empty
+    // level, skip the ticks in between
+    uint64_t granularity = 1;
+    for (unsigned int level = 0; level < LEVELS && m_occupied[level] == 0; level++)
+      granularity = 1ULL << (SLOT_BITS * (level + 1));
+    if (granularity > 1)
+    {
+      const uint64_t next = (m_current + granularity - 1) & ~(granularity - 1);
+      m_current = next < now + 1 ? next : now + 1;
+    }
+  }
+}
+
+uint64_t CTimerWheel::NextExpiry() const
+{
+  if (m_ready)
+    return m_current;
+
+  uint64_t next = std::numeric_limits<uint64_t>::max();
+  for (unsigned int level = 0; level < LEVELS; level++)
+  {
+    if (m_occupied[level] == 0)
+      continue;
+
+    // the tick at which a slot is processed (level 0) or cascaded
+    const unsigned int shift = SLOT_BITS * level;
+    const uint64_t block = (m_current + (1ULL << shift) - 1) >> shift;
+    for (unsigned int slot = 0; slot < SLOTS; slot++)
+    {
+      if ((m_occupied[level] & (1ULL << slot)) == 0)
+        continue;
+
+      const uint64_t tick = (block + ((slot - block) & (SLOTS - 1))) << shift;
+      if (tick < next)
+        next = tick;
+    }
+  }
+  return next;
+}
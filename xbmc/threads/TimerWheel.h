@@ -0,0 +1,153 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <functional>
+#include <stdint.h>
+#include <thread>
+
+#include "Condition.h"
+#include "CriticalSection.h"
+#include "Thread.h"
+
+/*!
+ \brief Process wide timer service running all timers on a single thread.
+
+ Timers are kept in a hierarchical timing wheel with a resolution of one
+ millisecond: scheduling and cancelling are O(1) and the dispatcher thread
+ only wakes up when the next timer is due.
+
+ Callbacks of synchronous entries run on the dispatcher thread one after the
+ other, so they have to be short. Callbacks of asynchronous entries run as
+ dedicated jobs of the CJobManager and may block.
+ */
+class CTimerWheel : private CThread
+{
+public:
+  class CEntry
+  {
+  public:
+    /*!
+     \param callback called when the timer expires
+     \param async run the callback as a job instead of on the dispatcher thread
+     */
+    explicit CEntry(std::function<void()> const& callback, bool async = false)
+      : m_callback(callback), m_async(async) {}
+    CEntry(const CEntry&) = delete;
+    CEntry& operator=(const CEntry&) = delete;
+
+  private:
+    friend class CTimerWheel;
+
+    std::function<void()> m_callback;
+    bool m_async;
+
+    uint64_t m_expires = 0;
+    int m_level = -1; //!< wheel level, LEVEL_READY when due or -1 when not scheduled
+    unsigned int m_slot = 0;
+    CEntry *m_prev = nullptr;
+    CEntry *m_next = nullptr;
+
+    bool m_firing = false;
+    bool m_pending = false; //!< expired while its callback was still running
+    std::thread::id m_firingThread;
+  };
+
+  struct Statistics
+  {
+    unsigned int scheduled = 0;       //!< timers currently waiting
+    unsigned int peakScheduled = 0;   //!< most timers waiting at the same time
+    uint64_t fired = 0;
+    uint64_t firedAsync = 0;
+    uint64_t late = 0;                //!< timers fired more than LATE_THRESHOLD ms after they were due
+    uint64_t totalLatenessMs = 0;
+    uint64_t maxLatenessMs = 0;
+    uint64_t maxCallbackMs = 0;       //!< longest callback run on the dispatcher thread
+  };
+
+  static CTimerWheel& GetInstance();
+
+  /*!
+   \brief Schedule the entry to expire after the given delay, an entry that is
+   already scheduled is moved.
+   */
+  void Schedule(CEntry &entry, uint32_t delay);
+
+  /*!
+   \brief Move an entry that is still waiting to expire after the given delay.
+   \return false if the entry isn't waiting (e.g. because it is firing right now)
+   */
+  bool Reschedule(CEntry &entry, uint32_t delay);
+
+  /*!
+   \brief Cancel the entry.
+   \param wait wait for a running callback of the entry to return, unless it
+   is the calling thread that runs it
+   \return true if the entry was waiting
+   */
+  bool Cancel(CEntry &entry, bool wait);
+
+  bool IsScheduled(const CEntry &entry) const;
+  bool IsFiring(const CEntry &entry) const;
+
+  Statistics GetStatistics() const;
+  void LogStatistics() const;
+
+  static const unsigned int LATE_THRESHOLD = 10;
+
+protected:
+  void Process() override;
+
+private:
+  CTimerWheel();
+  ~CTimerWheel() override;
+
+  static const unsigned int LEVELS = 4;
+  static const unsigned int SLOT_BITS = 6;
+  static const unsigned int SLOTS = 1 << SLOT_BITS;
+  static const int LEVEL_READY = LEVELS;
+
+  uint64_t Now() const;
+  void Insert(CEntry &entry);
+  void Unlink(CEntry &entry);
+  void Link(CEntry &entry, int level, unsigned int slot);
+  void Cascade(unsigned int level);
+  void Advance(uint64_t now);
+  uint64_t NextExpiry() const;
+  void Fired(CEntry &entry);
+
+  class CFireJob;
+
+  mutable CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_wakeup;
+  XbmcThreads::ConditionVariable m_fired;
+
+  // ticks follow SystemClockMillis(), so a timer never fires early for
+  // callers measuring time with it; extended to 64 bits across its wrap around
+  mutable unsigned int m_lastMillis;
+  mutable uint64_t m_now = 0;
+  uint64_t m_current = 0; //!< first tick that hasn't been processed yet
+  CEntry *m_slots[LEVELS][SLOTS];
+  uint64_t m_occupied[LEVELS];
+  CEntry *m_ready = nullptr;
+  CEntry *m_readyTail = nullptr;
+
+  Statistics m_stats;
+};
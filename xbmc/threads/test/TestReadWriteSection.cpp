@@ -0,0 +1,293 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/ReadWriteSection.h"
+#include "threads/Event.h"
+#include "threads/test/TestHelpers.h"
+
+#include <memory>
+#include <vector>
+
+//=============================================================================
+// Helper classes
+//=============================================================================
+
+template<class L>
+class rwlocker : public IRunnable
+{
+  CReadWriteSection& sec;
+  CEvent* wait;
+
+  std::atomic<long>* mutex;
+public:
+  volatile bool haslock;
+  volatile bool obtainedlock;
+
+  inline rwlocker(CReadWriteSection& o, std::atomic<long>* mutex_ = NULL, CEvent* wait_ = NULL) :
+    sec(o), wait(wait_), mutex(mutex_), haslock(false), obtainedlock(false) {}
+
+  void Run() override
+  {
+    AtomicGuard g(mutex);
+    L lock(sec);
+    haslock = true;
+    obtainedlock = true;
+    if (wait)
+      wait->Wait();
+    haslock = false;
+  }
+};
+
+class rwstress : public IRunnable
+{
+  CReadWriteSection& sec;
+  std::atomic<bool>& stop;
+  std::atomic<long>& shared;
+  bool writer;
+
+public:
+  unsigned long iterations;
+  bool consistent;
+
+  inline rwstress(CReadWriteSection& o, std::atomic<bool>& stop_, std::atomic<long>& shared_, bool writer_) :
+    sec(o), stop(stop_), shared(shared_), writer(writer_), iterations(0), consistent(true) {}
+
+  void Run() override
+  {
+    while (!stop)
+    {
+      if (writer)
+      {
+        CWriteLock lock(sec);
+        long value = ++shared;
+        // nobody else may touch the value while we hold the exclusive lock
+        if (shared != value)
+          consistent = false;
+        --shared;
+      }
+      else
+      {
+        CReadLock lock(sec);
+        CReadLock recursive(sec);
+        if (shared != 0)
+          consistent = false;
+      }
+      iterations++;
+    }
+  }
+};
+
+//=============================================================================
+
+TEST(TestReadWriteSection, General)
+{
+  CReadWriteSection sec;
+
+  CReadLock l1(sec);
+  CReadLock l2(sec);
+}
+
+TEST(TestReadWriteSection, RecursiveExclusive)
+{
+  CReadWriteSection sec;
+
+  CWriteLock l1(sec);
+  CWriteLock l2(sec);
+  CReadLock l3(sec); // the exclusive owner may also read
+
+  CReadWriteSection::Statistics stats = sec.GetStatistics();
+  EXPECT_EQ(1u, stats.exclusiveHolders);
+  EXPECT_EQ(1u, stats.sharedHolders);
+  EXPECT_EQ(2u, stats.exclusiveAcquisitions);
+  EXPECT_EQ(0u, stats.exclusiveContentions);
+}
+
+TEST(TestReadWriteSection, TryLock)
+{
+  CReadWriteSection sec;
+
+  {
+    CReadLock l1(sec);
+    EXPECT_FALSE(sec.try_lock());
+    EXPECT_TRUE(sec.try_lock_shared());
+    sec.unlock_shared();
+  }
+
+  EXPECT_TRUE(sec.try_lock());
+  sec.unlock();
+}
+
+TEST(TestReadWriteSection, WriterPreferenceBlocksNewReaders)
+{
+  std::atomic<long> mutex(0L);
+  CEvent event;
+
+  CReadWriteSection sec(nullptr, CReadWriteSection::Preference::WRITERS);
+
+  CReadLock l1(sec); // get a shared lock
+
+  rwlocker<CWriteLock> l2(sec, &mutex);
+  thread waitThread1(l2); // try to get an exclusive lock
+
+  EXPECT_TRUE(waitForThread(mutex, 1, 10000));
+  SleepMillis(10);
+
+  EXPECT_TRUE(!l2.obtainedlock);  // the writer is waiting ...
+
+  // ... so a new reader has to queue up behind it
+  rwlocker<CReadLock> l3(sec, &mutex, &event);
+  thread waitThread3(l3);
+  EXPECT_TRUE(waitForThread(mutex, 2, 10000));
+  SleepMillis(10);
+  EXPECT_TRUE(!l3.obtainedlock);
+
+  // a recursive read from a thread that already holds the lock still works
+  {
+    CReadLock recursive(sec);
+    EXPECT_TRUE(recursive.IsOwner());
+  }
+
+  l1.Leave(); // the last shared lock leaves.
+
+  EXPECT_TRUE(waitThread1.timed_join(MILLIS(10000)));
+  EXPECT_TRUE(l2.obtainedlock);
+
+  event.Set();
+  EXPECT_TRUE(waitThread3.timed_join(MILLIS(10000)));
+  EXPECT_TRUE(l3.obtainedlock);
+
+  CReadWriteSection::Statistics stats = sec.GetStatistics();
+  EXPECT_EQ(1u, stats.exclusiveContentions);
+  EXPECT_EQ(1u, stats.sharedContentions);
+  EXPECT_EQ(0u, stats.sharedHolders);
+  EXPECT_EQ(0u, stats.waitingWriters);
+}
+
+TEST(TestReadWriteSection, ReaderPreferenceAdmitsNewReaders)
+{
+  std::atomic<long> mutex(0L);
+  CEvent event;
+
+  CReadWriteSection sec(nullptr, CReadWriteSection::Preference::READERS);
+
+  CReadLock l1(sec);
+
+  rwlocker<CWriteLock> l2(sec, &mutex);
+  thread waitThread1(l2);
+
+  EXPECT_TRUE(waitForThread(mutex, 1, 10000));
+  SleepMillis(10);
+  EXPECT_TRUE(!l2.obtainedlock);
+
+  rwlocker<CReadLock> l3(sec, &mutex, &event);
+  thread waitThread3(l3);
+  EXPECT_TRUE(waitForThread(mutex, 2, 10000));
+  SleepMillis(10);
+  EXPECT_TRUE(l3.haslock);
+
+  event.Set();
+  EXPECT_TRUE(waitThread3.timed_join(MILLIS(10000)));
+  EXPECT_TRUE(!l2.obtainedlock);
+
+  l1.Leave();
+
+  EXPECT_TRUE(waitThread1.timed_join(MILLIS(10000)));
+  EXPECT_TRUE(l2.obtainedlock);
+}
+
+static CReadWriteSection::Statistics GetNamedStatistics(const std::string& name)
+{
+  for (const auto& stats : CReadWriteSection::GetAllStatistics())
+  {
+    if (stats.name == name)
+      return stats;
+  }
+  return CReadWriteSection::Statistics();
+}
+
+TEST(TestReadWriteSection, NamedSectionsAreAggregated)
+{
+  {
+    CReadWriteSection sec1("TestReadWriteSection.Aggregated");
+    CReadWriteSection sec2("TestReadWriteSection.Aggregated");
+
+    { CReadLock lock(sec1); }
+    CWriteLock lock(sec2);
+
+    CReadWriteSection::Statistics stats = GetNamedStatistics("TestReadWriteSection.Aggregated");
+    EXPECT_EQ("TestReadWriteSection.Aggregated", stats.name);
+    EXPECT_EQ(2u, stats.instances);
+    EXPECT_EQ(1u, stats.sharedAcquisitions);
+    EXPECT_EQ(1u, stats.exclusiveAcquisitions);
+    EXPECT_EQ(0u, stats.sharedHolders);
+    EXPECT_EQ(1u, stats.exclusiveHolders);
+  }
+
+  // the name stays registered with the counters of the destroyed sections
+  CReadWriteSection::Statistics stats = GetNamedStatistics("TestReadWriteSection.Aggregated");
+  EXPECT_EQ(0u, stats.instances);
+  EXPECT_EQ(1u, stats.sharedAcquisitions);
+  EXPECT_EQ(0u, stats.exclusiveHolders);
+}
+
+static void RunStress(CReadWriteSection::Preference preference)
+{
+  static const int NUM_READERS = 8;
+  static const int NUM_WRITERS = 2;
+
+  CReadWriteSection sec(nullptr, preference);
+  std::atomic<bool> stop(false);
+  std::atomic<long> shared(0L);
+
+  std::vector<std::unique_ptr<rwstress>> workers;
+  std::vector<std::unique_ptr<thread>> threads;
+  for (int i = 0; i < NUM_READERS + NUM_WRITERS; i++)
+  {
+    workers.emplace_back(new rwstress(sec, stop, shared, i < NUM_WRITERS));
+    threads.emplace_back(new thread(*workers.back()));
+  }
+
+  SleepMillis(500);
+  stop = true;
+
+  unsigned long reads = 0;
+  unsigned long writes = 0;
+  for (int i = 0; i < NUM_READERS + NUM_WRITERS; i++)
+  {
+    EXPECT_TRUE(threads[i]->timed_join(MILLIS(10000)));
+    EXPECT_TRUE(workers[i]->consistent);
+    (i < NUM_WRITERS ? writes : reads) += workers[i]->iterations;
+  }
+
+  EXPECT_GT(reads, 0u);
+  // with writer preference a steady stream of readers must not starve the writers
+  if (preference == CReadWriteSection::Preference::WRITERS)
+    EXPECT_GT(writes, 0u);
+}
+
+TEST(TestReadWriteSection, StressWriterPreference)
+{
+  RunStress(CReadWriteSection::Preference::WRITERS);
+}
+
+TEST(TestReadWriteSection, StressReaderPreference)
+{
+  RunStress(CReadWriteSection::Preference::READERS);
+}
@@ -0,0 +1,294 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Event.h"
+#include "threads/SystemClock.h"
+#include "threads/Timer.h"
+#include "threads/TimerWheel.h"
+#include "threads/test/TestHelpers.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#if defined(TARGET_LINUX)
+#include <dirent.h>
+#endif
+
+TEST(TestTimer, OneShot)
+{
+  CEvent fired;
+  CTimer timer([&fired]() { fired.Set(); });
+
+  EXPECT_FALSE(timer.IsRunning());
+  EXPECT_TRUE(timer.Start(20));
+  EXPECT_TRUE(timer.IsRunning());
+  EXPECT_FALSE(timer.Start(20)); // already running
+
+  EXPECT_TRUE(fired.WaitMSec(10000));
+  SleepMillis(10);
+  EXPECT_FALSE(timer.IsRunning());
+}
+
+TEST(TestTimer, Interval)
+{
+  std::atomic<int> count(0);
+  CTimer timer([&count]() { count++; });
+
+  EXPECT_TRUE(timer.Start(10, true));
+  for (int i = 0; i < 10000 && count < 3; i++)
+    SleepMillis(1);
+  EXPECT_GE(count, 3);
+
+  EXPECT_TRUE(timer.Stop(true));
+  EXPECT_FALSE(timer.IsRunning());
+  const int stopped = count;
+  SleepMillis(50);
+  EXPECT_EQ(stopped, count);
+}
+
+TEST(TestTimer, Stop)
+{
+  std::atomic<int> count(0);
+  CTimer timer([&count]() { count++; });
+
+  EXPECT_FALSE(timer.Stop());
+  EXPECT_TRUE(timer.Start(50));
+  EXPECT_TRUE(timer.Stop());
+  SleepMillis(100);
+  EXPECT_EQ(0, count);
+}
+
+TEST(TestTimer, StopFromCallback)
+{
+  std::atomic<int> count(0);
+  std::unique_ptr<CTimer> timer;
+  timer.reset(new CTimer([&]()
+  {
+    // must neither deadlock nor fire again
+    if (++count == 2)
+      timer->Stop(true);
+  }));
+
+  EXPECT_TRUE(timer->Start(5, true));
+  for (int i = 0; i < 10000 && timer->IsRunning(); i++)
+    SleepMillis(1);
+  EXPECT_FALSE(timer->IsRunning());
+  EXPECT_EQ(2, count);
+}
+
+TEST(TestTimer, RestartAsync)
+{
+  CEvent fired;
+  unsigned int firedAt = 0;
+  CTimer timer([&]() { firedAt = XbmcThreads::SystemClockMillis(); fired.Set(); });
+
+  const unsigned int start = XbmcThreads::SystemClockMillis();
+  EXPECT_TRUE(timer.Start(50));
+  SleepMillis(30);
+  timer.RestartAsync(100); // now fires 130ms after the start
+
+  EXPECT_TRUE(fired.WaitMSec(10000));
+  EXPECT_GE(firedAt - start, 120u);
+}
+
+TEST(TestTimer, RestartAsyncFromCallback)
+{
+  std::atomic<int> count(0);
+  std::unique_ptr<CTimer> timer;
+  timer.reset(new CTimer([&]()
+  {
+    // a one shot timer restarted from its callback fires again
+    if (++count == 1)
+      timer->RestartAsync(10);
+  }));
+
+  EXPECT_TRUE(timer->Start(10));
+  for (int i = 0; i < 10000 && count < 2; i++)
+    SleepMillis(1);
+  SleepMillis(50);
+  EXPECT_EQ(2, count);
+  EXPECT_FALSE(timer->IsRunning());
+}
+
+TEST(TestTimer, SlowCallback)
+{
+  CEvent release;
+  CEvent entered;
+  CTimer slow([&]() { entered.Set(); release.WaitMSec(10000); });
+  CEvent fired;
+  CTimer fast([&fired]() { fired.Set(); });
+
+  // a callback that blocks must not delay the callbacks of other timers
+  EXPECT_TRUE(slow.Start(1));
+  EXPECT_TRUE(entered.WaitMSec(10000));
+  EXPECT_TRUE(fast.Start(10));
+  EXPECT_TRUE(fired.WaitMSec(1000));
+  EXPECT_TRUE(slow.IsRunning());
+
+  release.Set();
+  EXPECT_TRUE(slow.Stop(true));
+  EXPECT_FALSE(slow.IsRunning());
+}
+
+#if defined(TARGET_LINUX)
+static int CountThreads()
+{
+  DIR *dir = opendir("/proc/self/task");
+  if (!dir)
+    return -1;
+  int count = 0;
+  while (struct dirent *entry = readdir(dir))
+  {
+    if (entry->d_name[0] != '.')
+      count++;
+  }
+  closedir(dir);
+  return count;
+}
+
+// Every waiting timer used to sleep on a thread of its own
+TEST(TestTimer, NoThreadPerTimer)
+{
+  static const int NUM_TIMERS = 100;
+
+  // the dispatcher thread is started with the first timer
+  CTimer first([]() {});
+  EXPECT_TRUE(first.Start(60000));
+  const int threads = CountThreads();
+  ASSERT_GT(threads, 0);
+
+  std::vector<std::unique_ptr<CTimer>> timers;
+  for (int i = 0; i < NUM_TIMERS; i++)
+  {
+    timers.emplace_back(new CTimer([]() {}));
+    EXPECT_TRUE(timers.back()->Start(60000 + i));
+  }
+  EXPECT_EQ(threads, CountThreads());
+
+  RecordProperty("Timers", NUM_TIMERS + 1);
+  RecordProperty("Threads", CountThreads());
+}
+#endif
+
+// Many timers with delays spread over several levels of the wheel must all
+// fire, none of them early
+TEST(TestTimerWheel, ManyTimers)
+{
+  static const int NUM_TIMERS = 500;
+
+  std::vector<unsigned int> delays;
+  std::vector<unsigned int> elapsed(NUM_TIMERS, 0);
+  std::vector<std::unique_ptr<CTimerWheel::CEntry>> entries;
+  std::atomic<int> fired(0);
+
+  const unsigned int start = XbmcThreads::SystemClockMillis();
+  unsigned int seed = 1;
+  for (int i = 0; i < NUM_TIMERS; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    delays.push_back(1 + (seed >> 16) % 5000);
+    entries.emplace_back(new CTimerWheel::CEntry([&, i]()
+    {
+      elapsed[i] = XbmcThreads::SystemClockMillis() - start;
+      fired++;
+    }));
+  }
+
+  for (int i = 0; i < NUM_TIMERS; i++)
+    CTimerWheel::GetInstance().Schedule(*entries[i], delays[i]);
+
+  for (int i = 0; i < 20000 && fired < NUM_TIMERS; i++)
+    SleepMillis(1);
+  EXPECT_EQ(NUM_TIMERS, fired);
+
+  for (int i = 0; i < NUM_TIMERS; i++)
+    EXPECT_GE(elapsed[i], delays[i]) << "timer " << i;
+}
+
+TEST(TestTimerWheel, Cancel)
+{
+  std::atomic<int> count(0);
+  CTimerWheel::CEntry entry([&count]() { count++; });
+
+  CTimerWheel::GetInstance().Schedule(entry, 20);
+  EXPECT_TRUE(CTimerWheel::GetInstance().IsScheduled(entry));
+  EXPECT_TRUE(CTimerWheel::GetInstance().Cancel(entry, true));
+  EXPECT_FALSE(CTimerWheel::GetInstance().IsScheduled(entry));
+  EXPECT_FALSE(CTimerWheel::GetInstance().Reschedule(entry, 10));
+  SleepMillis(50);
+  EXPECT_EQ(0, count);
+}
+
+TEST(TestTimerWheel, CancelWaitsForCallback)
+{
+  CEvent entered;
+  CEvent release;
+  std::atomic<bool> done(false);
+  CTimerWheel::CEntry entry([&]()
+  {
+    entered.Set();
+    release.WaitMSec(100);
+    done = true;
+  });
+
+  CTimerWheel::GetInstance().Schedule(entry, 1);
+  EXPECT_TRUE(entered.WaitMSec(10000));
+  EXPECT_FALSE(CTimerWheel::GetInstance().Cancel(entry, true));
+  EXPECT_TRUE(done);
+}
+
+// An entry that is due while its callback still runs as a job waits for the
+// callback to return and fires again right after it
+TEST(TestTimerWheel, DueWhileFiring)
+{
+  CEvent release;
+  std::atomic<int> count(0);
+  std::atomic<bool> running(false);
+  std::atomic<bool> overlapped(false);
+  CTimerWheel::CEntry entry([&]()
+  {
+    if (running.exchange(true))
+      overlapped = true;
+    if (++count == 1)
+    {
+      CTimerWheel::GetInstance().Schedule(entry, 1);
+      release.WaitMSec(10000);
+    }
+    running = false;
+  }, true);
+
+  CTimerWheel::GetInstance().Schedule(entry, 1);
+  for (int i = 0; i < 10000 && count < 1; i++)
+    SleepMillis(1);
+  SleepMillis(50);
+  EXPECT_EQ(1, count);
+  EXPECT_TRUE(CTimerWheel::GetInstance().IsScheduled(entry));
+  EXPECT_TRUE(CTimerWheel::GetInstance().IsFiring(entry));
+
+  release.Set();
+  for (int i = 0; i < 10000 && count < 2; i++)
+    SleepMillis(1);
+  SleepMillis(50);
+  EXPECT_EQ(2, count);
+  EXPECT_FALSE(overlapped);
+  EXPECT_FALSE(CTimerWheel::GetInstance().IsScheduled(entry));
+  CTimerWheel::GetInstance().Cancel(entry, true);
+}
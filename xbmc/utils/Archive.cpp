@@ -61,6 +61,27 @@ CArchive::CArchive(CFile* pFile, int mode)
   }
 }
 
+CArchive::CArchive(const uint8_t* data, size_t size)
+{
+  m_pFile = nullptr;
+  m_iMode = load;
+
+  // read straight from the memory, there is nothing to buffer
+  m_BufferPos = const_cast<uint8_t*>(data);
+  m_BufferRemain = size;
+}
+
+CArchive::CArchive(std::vector<uint8_t>& data)
+{
+  m_pFile = nullptr;
+  m_pData = &data;
+  m_iMode = store;
+
+  m_pBuffer = std::unique_ptr<uint8_t[]>(new uint8_t[CARCHIVE_BUFFER_MAX]);
+  m_BufferPos = m_pBuffer.get();
+  m_BufferRemain = CARCHIVE_BUFFER_MAX;
+}
+
 CArchive::~CArchive()
 {
   FlushBuffer();
@@ -408,7 +429,13 @@ void CArchive::FlushBuffer()
 {
   if (m_iMode == store && m_BufferPos != m_pBuffer.get())
   {
-    if (m_pFile->Write(m_pBuffer.get(), m_BufferPos - m_pBuffer.get()) != m_BufferPos - m_pBuffer.get())
+    if (m_pData)
+    {
+      m_pData->insert(m_pData->end(), m_pBuffer.get(), m_BufferPos);
+      m_BufferPos = m_pBuffer.get();
+      m_BufferRemain = CARCHIVE_BUFFER_MAX;
+    }
+    else if (m_pFile->Write(m_pBuffer.get(), m_BufferPos - m_pBuffer.get()) != m_BufferPos - m_pBuffer.get())
       CLog::Log(LOGERROR, "%s: Error flushing buffer", __FUNCTION__);
     else
     {
@@ -435,7 +462,7 @@ CArchive &CArchive::streamout_bufferwrap(const uint8_t *ptr, size_t size)
 
 void CArchive::FillBuffer()
 {
-  if (m_iMode == load && m_BufferRemain == 0)
+  if (m_iMode == load && m_BufferRemain == 0 && m_pFile)
   {
     auto read = m_pFile->Read(m_pBuffer.get(), CARCHIVE_BUFFER_MAX);
     if (read > 0)
@@ -38,6 +38,17 @@ class CArchive
 {
 public:
   CArchive(XFILE::CFile* pFile, int mode);
+
+  /*!
+   \brief Load from a block of memory, which has to stay valid while loading
+   */
+  CArchive(const uint8_t* data, size_t size);
+
+  /*!
+   \brief Store by appending to a block of memory
+   */
+  explicit CArchive(std::vector<uint8_t>& data);
+
   ~CArchive();
 
   /* CArchive support storing and loading of all C basic integer types
@@ -180,6 +191,7 @@ protected:
   }
 
   XFILE::CFile* m_pFile; //non-owning
+  std::vector<uint8_t>* m_pData = nullptr; //non-owning, stored to instead of m_pFile
   int m_iMode;
   std::unique_ptr<uint8_t[]> m_pBuffer;
   uint8_t *m_BufferPos;
@@ -35,6 +35,7 @@
 #include "settings/lib/Setting.h"
 #include "settings/Settings.h"
 #include "utils/StringUtils.h"
+#include "utils/UnicodeConverter.h"
 #include "utils/Utf8Utils.h"
 
 #ifdef WORDS_BIGENDIAN
@@ -286,6 +287,96 @@ enum StdConversionType /* Keep it in sync with CCharsetConverter::CInnerConverte
   NumberOfStdConversionTypes /* Dummy sentinel entry */
 };
 
+#ifdef WORDS_BIGENDIAN
+  #define UTF16LE_IS_SWAPPED true
+#else
+  #define UTF16LE_IS_SWAPPED false
+#endif
+
+/* Conversions between the Unicode encodings are done by CUnicodeConverter without
+   iconv and without locking. Each returns false if the conversion is left to iconv. */
+template<class INPUT,class OUTPUT>
+static bool nativeConvert(StdConversionType, const INPUT&, OUTPUT&, bool, bool&)
+{
+  return false;
+}
+
+static bool isNativeUtf8Source(const std::string& strSource)
+{
+#if defined(TARGET_DARWIN)
+  return CUnicodeConverter::IsAscii(strSource); // UTF-8-MAC composes decomposed characters
+#else
+  return true;
+#endif
+}
+
+static bool nativeConvert(StdConversionType convertType, const std::string& strSource, std::u32string& strDest, bool failOnInvalidChar, bool& result)
+{
+  if (convertType != Utf8ToUtf32 || !isNativeUtf8Source(strSource))
+    return false;
+  result = CUnicodeConverter::Utf8ToUtf32(strSource, strDest, failOnInvalidChar);
+  return true;
+}
+
+static bool nativeConvert(StdConversionType convertType, const std::string& strSource, std::wstring& strDest, bool failOnInvalidChar, bool& result)
+{
+  if (convertType != Utf8toW || !isNativeUtf8Source(strSource))
+    return false;
+  result = CUnicodeConverter::Utf8ToW(strSource, strDest, failOnInvalidChar);
+  return true;
+}
+
+static bool nativeConvert(StdConversionType convertType, const std::u32string& strSource, std::string& strDest, bool failOnInvalidChar, bool& result)
+{
+  if (convertType != Utf32ToUtf8)
+    return false;
+  result = CUnicodeConverter::Utf32ToUtf8(strSource, strDest, failOnInvalidChar);
+  return true;
+}
+
+static bool nativeConvert(StdConversionType convertType, const std::u32string& strSource, std::wstring& strDest, bool failOnInvalidChar, bool& result)
+{
+  if (convertType != Utf32ToW)
+    return false;
+  result = CUnicodeConverter::Utf32ToW(strSource, strDest, failOnInvalidChar);
+  return true;
+}
+
+static bool nativeConvert(StdConversionType convertType, const std::wstring& strSource, std::string& strDest, bool failOnInvalidChar, bool& result)
+{
+  if (convertType != WtoUtf8)
+    return false;
+  result = CUnicodeConverter::WToUtf8(strSource, strDest, failOnInvalidChar);
+  return true;
+}
+
+static bool nativeConvert(StdConversionType convertType, const std::wstring& strSource, std::u32string& strDest, bool failOnInvalidChar, bool& result)
+{
+  if (convertType != WToUtf32)
+    return false;
+  result = CUnicodeConverter::WToUtf32(strSource, strDest, failOnInvalidChar);
+  return true;
+}
+
+static bool nativeConvert(StdConversionType convertType, const std::u16string& strSource, std::string& strDest, bool failOnInvalidChar, bool& result)
+{
+  if (convertType == Utf16LEtoUtf8)
+    result = CUnicodeConverter::Utf16ToUtf8(strSource, strDest, failOnInvalidChar, UTF16LE_IS_SWAPPED);
+  else if (convertType == Utf16BEtoUtf8)
+    result = CUnicodeConverter::Utf16ToUtf8(strSource, strDest, failOnInvalidChar, !UTF16LE_IS_SWAPPED);
+  else
+    return false; // UCS-2 has no surrogate pairs
+  return true;
+}
+
+static bool nativeConvert(StdConversionType convertType, const std::u16string& strSource, std::wstring& strDest, bool failOnInvalidChar, bool& result)
+{
+  if (convertType != Utf16LEtoW)
+    return false;
+  result = CUnicodeConverter::Utf16ToW(strSource, strDest, failOnInvalidChar, UTF16LE_IS_SWAPPED);
+  return true;
+}
+
 /* We don't want to pollute header file with many additional includes and definitions, so put 
    here all staff that require usage of types defined in this file or in additional headers */
 class CCharsetConverter::CInnerConverter
@@ -343,6 +434,10 @@ bool CCharsetConverter::CInnerConverter::stdConvert(StdConversionType convertTyp
   if (convertType < 0 || convertType >= NumberOfStdConversionTypes)
     return false;
 
+  bool result;
+  if (nativeConvert(convertType, strSource, strDest, failOnInvalidChar, result))
+    return result;
+
   CConverterType& convType = m_stdConversion[convertType];
   CSingleLock converterLock(convType);
 
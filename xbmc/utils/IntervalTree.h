@@ -0,0 +1,232 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+/*!
+ \brief Closed intervals [start, end] with a value each, queried for the
+ intervals overlapping or containing a given interval.
+
+ The intervals are kept in a treap ordered by start, every node knowing the
+ largest end below it, so insert, erase and queries take O(log n) expected
+ time plus the number of intervals reported. Key only needs operator<.
+ Intervals with the same start, end and value may be added more than once.
+ */
+template<typename Key, typename Value>
+class CIntervalTree
+{
+public:
+  CIntervalTree() = default;
+  CIntervalTree(const CIntervalTree&) = delete;
+  CIntervalTree& operator=(const CIntervalTree&) = delete;
+
+  void Insert(const Key& start, const Key& end, const Value& value)
+  {
+    std::unique_ptr<Node> node(new Node(start, end, value, NextPriority()));
+    Insert(m_root, node);
+    ++m_size;
+  }
+
+  /*!
+   \brief Remove one interval with the given start, end and value
+   \return true if it was found, false otherwise
+   */
+  bool Erase(const Key& start, const Key& end, const Value& value)
+  {
+    if (!Erase(m_root, start, end, value))
+      return false;
+    --m_size;
+    return true;
+  }
+
+  /*!
+   \brief Call f(start, end, value) for every interval sharing at least one
+   point with [start, end], in order of start
+   */
+  template<typename F>
+  void ForEachOverlapping(const Key& start, const Key& end, F f) const
+  {
+    Visit(m_root.get(), end, start, f);
+  }
+
+  /*!
+   \brief Call f(start, end, value) for every interval containing all of
+   [start, end], in order of start
+   */
+  template<typename F>
+  void ForEachContaining(const Key& start, const Key& end, F f) const
+  {
+    Visit(m_root.get(), start, end, f);
+  }
+
+  size_t Size() const { return m_size; }
+  bool IsEmpty() const { return m_size == 0; }
+
+  void Clear()
+  {
+    m_root.reset();
+    m_size = 0;
+  }
+
+private:
+  struct Node
+  {
+    Node(const Key& s, const Key& e, const Value& v, uint32_t p)
+      : start(s), end(e), maxEnd(e), value(v), priority(p) {}
+
+    Key start;
+    Key end;
+    Key maxEnd; //!< largest end of this node and the nodes below it
+    Value value;
+    uint32_t priority;
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> right;
+  };
+
+  static void Update(Node& node)
+  {
+    node.maxEnd = node.end;
+    if (node.left && node.maxEnd < node.left->maxEnd)
+      node.maxEnd = node.left->maxEnd;
+    if (node.right && node.maxEnd < node.right->maxEnd)
+      node.maxEnd = node.right->maxEnd;
+  }
+
+  static void RotateRight(std::unique_ptr<Node>& root)
+  {
+    std::unique_ptr<Node> left(std::move(root->left));
+    root->left = std::move(left->right);
+    Update(*root);
+    left->right = std::move(root);
+    root = std::move(left);
+    Update(*root);
+  }
+
+  static void RotateLeft(std::unique_ptr<Node>& root)
+  {
+    std::unique_ptr<Node> right(std::move(root->right));
+    root->right = std::move(right->left);
+    Update(*root);
+    right->left = std::move(root);
+    root = std::move(right);
+    Update(*root);
+  }
+
+  static void Insert(std::unique_ptr<Node>& root, std::unique_ptr<Node>& node)
+  {
+    if (!root)
+    {
+      root = std::move(node);
+      return;
+    }
+
+    if (node->start < root->start)
+    {
+      Insert(root->left, node);
+      if (root->left->priority > root->priority)
+        RotateRight(root);
+    }
+    else
+    {
+      Insert(root->right, node);
+      if (root->right->priority > root->priority)
+        RotateLeft(root);
+    }
+    Update(*root);
+  }
+
+  static void EraseRoot(std::unique_ptr<Node>& root)
+  {
+    if (!root->left)
+      root = std::move(root->right);
+    else if (!root->right)
+      root = std::move(root->left);
+    else if (root->left->priority > root->right->priority)
+    {
+      RotateRight(root);
+      EraseRoot(root->right);
+      Update(*root);
+    }
+    else
+    {
+      RotateLeft(root);
+      EraseRoot(root->left);
+      Update(*root);
+    }
+  }
+
+  static bool Erase(std::unique_ptr<Node>& root, const Key& start, const Key& end, const Value& value)
+  {
+    if (!root)
+      return false;
+
+    bool erased;
+    if (start < root->start)
+      erased = Erase(root->left, start, end, value);
+    else if (root->start < start)
+      erased = Erase(root->right, start, end, value);
+    else if (!(root->end < end) && !(end < root->end) && root->value == value)
+    {
+      EraseRoot(root);
+      return true;
+    }
+    else
+    {
+      // rotations may have moved intervals with the same start to either side
+      erased = Erase(root->left, start, end, value) || Erase(root->right, start, end, value);
+    }
+
+    if (erased)
+      Update(*root);
+    return erased;
+  }
+
+  //! visit the intervals with start <= maxStart and end >= minEnd
+  template<typename F>
+  static void Visit(const Node* node, const Key& maxStart, const Key& minEnd, F& f)
+  {
+    while (node && !(node->maxEnd < minEnd))
+    {
+      Visit(node->left.get(), maxStart, minEnd, f);
+      if (maxStart < node->start)
+        return;
+      if (!(node->end < minEnd))
+        f(node->start, node->end, node->value);
+      node = node->right.get();
+    }
+  }
+
+  uint32_t NextPriority()
+  {
+    // xorshift, a fixed sequence keeps the shape of the tree reproducible
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+    return m_seed;
+  }
+
+  std::unique_ptr<Node> m_root;
+  size_t m_size = 0;
+  uint32_t m_seed = 2463534242u;
+};
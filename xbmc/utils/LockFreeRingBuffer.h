@@ -0,0 +1,97 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <stddef.h>
+#include <vector>
+
+/*!
+ \brief Fixed number of slots passed from one producer thread to one consumer
+ thread without locking.
+
+ Slots are reused, so a producer can fill them without allocating. The
+ producer never waits for the consumer: if all slots are taken, it gets none
+ and has to drop its data.
+ */
+template<typename T>
+class CLockFreeRingBuffer
+{
+public:
+  explicit CLockFreeRingBuffer(size_t size) : m_slots(size) {}
+
+  CLockFreeRingBuffer(const CLockFreeRingBuffer&) = delete;
+  CLockFreeRingBuffer& operator=(const CLockFreeRingBuffer&) = delete;
+
+  /*!
+   \brief Producer: get the slot to fill next
+   \return the slot, nullptr if all slots are taken
+   */
+  T* GetWriteSlot()
+  {
+    const size_t write = m_write.load(std::memory_order_relaxed);
+    if (write - m_read.load(std::memory_order_acquire) >= m_slots.size())
+      return nullptr;
+    return &m_slots[write % m_slots.size()];
+  }
+
+  /*!
+   \brief Producer: pass the slot returned by GetWriteSlot() to the consumer
+   */
+  void Commit()
+  {
+    m_write.store(m_write.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  /*!
+   \brief Consumer: get the oldest filled slot
+   \return the slot, nullptr if there is none
+   */
+  T* GetReadSlot()
+  {
+    const size_t read = m_read.load(std::memory_order_relaxed);
+    if (read == m_write.load(std::memory_order_acquire))
+      return nullptr;
+    return &m_slots[read % m_slots.size()];
+  }
+
+  /*!
+   \brief Consumer: give the slot returned by GetReadSlot() back to the producer
+   */
+  void Release()
+  {
+    m_read.store(m_read.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  /*!
+   \brief Consumer: drop all filled slots
+   */
+  void Clear()
+  {
+    m_read.store(m_write.load(std::memory_order_acquire), std::memory_order_release);
+  }
+
+  size_t Size() const { return m_slots.size(); }
+
+private:
+  std::vector<T> m_slots;
+  std::atomic<size_t> m_write{0}; //!< slots committed, written by the producer only
+  std::atomic<size_t> m_read{0};  //!< slots released, written by the consumer only
+};
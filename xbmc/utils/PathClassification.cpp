@@ -0,0 +1,106 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PathClassification.h"
+#include "URIUtils.h"
+
+CPathClassification::CPathClassification(const CPathClassification &other)
+  : m_known(other.m_known.load(std::memory_order_acquire)),
+    m_values(other.m_values.load(std::memory_order_relaxed))
+{
+}
+
+CPathClassification& CPathClassification::operator=(const CPathClassification &other)
+{
+  if (this == &other)
+    return *this;
+
+  const uint32_t known = other.m_known.load(std::memory_order_acquire);
+  const uint32_t values = other.m_values.load(std::memory_order_relaxed);
+  m_known.store(0, std::memory_order_relaxed);
+  m_values.store(values, std::memory_order_relaxed);
+  m_known.store(known, std::memory_order_release);
+  return *this;
+}
+
+void CPathClassification::Reset()
+{
+  m_known.store(0, std::memory_order_relaxed);
+  m_values.store(0, std::memory_order_relaxed);
+}
+
+unsigned int CPathClassification::GetEvaluatedCount() const
+{
+  unsigned int count = 0;
+  for (uint32_t known = m_known.load(std::memory_order_acquire); known; known &= known - 1)
+    count++;
+  return count;
+}
+
+bool CPathClassification::Evaluate(Flag flag, const std::string &path) const
+{
+  const bool value = Classify(flag, path);
+
+  // publish the value before marking it as known, racing threads evaluate
+  // the same value so there's no need to lock
+  if (value)
+    m_values.fetch_or(flag, std::memory_order_relaxed);
+  m_known.fetch_or(flag, std::memory_order_release);
+  return value;
+}
+
+bool CPathClassification::Classify(Flag flag, const std::string &path)
+{
+  switch (flag)
+  {
+  case REMOTE:                 return URIUtils::IsRemote(path);
+  case SMB:                    return URIUtils::IsSmb(path);
+  case NFS:                    return URIUtils::IsNfs(path);
+  case HD:                     return URIUtils::IsHD(path);
+  case URL:                    return URIUtils::IsURL(path);
+  case INTERNET_STREAM:        return URIUtils::IsInternetStream(path, false);
+  case INTERNET_STREAM_STRICT: return URIUtils::IsInternetStream(path, true);
+  case ARCHIVE:                return URIUtils::IsArchive(path);
+  case IN_ARCHIVE:             return URIUtils::IsInArchive(path);
+  case IN_RAR:                 return URIUtils::IsInRAR(path);
+  case IN_ZIP:                 return URIUtils::IsInZIP(path);
+  case RAR:                    return URIUtils::IsRAR(path);
+  case ZIP:                    return URIUtils::IsZIP(path);
+  case APK:                    return URIUtils::IsAPK(path);
+  case STACK:                  return URIUtils::IsStack(path);
+  case MULTI_PATH:             return URIUtils::IsMultiPath(path);
+  case PLUGIN:                 return URIUtils::IsPlugin(path);
+  case SCRIPT:                 return URIUtils::IsScript(path);
+  case ADDONS_PATH:            return URIUtils::IsAddonsPath(path);
+  case SOURCES_PATH:           return URIUtils::IsSourcesPath(path);
+  case ANDROID_APP:            return URIUtils::IsAndroidApp(path);
+  case CDDA:                   return URIUtils::IsCDDA(path);
+  case ISO9660:                return URIUtils::IsISO9660(path);
+  case BLURAY:                 return URIUtils::IsBluray(path);
+  case UPNP:                   return URIUtils::IsUPnP(path);
+  case FTP:                    return URIUtils::IsFTP(path);
+  case LIVE_TV:                return URIUtils::IsLiveTV(path);
+  case PVR_GUIDE_ITEM:         return URIUtils::IsPVRGuideItem(path);
+  case MUSIC_DB:               return URIUtils::IsMusicDb(path);
+  case VIDEO_DB:               return URIUtils::IsVideoDb(path);
+  case LIBRARY_FOLDER:         return URIUtils::IsLibraryFolder(path);
+  }
+  return false;
+}
@@ -0,0 +1,117 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+/*!
+ \brief Memoized URIUtils classification of a path.
+
+ The URIUtils predicates parse the path, and for stack://, multipath:// and
+ special:// paths also the paths they point to, on every call. Owners of a
+ path that is asked the same questions over and over (e.g. CFileItem, which
+ is classified several times per GUI frame and per scanned file) keep one of
+ these next to the path: each predicate is evaluated once and remembered until
+ Reset() is called because the path changed.
+
+ Only predicates that depend on nothing but the path are cached, IsOnLAN() and
+ the drive type checks of IsDVD()/IsOnDVD() ask the system and are not.
+
+ Lookups are lock free and may happen from several threads at once, changing
+ the path isn't thread safe anyway.
+ */
+class CPathClassification
+{
+public:
+  enum Flag : uint32_t
+  {
+    REMOTE                 = 1u << 0,
+    SMB                    = 1u << 1,
+    NFS                    = 1u << 2,
+    HD                     = 1u << 3,
+    URL                    = 1u << 4,
+    INTERNET_STREAM        = 1u << 5,
+    INTERNET_STREAM_STRICT = 1u << 6,
+    ARCHIVE                = 1u << 7,
+    IN_ARCHIVE             = 1u << 8,
+    IN_RAR                 = 1u << 9,
+    IN_ZIP                 = 1u << 10,
+    RAR                    = 1u << 11,
+    ZIP                    = 1u << 12,
+    APK                    = 1u << 13,
+    STACK                  = 1u << 14,
+    MULTI_PATH             = 1u << 15,
+    PLUGIN                 = 1u << 16,
+    SCRIPT                 = 1u << 17,
+    ADDONS_PATH            = 1u << 18,
+    SOURCES_PATH           = 1u << 19,
+    ANDROID_APP            = 1u << 20,
+    CDDA                   = 1u << 21,
+    ISO9660                = 1u << 22,
+    BLURAY                 = 1u << 23,
+    UPNP                   = 1u << 24,
+    FTP                    = 1u << 25,
+    LIVE_TV                = 1u << 26,
+    PVR_GUIDE_ITEM         = 1u << 27,
+    MUSIC_DB               = 1u << 28,
+    VIDEO_DB               = 1u << 29,
+    LIBRARY_FOLDER         = 1u << 30,
+  };
+
+  CPathClassification() = default;
+  CPathClassification(const CPathClassification &other);
+  CPathClassification& operator=(const CPathClassification &other);
+
+  /*!
+   \brief Check the path for the given flag, evaluating it on first use.
+   \param path the path, which has to be the same for all calls until the next Reset()
+   */
+  bool Is(Flag flag, const std::string &path) const
+  {
+    const uint32_t known = m_known.load(std::memory_order_acquire);
+    if (known & flag)
+      return (m_values.load(std::memory_order_relaxed) & flag) != 0;
+    return Evaluate(flag, path);
+  }
+
+  /*!
+   \brief Forget all flags, to be called whenever the path changes.
+   */
+  void Reset();
+
+  /*!
+   \brief Number of flags evaluated since the last Reset(), every other lookup
+   was answered from the cache.
+   */
+  unsigned int GetEvaluatedCount() const;
+
+  /*!
+   \brief Evaluate a flag with URIUtils, bypassing the cache.
+   */
+  static bool Classify(Flag flag, const std::string &path);
+
+private:
+  bool Evaluate(Flag flag, const std::string &path) const;
+
+  mutable std::atomic<uint32_t> m_known{0};
+  mutable std::atomic<uint32_t> m_values{0};
+};
@@ -0,0 +1,415 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "UnicodeConverter.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#define UNICODE_CONVERTER_SSE2 1
+#endif
+
+namespace
+{
+
+inline uint16_t Swap16(uint16_t unit)
+{
+  return static_cast<uint16_t>((unit << 8) | (unit >> 8));
+}
+
+#ifdef UNICODE_CONVERTER_SSE2
+inline unsigned int FirstSetBit(unsigned int mask)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+/* Decoders return the number of code units of the next character, 0 if the
+   input at that position is invalid */
+
+// well-formed UTF-8 as per table 3-7 of the Unicode standard, no overlong
+// forms, surrogates or code points beyond U+10FFFF
+inline size_t DecodeUtf8(const unsigned char* str, size_t avail, char32_t& cp)
+{
+  const unsigned char c = str[0];
+  if (c < 0x80)
+  {
+    cp = c;
+    return 1;
+  }
+  if (c < 0xC2)
+    return 0;
+  if (c < 0xE0)
+  {
+    if (avail < 2 || (str[1] & 0xC0) != 0x80)
+      return 0;
+    cp = ((c & 0x1F) << 6) | (str[1] & 0x3F);
+    return 2;
+  }
+  if (c < 0xF0)
+  {
+    if (avail < 3)
+      return 0;
+    const unsigned char low = c == 0xE0 ? 0xA0 : 0x80;
+    const unsigned char high = c == 0xED ? 0x9F : 0xBF;
+    if (str[1] < low || str[1] > high || (str[2] & 0xC0) != 0x80)
+      return 0;
+    cp = ((c & 0x0F) << 12) | ((str[1] & 0x3F) << 6) | (str[2] & 0x3F);
+    return 3;
+  }
+  if (c < 0xF5)
+  {
+    if (avail < 4)
+      return 0;
+    const unsigned char low = c == 0xF0 ? 0x90 : 0x80;
+    const unsigned char high = c == 0xF4 ? 0x8F : 0xBF;
+    if (str[1] < low || str[1] > high || (str[2] & 0xC0) != 0x80 || (str[3] & 0xC0) != 0x80)
+      return 0;
+    cp = ((c & 0x07) << 18) | ((str[1] & 0x3F) << 12) | ((str[2] & 0x3F) << 6) | (str[3] & 0x3F);
+    return 4;
+  }
+  return 0;
+}
+
+inline size_t DecodeUtf16(const uint16_t* str, size_t avail, bool swapped, char32_t& cp)
+{
+  const uint16_t unit = swapped ? Swap16(str[0]) : str[0];
+  if (unit < 0xD800 || unit > 0xDFFF)
+  {
+    cp = unit;
+    return 1;
+  }
+  if (unit > 0xDBFF || avail < 2)
+    return 0;
+  const uint16_t low = swapped ? Swap16(str[1]) : str[1];
+  if (low < 0xDC00 || low > 0xDFFF)
+    return 0;
+  cp = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+  return 2;
+}
+
+inline size_t DecodeUtf32(const uint32_t* str, char32_t& cp)
+{
+  const uint32_t unit = str[0];
+  if ((unit >= 0xD800 && unit <= 0xDFFF) || unit > 0x10FFFF)
+    return 0;
+  cp = unit;
+  return 1;
+}
+
+/* Encoders return the number of code units written */
+
+inline size_t EncodeUtf8(char32_t cp, unsigned char* out)
+{
+  if (cp < 0x80)
+  {
+    out[0] = static_cast<unsigned char>(cp);
+    return 1;
+  }
+  if (cp < 0x800)
+  {
+    out[0] = static_cast<unsigned char>(0xC0 | (cp >> 6));
+    out[1] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+    return 2;
+  }
+  if (cp < 0x10000)
+  {
+    out[0] = static_cast<unsigned char>(0xE0 | (cp >> 12));
+    out[1] = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+    out[2] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+    return 3;
+  }
+  out[0] = static_cast<unsigned char>(0xF0 | (cp >> 18));
+  out[1] = static_cast<unsigned char>(0x80 | ((cp >> 12) & 0x3F));
+  out[2] = static_cast<unsigned char>(0x80 | ((cp >> 6) & 0x3F));
+  out[3] = static_cast<unsigned char>(0x80 | (cp & 0x3F));
+  return 4;
+}
+
+inline size_t EncodeUtf16(char32_t cp, uint16_t* out)
+{
+  if (cp < 0x10000)
+  {
+    out[0] = static_cast<uint16_t>(cp);
+    return 1;
+  }
+  cp -= 0x10000;
+  out[0] = static_cast<uint16_t>(0xD800 + (cp >> 10));
+  out[1] = static_cast<uint16_t>(0xDC00 + (cp & 0x3FF));
+  return 2;
+}
+
+inline size_t EncodeUtf32(char32_t cp, uint32_t* out)
+{
+  out[0] = cp;
+  return 1;
+}
+
+/* ASCII runs, return the number of characters copied */
+
+// UTF-8 to 16 or 32 bit units
+template<typename UNIT>
+size_t WidenAscii(const unsigned char* in, size_t length, UNIT* out)
+{
+  size_t pos = 0;
+#ifdef UNICODE_CONVERTER_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  for (; pos + 16 <= length; pos += 16)
+  {
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + pos));
+    if (_mm_movemask_epi8(chars) != 0)
+      break; // the rest of the block is copied one by one
+    const __m128i low = _mm_unpacklo_epi8(chars, zero);
+    const __m128i high = _mm_unpackhi_epi8(chars, zero);
+    if (sizeof(UNIT) == 2)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + pos), low);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + pos + 8), high);
+    }
+    else
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + pos), _mm_unpacklo_epi16(low, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + pos + 4), _mm_unpackhi_epi16(low, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + pos + 8), _mm_unpacklo_epi16(high, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + pos + 12), _mm_unpackhi_epi16(high, zero));
+    }
+  }
+#endif
+  for (; pos < length && in[pos] < 0x80; pos++)
+    out[pos] = in[pos];
+  return pos;
+}
+
+// 16 or 32 bit units to UTF-8
+template<typename UNIT>
+size_t NarrowAscii(const UNIT* in, size_t length, bool swapped, unsigned char* out)
+{
+  size_t pos = 0;
+#ifdef UNICODE_CONVERTER_SSE2
+  if (!swapped)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i nonAscii = sizeof(UNIT) == 2 ? _mm_set1_epi16(static_cast<short>(0xFF80)) : _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+    const size_t unitsPerBlock = 16 / sizeof(UNIT) * 2;
+    for (; pos + unitsPerBlock <= length; pos += unitsPerBlock)
+    {
+      const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + pos));
+      const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + pos + unitsPerBlock / 2));
+      const __m128i high = _mm_and_si128(_mm_or_si128(a, b), nonAscii);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(high, zero)) != 0xFFFF)
+        break;
+      if (sizeof(UNIT) == 2)
+      {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + pos), _mm_packus_epi16(a, b));
+      }
+      else
+      {
+        const __m128i packed = _mm_packs_epi32(a, b);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + pos), _mm_packus_epi16(packed, packed));
+      }
+    }
+  }
+#endif
+  for (; pos < length; pos++)
+  {
+    const uint32_t unit = sizeof(UNIT) == 2 && swapped ? Swap16(static_cast<uint16_t>(in[pos])) : static_cast<uint32_t>(in[pos]);
+    if (unit >= 0x80)
+      break;
+    out[pos] = static_cast<unsigned char>(unit);
+  }
+  return pos;
+}
+
+template<typename IN, typename OUT>
+inline size_t CopyAscii(const IN*, size_t, bool, OUT*)
+{
+  return 0;
+}
+
+template<>
+inline size_t CopyAscii(const unsigned char* in, size_t length, bool, uint16_t* out)
+{
+  return WidenAscii(in, length, out);
+}
+
+template<>
+inline size_t CopyAscii(const unsigned char* in, size_t length, bool, uint32_t* out)
+{
+  return WidenAscii(in, length, out);
+}
+
+template<>
+inline size_t CopyAscii(const uint16_t* in, size_t length, bool swapped, unsigned char* out)
+{
+  return NarrowAscii(in, length, swapped, out);
+}
+
+template<>
+inline size_t CopyAscii(const uint32_t* in, size_t length, bool swapped, unsigned char* out)
+{
+  return NarrowAscii(in, length, swapped, out);
+}
+
+inline size_t Decode(const unsigned char* in, size_t avail, bool, char32_t& cp) { return DecodeUtf8(in, avail, cp); }
+inline size_t Decode(const uint16_t* in, size_t avail, bool swapped, char32_t& cp) { return DecodeUtf16(in, avail, swapped, cp); }
+inline size_t Decode(const uint32_t* in, size_t, bool, char32_t& cp) { return DecodeUtf32(in, cp); }
+
+inline size_t Encode(char32_t cp, unsigned char* out) { return EncodeUtf8(cp, out); }
+inline size_t Encode(char32_t cp, uint16_t* out) { return EncodeUtf16(cp, out); }
+inline size_t Encode(char32_t cp, uint32_t* out) { return EncodeUtf32(cp, out); }
+
+template<typename UNIT>
+struct Unit
+{
+  typedef typename std::conditional<sizeof(UNIT) == 1, unsigned char,
+          typename std::conditional<sizeof(UNIT) == 2, uint16_t, uint32_t>::type>::type type;
+};
+
+template<class INPUT, class OUTPUT>
+bool Convert(const INPUT& source, OUTPUT& dest, bool failOnInvalidChar, bool swapped)
+{
+  typedef typename Unit<typename INPUT::value_type>::type InUnit;
+  typedef typename Unit<typename OUTPUT::value_type>::type OutUnit;
+
+  dest.clear();
+  const size_t length = source.length();
+  if (length == 0)
+    return true;
+
+  // every input unit takes at most this many output units, a character
+  // needing 4 bytes in UTF-8 needs 2 units in UTF-16
+  const size_t maxUnits = sizeof(OutUnit) == 1 ? (sizeof(InUnit) == 2 ? 3 : 4) :
+                          (sizeof(InUnit) == 4 && sizeof(OutUnit) == 2 ? 2 : 1);
+  dest.resize(length * maxUnits);
+
+  const InUnit* in = reinterpret_cast<const InUnit*>(source.data());
+  OutUnit* out = reinterpret_cast<OutUnit*>(&dest[0]);
+  size_t inPos = 0;
+  size_t outPos = 0;
+  while (inPos < length)
+  {
+    const size_t ascii = CopyAscii(in + inPos, length - inPos, swapped, out + outPos);
+    inPos += ascii;
+    outPos += ascii;
+    if (inPos == length)
+      break;
+
+    char32_t cp;
+    const size_t used = Decode(in + inPos, length - inPos, swapped, cp);
+    if (used == 0)
+    {
+      if (failOnInvalidChar)
+      {
+        dest.clear();
+        return false;
+      }
+      inPos++; // skip invalid unit
+      continue;
+    }
+    inPos += used;
+    outPos += Encode(cp, out + outPos);
+  }
+
+  dest.resize(outPos);
+  return true;
+}
+
+}
+
+bool CUnicodeConverter::Utf8ToUtf32(const std::string& utf8, std::u32string& utf32, bool failOnInvalidChar)
+{
+  return Convert(utf8, utf32, failOnInvalidChar, false);
+}
+
+bool CUnicodeConverter::Utf8ToUtf16(const std::string& utf8, std::u16string& utf16, bool failOnInvalidChar)
+{
+  return Convert(utf8, utf16, failOnInvalidChar, false);
+}
+
+bool CUnicodeConverter::Utf8ToW(const std::string& utf8, std::wstring& wide, bool failOnInvalidChar)
+{
+  return Convert(utf8, wide, failOnInvalidChar, false);
+}
+
+bool CUnicodeConverter::Utf32ToUtf8(const std::u32string& utf32, std::string& utf8, bool failOnInvalidChar)
+{
+  return Convert(utf32, utf8, failOnInvalidChar, false);
+}
+
+bool CUnicodeConverter::Utf32ToW(const std::u32string& utf32, std::wstring& wide, bool failOnInvalidChar)
+{
+  return Convert(utf32, wide, failOnInvalidChar, false);
+}
+
+bool CUnicodeConverter::WToUtf8(const std::wstring& wide, std::string& utf8, bool failOnInvalidChar)
+{
+  return Convert(wide, utf8, failOnInvalidChar, false);
+}
+
+bool CUnicodeConverter::WToUtf32(const std::wstring& wide, std::u32string& utf32, bool failOnInvalidChar)
+{
+  return Convert(wide, utf32, failOnInvalidChar, false);
+}
+
+bool CUnicodeConverter::Utf16ToUtf8(const std::u16string& utf16, std::string& utf8, bool failOnInvalidChar, bool swapped /* = false */)
+{
+  return Convert(utf16, utf8, failOnInvalidChar, swapped);
+}
+
+bool CUnicodeConverter::Utf16ToW(const std::u16string& utf16, std::wstring& wide, bool failOnInvalidChar, bool swapped /* = false */)
+{
+  return Convert(utf16, wide, failOnInvalidChar, swapped);
+}
+
+size_t CUnicodeConverter::AsciiLength(const char* str, size_t length)
+{
+  const unsigned char* in = reinterpret_cast<const unsigned char*>(str);
+  size_t pos = 0;
+#ifdef UNICODE_CONVERTER_SSE2
+  for (; pos + 16 <= length; pos += 16)
+  {
+    const int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + pos)));
+    if (mask != 0)
+      return pos + FirstSetBit(mask);
+  }
+#endif
+  for (; pos + 8 <= length; pos += 8)
+  {
+    uint64_t chars;
+    memcpy(&chars, in + pos, sizeof(chars));
+    if (chars & 0x8080808080808080ULL)
+      break;
+  }
+  while (pos < length && in[pos] < 0x80)
+    pos++;
+  return pos;
+}
@@ -0,0 +1,61 @@
+#pragma once
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+
+/*!
+ \brief Conversions between the Unicode encodings without iconv.
+
+ Used by CCharsetConverter for the UTF-8, UTF-16, UTF-32 and wchar_t pairs,
+ iconv is only needed for legacy charsets. The converters neither lock nor
+ allocate beyond the destination string, runs of ASCII characters are copied
+ with SSE2 when available.
+
+ Invalid input is handled like CCharsetConverter does with iconv: with
+ failOnInvalidChar the conversion fails and the destination is cleared,
+ otherwise invalid UTF-8 is skipped byte by byte and invalid UTF-16/UTF-32
+ (unpaired surrogates, code points beyond U+10FFFF) unit by unit.
+ wchar_t strings are UTF-16 where wchar_t has 16 bits and UTF-32 elsewhere.
+ */
+class CUnicodeConverter
+{
+public:
+  static bool Utf8ToUtf32(const std::string& utf8, std::u32string& utf32, bool failOnInvalidChar);
+  static bool Utf8ToUtf16(const std::string& utf8, std::u16string& utf16, bool failOnInvalidChar);
+  static bool Utf8ToW(const std::string& utf8, std::wstring& wide, bool failOnInvalidChar);
+
+  static bool Utf32ToUtf8(const std::u32string& utf32, std::string& utf8, bool failOnInvalidChar);
+  static bool Utf32ToW(const std::u32string& utf32, std::wstring& wide, bool failOnInvalidChar);
+  static bool WToUtf8(const std::wstring& wide, std::string& utf8, bool failOnInvalidChar);
+  static bool WToUtf32(const std::wstring& wide, std::u32string& utf32, bool failOnInvalidChar);
+
+  /*!
+   \param swapped the code units are in the opposite byte order of the machine
+   */
+  static bool Utf16ToUtf8(const std::u16string& utf16, std::string& utf8, bool failOnInvalidChar, bool swapped = false);
+  static bool Utf16ToW(const std::u16string& utf16, std::wstring& wide, bool failOnInvalidChar, bool swapped = false);
+
+  /*!
+   \brief Length of the run of ASCII characters at the start of the string.
+   */
+  static size_t AsciiLength(const char* str, size_t length);
+  static bool IsAscii(const std::string& str) { return AsciiLength(str.c_str(), str.length()) == str.length(); }
+};
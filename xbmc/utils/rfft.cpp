@@ -25,10 +25,84 @@
 #endif
 #include <math.h>
 
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#define RFFT_SSE2 1
+#endif
+
+// Below this size the radix-2 path isn't worth the setup
+#define RFFT_MIN_RADIX2_SIZE 8
+
 RFFT::RFFT(int size, bool windowed) :
-  m_size(size), m_windowed(windowed)
+  RFFT(size, windowed ? Window::HANN : Window::NONE)
 {
-  m_cfg = kiss_fftr_alloc(m_size,0,nullptr,nullptr);
+}
+
+RFFT::RFFT(int size, Window window) :
+  m_size(size), m_window(window), m_scale(2.0f / size)
+{
+  if (m_window != Window::NONE)
+  {
+    m_windowData.resize(m_size);
+    double sum = 0.0;
+    for (size_t i = 0; i < m_size; ++i)
+    {
+      const double phase = 2 * M_PI * i / (m_size - 1);
+      double w;
+      switch (m_window)
+      {
+      case Window::HAMMING:
+        w = 0.54 - 0.46 * cos(phase);
+        break;
+      case Window::BLACKMAN:
+        w = 0.42 - 0.5 * cos(phase) + 0.08 * cos(2 * phase);
+        break;
+      case Window::HANN:
+      default:
+        w = 0.5 * (1.0 - cos(phase));
+        break;
+      }
+      m_windowData[i] = static_cast<float>(w);
+      sum += w * w;
+    }
+    // keep the energy of the signal, sqrt(8/3) for a Hann window
+    if (sum > 0.0)
+      m_scale *= static_cast<float>(sqrt(m_size / sum));
+  }
+
+  if (m_size < RFFT_MIN_RADIX2_SIZE || (m_size & (m_size - 1)) != 0)
+  {
+    m_cfg = kiss_fftr_alloc(m_size,0,nullptr,nullptr);
+    return;
+  }
+
+  unsigned int bits = 0;
+  while ((1u << bits) < m_size)
+    bits++;
+
+  m_bitrev.resize(m_size);
+  for (size_t i = 0; i < m_size; ++i)
+  {
+    uint32_t reversed = 0;
+    for (unsigned int b = 0; b < bits; ++b)
+      reversed |= ((i >> b) & 1) << (bits - 1 - b);
+    m_bitrev[i] = reversed;
+  }
+
+  m_twiddleRe.resize(m_size);
+  m_twiddleIm.resize(m_size);
+  for (size_t half = 1; half < m_size; half <<= 1)
+  {
+    for (size_t j = 0; j < half; ++j)
+    {
+      const double phase = -M_PI * j / half;
+      m_twiddleRe[half + j] = static_cast<float>(cos(phase));
+      m_twiddleIm[half + j] = static_cast<float>(sin(phase));
+    }
+  }
+
+  m_re.resize(m_size);
+  m_im.resize(m_size);
 }
 
 RFFT::~RFFT()
@@ -37,10 +111,147 @@ RFFT::~RFFT()
   // its hardcoded to free and doesn't pay attention
   // to SIMD (which might be used during kiss_fftr_alloc
   //in the C'tor).
-  KISS_FFT_FREE(m_cfg);
+  if (m_cfg)
+    KISS_FFT_FREE(m_cfg);
 }
 
 void RFFT::calc(const float* input, float* output)
+{
+  if (m_cfg)
+  {
+    calcKiss(input, output);
+    return;
+  }
+
+  // left channel as real, right channel as imaginary part, in bit reversed
+  // order for the transform
+  if (m_windowData.empty())
+  {
+    for (size_t i = 0; i < m_size; ++i)
+    {
+      m_re[m_bitrev[i]] = input[2*i];
+      m_im[m_bitrev[i]] = input[2*i+1];
+    }
+  }
+  else
+  {
+    for (size_t i = 0; i < m_size; ++i)
+    {
+      m_re[m_bitrev[i]] = input[2*i] * m_windowData[i];
+      m_im[m_bitrev[i]] = input[2*i+1] * m_windowData[i];
+    }
+  }
+
+  transform();
+
+  // separate the channels: L[k] = (X[k] + conj(X[N-k])) / 2 and
+  // R[k] = (X[k] - conj(X[N-k])) / 2i, interleave their magnitudes
+  const float scale = 0.5f * m_scale;
+  const float* re = m_re.data();
+  const float* im = m_im.data();
+
+  output[0] = fabsf(re[0]) * 2 * scale;
+  output[1] = fabsf(im[0]) * 2 * scale;
+
+  size_t k = 1;
+#ifdef RFFT_SSE2
+  const __m128 vscale = _mm_set1_ps(scale);
+  for (; k + 4 <= m_size / 2; k += 4)
+  {
+    // X[N-k] for k..k+3 are at N-k-3..N-k in reverse order
+    const __m128 xr = _mm_loadu_ps(re + k);
+    const __m128 xi = _mm_loadu_ps(im + k);
+    const __m128 nr = _mm_shuffle_ps(_mm_loadu_ps(re + m_size - k - 3), _mm_loadu_ps(re + m_size - k - 3), _MM_SHUFFLE(0, 1, 2, 3));
+    const __m128 ni = _mm_shuffle_ps(_mm_loadu_ps(im + m_size - k - 3), _mm_loadu_ps(im + m_size - k - 3), _MM_SHUFFLE(0, 1, 2, 3));
+
+    const __m128 lr = _mm_add_ps(xr, nr);
+    const __m128 li = _mm_sub_ps(xi, ni);
+    const __m128 rr = _mm_add_ps(xi, ni);
+    const __m128 ri = _mm_sub_ps(nr, xr);
+
+    const __m128 left = _mm_mul_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(lr, lr), _mm_mul_ps(li, li))), vscale);
+    const __m128 right = _mm_mul_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(rr, rr), _mm_mul_ps(ri, ri))), vscale);
+
+    _mm_storeu_ps(output + 2*k, _mm_unpacklo_ps(left, right));
+    _mm_storeu_ps(output + 2*k + 4, _mm_unpackhi_ps(left, right));
+  }
+#endif
+  for (; k < m_size / 2; ++k)
+  {
+    const float lr = re[k] + re[m_size - k];
+    const float li = im[k] - im[m_size - k];
+    const float rr = im[k] + im[m_size - k];
+    const float ri = re[m_size - k] - re[k];
+    output[2*k] = sqrtf(lr*lr + li*li) * scale;
+    output[2*k+1] = sqrtf(rr*rr + ri*ri) * scale;
+  }
+}
+
+void RFFT::transform()
+{
+  float* re = m_re.data();
+  float* im = m_im.data();
+  const size_t n = m_size;
+
+  // first two stages have trivial twiddle factors (1 and -i)
+  for (size_t s = 0; s < n; s += 4)
+  {
+    const float ar = re[s] + re[s+1], ai = im[s] + im[s+1];
+    const float br = re[s] - re[s+1], bi = im[s] - im[s+1];
+    const float cr = re[s+2] + re[s+3], ci = im[s+2] + im[s+3];
+    const float dr = re[s+2] - re[s+3], di = im[s+2] - im[s+3];
+
+    re[s] = ar + cr;   im[s] = ai + ci;
+    re[s+2] = ar - cr; im[s+2] = ai - ci;
+    // d * -i = (di, -dr)
+    re[s+1] = br + di; im[s+1] = bi - dr;
+    re[s+3] = br - di; im[s+3] = bi + dr;
+  }
+
+  for (size_t half = 4; half < n; half <<= 1)
+  {
+    const float* twr = m_twiddleRe.data() + half;
+    const float* twi = m_twiddleIm.data() + half;
+
+    for (size_t s = 0; s < n; s += 2 * half)
+    {
+      float* are = re + s;
+      float* aim = im + s;
+      float* bre = are + half;
+      float* bim = aim + half;
+
+      size_t j = 0;
+#ifdef RFFT_SSE2
+      for (; j + 4 <= half; j += 4)
+      {
+        const __m128 wr = _mm_loadu_ps(twr + j);
+        const __m128 wi = _mm_loadu_ps(twi + j);
+        const __m128 xr = _mm_loadu_ps(bre + j);
+        const __m128 xi = _mm_loadu_ps(bim + j);
+        const __m128 tr = _mm_sub_ps(_mm_mul_ps(wr, xr), _mm_mul_ps(wi, xi));
+        const __m128 ti = _mm_add_ps(_mm_mul_ps(wr, xi), _mm_mul_ps(wi, xr));
+        const __m128 ar = _mm_loadu_ps(are + j);
+        const __m128 ai = _mm_loadu_ps(aim + j);
+        _mm_storeu_ps(bre + j, _mm_sub_ps(ar, tr));
+        _mm_storeu_ps(bim + j, _mm_sub_ps(ai, ti));
+        _mm_storeu_ps(are + j, _mm_add_ps(ar, tr));
+        _mm_storeu_ps(aim + j, _mm_add_ps(ai, ti));
+      }
+#endif
+      for (; j < half; ++j)
+      {
+        const float tr = twr[j] * bre[j] - twi[j] * bim[j];
+        const float ti = twr[j] * bim[j] + twi[j] * bre[j];
+        bre[j] = are[j] - tr;
+        bim[j] = aim[j] - ti;
+        are[j] += tr;
+        aim[j] += ti;
+      }
+    }
+  }
+}
+
+void RFFT::calcKiss(const float* input, float* output)
 {
   // temporary buffers
   std::vector<kiss_fft_scalar> linput(m_size), rinput(m_size);
@@ -52,10 +263,13 @@ void RFFT::calc(const float* input, float* output)
     rinput[i] = input[2*i+1];
   }
 
-  if (m_windowed)
+  if (!m_windowData.empty())
   {
-    hann(linput);
-    hann(rinput);
+    for (size_t i=0;i<m_size;++i)
+    {
+      linput[i] *= m_windowData[i];
+      rinput[i] *= m_windowData[i];
+    }
   }
 
   // transform channels
@@ -64,7 +278,7 @@ void RFFT::calc(const float* input, float* output)
 
   auto&& filter = [&](kiss_fft_cpx& data)
   {
-    return sqrt(data.r*data.r+data.i*data.i) * 2.0/m_size * (m_windowed?sqrt(8.0/3.0):1.0);
+    return sqrt(data.r*data.r+data.i*data.i) * m_scale;
   };
 
   // interleave while taking magnitudes and normalizing
@@ -74,11 +288,3 @@ void RFFT::calc(const float* input, float* output)
     output[2*i+1] = filter(routput[i]);
   }
 }
-
-#include <iostream>
-
-void RFFT::hann(std::vector<kiss_fft_scalar>& data)
-{
-  for (size_t i=0;i<data.size();++i)
-    data[i] *= 0.5*(1.0-cos(2*M_PI*i/(data.size()-1)));
-}
@@ -20,17 +20,36 @@
  */
 
 #include "contrib/kissfft/kiss_fftr.h"
+#include <stdint.h>
 #include <vector>
 
 //! \brief Class performing a RFFT of interleaved stereo data.
+//!
+//! For power of two sizes both channels are transformed at once, as the real
+//! and imaginary part of a single complex FFT, using SSE2 where available.
+//! Other sizes use kissfft.
 class RFFT
 {
 public:
+  //! \brief Window functions that can be applied to the data.
+  enum class Window
+  {
+    NONE,
+    HANN,
+    HAMMING,
+    BLACKMAN
+  };
+
   //! \brief The constructor creates a RFFT plan.
   //! \brief size Length of time data for a single channel.
   //! \brief windowed Whether or not to apply a Hann window to data.
   RFFT(int size, bool windowed=false);
 
+  //! \brief The constructor creates a RFFT plan.
+  //! \brief size Length of time data for a single channel.
+  //! \brief window Window function to apply to data.
+  RFFT(int size, Window window);
+
   //! \brief Free the RFFT plan
   ~RFFT();
 
@@ -39,11 +58,21 @@ public:
   //! \param output Output data of size m_size.
   void calc(const float* input, float* output);
 protected:
-  //! \brief Apply a Hann window to a buffer.
-  //! \param data Vector with data to apply window to.
-  static void hann(std::vector<kiss_fft_scalar>& data);
+  //! \brief Calculate FFTs with kissfft, for sizes not a power of two.
+  void calcKiss(const float* input, float* output);
+
+  //! \brief Complex FFT of m_re + i*m_im in place, input in bit reversed order.
+  void transform();
+
+  size_t m_size;                  //!< Size for a single channel.
+  Window m_window;                //!< Window function applied.
+  std::vector<float> m_windowData; //!< Window function values, empty for none.
+  float m_scale;                  //!< Normalization of the magnitudes.
+  kiss_fftr_cfg m_cfg = nullptr;  //!< FFT plan, if the size is not a power of two
 
-  size_t m_size;       //!< Size for a single channel.
-  bool m_windowed;     //!< Whether or not a Hann window is applied.
-  kiss_fftr_cfg m_cfg; //!< FFT plan
+  std::vector<uint32_t> m_bitrev; //!< Bit reversal permutation
+  std::vector<float> m_twiddleRe; //!< Twiddle factors, the ones of a stage with
+  std::vector<float> m_twiddleIm; //!< half size h start at index h
+  std::vector<float> m_re;        //!< Real parts, left channel
+  std::vector<float> m_im;        //!< Imaginary parts, right channel
 };
@@ -421,3 +421,29 @@ TEST_F(TestArchive, MultiTypeArchive)
   EXPECT_EQ(2, iArray_var.at(2));
   EXPECT_EQ(3, iArray_var.at(3));
 }
+
+TEST_F(TestArchive, MemoryArchive)
+{
+  std::vector<uint8_t> data;
+  std::string string_ref(3 * CARCHIVE_BUFFER_MAX, 'x'), string_var;
+  int int_ref = 3, int_var = 0, missing = 1;
+
+  CArchive arstore(data);
+  EXPECT_TRUE(arstore.IsStoring());
+  arstore << int_ref;
+  arstore << string_ref;
+  arstore.Close();
+  EXPECT_EQ(sizeof(int) + sizeof(uint32_t) + string_ref.size(), data.size());
+
+  CArchive arload(data.data(), data.size());
+  EXPECT_TRUE(arload.IsLoading());
+  arload >> int_var;
+  arload >> string_var;
+  // reading past the end gives zeros
+  arload >> missing;
+  arload.Close();
+
+  EXPECT_EQ(int_ref, int_var);
+  EXPECT_EQ(string_ref, string_var);
+  EXPECT_EQ(0, missing);
+}
@@ -20,11 +20,19 @@
 
 #include "ServiceBroker.h"
 #include "settings/Settings.h"
+#include "threads/SystemClock.h"
 #include "utils/CharsetConverter.h"
 #include "utils/Utf8Utils.h"
 
+
 #include "gtest/gtest.h"
 
+#ifdef WORDS_BIGENDIAN
+#define UTF32_NATIVE "UTF-32BE"
+#else
+#define UTF32_NATIVE "UTF-32LE"
+#endif
+
 #if 0
 static const uint16_t refutf16LE1[] = { 0xff54, 0xff45, 0xff53, 0xff54,
                                         0xff3f, 0xff55, 0xff54, 0xff46,
@@ -411,3 +419,152 @@ TEST_F(TestCharsetConverter, fromW)
   g_charsetConverter.fromW(refstrw1, varstra1, "UTF-16LE");
   EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
 }
+
+namespace
+{
+
+struct Utf8Sample
+{
+  const char* description;
+  const char* utf8;
+  bool valid;
+};
+
+// boundary cases of the UTF-8 decoder, after Markus Kuhn's UTF-8 decoder
+// capability and stress test
+const Utf8Sample utf8Corpus[] =
+{
+  { "ascii",                   "The Matrix (1999)",                        true },
+  { "2 byte",                  "Am\xC3\xA9lie",                             true },
+  { "3 byte",                  "\xE6\x9D\xB1\xE4\xBA\xAC\xE7\x89\xA9\xE8\xAA\x9E",     true },
+  { "4 byte",                  "\xF0\x9F\x90\xAD\xF0\x9F\x90\xAE",             true },
+  { "first 2 byte",            "\xC2\x80",                                 true },
+  { "last 2 byte",             "\xDF\xBF",                                 true },
+  { "first 3 byte",            "\xE0\xA0\x80",                             true },
+  { "last before surrogates",  "\xED\x9F\xBF",                             true },
+  { "first after surrogates",  "\xEE\x80\x80",                             true },
+  { "BOM",                     "\xEF\xBB\xBFtext",                         true },
+  { "U+FFFF",                  "\xEF\xBF\xBF",                             true },
+  { "first 4 byte",            "\xF0\x90\x80\x80",                         true },
+  { "U+10FFFF",                "\xF4\x8F\xBF\xBF",                         true },
+  { "long ascii run",          "0123456789abcdefghijklmnopqrstuvwxyz\xC3\xA9" "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789", true },
+  { "lone continuation",       "a\x80" "b",                                 false },
+  { "continuations",           "\x80\xBF\x80\xBF",                          false },
+  { "lone lead",               "a\xC3 b",                                   false },
+  { "truncated 3 byte",        "\xE6\x9Dx",                                 false },
+  { "truncated at end",        "abc\xF0\x9F\x90",                            false },
+  { "overlong 2 byte",         "\xC0\xAF",                                 false },
+  { "overlong 3 byte",         "\xE0\x80\xAF",                             false },
+  { "overlong 4 byte",         "\xF0\x80\x80\xAF",                         false },
+  { "high surrogate",          "\xED\xA0\x80",                             false },
+  { "low surrogate",           "\xED\xBF\xBF",                             false },
+  { "beyond U+10FFFF",         "\xF4\x90\x80\x80",                         false },
+  { "5 byte",                  "\xF8\x88\x80\x80\x80",                     false },
+  { "FE FF",                   "\xFE\xFF",                                 false },
+  { "invalid in ascii run",    "0123456789abcdef\xFF" "0123456789abcdef", false },
+};
+
+}
+
+// The built-in Unicode converters have to produce what iconv produces
+TEST_F(TestCharsetConverter, Utf8ConformanceCorpus)
+{
+  for (const Utf8Sample& sample : utf8Corpus)
+  {
+    const std::string utf8(sample.utf8);
+
+    std::u32string reference;
+    EXPECT_TRUE(g_charsetConverter.utf8To(UTF32_NATIVE, utf8, reference)) << sample.description;
+
+    std::u32string utf32;
+    EXPECT_TRUE(g_charsetConverter.utf8ToUtf32(utf8, utf32, false)) << sample.description;
+    EXPECT_TRUE(reference == utf32) << sample.description;
+    EXPECT_EQ(sample.valid, g_charsetConverter.utf8ToUtf32(utf8, utf32, true)) << sample.description;
+    if (!sample.valid)
+      EXPECT_TRUE(utf32.empty()) << sample.description;
+
+    std::wstring wide;
+    EXPECT_TRUE(g_charsetConverter.utf8ToW(utf8, wide, false, false, false)) << sample.description;
+    std::u32string wideUtf32;
+    EXPECT_TRUE(g_charsetConverter.wToUtf32(wide, wideUtf32)) << sample.description;
+    EXPECT_TRUE(reference == wideUtf32) << sample.description;
+
+    if (sample.valid)
+    {
+      std::string utf8Back;
+      EXPECT_TRUE(g_charsetConverter.utf32ToUtf8(reference, utf8Back)) << sample.description;
+      EXPECT_EQ(utf8, utf8Back) << sample.description;
+      EXPECT_TRUE(g_charsetConverter.wToUTF8(wide, utf8Back)) << sample.description;
+      EXPECT_EQ(utf8, utf8Back) << sample.description;
+
+      std::u16string utf16;
+      EXPECT_TRUE(g_charsetConverter.utf8To("UTF-16LE", utf8, utf16)) << sample.description;
+      EXPECT_TRUE(g_charsetConverter.utf16LEtoUTF8(utf16, utf8Back)) << sample.description;
+      EXPECT_EQ(utf8, utf8Back) << sample.description;
+      std::wstring wideFromUtf16;
+      EXPECT_TRUE(g_charsetConverter.utf16LEtoW(utf16, wideFromUtf16)) << sample.description;
+      EXPECT_TRUE(wide == wideFromUtf16) << sample.description;
+    }
+  }
+}
+
+TEST_F(TestCharsetConverter, InvalidUtf32)
+{
+  std::string utf8;
+  const std::u32string surrogate = { 'a', 0xD800, 'b' };
+  EXPECT_FALSE(g_charsetConverter.utf32ToUtf8(surrogate, utf8, true));
+  EXPECT_TRUE(g_charsetConverter.utf32ToUtf8(surrogate, utf8, false));
+  EXPECT_EQ("ab", utf8);
+
+  const std::u32string beyond = { 'a', 0x110000 };
+  EXPECT_FALSE(g_charsetConverter.utf32ToUtf8(beyond, utf8, true));
+}
+
+// UTF-8 to UTF-32 is done for every string the GUI renders, compare the
+// built-in converter with iconv
+TEST_F(TestCharsetConverter, DISABLED_Utf8ToUtf32Throughput)
+{
+  static const size_t TEXT_SIZE = 1 << 20;
+  static const int ROUNDS = 20;
+
+  const char* const titles[] =
+  {
+    "The Matrix ", "Am\xC3\xA9lie ", "L\xC3\xA9on ", "\xE6\x9D\xB1\xE4\xBA\xAC\xE7\x89\xA9\xE8\xAA\x9E ",
+    "\xD0\x91\xD1\x80\xD0\xB8\xD0\xBB\xD0\xBB\xD0\xB8\xD0\xB0\xD0\xBD\xD1\x82\xD0\xBE\xD0\xB2\xD0\xB0\xD1\x8F ", "Das Boot "
+  };
+  std::string ascii;
+  std::string mixed;
+  for (size_t i = 0; ascii.size() < TEXT_SIZE; i++)
+    ascii += titles[i % 2 ? 0 : 5];
+  for (size_t i = 0; mixed.size() < TEXT_SIZE; i++)
+    mixed += titles[i % 6];
+
+  for (const std::string* text : { &ascii, &mixed })
+  {
+    std::u32string reference;
+    std::u32string utf32;
+
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    for (int i = 0; i < ROUNDS; i++)
+      g_charsetConverter.utf8To(UTF32_NATIVE, *text, reference);
+    const unsigned int iconvMs = XbmcThreads::SystemClockMillis() - start;
+
+    start = XbmcThreads::SystemClockMillis();
+    for (int i = 0; i < ROUNDS; i++)
+      g_charsetConverter.utf8ToUtf32(*text, utf32);
+    const unsigned int nativeMs = XbmcThreads::SystemClockMillis() - start;
+
+    std::string utf8;
+    start = XbmcThreads::SystemClockMillis();
+    for (int i = 0; i < ROUNDS; i++)
+      g_charsetConverter.utf32ToUtf8(utf32, utf8);
+    const unsigned int backMs = XbmcThreads::SystemClockMillis() - start;
+
+    EXPECT_TRUE(reference == utf32);
+    EXPECT_EQ(*text, utf8);
+    const std::string name = text == &ascii ? "Ascii" : "Mixed";
+    RecordProperty(name + "IconvMs", static_cast<int>(iconvMs));
+    RecordProperty(name + "BuiltInMs", static_cast<int>(nativeMs));
+    RecordProperty(name + "BackMs", static_cast<int>(backMs));
+  }
+}
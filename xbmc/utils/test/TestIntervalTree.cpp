@@ -0,0 +1,148 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/IntervalTree.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+struct Interval
+{
+  int start;
+  int end;
+  int value;
+};
+
+std::vector<int> Overlapping(const CIntervalTree<int, int>& tree, int start, int end)
+{
+  std::vector<int> values;
+  tree.ForEachOverlapping(start, end, [&values](int, int, int value) { values.push_back(value); });
+  std::sort(values.begin(), values.end());
+  return values;
+}
+
+std::vector<int> Containing(const CIntervalTree<int, int>& tree, int start, int end)
+{
+  std::vector<int> values;
+  tree.ForEachContaining(start, end, [&values](int, int, int value) { values.push_back(value); });
+  std::sort(values.begin(), values.end());
+  return values;
+}
+}
+
+TEST(TestIntervalTree, Queries)
+{
+  CIntervalTree<int, int> tree;
+  tree.Insert(10, 20, 1);
+  tree.Insert(15, 30, 2);
+  tree.Insert(30, 40, 3);
+  tree.Insert(0, 100, 4);
+  EXPECT_EQ(4u, tree.Size());
+
+  EXPECT_EQ(std::vector<int>({1, 2, 4}), Overlapping(tree, 18, 25));
+  // the intervals are closed
+  EXPECT_EQ(std::vector<int>({2, 3, 4}), Overlapping(tree, 30, 30));
+  EXPECT_EQ(std::vector<int>(), Overlapping(tree, 101, 200));
+
+  EXPECT_EQ(std::vector<int>({2, 4}), Containing(tree, 18, 25));
+  EXPECT_EQ(std::vector<int>({4}), Containing(tree, 5, 35));
+
+  // results come in order of start
+  std::vector<int> starts;
+  tree.ForEachOverlapping(0, 100, [&starts](int start, int, int) { starts.push_back(start); });
+  EXPECT_TRUE(std::is_sorted(starts.begin(), starts.end()));
+}
+
+TEST(TestIntervalTree, Erase)
+{
+  CIntervalTree<int, int> tree;
+  tree.Insert(10, 20, 1);
+  tree.Insert(10, 20, 2);
+  tree.Insert(10, 25, 3);
+
+  EXPECT_FALSE(tree.Erase(10, 20, 3));
+  EXPECT_FALSE(tree.Erase(11, 20, 1));
+  EXPECT_TRUE(tree.Erase(10, 20, 2));
+  EXPECT_EQ(std::vector<int>({1, 3}), Overlapping(tree, 0, 100));
+  EXPECT_TRUE(tree.Erase(10, 25, 3));
+  EXPECT_EQ(std::vector<int>(), Overlapping(tree, 21, 100));
+  EXPECT_TRUE(tree.Erase(10, 20, 1));
+  EXPECT_TRUE(tree.IsEmpty());
+
+  tree.Insert(1, 2, 1);
+  tree.Clear();
+  EXPECT_EQ(0u, tree.Size());
+  EXPECT_EQ(std::vector<int>(), Overlapping(tree, 0, 100));
+}
+
+// compare with a linear scan while intervals come and go
+TEST(TestIntervalTree, Random)
+{
+  std::mt19937 random(42);
+  std::uniform_int_distribution<int> position(0, 10000);
+  std::uniform_int_distribution<int> length(0, 300);
+
+  CIntervalTree<int, int> tree;
+  std::vector<Interval> intervals;
+  int next = 0;
+
+  for (int round = 0; round < 2000; round++)
+  {
+    if (intervals.empty() || random() % 3 != 0)
+    {
+      Interval interval;
+      interval.start = position(random);
+      interval.end = interval.start + length(random);
+      interval.value = next++;
+      tree.Insert(interval.start, interval.end, interval.value);
+      intervals.push_back(interval);
+    }
+    else
+    {
+      const size_t index = random() % intervals.size();
+      const Interval& interval = intervals[index];
+      ASSERT_TRUE(tree.Erase(interval.start, interval.end, interval.value));
+      intervals.erase(intervals.begin() + index);
+    }
+    ASSERT_EQ(intervals.size(), tree.Size());
+
+    const int start = position(random);
+    const int end = start + length(random);
+    std::vector<int> overlapping;
+    std::vector<int> containing;
+    for (const auto& interval : intervals)
+    {
+      if (interval.start <= end && interval.end >= start)
+        overlapping.push_back(interval.value);
+      if (interval.start <= start && interval.end >= end)
+        containing.push_back(interval.value);
+    }
+    std::sort(overlapping.begin(), overlapping.end());
+    std::sort(containing.begin(), containing.end());
+
+    ASSERT_EQ(overlapping, Overlapping(tree, start, end));
+    ASSERT_EQ(containing, Containing(tree, start, end));
+  }
+}
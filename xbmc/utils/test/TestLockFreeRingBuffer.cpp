@@ -0,0 +1,90 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/LockFreeRingBuffer.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(TestLockFreeRingBuffer, Full)
+{
+  CLockFreeRingBuffer<int> ring(4);
+  EXPECT_TRUE(ring.GetReadSlot() == nullptr);
+
+  for (int i = 0; i < 4; i++)
+  {
+    int* slot = ring.GetWriteSlot();
+    ASSERT_TRUE(slot != nullptr);
+    *slot = i;
+    ring.Commit();
+  }
+  EXPECT_TRUE(ring.GetWriteSlot() == nullptr);
+
+  ASSERT_TRUE(ring.GetReadSlot() != nullptr);
+  EXPECT_EQ(0, *ring.GetReadSlot());
+  ring.Release();
+  EXPECT_TRUE(ring.GetWriteSlot() != nullptr);
+
+  ring.Clear();
+  EXPECT_TRUE(ring.GetReadSlot() == nullptr);
+}
+
+TEST(TestLockFreeRingBuffer, Threads)
+{
+  static const int COUNT = 200000;
+  CLockFreeRingBuffer<std::vector<int>> ring(8);
+
+  std::thread producer([&ring]()
+  {
+    for (int i = 0; i < COUNT;)
+    {
+      std::vector<int>* slot = ring.GetWriteSlot();
+      if (!slot)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      slot->assign(4, i++);
+      ring.Commit();
+    }
+  });
+
+  int expected = 0;
+  int wrong = 0;
+  while (expected < COUNT)
+  {
+    std::vector<int>* slot = ring.GetReadSlot();
+    if (!slot)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    if (*slot != std::vector<int>(4, expected))
+      wrong++;
+    expected++;
+    ring.Release();
+  }
+
+  producer.join();
+  EXPECT_EQ(0, wrong);
+  EXPECT_TRUE(ring.GetReadSlot() == nullptr);
+}
@@ -0,0 +1,160 @@
+/*
+ *      Copyright (C) 2018 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/SystemClock.h"
+#include "utils/PathClassification.h"
+#include "utils/StringUtils.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define LAST_FLAG CPathClassification::LIBRARY_FOLDER
+
+namespace
+{
+
+const char* const paths[] =
+{
+  "/home/user/movies/Alien (1979).mkv",
+  "smb://server/share/movies/Alien (1979).mkv",
+  "nfs://server/export/music/",
+  "http://example.com/stream.m3u8",
+  "ftp://server/pub/movie.avi",
+  "stack://smb://server/movies/Alien cd1.avi , smb://server/movies/Alien cd2.avi",
+  "zip://%2fhome%2fuser%2farchive.zip/folder/",
+  "rar://%2fhome%2fuser%2farchive.rar/movie.avi",
+  "/home/user/archive.zip",
+  "special://home/addons/",
+  "special://temp/thumb.jpg",
+  "plugin://plugin.video.example/?mode=1",
+  "multipath://%2fhome%2fuser%2fmovies%2f/%2fhome%2fuser%2fmore%2f/",
+  "musicdb://songs/12.mp3",
+  "videodb://movies/titles/",
+  "library://video/movies/",
+  "upnp://uuid/1/2/",
+  "pvr://channels/tv/",
+  "cdda://local/1.cdda",
+  ""
+};
+
+std::vector<CPathClassification::Flag> AllFlags()
+{
+  std::vector<CPathClassification::Flag> flags;
+  for (uint32_t flag = 1; flag <= LAST_FLAG; flag <<= 1)
+    flags.push_back(static_cast<CPathClassification::Flag>(flag));
+  return flags;
+}
+
+}
+
+TEST(TestPathClassification, MatchesURIUtils)
+{
+  for (const char* path : paths)
+  {
+    CPathClassification classification;
+    for (int pass = 0; pass < 2; pass++)
+    {
+      for (CPathClassification::Flag flag : AllFlags())
+        EXPECT_EQ(CPathClassification::Classify(flag, path), classification.Is(flag, path))
+          << path << " flag " << flag << " pass " << pass;
+    }
+    EXPECT_EQ(AllFlags().size(), classification.GetEvaluatedCount());
+  }
+}
+
+TEST(TestPathClassification, Reset)
+{
+  const std::string smb = "smb://server/share/movie.avi";
+  const std::string local = "/home/user/movie.avi";
+
+  CPathClassification classification;
+  EXPECT_TRUE(classification.Is(CPathClassification::SMB, smb));
+  EXPECT_TRUE(classification.Is(CPathClassification::REMOTE, smb));
+  EXPECT_EQ(2u, classification.GetEvaluatedCount());
+
+  CPathClassification copy(classification);
+  EXPECT_EQ(2u, copy.GetEvaluatedCount());
+  EXPECT_TRUE(copy.Is(CPathClassification::SMB, smb));
+
+  classification.Reset();
+  EXPECT_EQ(0u, classification.GetEvaluatedCount());
+  EXPECT_FALSE(classification.Is(CPathClassification::SMB, local));
+  EXPECT_FALSE(classification.Is(CPathClassification::REMOTE, local));
+
+  copy = classification;
+  EXPECT_FALSE(copy.Is(CPathClassification::SMB, local));
+  EXPECT_EQ(2u, copy.GetEvaluatedCount());
+}
+
+// A list of 1000 items asked the questions the GUI and the thumb loaders ask
+// each frame, for 100 frames
+TEST(TestPathClassification, DISABLED_Benchmark)
+{
+  static const int NUM_ITEMS = 1000;
+  static const int NUM_FRAMES = 100;
+  static const CPathClassification::Flag frameFlags[] =
+  {
+    CPathClassification::REMOTE, CPathClassification::SMB, CPathClassification::INTERNET_STREAM,
+    CPathClassification::STACK, CPathClassification::IN_ARCHIVE, CPathClassification::PLUGIN,
+    CPathClassification::LIVE_TV, CPathClassification::HD
+  };
+
+  std::vector<std::string> items;
+  for (int i = 0; i < NUM_ITEMS; i++)
+    items.push_back(StringUtils::Format("%s/movie %04i.mkv", i % 3 == 0 ? "special://home/videos" : "smb://server/share", i));
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  unsigned int uncachedHits = 0;
+  for (int frame = 0; frame < NUM_FRAMES; frame++)
+    for (const std::string &item : items)
+      for (CPathClassification::Flag flag : frameFlags)
+        uncachedHits += CPathClassification::Classify(flag, item);
+  const unsigned int uncached = XbmcThreads::SystemClockMillis() - start;
+
+  std::vector<CPathClassification> classifications(items.size());
+  start = XbmcThreads::SystemClockMillis();
+  unsigned int cachedHits = 0;
+  unsigned int calls = 0;
+  for (int frame = 0; frame < NUM_FRAMES; frame++)
+  {
+    for (size_t i = 0; i < items.size(); i++)
+    {
+      for (CPathClassification::Flag flag : frameFlags)
+      {
+        cachedHits += classifications[i].Is(flag, items[i]);
+        calls++;
+      }
+    }
+  }
+  const unsigned int cached = XbmcThreads::SystemClockMillis() - start;
+
+  unsigned int evaluated = 0;
+  for (const CPathClassification &classification : classifications)
+    evaluated += classification.GetEvaluatedCount();
+
+  EXPECT_EQ(uncachedHits, cachedHits);
+  EXPECT_EQ(NUM_ITEMS * sizeof(frameFlags) / sizeof(frameFlags[0]), evaluated);
+  RecordProperty("Classifications", static_cast<int>(calls));
+  RecordProperty("Evaluated", static_cast<int>(evaluated));
+  RecordProperty("UncachedMs", static_cast<int>(uncached));
+  RecordProperty("CachedMs", static_cast<int>(cached));
+}
@@ -26,7 +26,9 @@
 #define _USE_MATH_DEFINES
 #endif
 
+#include <chrono>
 #include <math.h>
+#include <vector>
 
 
 TEST(TestRFFT, SimpleSignal)
@@ -51,3 +53,139 @@ TEST(TestRFFT, SimpleSignal)
     EXPECT_NEAR(output[2*i+1], ((i==freq2[0]||i==freq2[1])?1.0:0.0), 1e-7);
   }
 }
+
+// magnitudes as calculated by RFFT, from a plain DFT in double precision
+static std::vector<double> ReferenceMagnitudes(const std::vector<float>& input, size_t size,
+                                               const std::vector<double>& window, double scale)
+{
+  std::vector<double> output(size);
+  for (size_t channel = 0; channel < 2; ++channel)
+  {
+    for (size_t k = 0; k < size/2; ++k)
+    {
+      double re = 0.0, im = 0.0;
+      for (size_t n = 0; n < size; ++n)
+      {
+        const double x = input[2*n+channel] * window[n];
+        re += x * cos(2.0*M_PI*k*n/size);
+        im -= x * sin(2.0*M_PI*k*n/size);
+      }
+      output[2*k+channel] = sqrt(re*re + im*im) * scale;
+    }
+  }
+  return output;
+}
+
+TEST(TestRFFT, Accuracy)
+{
+  const int sizes[] = { 8, 16, 48, 64, 256, 512, 1000, 2048 };
+  const RFFT::Window windows[] = { RFFT::Window::NONE, RFFT::Window::HANN, RFFT::Window::HAMMING, RFFT::Window::BLACKMAN };
+
+  unsigned int seed = 1;
+  for (int size : sizes)
+  {
+    std::vector<float> input(2*size);
+    for (float& sample : input)
+    {
+      seed = seed * 1103515245 + 12345;
+      sample = static_cast<float>((seed >> 8) & 0xFFFF) / 32768.0f - 1.0f;
+    }
+
+    for (RFFT::Window window : windows)
+    {
+      std::vector<double> w(size, 1.0);
+      double sum = size;
+      if (window != RFFT::Window::NONE)
+      {
+        sum = 0.0;
+        for (int i = 0; i < size; ++i)
+        {
+          const double phase = 2*M_PI*i/(size-1);
+          if (window == RFFT::Window::HANN)
+            w[i] = 0.5*(1.0-cos(phase));
+          else if (window == RFFT::Window::HAMMING)
+            w[i] = 0.54-0.46*cos(phase);
+          else
+            w[i] = 0.42-0.5*cos(phase)+0.08*cos(2*phase);
+          sum += w[i]*w[i];
+        }
+      }
+      const std::vector<double> expected = ReferenceMagnitudes(input, size, w, 2.0/size*sqrt(size/sum));
+
+      RFFT transform(size, window);
+      std::vector<float> output(size);
+      transform.calc(&input[0], &output[0]);
+
+      for (int i = 0; i < size; ++i)
+        ASSERT_NEAR(expected[i], output[i], 1e-5) << "size " << size << " window " << static_cast<int>(window) << " bin " << i;
+    }
+  }
+}
+
+TEST(TestRFFT, HannWindow)
+{
+  // a bin centered sine keeps its amplitude after the energy correction of
+  // the window, up to the spread into the neighbouring bins
+  const int size = 512;
+  const int freq = 40;
+  std::vector<float> input(2*size);
+  for (int i = 0; i < size; ++i)
+  {
+    input[2*i] = cos(freq*2.0*M_PI*i/size);
+    input[2*i+1] = 0.0f;
+  }
+
+  RFFT transform(size, true);
+  std::vector<float> output(size);
+  transform.calc(&input[0], &output[0]);
+
+  EXPECT_NEAR(0.5*sqrt(8.0/3.0), output[2*freq], 1e-2);
+  EXPECT_NEAR(0.25*sqrt(8.0/3.0), output[2*(freq-1)], 1e-2);
+  EXPECT_NEAR(0.0, output[2*(freq+10)], 1e-3);
+  EXPECT_NEAR(0.0, output[2*freq+1], 1e-6);
+}
+
+// Compares the stereo transform to two kissfft real transforms, as used for
+// all sizes before
+TEST(TestRFFT, DISABLED_Benchmark)
+{
+  const int size = 256; // AUDIO_BUFFER_SIZE/2 of the visualisation control
+  const int iterations = 20000;
+
+  std::vector<float> input(2*size);
+  for (int i = 0; i < 2*size; ++i)
+    input[i] = sin(i*0.37f) * 0.5f + sin(i*0.011f) * 0.25f;
+  std::vector<float> output(size);
+
+  RFFT transform(size, RFFT::Window::HANN);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i)
+    transform.calc(&input[0], &output[0]);
+  const auto rfftUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  kiss_fftr_cfg cfg = kiss_fftr_alloc(size, 0, nullptr, nullptr);
+  std::vector<kiss_fft_scalar> linput(size), rinput(size);
+  std::vector<kiss_fft_cpx> loutput(size), routput(size);
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i)
+  {
+    for (int j = 0; j < size; ++j)
+    {
+      const double w = 0.5*(1.0-cos(2*M_PI*j/(size-1)));
+      linput[j] = input[2*j] * w;
+      rinput[j] = input[2*j+1] * w;
+    }
+    kiss_fftr(cfg, &linput[0], &loutput[0]);
+    kiss_fftr(cfg, &rinput[0], &routput[0]);
+    for (int j = 0; j < size/2; ++j)
+    {
+      output[2*j] = sqrt(loutput[j].r*loutput[j].r + loutput[j].i*loutput[j].i);
+      output[2*j+1] = sqrt(routput[j].r*routput[j].r + routput[j].i*routput[j].i);
+    }
+  }
+  const auto kissUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  KISS_FFT_FREE(cfg);
+
+  RecordProperty("RfftUs", static_cast<int>(rfftUs));
+  RecordProperty("KissFftUs", static_cast<int>(kissUs));
+}
@@ -1730,6 +1730,7 @@ void CVideoDatabase::AddTagToItem(int media_id, int tag_id, const std::string &t
     return;
 
   AddToLinkTable(media_id, type, "tag", tag_id);
+  UpdateMediaFullTextEntry(type, media_id);
 }
 
 void CVideoDatabase::RemoveTagFromItem(int media_id, int tag_id, const std::string &type)
@@ -1738,6 +1739,7 @@ void CVideoDatabase::RemoveTagFromItem(int media_id, int tag_id, const std::stri
     return;
 
   RemoveFromLinkTable(media_id, type, "tag", tag_id);
+  UpdateMediaFullTextEntry(type, media_id);
 }
 
 void CVideoDatabase::RemoveTagsFromItem(int media_id, const std::string &type)
@@ -1746,6 +1748,7 @@ void CVideoDatabase::RemoveTagsFromItem(int media_id, const std::string &type)
     return;
 
   m_pDS2->exec(PrepareSQL("DELETE FROM tag_link WHERE media_id=%d AND media_type='%s'", media_id, type.c_str()));
+  UpdateMediaFullTextEntry(type, media_id);
 }
 
 //****Actors****
@@ -2386,6 +2389,10 @@ int CVideoDatabase::SetDetailsForMovie(const std::string& strFilenameAndPath, CV
       sql += PrepareSQL(", premiered = '%i'", details.GetYear());
     sql += PrepareSQL(" where idMovie=%i", idMovie);
     m_pDS->exec(sql);
+
+    // the cast and tags were written above, so the entry is complete now
+    UpdateMediaFullTextEntry(MediaTypeMovie, idMovie);
+
     CommitTransaction();
 
     return idMovie;
@@ -2488,6 +2495,8 @@ int CVideoDatabase::UpdateDetailsForMovie(int idMovie, CVideoInfoTag& details, c
     sql += PrepareSQL(" where idMovie=%i", idMovie);
     m_pDS->exec(sql);
 
+    UpdateMediaFullTextEntry(MediaTypeMovie, idMovie);
+
     CommitTransaction();
 
     CLog::Log(LOGINFO, "%s: Finished updates for movie %i", __FUNCTION__, idMovie);
@@ -2647,6 +2656,7 @@ bool CVideoDatabase::UpdateDetailsForTvShow(int idTvShow, CVideoInfoTag &details
   sql += PrepareSQL(" WHERE idShow=%i", idTvShow);
   if (ExecuteQuery(sql))
   {
+    UpdateMediaFullTextEntry(MediaTypeTvShow, idTvShow);
     CommitTransaction();
     return true;
   }
@@ -3350,6 +3360,7 @@ void CVideoDatabase::DeleteMovie(int idMovie, bool bKeepId /* = false */)
 
       std::string strSQL = PrepareSQL("delete from movie where idMovie=%i", idMovie);
       m_pDS->exec(strSQL);
+      DeleteFullTextEntry("movie_fts", idMovie);
     }
 
     //! @todo move this below CommitTransaction() once UPnP doesn't rely on this anymore
@@ -3406,6 +3417,7 @@ void CVideoDatabase::DeleteTvShow(int idTvShow, bool bKeepId /* = false */)
     {
       strSQL=PrepareSQL("delete from tvshow where idShow=%i", idTvShow);
       m_pDS->exec(strSQL);
+      DeleteFullTextEntry("tvshow_fts", idTvShow);
 
       for (const auto &i : paths)
       {
@@ -5293,6 +5305,67 @@ int CVideoDatabase::GetSchemaVersion() const
   return 109;
 }
 
+namespace
+{
+
+/*! \brief Flatten the names linked to an item (e.g. its cast or tags) into
+ a single column of a full text search index.
+ */
+std::string GetFullTextLinkColumn(const std::string &table, const std::string &mediaType, const std::string &mediaId)
+{
+  return "(SELECT GROUP_CONCAT(" + table + ".name) FROM " + table + "_link "
+         "JOIN " + table + " ON " + table + "." + table + "_id=" + table + "_link." + table + "_id "
+         "WHERE " + table + "_link.media_id=" + mediaId + " AND " + table + "_link.media_type='" + mediaType + "')";
+}
+
+}
+
+std::vector<CDatabase::FullTextIndex> CVideoDatabase::GetFullTextIndexes() const
+{
+  std::vector<FullTextIndex> indexes;
+
+  FullTextIndex movies;
+  movies.name = "movie_fts";
+  movies.table = "movie";
+  movies.idColumn = "idMovie";
+  movies.columns = {
+    { "title", StringUtils::Format("c%02d", VIDEODB_ID_TITLE) },
+    { "plot", StringUtils::Format("c%02d", VIDEODB_ID_PLOT) },
+    { "plotoutline", StringUtils::Format("c%02d", VIDEODB_ID_PLOTOUTLINE) },
+    { "tagline", StringUtils::Format("c%02d", VIDEODB_ID_TAGLINE) },
+    { "people", GetFullTextLinkColumn("actor", MediaTypeMovie, "movie.idMovie") },
+    { "tags", GetFullTextLinkColumn("tag", MediaTypeMovie, "movie.idMovie") }
+  };
+  indexes.push_back(movies);
+
+  FullTextIndex tvshows;
+  tvshows.name = "tvshow_fts";
+  tvshows.table = "tvshow";
+  tvshows.idColumn = "idShow";
+  tvshows.columns = {
+    { "title", StringUtils::Format("c%02d", VIDEODB_ID_TV_TITLE) },
+    { "plot", StringUtils::Format("c%02d", VIDEODB_ID_TV_PLOT) },
+    { "people", GetFullTextLinkColumn("actor", MediaTypeTvShow, "tvshow.idShow") },
+    { "tags", GetFullTextLinkColumn("tag", MediaTypeTvShow, "tvshow.idShow") }
+  };
+  indexes.push_back(tvshows);
+
+  return indexes;
+}
+
+bool CVideoDatabase::IsFullTextSearchEnabled() const
+{
+  return g_advancedSettings.m_bVideoLibraryFullTextSearch;
+}
+
+void CVideoDatabase::UpdateMediaFullTextEntry(const std::string &mediaType, int mediaId)
+{
+  if (mediaType == MediaTypeMovie)
+    UpdateFullTextEntry("movie_fts", mediaId);
+  else if (mediaType == MediaTypeTvShow)
+    UpdateFullTextEntry("tvshow_fts", mediaId);
+}
+
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
 {
   SScanSettings settings;
@@ -6774,6 +6847,21 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
       strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
+    // A limited random list (e.g. a random movies widget) only needs to fetch
+    // the randomly picked movies instead of all of them
+    else if (extFilter.limit.empty() &&
+             sorting.sortBy == SortByRandom &&
+             sorting.limitStart <= 0 && sorting.limitEnd > 0)
+    {
+      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
+
+      Filter randomFilter = extFilter;
+      if (!FilterRandomIDs("movie_view", "movie_view.idMovie", randomFilter, sorting.limitEnd))
+        return false;
+      strSQLExtra.clear();
+      if (!CDatabase::BuildSQL(strSQLExtra, randomFilter, strSQLExtra))
+        return false;
+    }
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
@@ -6882,6 +6970,21 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
       strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
+    // A limited random list (e.g. a random tv shows widget) only needs to fetch
+    // the randomly picked tv shows instead of all of them
+    else if (extFilter.limit.empty() &&
+             sorting.sortBy == SortByRandom &&
+             sorting.limitStart <= 0 && sorting.limitEnd > 0)
+    {
+      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
+
+      Filter randomFilter = extFilter;
+      if (!FilterRandomIDs("tvshow_view", "tvshow_view.idShow", randomFilter, sorting.limitEnd))
+        return false;
+      strSQLExtra.clear();
+      if (!CDatabase::BuildSQL(strSQLExtra, randomFilter, strSQLExtra))
+        return false;
+    }
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
@@ -7008,6 +7111,21 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
       strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
+    // A limited random list (e.g. a random episodes widget) only needs to fetch
+    // the randomly picked episodes instead of all of them
+    else if (extFilter.limit.empty() &&
+             sorting.sortBy == SortByRandom &&
+             sorting.limitStart <= 0 && sorting.limitEnd > 0)
+    {
+      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
+
+      Filter randomFilter = extFilter;
+      if (!FilterRandomIDs("episode_view", "episode_view.idEpisode", randomFilter, sorting.limitEnd))
+        return false;
+      strSQLExtra.clear();
+      if (!CDatabase::BuildSQL(strSQLExtra, randomFilter, strSQLExtra))
+        return false;
+    }
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
@@ -7849,6 +7967,21 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
       total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
       strSQLExtra += DatabaseUtils::BuildLimitClause(sorting.limitEnd, sorting.limitStart);
     }
+    // A limited random list (e.g. a random music videos widget) only needs to fetch
+    // the randomly picked music videos instead of all of them
+    else if (extFilter.limit.empty() &&
+             sorting.sortBy == SortByRandom &&
+             sorting.limitStart <= 0 && sorting.limitEnd > 0)
+    {
+      total = (int)strtol(GetSingleValue(PrepareSQL(strSQL, "COUNT(1)") + strSQLExtra, m_pDS).c_str(), NULL, 10);
+
+      Filter randomFilter = extFilter;
+      if (!FilterRandomIDs("musicvideo_view", "musicvideo_view.idMVideo", randomFilter, sorting.limitEnd))
+        return false;
+      strSQLExtra.clear();
+      if (!CDatabase::BuildSQL(strSQLExtra, randomFilter, strSQLExtra))
+        return false;
+    }
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
@@ -7936,7 +8069,7 @@ unsigned int CVideoDatabase::GetMusicVideoIDs(const std::string& strWhere, std::
   return 0;
 }
 
-bool CVideoDatabase::GetRandomMusicVideo(CFileItem* item, int& idSong, const std::string& strWhere)
+bool CVideoDatabase::GetRandomMusicVideo(CFileItem* item, int& idSong, const std::string& strWhere, const std::set<int> &exclude /* = std::set<int>() */)
 {
   try
   {
@@ -7945,10 +8078,11 @@ bool CVideoDatabase::GetRandomMusicVideo(CFileItem* item, int& idSong, const std
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    std::string strSQL = "select * from musicvideo_view";
-    if (!strWhere.empty())
-      strSQL += " where " + strWhere;
-    strSQL += PrepareSQL(" order by RANDOM() limit 1");
+    std::vector<int> ids;
+    if (!GetRandomIDs("musicvideo_view", "idMVideo", Filter(strWhere), 1, exclude, ids) || ids.empty())
+      return false;
+
+    std::string strSQL = PrepareSQL("select * from musicvideo_view where idMVideo = %i", ids.front());
     CLog::Log(LOGDEBUG, LOGDATABASE, "%s query = %s", __FUNCTION__, strSQL.c_str());
     // run query
     if (!m_pDS->query(strSQL))
@@ -8028,10 +8162,16 @@ void CVideoDatabase::GetMoviesByName(const std::string& strSearch, CFileItemList
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    std::string where = PrepareSQL("movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE, strSearch.c_str());
+    // the full text index narrows down the rows the LIKE is evaluated on
+    std::string fullText = GetFullTextSubQuery("movie_fts", { "title" }, strSearch, false);
+    if (!fullText.empty())
+      where = "movie.idMovie IN (" + fullText + ") AND " + where;
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_TITLE) + where;
     else
-      strSQL = PrepareSQL("select movie.idMovie,movie.c%02d, movie.idSet from movie where movie.c%02d like '%%%s%%'",VIDEODB_ID_TITLE,VIDEODB_ID_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select movie.idMovie,movie.c%02d, movie.idSet from movie where ",VIDEODB_ID_TITLE) + where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8073,10 +8213,16 @@ void CVideoDatabase::GetTvShowsByName(const std::string& strSearch, CFileItemLis
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    std::string where = PrepareSQL("tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, strSearch.c_str());
+    // the full text index narrows down the rows the LIKE is evaluated on
+    std::string fullText = GetFullTextSubQuery("tvshow_fts", { "title" }, strSearch, false);
+    if (!fullText.empty())
+      where = "tvshow.idShow IN (" + fullText + ") AND " + where;
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, VIDEODB_ID_TV_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE ", VIDEODB_ID_TV_TITLE) + where;
     else
-      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where tvshow.c%02d like '%%%s%%'",VIDEODB_ID_TV_TITLE,VIDEODB_ID_TV_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where ",VIDEODB_ID_TV_TITLE) + where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8243,10 +8389,16 @@ void CVideoDatabase::GetMoviesByPlot(const std::string& strSearch, CFileItemList
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    std::string where = PrepareSQL("(movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%')", VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE, strSearch.c_str());
+    // the full text index narrows down the rows the LIKE is evaluated on
+    std::string fullText = GetFullTextSubQuery("movie_fts", { "plot", "plotoutline", "tagline" }, strSearch, false);
+    if (!fullText.empty())
+      where = "movie.idMovie IN (" + fullText + ") AND " + where;
+
     if (m_profileManager.GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE,VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE,strSearch.c_str());
+      strSQL = PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_TITLE) + where;
     else
-      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie WHERE (movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%')", VIDEODB_ID_TITLE, VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie WHERE ", VIDEODB_ID_TITLE) + where;
 
     m_pDS->query( strSQL );
 
@@ -9687,7 +9839,11 @@ bool CVideoDatabase::SetSingleValue(VIDEODB_CONTENT_TYPE type, int dbId, int dbF
     if (strTable.empty())
       return false;
 
-    return SetSingleValue(strTable, StringUtils::Format("c%02u", dbField), strValue, strField, dbId);
+    if (!SetSingleValue(strTable, StringUtils::Format("c%02u", dbField), strValue, strField, dbId))
+      return false;
+
+    UpdateMediaFullTextEntry(DatabaseUtils::MediaTypeFromVideoContentType(type), dbId);
+    return true;
   }
   catch (...)
   {
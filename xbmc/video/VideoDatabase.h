@@ -809,7 +809,7 @@ public:
 
   // partymode
   unsigned int GetMusicVideoIDs(const std::string& strWhere, std::vector<std::pair<int, int> > &songIDs);
-  bool GetRandomMusicVideo(CFileItem* item, int& idSong, const std::string& strWhere);
+  bool GetRandomMusicVideo(CFileItem* item, int& idSong, const std::string& strWhere, const std::set<int> &exclude = std::set<int>());
 
   static void VideoContentTypeToString(VIDEODB_CONTENT_TYPE type, std::string& out)
   {
@@ -982,6 +982,14 @@ private:
   int GetSchemaVersion() const override;
   virtual int GetExportVersion() const { return 1; };
   const char *GetBaseDBName() const override { return "MyVideos"; };
+  std::vector<FullTextIndex> GetFullTextIndexes() const override;
+  bool IsFullTextSearchEnabled() const override;
+
+  /*! \brief Refresh the full text search entry of a movie or tvshow
+   \param mediaType the media type of the item, other types are ignored
+   \param mediaId the id of the item
+   */
+  void UpdateMediaFullTextEntry(const std::string &mediaType, int mediaId);
 
   void ConstructPath(std::string& strDest, const std::string& strPath, const std::string& strFileName);
   void SplitPath(const std::string& strFileNameAndPath, std::string& strPath, std::string& strFileName);
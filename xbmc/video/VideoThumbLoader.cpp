@@ -103,8 +103,8 @@ bool CThumbExtractor::DoWork()
     return false;
 
   // For HTTP/FTP we only allow extraction when on a LAN
-  if (URIUtils::IsRemote(m_item.GetPath()) &&
-     !URIUtils::IsOnLAN(m_item.GetPath())  &&
+  if (m_item.IsRemote() &&
+     !m_item.IsOnLAN() &&
      (URIUtils::IsFTP(m_item.GetPath())    ||
       URIUtils::IsHTTP(m_item.GetPath())))
     return false;
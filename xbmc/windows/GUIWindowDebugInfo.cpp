@@ -157,6 +157,9 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
       if (control)
         info += StringUtils::Format("Focused: %i (%s)", control->GetID(), CGUIControlFactory::TranslateControlType(control->GetControlType()).c_str());
     }
+    const CGUIInfoManager::InfoStatistics stats = CServiceBroker::GetGUI()->GetInfoManager().GetStatistics();
+    info += StringUtils::Format("\nConditions: %u evaluated of %u looked up - Frame: %u ms",
+                                stats.evaluations, stats.lookups, stats.frameTime);
   }
 
   float w, h;